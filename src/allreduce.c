@@ -0,0 +1,333 @@
+/**
+ * @file allreduce.c
+ * @brief Implementation of the shared-memory allreduce algorithms.
+ *
+ * Step numbering: a rank whose flag reads E on entry publishes E + 1
+ * once its input may be read, then E + 2 + k after algorithm step k.
+ * All ranks make the same calls, so they all enter with the same E.
+ * Waiting for a peer's flag to reach E + 2 + k therefore means "the
+ * peer finished step k of this call", and reaching E means "the peer
+ * finished the previous call". Vectors are written before the flag is
+ * published and read after it is seen, as in reduce.c.
+ */
+
+#include "allreduce.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/** @brief Elements per cache line; vectors and chunks align to it. */
+#define ALLREDUCE_ALIGN (CB_CACHE_LINE / sizeof(float))
+
+/** @brief Vectors of one rank. */
+enum {
+    BUF_IN  = 0, /**< Input. */
+    BUF_OUT = 1, /**< Output. */
+    BUF_TMP = 2, /**< Scratch (recursive doubling). */
+    BUF_COUNT    /**< Vectors per rank. */
+};
+
+/** @brief Header bytes, rounded up to a cache line. */
+static size_t header_size(void)
+{
+    return (sizeof(cb_allreduce_t) + CB_CACHE_LINE - 1) /
+           CB_CACHE_LINE * CB_CACHE_LINE;
+}
+
+/** @brief Vector @p which of @p rank. */
+static float *vec(cb_allreduce_t *ar, int rank, int which)
+{
+    float *data = (float *)((char *)ar + header_size());
+    return data + ((size_t)rank * BUF_COUNT + (size_t)which) * ar->stride;
+}
+
+/** @brief First element of chunk @p c (c == count gives the length). */
+static size_t chunk_start(const cb_allreduce_t *ar, int c)
+{
+    if (c >= ar->count) {
+        return ar->length;
+    }
+    size_t start = (size_t)((uint64_t)ar->length * (uint64_t)c /
+                            (uint64_t)ar->count);
+    return start - start % ALLREDUCE_ALIGN;
+}
+
+/** @brief dst[i] = a[i] + b[i] for i in [first, end). */
+static void add_range(float *restrict dst, const float *restrict a,
+                      const float *restrict b, size_t first, size_t end)
+{
+    for (size_t i = first; i < end; i++) {
+        dst[i] = a[i] + b[i];
+    }
+}
+
+/** @brief dst[i] += src[i] for i in [first, end). */
+static void acc_range(float *restrict dst, const float *restrict src,
+                      size_t first, size_t end)
+{
+    for (size_t i = first; i < end; i++) {
+        dst[i] += src[i];
+    }
+}
+
+/** @brief Copy chunk @p c of @p src to @p dst. */
+static void copy_chunk(const cb_allreduce_t *ar, float *dst, const float *src,
+                       int c)
+{
+    size_t first = chunk_start(ar, c), end = chunk_start(ar, c + 1);
+    memcpy(dst + first, src + first, (end - first) * sizeof(float));
+}
+
+/** @brief Wait for @p rank's step counter to reach @p target. */
+static void wait_rank(cb_allreduce_t *ar, int rank, uint32_t target)
+{
+    cb_flag_wait(&ar->slots[rank].step, target, ar->policy,
+                 ar->process_shared);
+}
+
+/** @brief Publish the caller's step counter. */
+static void publish(cb_allreduce_t *ar, int rank, uint32_t value)
+{
+    cb_flag_publish(&ar->slots[rank].step, value, INT32_MAX,
+                    ar->process_shared);
+}
+
+/**
+ * @brief Ring allreduce.
+ *
+ * Reduce-scatter step k (0 .. P - 2): rank r sets its output chunk
+ * r - 1 - k to its input chunk plus the predecessor's value of that
+ * chunk (the predecessor's input at k = 0, its output after). Rank r
+ * then holds chunk r + 1 complete. Allgather step s (0 .. P - 2)
+ * copies chunk r - s from the predecessor's output.
+ *
+ * Only the successor reads rank r's vectors. It runs at most one step
+ * behind, and the chunk it reads in step k - 1 is never the one rank r
+ * writes in step k, so rank r only waits for it to finish step k - 2.
+ */
+static void ring(cb_allreduce_t *ar, int r, uint32_t e)
+{
+    int p = ar->count;
+    int prev = (r + p - 1) % p, next = (r + 1) % p;
+    const float *in = vec(ar, r, BUF_IN);
+    float *out = vec(ar, r, BUF_OUT);
+    const float *prev_in = vec(ar, prev, BUF_IN);
+    const float *prev_out = vec(ar, prev, BUF_OUT);
+
+    wait_rank(ar, next, e);
+    publish(ar, r, e + 1);
+
+    for (int k = 0; k < 2 * (p - 1); k++) {
+        wait_rank(ar, prev, e + 1 + (uint32_t)k);
+        if (k >= 2) {
+            wait_rank(ar, next, e + (uint32_t)k);
+        }
+
+        if (k < p - 1) {
+            int c = ((r - 1 - k) % p + p) % p;
+            add_range(out, in, k == 0 ? prev_in : prev_out,
+                      chunk_start(ar, c), chunk_start(ar, c + 1));
+        } else {
+            int c = ((r - (k - (p - 1))) % p + p) % p;
+            copy_chunk(ar, out, prev_out, c);
+        }
+
+        publish(ar, r, e + 2 + (uint32_t)k);
+    }
+}
+
+/**
+ * @brief Vector holding stage @p t of recursive doubling for @p rank.
+ *
+ * Stages alternate between the output and scratch vectors so that the
+ * last one (stage @p levels) lands in the output. Stage 0 is the fold
+ * of an extra rank; a rank without one uses its input directly.
+ */
+static float *rd_stage(cb_allreduce_t *ar, int rank, int t, int levels,
+                       bool folded)
+{
+    if (t == 0 && !folded) {
+        return vec(ar, rank, BUF_IN);
+    }
+    return vec(ar, rank, (levels - t) % 2 == 0 ? BUF_OUT : BUF_TMP);
+}
+
+/**
+ * @brief Recursive-doubling allreduce.
+ *
+ * Stage 0: each of the first P - P2 ranks (P2 the largest power of two
+ * not above P) adds the input of extra rank r + P2. Stage t (1 .. L,
+ * L = log2(P2)): ranks r and r ^ 2^(t-1) add each other's stage t - 1
+ * vectors. Stage L + 1: each extra rank copies its partner's output.
+ *
+ * Before overwriting the vector that held stage t - 2, a rank waits for
+ * the stage t - 1 partner that read it.
+ */
+static void recursive_doubling(cb_allreduce_t *ar, int r, uint32_t e)
+{
+    int p = ar->count, p2 = 1, levels = 0;
+    size_t n = ar->length;
+
+    while (p2 * 2 <= p) {
+        p2 *= 2;
+        levels++;
+    }
+    int extras = p - p2;
+    uint32_t done = e + 3 + (uint32_t)levels;
+
+    if (r >= p2) {
+        int partner = r - p2;
+        wait_rank(ar, partner, e);
+        publish(ar, r, e + 1);
+        wait_rank(ar, partner, e + 2 + (uint32_t)levels);
+        memcpy(vec(ar, r, BUF_OUT), vec(ar, partner, BUF_OUT),
+               n * sizeof(float));
+        publish(ar, r, done);
+        return;
+    }
+
+    bool folded = r < extras;
+    for (int j = 0; j < levels; j++) {
+        wait_rank(ar, r ^ (1 << j), e);
+    }
+    if (folded) {
+        wait_rank(ar, r + p2, e);
+    }
+    publish(ar, r, e + 1);
+
+    if (folded) {
+        wait_rank(ar, r + p2, e + 1);
+        add_range(rd_stage(ar, r, 0, levels, true), vec(ar, r, BUF_IN),
+                  vec(ar, r + p2, BUF_IN), 0, n);
+    }
+    publish(ar, r, e + 2);
+
+    for (int t = 1; t <= levels; t++) {
+        int q = r ^ (1 << (t - 1));
+        wait_rank(ar, q, e + 1 + (uint32_t)t);
+        if (t >= 2) {
+            wait_rank(ar, r ^ (1 << (t - 2)), e + 1 + (uint32_t)t);
+        }
+        add_range(rd_stage(ar, r, t, levels, true),
+                  rd_stage(ar, r, t - 1, levels, folded),
+                  rd_stage(ar, q, t - 1, levels, q < extras), 0, n);
+        publish(ar, r, e + 2 + (uint32_t)t);
+    }
+
+    publish(ar, r, done);
+}
+
+/**
+ * @brief Direct reduce-scatter + allgather.
+ *
+ * Every rank reads every other rank's vectors, so a rank enters only
+ * after all peers finished the previous call.
+ */
+static void reduce_scatter_allgather(cb_allreduce_t *ar, int r, uint32_t e)
+{
+    int p = ar->count;
+    float *out = vec(ar, r, BUF_OUT);
+    size_t first = chunk_start(ar, r), end = chunk_start(ar, r + 1);
+
+    for (int q = 0; q < p; q++) {
+        if (q != r) {
+            wait_rank(ar, q, e);
+        }
+    }
+    publish(ar, r, e + 1);
+
+    for (int q = 0; q < p; q++) {
+        if (q != r) {
+            wait_rank(ar, q, e + 1);
+        }
+    }
+    add_range(out, vec(ar, 0, BUF_IN), vec(ar, 1, BUF_IN), first, end);
+    for (int q = 2; q < p; q++) {
+        acc_range(out, vec(ar, q, BUF_IN), first, end);
+    }
+    publish(ar, r, e + 2);
+
+    /* Start after the caller's own chunk so owners are read in turn. */
+    for (int i = 1; i < p; i++) {
+        int q = (r + i) % p;
+        wait_rank(ar, q, e + 2);
+        copy_chunk(ar, out, vec(ar, q, BUF_OUT), q);
+    }
+    publish(ar, r, e + 3);
+}
+
+size_t cb_allreduce_size(int count, size_t length)
+{
+    size_t stride = (length + ALLREDUCE_ALIGN - 1) / ALLREDUCE_ALIGN *
+                    ALLREDUCE_ALIGN;
+    return header_size() + (size_t)count * BUF_COUNT * stride * sizeof(float);
+}
+
+cb_error_t cb_allreduce_init(cb_allreduce_t *ar, int count, size_t length,
+                             cb_wait_policy_t policy, bool process_shared)
+{
+    if (!ar || count < 1 || count > CB_MAX_WORKERS || length < 1 ||
+        policy < 0 || policy >= CB_WAIT_POLICY_COUNT) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(ar, 0, sizeof(*ar));
+
+    ar->count = count;
+    ar->length = length;
+    ar->stride = (length + ALLREDUCE_ALIGN - 1) / ALLREDUCE_ALIGN *
+                 ALLREDUCE_ALIGN;
+    ar->policy = policy;
+    ar->process_shared = process_shared;
+
+    return CB_OK;
+}
+
+float *cb_allreduce_input(cb_allreduce_t *ar, int rank)
+{
+    return vec(ar, rank, BUF_IN);
+}
+
+float *cb_allreduce_output(cb_allreduce_t *ar, int rank)
+{
+    return vec(ar, rank, BUF_OUT);
+}
+
+void cb_allreduce(cb_allreduce_t *ar, cb_allreduce_algo_t algo, int rank)
+{
+    if (ar->count == 1) {
+        memcpy(vec(ar, rank, BUF_OUT), vec(ar, rank, BUF_IN),
+               ar->length * sizeof(float));
+        return;
+    }
+
+    /* Only the owner writes its flag, so this reads back E. */
+    uint32_t e = atomic_load(&ar->slots[rank].step.value);
+
+    switch (algo) {
+    case CB_ALLREDUCE_RING:
+        ring(ar, rank, e);
+        break;
+    case CB_ALLREDUCE_RDOUBLING:
+        recursive_doubling(ar, rank, e);
+        break;
+    case CB_ALLREDUCE_RSAG:
+        reduce_scatter_allgather(ar, rank, e);
+        break;
+    default:
+        break;
+    }
+}
+
+const char *cb_allreduce_algo_name(cb_allreduce_algo_t algo)
+{
+    switch (algo) {
+    case CB_ALLREDUCE_RING:      return "ring";
+    case CB_ALLREDUCE_RDOUBLING: return "rec-doubling";
+    case CB_ALLREDUCE_RSAG:      return "rs-allgather";
+    default:                     break;
+    }
+
+    return "unknown";
+}
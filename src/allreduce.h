@@ -0,0 +1,120 @@
+/**
+ * @file allreduce.h
+ * @brief Shared-memory allreduce of float vectors among processes.
+ *
+ * Every participant (rank) contributes a vector of the same length and
+ * ends up with the element-wise sum in its own output vector. All
+ * input, output and scratch vectors live in one region after the
+ * cb_allreduce_t header, so ranks read each other's vectors directly
+ * instead of copying messages. Three algorithms are provided:
+ *
+ * - Ring: reduce-scatter then allgather around the ring of ranks, in
+ *   2 (P - 1) steps; each step moves one 1/P chunk from a rank to its
+ *   successor, so every rank reads 2 (P - 1) / P of the vector.
+ * - Recursive doubling: log2(P) rounds in which partners r and
+ *   r ^ 2^j add each other's whole vectors. A non-power-of-two count
+ *   first folds the extra ranks into their partners and hands them the
+ *   result at the end.
+ * - Reduce-scatter + allgather: rank r sums chunk r of every input in
+ *   one step, then copies every other chunk from its owner.
+ *
+ * Ranks synchronize through one cb_flag_t per rank that counts the
+ * steps it has completed, cumulatively over calls; a rank waits only
+ * for the peers whose data it reads or whose reads it would overwrite.
+ * Like cb_reduce_t, the region holds no pointers, so it works on the
+ * heap for threads or in a cb_shared_mem_t region for processes.
+ */
+
+#ifndef CB_ALLREDUCE_H
+#define CB_ALLREDUCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "barrier.h"
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Allreduce algorithm selector.
+ */
+typedef enum {
+    CB_ALLREDUCE_RING = 0,       /**< Ring reduce-scatter + allgather. */
+    CB_ALLREDUCE_RDOUBLING,      /**< Recursive doubling. */
+    CB_ALLREDUCE_RSAG,           /**< Direct reduce-scatter + allgather. */
+    CB_ALLREDUCE_ALGO_COUNT      /**< Number of algorithms (not an algorithm). */
+} cb_allreduce_algo_t;
+
+/**
+ * @brief One rank's step counter, padded to its own cache line.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) cb_flag_t step;  /**< Steps completed, cumulative. */
+} cb_allreduce_slot_t;
+
+/**
+ * @brief Allreduce header; the vectors follow it in the same region.
+ */
+typedef struct {
+    int                 count;           /**< Number of ranks. */
+    size_t              length;          /**< Elements per vector. */
+    size_t              stride;          /**< Elements between vectors (padded). */
+    cb_wait_policy_t    policy;          /**< How ranks wait for peers. */
+    bool                process_shared;  /**< True if placed in shared memory. */
+    cb_allreduce_slot_t slots[CB_MAX_WORKERS]; /**< One slot per rank. */
+} cb_allreduce_t;
+
+/**
+ * @brief Bytes of region needed for @p count ranks and @p length elements.
+ *
+ * @param count   Number of ranks.
+ * @param length  Elements per vector.
+ * @return Size of the header plus three padded vectors per rank.
+ */
+size_t cb_allreduce_size(int count, size_t length);
+
+/**
+ * @brief Initialize an allreduce in caller-provided (heap or shared) memory.
+ *
+ * Clears the header only; the vectors are left as they are.
+ *
+ * @param ar              Region of at least cb_allreduce_size() bytes,
+ *                        aligned to CB_CACHE_LINE.
+ * @param count           Number of ranks (1 - CB_MAX_WORKERS).
+ * @param length          Elements per vector (at least 1).
+ * @param policy          Wait policy for peer flags.
+ * @param process_shared  True if ranks are separate processes.
+ * @return CB_OK on success, or CB_ERR_ARGS.
+ */
+cb_error_t cb_allreduce_init(cb_allreduce_t *ar, int count, size_t length,
+                             cb_wait_policy_t policy, bool process_shared);
+
+/** @brief Input vector of @p rank; fill it before calling cb_allreduce(). */
+float *cb_allreduce_input(cb_allreduce_t *ar, int rank);
+
+/** @brief Output vector of @p rank; holds the sum after cb_allreduce(). */
+float *cb_allreduce_output(cb_allreduce_t *ar, int rank);
+
+/**
+ * @brief Run one allreduce as @p rank.
+ *
+ * Every rank must make the same sequence of calls. Back-to-back calls
+ * with the same algorithm need no other synchronization; before
+ * switching algorithms, or before changing an input vector, all ranks
+ * must have returned (e.g. by passing a barrier), because peers may
+ * still read a rank's vectors after it returns.
+ *
+ * @param ar    Initialized allreduce.
+ * @param algo  Algorithm.
+ * @param rank  Caller's rank (0 .. count - 1).
+ */
+void cb_allreduce(cb_allreduce_t *ar, cb_allreduce_algo_t algo, int rank);
+
+/**
+ * @brief Short name of an algorithm, e.g. "ring".
+ * @param algo  Algorithm.
+ * @return Static string, or "unknown".
+ */
+const char *cb_allreduce_algo_name(cb_allreduce_algo_t algo);
+
+#endif /* CB_ALLREDUCE_H */
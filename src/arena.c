@@ -0,0 +1,245 @@
+/**
+ * @file arena.c
+ * @brief Implementation of the per-thread slab arena.
+ *
+ * The remote list is a Treiber stack with many pushers and a single
+ * consumer that always takes the whole list with one exchange, so it
+ * is free of the ABA problem without tagged pointers.
+ */
+
+#include "arena.h"
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "platform.h"
+
+/** @brief Class index marking a block that came from malloc(). */
+#define ARENA_LARGE_CLASS  UINT32_MAX
+
+/** @brief Alignment of chunk allocations (one cache line). */
+#define ARENA_CHUNK_ALIGN  64
+
+/**
+ * @brief Header in front of every block; 16 bytes keeps payloads aligned.
+ */
+typedef struct {
+    cb_arena_t *owner;  /**< Arena the block belongs to. */
+    uint32_t    cls;    /**< Size class, or ARENA_LARGE_CLASS. */
+    uint32_t    pad;    /**< Keeps the header 16 bytes on 32-bit targets. */
+#if UINTPTR_MAX == UINT32_MAX
+    uint32_t    pad2;   /**< Extra padding for 4-byte pointers. */
+#endif
+} block_header_t;
+
+/**
+ * @brief Free block link, stored in the payload of a free block.
+ */
+typedef struct free_block {
+    struct free_block *next;  /**< Next free block. */
+} free_block_t;
+
+/**
+ * @brief Remote free entry, stored in the payload of a remote-freed block.
+ */
+typedef struct remote_block {
+    struct remote_block *next;  /**< Next pushed block. */
+} remote_block_t;
+
+/**
+ * @brief Chunk header; chunks form a list for destruction.
+ */
+typedef struct chunk {
+    struct chunk *next;  /**< Next chunk owned by the arena. */
+} chunk_t;
+
+struct cb_arena {
+    free_block_t  *free_lists[CB_ARENA_NUM_CLASSES]; /**< Per-class free lists. */
+    char          *bump;       /**< Next unused byte of the current chunk. */
+    char          *bump_end;   /**< End of the current chunk. */
+    chunk_t       *chunks;     /**< All chunks, for destruction. */
+    size_t         reserved;   /**< Bytes of chunk memory obtained. */
+    /** Remote frees, on their own cache line to avoid false sharing. */
+    alignas(64) _Atomic(remote_block_t *) remote;
+};
+
+/** @brief Payload bytes of class @p cls. */
+static size_t class_size(uint32_t cls)
+{
+    return (size_t)CB_ARENA_MIN_CLASS << cls;
+}
+
+/** @brief Smallest class that fits @p size, or ARENA_LARGE_CLASS. */
+static uint32_t size_to_class(size_t size)
+{
+    for (uint32_t cls = 0; cls < CB_ARENA_NUM_CLASSES; cls++) {
+        if (size <= class_size(cls)) {
+            return cls;
+        }
+    }
+    return ARENA_LARGE_CLASS;
+}
+
+/** @brief Header of the block whose payload is @p ptr. */
+static block_header_t *header_of(void *ptr)
+{
+    return (block_header_t *)ptr - 1;
+}
+
+/**
+ * @brief Move every remotely freed block onto the local free lists.
+ */
+static void drain_remote(cb_arena_t *arena)
+{
+    remote_block_t *r = atomic_exchange_explicit(&arena->remote, NULL,
+                                                 memory_order_acquire);
+
+    while (r) {
+        remote_block_t *next = r->next;
+        uint32_t cls = header_of(r)->cls;
+        free_block_t *f = (free_block_t *)r;
+
+        f->next = arena->free_lists[cls];
+        arena->free_lists[cls] = f;
+        r = next;
+    }
+}
+
+/**
+ * @brief Carve one block of class @p cls with the bump pointer.
+ */
+static void *bump_alloc(cb_arena_t *arena, uint32_t cls)
+{
+    size_t need = sizeof(block_header_t) + class_size(cls);
+
+    if (!arena->bump || (size_t)(arena->bump_end - arena->bump) < need) {
+        chunk_t *c = cb_aligned_alloc(ARENA_CHUNK_ALIGN, CB_ARENA_CHUNK_SIZE);
+        if (!c) {
+            return NULL;
+        }
+        c->next = arena->chunks;
+        arena->chunks = c;
+        arena->reserved += CB_ARENA_CHUNK_SIZE;
+        /* Skip the chunk link, keeping 16-byte alignment. */
+        arena->bump = (char *)c + 16;
+        arena->bump_end = (char *)c + CB_ARENA_CHUNK_SIZE;
+    }
+
+    block_header_t *h = (block_header_t *)arena->bump;
+    arena->bump += need;
+    h->owner = arena;
+    h->cls = cls;
+    return h + 1;
+}
+
+cb_error_t cb_arena_create(cb_arena_t **out)
+{
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+
+    cb_arena_t *arena = cb_aligned_alloc(64, sizeof(*arena));
+    if (!arena) {
+        *out = NULL;
+        return CB_ERR_ALLOC;
+    }
+
+    for (int i = 0; i < CB_ARENA_NUM_CLASSES; i++) {
+        arena->free_lists[i] = NULL;
+    }
+    arena->bump = NULL;
+    arena->bump_end = NULL;
+    arena->chunks = NULL;
+    arena->reserved = 0;
+    atomic_init(&arena->remote, NULL);
+
+    *out = arena;
+    return CB_OK;
+}
+
+void *cb_arena_alloc(cb_arena_t *arena, size_t size)
+{
+    if (!arena) {
+        return NULL;
+    }
+
+    uint32_t cls = size_to_class(size);
+
+    if (cls == ARENA_LARGE_CLASS) {
+        block_header_t *h = malloc(sizeof(block_header_t) + size);
+        if (!h) {
+            return NULL;
+        }
+        h->owner = arena;
+        h->cls = ARENA_LARGE_CLASS;
+        return h + 1;
+    }
+
+    if (!arena->free_lists[cls] &&
+        atomic_load_explicit(&arena->remote, memory_order_relaxed)) {
+        drain_remote(arena);
+    }
+
+    free_block_t *f = arena->free_lists[cls];
+    if (f) {
+        arena->free_lists[cls] = f->next;
+        return f;
+    }
+
+    return bump_alloc(arena, cls);
+}
+
+void cb_arena_free(cb_arena_t *self, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    block_header_t *h = header_of(ptr);
+
+    if (h->cls == ARENA_LARGE_CLASS) {
+        free(h);
+        return;
+    }
+
+    cb_arena_t *owner = h->owner;
+
+    if (owner == self) {
+        free_block_t *f = (free_block_t *)ptr;
+        f->next = owner->free_lists[h->cls];
+        owner->free_lists[h->cls] = f;
+        return;
+    }
+
+    remote_block_t *r = (remote_block_t *)ptr;
+    remote_block_t *head = atomic_load_explicit(&owner->remote,
+                                                memory_order_relaxed);
+    do {
+        r->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&owner->remote, &head, r,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+size_t cb_arena_reserved(const cb_arena_t *arena)
+{
+    return arena ? arena->reserved : 0;
+}
+
+void cb_arena_destroy(cb_arena_t *arena)
+{
+    if (!arena) {
+        return;
+    }
+
+    chunk_t *c = arena->chunks;
+    while (c) {
+        chunk_t *next = c->next;
+        cb_aligned_free(c);
+        c = next;
+    }
+
+    cb_aligned_free(arena);
+}
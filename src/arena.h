@@ -0,0 +1,83 @@
+/**
+ * @file arena.h
+ * @brief Per-thread slab arena allocator for the alloc workload.
+ *
+ * Each thread owns one arena. Small requests are served from
+ * power-of-two size classes carved out of 64 KiB chunks with a bump
+ * pointer, and freed blocks go onto per-class free lists, so the owner
+ * never takes a lock. A block freed by another thread is pushed onto
+ * the owner's lock-free remote list, which the owner drains the next
+ * time a class runs dry. Requests above the largest class go straight
+ * to malloc().
+ *
+ * Every block carries a 16-byte header naming its owner and class, so
+ * cb_arena_free() needs no size argument. Chunks are returned only
+ * when the arena is destroyed.
+ */
+
+#ifndef CB_ARENA_H
+#define CB_ARENA_H
+
+#include <stddef.h>
+
+#include "error.h"
+
+/** @brief Smallest size class in bytes. */
+#define CB_ARENA_MIN_CLASS   16
+
+/** @brief Number of power-of-two size classes (16 B .. 4 KiB). */
+#define CB_ARENA_NUM_CLASSES 9
+
+/** @brief Bytes per chunk carved into blocks. */
+#define CB_ARENA_CHUNK_SIZE  (64 * 1024)
+
+/** @brief Opaque arena. */
+typedef struct cb_arena cb_arena_t;
+
+/**
+ * @brief Create an empty arena.
+ * @param out  Output: the new arena.
+ * @return CB_OK on success, CB_ERR_ARGS or CB_ERR_ALLOC on failure.
+ */
+cb_error_t cb_arena_create(cb_arena_t **out);
+
+/**
+ * @brief Allocate @p size bytes from an arena.
+ *
+ * Must only be called by the arena's owning thread.
+ *
+ * @param arena  Owning thread's arena.
+ * @param size   Requested size in bytes.
+ * @return 16-byte aligned pointer, or NULL on failure.
+ */
+void *cb_arena_alloc(cb_arena_t *arena, size_t size);
+
+/**
+ * @brief Free a block from any thread.
+ *
+ * A block owned by @p self is freed locally; otherwise it is handed
+ * back to its owner through the owner's remote list.
+ *
+ * @param self  Calling thread's arena.
+ * @param ptr   Block to free, or NULL (no-op).
+ */
+void cb_arena_free(cb_arena_t *self, void *ptr);
+
+/**
+ * @brief Bytes of chunk memory the arena has obtained so far.
+ * @param arena  Arena to query.
+ * @return Reserved bytes (excluding large blocks).
+ */
+size_t cb_arena_reserved(const cb_arena_t *arena);
+
+/**
+ * @brief Destroy an arena and release all of its chunks.
+ *
+ * Every block must already be freed, and no other thread may still
+ * free into it.
+ *
+ * @param arena  Arena to destroy, or NULL (no-op).
+ */
+void cb_arena_destroy(cb_arena_t *arena);
+
+#endif /* CB_ARENA_H */
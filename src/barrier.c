@@ -0,0 +1,230 @@
+/**
+ * @file barrier.c
+ * @brief Implementation of barrier algorithms and flag wait primitives.
+ *
+ * All shared words are C11 atomics with sequentially consistent
+ * ordering. The publish/sleep handshake in cb_flag_publish() and
+ * cb_flag_wait() is a Dekker-style pair: the waiter increments
+ * `waiters` before re-reading `value`, the publisher stores `value`
+ * before reading `waiters`, so at least one side always observes the
+ * other and no wake-up is lost.
+ */
+
+#include "barrier.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Wrap-aware "value has reached target" comparison.
+ */
+static bool reached(uint32_t value, uint32_t target)
+{
+    return (int32_t)(value - target) >= 0;
+}
+
+void cb_flag_wait(cb_flag_t *flag, uint32_t target,
+                  cb_wait_policy_t policy, bool process_shared)
+{
+    int spins = 0;
+
+    while (!reached(atomic_load(&flag->value), target)) {
+        if (policy == CB_WAIT_SPIN ||
+            (policy == CB_WAIT_SPIN_FUTEX && spins < CB_BARRIER_SPIN_LIMIT)) {
+            cb_cpu_relax();
+            spins++;
+            continue;
+        }
+
+        atomic_fetch_add(&flag->waiters, 1);
+        uint32_t seen = atomic_load(&flag->value);
+        if (!reached(seen, target)) {
+            cb_futex_wait((void *)&flag->value, seen, process_shared);
+        }
+        atomic_fetch_sub(&flag->waiters, 1);
+    }
+}
+
+void cb_flag_publish(cb_flag_t *flag, uint32_t value, int wake_count,
+                     bool process_shared)
+{
+    atomic_store(&flag->value, value);
+
+    if (atomic_load(&flag->waiters) != 0) {
+        cb_futex_wake((void *)&flag->value, wake_count, process_shared);
+    }
+}
+
+cb_error_t cb_barrier_init(cb_barrier_t *barrier, cb_barrier_algo_t algo,
+                           cb_wait_policy_t policy, int count,
+                           bool process_shared)
+{
+    if (!barrier || count < 1 || count > CB_MAX_WORKERS ||
+        algo < 0 || algo >= CB_BARRIER_ALGO_COUNT) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(barrier, 0, sizeof(*barrier));
+
+    barrier->algo = algo;
+    barrier->policy = policy;
+    barrier->count = count;
+    barrier->process_shared = process_shared;
+
+    while ((1 << barrier->rounds) < count) {
+        barrier->rounds++;
+    }
+
+    if (algo == CB_BARRIER_NATIVE) {
+        return cb_native_barrier_init(&barrier->native, (unsigned int)count,
+                                      process_shared);
+    }
+
+    return CB_OK;
+}
+
+/**
+ * @brief Centralized barrier: the arrival counter grows by `count` per
+ * episode, so the last arriver is the one that brings it to
+ * episode * count (mod 2^32); no reset is ever required.
+ */
+static void wait_central(cb_barrier_t *b, uint32_t episode)
+{
+    uint32_t target = episode * (uint32_t)b->count;
+    uint32_t arrived = atomic_fetch_add(&b->arrived, 1) + 1;
+
+    if (arrived == target) {
+        cb_flag_publish(&b->release, episode, INT32_MAX, b->process_shared);
+    } else {
+        cb_flag_wait(&b->release, episode, b->policy, b->process_shared);
+    }
+}
+
+/**
+ * @brief Dissemination barrier: in round r, signal (id + 2^r) mod N and
+ * wait for the signal from (id - 2^r) mod N.
+ */
+static void wait_dissemination(cb_barrier_t *b, int id, uint32_t episode)
+{
+    for (int r = 0; r < b->rounds; r++) {
+        int partner = (id + (1 << r)) % b->count;
+
+        cb_flag_publish(&b->slots[partner].dissem[r], episode, 1,
+                        b->process_shared);
+        cb_flag_wait(&b->slots[id].dissem[r], episode, b->policy,
+                     b->process_shared);
+    }
+}
+
+/**
+ * @brief Tournament barrier: in round r, participants whose low r+1 bits
+ * are zero win and wait for id + 2^r; those with bit r set lose, signal
+ * their winner, and drop out to wait for the champion's release.
+ */
+static void wait_tournament(cb_barrier_t *b, int id, uint32_t episode)
+{
+    for (int r = 0; r < b->rounds; r++) {
+        int step = 1 << r;
+
+        if (id & step) {
+            cb_flag_publish(&b->slots[id - step].arrive[r], episode, 1,
+                            b->process_shared);
+            cb_flag_wait(&b->release, episode, b->policy, b->process_shared);
+            return;
+        }
+
+        if (id + step < b->count) {
+            cb_flag_wait(&b->slots[id].arrive[r], episode, b->policy,
+                         b->process_shared);
+        }
+    }
+
+    /* Only participant 0 survives every round. */
+    cb_flag_publish(&b->release, episode, INT32_MAX, b->process_shared);
+}
+
+void cb_barrier_wait(cb_barrier_t *barrier, int id)
+{
+    uint32_t episode = ++barrier->slots[id].episode;
+
+    switch (barrier->algo) {
+    case CB_BARRIER_CENTRAL:
+        wait_central(barrier, episode);
+        break;
+    case CB_BARRIER_DISSEMINATION:
+        wait_dissemination(barrier, id, episode);
+        break;
+    case CB_BARRIER_TOURNAMENT:
+        wait_tournament(barrier, id, episode);
+        break;
+    case CB_BARRIER_NATIVE:
+        cb_native_barrier_wait(&barrier->native);
+        break;
+    default:
+        break;
+    }
+}
+
+void cb_barrier_destroy(cb_barrier_t *barrier)
+{
+    if (barrier && barrier->algo == CB_BARRIER_NATIVE) {
+        cb_native_barrier_destroy(&barrier->native);
+    }
+}
+
+/** @brief Start gate states. */
+enum {
+    GATE_WAIT  = 0, /**< Participants are still being created. */
+    GATE_OPEN  = 1, /**< All participants exist; start. */
+    GATE_ABORT = 2  /**< Creation failed; return immediately. */
+};
+
+void cb_start_gate_init(cb_start_gate_t *gate)
+{
+    atomic_store(&gate->state, GATE_WAIT);
+}
+
+void cb_start_gate_open(cb_start_gate_t *gate)
+{
+    atomic_store(&gate->state, GATE_OPEN);
+}
+
+void cb_start_gate_abort(cb_start_gate_t *gate)
+{
+    atomic_store(&gate->state, GATE_ABORT);
+}
+
+bool cb_start_gate_wait(cb_start_gate_t *gate)
+{
+    int state;
+
+    while ((state = atomic_load(&gate->state)) == GATE_WAIT) {
+        cb_thread_yield();
+    }
+    return state == GATE_OPEN;
+}
+
+const char *cb_barrier_algo_name(cb_barrier_algo_t algo)
+{
+    switch (algo) {
+    case CB_BARRIER_CENTRAL:       return "central";
+    case CB_BARRIER_DISSEMINATION: return "dissemination";
+    case CB_BARRIER_TOURNAMENT:    return "tournament";
+    case CB_BARRIER_NATIVE:        return "pthread";
+    default:                       break;
+    }
+
+    return "unknown";
+}
+
+const char *cb_wait_policy_name(cb_wait_policy_t policy)
+{
+    switch (policy) {
+    case CB_WAIT_SPIN:       return "spin";
+    case CB_WAIT_SPIN_FUTEX: return "spin-futex";
+    case CB_WAIT_BLOCK:      return "block";
+    default:                 break;
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,208 @@
+/**
+ * @file barrier.h
+ * @brief Barrier algorithms and flag wait primitives for concur-bench.
+ *
+ * Implements four barrier algorithms behind one interface:
+ * - Centralized sense-reversing: one shared arrival counter; the last
+ *   arriver releases everyone through a single release flag.
+ * - Dissemination: ceil(log2 N) rounds of pairwise signalling, with no
+ *   single hot spot and no release phase.
+ * - Tournament: a binary arrival tree with statically chosen winners;
+ *   the champion (participant 0) releases everyone through a flag.
+ * - Native: the OS barrier (pthread_barrier_t / SYNCHRONIZATION_BARRIER).
+ *
+ * The hand-rolled algorithms are combined with one of three wait
+ * policies (spin, spin-then-futex, block). All state lives inside a
+ * single position-independent cb_barrier_t (no pointers), so the same
+ * structure works on the heap for threads or in a cb_shared_mem_t
+ * region for processes.
+ *
+ * Flags never need resetting: each participant counts its episodes,
+ * and flags carry the episode number of their most recent signal.
+ * Comparisons are wrap-aware, so counters may overflow safely.
+ *
+ * A start gate holds participants back until all of them exist, and
+ * lets those already running return if creating a later one failed.
+ */
+
+#ifndef CB_BARRIER_H
+#define CB_BARRIER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "error.h"
+#include "platform.h"
+#include "types.h"
+
+/** @brief Assumed cache line size used for padding shared state. */
+#define CB_CACHE_LINE          64
+
+/** @brief Maximum signalling rounds (supports up to 2^16 participants). */
+#define CB_BARRIER_MAX_ROUNDS  16
+
+/** @brief Spin iterations before CB_WAIT_SPIN_FUTEX falls back to sleeping. */
+#define CB_BARRIER_SPIN_LIMIT  4096
+
+/**
+ * @brief How a participant waits for a flag to change.
+ */
+typedef enum {
+    CB_WAIT_SPIN = 0,    /**< Busy-wait with cb_cpu_relax() only. */
+    CB_WAIT_SPIN_FUTEX,  /**< Spin up to CB_BARRIER_SPIN_LIMIT, then sleep. */
+    CB_WAIT_BLOCK,       /**< Sleep in the kernel as soon as the flag is unset. */
+    CB_WAIT_POLICY_COUNT /**< Number of policies (not a policy). */
+} cb_wait_policy_t;
+
+/**
+ * @brief Barrier algorithm selector.
+ */
+typedef enum {
+    CB_BARRIER_CENTRAL = 0,   /**< Centralized sense-reversing counter. */
+    CB_BARRIER_DISSEMINATION, /**< Dissemination (log2 N pairwise rounds). */
+    CB_BARRIER_TOURNAMENT,    /**< Tournament tree with flag broadcast. */
+    CB_BARRIER_NATIVE,        /**< OS-provided barrier; ignores the wait policy. */
+    CB_BARRIER_ALGO_COUNT     /**< Number of algorithms (not an algorithm). */
+} cb_barrier_algo_t;
+
+/**
+ * @brief A 32-bit flag word plus a count of sleeping waiters.
+ *
+ * The waiter count lets the publisher skip the wake system call when
+ * nobody is asleep, which keeps spin-then-futex cheap on the fast path.
+ */
+typedef struct {
+    _Atomic uint32_t value;    /**< Episode number of the latest signal. */
+    _Atomic uint32_t waiters;  /**< Participants currently in cb_futex_wait(). */
+} cb_flag_t;
+
+/**
+ * @brief Per-participant state, padded to its own cache lines.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) uint32_t episode;      /**< Owner-private episode counter. */
+    cb_flag_t dissem[CB_BARRIER_MAX_ROUNDS];      /**< Dissemination: set by round-r partner. */
+    cb_flag_t arrive[CB_BARRIER_MAX_ROUNDS];      /**< Tournament: set by round-r loser. */
+} cb_barrier_slot_t;
+
+/**
+ * @brief Complete barrier state for up to CB_MAX_WORKERS participants.
+ */
+typedef struct {
+    cb_barrier_algo_t algo;            /**< Selected algorithm. */
+    cb_wait_policy_t  policy;          /**< Wait policy for hand-rolled algorithms. */
+    int               count;           /**< Number of participants. */
+    int               rounds;          /**< ceil(log2(count)). */
+    bool              process_shared;  /**< True if placed in shared memory. */
+
+    _Alignas(CB_CACHE_LINE) _Atomic uint32_t arrived; /**< Central: total arrivals. */
+    _Alignas(CB_CACHE_LINE) cb_flag_t release;        /**< Central/tournament release. */
+    _Alignas(CB_CACHE_LINE) cb_native_barrier_t native; /**< Native barrier storage. */
+
+    cb_barrier_slot_t slots[CB_MAX_WORKERS]; /**< One slot per participant. */
+} cb_barrier_t;
+
+/**
+ * @brief One-shot start gate.
+ *
+ * Contains no pointers, so it works in shared memory across processes.
+ */
+typedef struct {
+    _Atomic int state;  /**< Wait, open or aborted. */
+} cb_start_gate_t;
+
+/**
+ * @brief Wait until a flag reaches (or passes) @p target.
+ *
+ * @param flag            Flag to watch.
+ * @param target          Episode number to wait for.
+ * @param policy          Wait policy.
+ * @param process_shared  True if the flag lives in shared memory.
+ */
+void cb_flag_wait(cb_flag_t *flag, uint32_t target,
+                  cb_wait_policy_t policy, bool process_shared);
+
+/**
+ * @brief Publish a new value and wake sleepers if there are any.
+ *
+ * @param flag            Flag to set.
+ * @param value           New value (an episode number).
+ * @param wake_count      Waiters to wake (1, or INT32_MAX for broadcast).
+ * @param process_shared  True if the flag lives in shared memory.
+ */
+void cb_flag_publish(cb_flag_t *flag, uint32_t value, int wake_count,
+                     bool process_shared);
+
+/**
+ * @brief Initialize a barrier in caller-provided (heap or shared) memory.
+ *
+ * @param barrier         Storage of at least sizeof(cb_barrier_t) bytes,
+ *                        aligned to CB_CACHE_LINE.
+ * @param algo            Algorithm.
+ * @param policy          Wait policy (ignored by CB_BARRIER_NATIVE).
+ * @param count           Number of participants (1 - CB_MAX_WORKERS).
+ * @param process_shared  True if participants are separate processes.
+ * @return CB_OK on success, CB_ERR_ARGS for a bad count, or
+ *         CB_ERR_PLATFORM if the native barrier is unavailable.
+ */
+cb_error_t cb_barrier_init(cb_barrier_t *barrier, cb_barrier_algo_t algo,
+                           cb_wait_policy_t policy, int count,
+                           bool process_shared);
+
+/**
+ * @brief Arrive at the barrier and wait for all other participants.
+ *
+ * @param barrier  Initialized barrier.
+ * @param id       Caller's participant index (0 .. count - 1). Each index
+ *                 must be used by exactly one thread or process.
+ */
+void cb_barrier_wait(cb_barrier_t *barrier, int id);
+
+/**
+ * @brief Release resources held by a barrier (native algorithm only).
+ * @param barrier  Barrier to destroy. No participant may be waiting.
+ */
+void cb_barrier_destroy(cb_barrier_t *barrier);
+
+/**
+ * @brief Close a start gate before creating the participants.
+ * @param gate  Gate to reset.
+ */
+void cb_start_gate_init(cb_start_gate_t *gate);
+
+/**
+ * @brief Release every participant waiting at, or yet to reach, the gate.
+ * @param gate  Gate to open.
+ */
+void cb_start_gate_open(cb_start_gate_t *gate);
+
+/**
+ * @brief Tell every participant to return without starting.
+ * @param gate  Gate to abort.
+ */
+void cb_start_gate_abort(cb_start_gate_t *gate);
+
+/**
+ * @brief Yield until the gate is opened or aborted.
+ *
+ * @param gate  Gate to wait at.
+ * @return True if the gate was opened, false if it was aborted.
+ */
+bool cb_start_gate_wait(cb_start_gate_t *gate);
+
+/**
+ * @brief Short lowercase name of an algorithm ("central", ...).
+ * @param algo  Algorithm.
+ * @return Static string. Never NULL.
+ */
+const char *cb_barrier_algo_name(cb_barrier_algo_t algo);
+
+/**
+ * @brief Short lowercase name of a wait policy ("spin", ...).
+ * @param policy  Wait policy.
+ * @return Static string. Never NULL.
+ */
+const char *cb_wait_policy_name(cb_wait_policy_t policy);
+
+#endif /* CB_BARRIER_H */
@@ -0,0 +1,541 @@
+/**
+ * @file bench_access.c
+ * @brief Implementation of the access-pattern workloads.
+ *
+ * Patterns (every one visits each element exactly once, so all rows
+ * must reproduce the sequential sum):
+ * - seq:       contiguous slices, as in the core modes.
+ * - stride-S:  each worker walks its slice S times, at offsets
+ *              0 .. S-1, touching every S-th element per pass.
+ * - blocked:   data[idx[i]], where idx permutes each block of
+ *              CB_ACCESS_BLOCK elements randomly in place; misses stay
+ *              within a cache-sized window.
+ * - gather:    data[idx[i]], where idx is a random permutation of the
+ *              whole array.
+ *
+ * Index arrays come from a keyed Feistel permutation with cycle
+ * walking, so any element of idx can be computed on its own: threads
+ * fill disjoint ranges in parallel, with no shuffle and no merging.
+ * They live in shared memory and are only read once generated.
+ *
+ * Worker counts run in powers of two up to config->num_threads. On
+ * Unix a process row at config->num_processes follows each pattern;
+ * children see the index array through the shared mapping. Runs are
+ * timed like the core modes, worker creation included.
+ *
+ * GB/s counts bytes the pattern requests: 4 per element, plus 4 per
+ * index for blocked and gather. Strided passes may pull whole cache
+ * lines several times, which this deliberately does not count.
+ */
+
+#include "bench_access.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define ACCESS_COLS 9
+
+/** @brief Strides in the default sweep. */
+#define ACCESS_STRIDE_STEPS 5
+
+/** @brief Growth factor between strides. */
+#define ACCESS_STRIDE_FACTOR 4
+
+/** @brief Feistel rounds; four give a good mix for a benchmark. */
+#define ACCESS_FEISTEL_ROUNDS 4
+
+/** @brief Key offsets so the two index arrays differ. */
+#define ACCESS_KEY_BLOCKED 0x6a09e667u
+#define ACCESS_KEY_GATHER  0xbb67ae85u
+
+/** @brief Pattern kinds. */
+typedef enum {
+    PATTERN_SEQ = 0,   /**< Contiguous. */
+    PATTERN_STRIDE,    /**< Constant stride. */
+    PATTERN_BLOCKED,   /**< Random within blocks (index array). */
+    PATTERN_GATHER     /**< Random over the array (index array). */
+} access_pattern_t;
+
+/**
+ * @brief Work description shared by all workers of one run.
+ */
+typedef struct {
+    const int        *dataset;  /**< Input array. */
+    const int        *index;    /**< Index array (blocked, gather). */
+    access_pattern_t  pattern;  /**< Pattern kind. */
+    int               stride;   /**< Stride for PATTERN_STRIDE. */
+} access_work_t;
+
+/**
+ * @brief Per-worker argument.
+ */
+typedef struct {
+    const access_work_t *work;     /**< Shared work description. */
+    int                  start;    /**< First element of the slice. */
+    int                  length;   /**< Elements in the slice. */
+    long int            *partial;  /**< Where to store the slice sum. */
+} access_arg_t;
+
+/**
+ * @brief Argument of one index-generation thread.
+ */
+typedef struct {
+    int          *index;   /**< Output array. */
+    int           n;       /**< Array length. */
+    int           start;   /**< First entry to fill. */
+    int           end;     /**< One past the last entry. */
+    int           block;   /**< Permutation block (n for a full gather). */
+    uint32_t      key;     /**< Permutation key. */
+} index_arg_t;
+
+/* ---- Index generation ---- */
+
+/** @brief 32-bit finalizer from MurmurHash3. */
+static uint32_t mix32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Map @p i to a unique value in [0, @p range).
+ *
+ * A balanced Feistel network on 2 * half bits is a bijection on
+ * [0, 4^half); values outside the range are fed through again (cycle
+ * walking), which keeps the mapping a bijection on [0, range). Since
+ * 4^half < 4 * range, the expected number of walks is below four.
+ */
+static uint32_t permute(uint32_t i, uint32_t range, uint32_t key)
+{
+    int half = 1;
+    while (((uint64_t)1 << (2 * half)) < range) {
+        half++;
+    }
+    uint32_t mask = (1u << half) - 1;
+
+    do {
+        uint32_t l = i >> half, r = i & mask;
+        for (int round = 0; round < ACCESS_FEISTEL_ROUNDS; round++) {
+            uint32_t f = mix32(r ^ key ^ (uint32_t)round * 0x9e3779b9u) & mask;
+            uint32_t next = l ^ f;
+            l = r;
+            r = next;
+        }
+        i = (l << half) | r;
+    } while (i >= range);
+
+    return i;
+}
+
+/** @brief Thread body: fill index[start .. end). */
+static void *index_thread_fn(void *arg)
+{
+    index_arg_t *a = (index_arg_t *)arg;
+
+    for (int i = a->start; i < a->end; i++) {
+        int base = i - i % a->block;
+        int size = a->n - base < a->block ? a->n - base : a->block;
+        a->index[i] = base + (int)permute((uint32_t)(i - base),
+                                          (uint32_t)size, a->key);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Fill @p index with @p threads threads.
+ *
+ * @param block  Entries are permuted within consecutive blocks of
+ *               this size (the last may be shorter).
+ */
+static cb_error_t build_index(int *index, int n, int block, uint32_t key,
+                              int threads)
+{
+    cb_error_t err = CB_OK;
+    cb_thread_t handles[CB_MAX_WORKERS];
+    index_arg_t args[CB_MAX_WORKERS];
+    int created = 0;
+
+    for (int t = 0; t < threads; t++) {
+        args[t].index = index;
+        args[t].n = n;
+        args[t].start = (int)((long long)n * t / threads);
+        args[t].end = (int)((long long)n * (t + 1) / threads);
+        args[t].block = block;
+        args[t].key = key;
+        err = cb_thread_create(&handles[t], index_thread_fn, &args[t]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    for (int t = 0; t < created; t++) {
+        cb_error_t join_err = cb_thread_join(&handles[t]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+    return err;
+}
+
+/* ---- Pattern kernels ---- */
+
+/** @brief Sum one slice in the order given by @p w. */
+static long int access_sum(const access_work_t *w, int start, int length)
+{
+    const int *data = w->dataset;
+    long int sum = 0;
+    int end = start + length;
+
+    switch (w->pattern) {
+    case PATTERN_STRIDE:
+        for (int off = 0; off < w->stride && off < length; off++) {
+            /* long long: i += stride must not overflow near INT_MAX. */
+            for (long long i = start + off; i < end; i += w->stride) {
+                sum += data[i];
+            }
+        }
+        break;
+    case PATTERN_BLOCKED:
+    case PATTERN_GATHER:
+        for (int i = start; i < end; i++) {
+            sum += data[w->index[i]];
+        }
+        break;
+    default:
+        for (int i = start; i < end; i++) {
+            sum += data[i];
+        }
+        break;
+    }
+    return sum;
+}
+
+/** @brief Thread entry point. */
+static void *access_thread_fn(void *arg)
+{
+    access_arg_t *a = (access_arg_t *)arg;
+    *a->partial = access_sum(a->work, a->start, a->length);
+    return NULL;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child entry point; the partial lands in shared memory. */
+static void access_child_fn(void *arg)
+{
+    access_arg_t *a = (access_arg_t *)arg;
+    *a->partial = access_sum(a->work, a->start, a->length);
+    _Exit(EXIT_SUCCESS);
+}
+#endif
+
+/**
+ * @brief Run the pattern once on @p workers threads or processes.
+ *
+ * @param partials  One slot per worker; shared memory for processes.
+ */
+static cb_error_t run_once(const access_work_t *work, int n, int workers,
+                           bool process, long int *partials,
+                           access_arg_t *args, cb_thread_t *threads,
+                           cb_process_t *procs, long int *sum_out)
+{
+    cb_error_t err = CB_OK;
+    int started = 0;
+    int base_len = n / workers, remainder = n % workers, offset = 0;
+
+#ifndef CB_PLATFORM_UNIX
+    (void)procs;
+#endif
+
+    for (int i = 0; i < workers; i++) {
+        args[i].work = work;
+        args[i].start = offset;
+        args[i].length = base_len + (i < remainder ? 1 : 0);
+        args[i].partial = &partials[i];
+        offset += args[i].length;
+
+#ifdef CB_PLATFORM_UNIX
+        if (process) {
+            err = cb_process_spawn(&procs[i], NULL, access_child_fn, &args[i]);
+        } else
+#endif
+        {
+            err = cb_thread_create(&threads[i], access_thread_fn, &args[i]);
+        }
+        if (err) {
+            break;
+        }
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        cb_error_t join_err;
+#ifdef CB_PLATFORM_UNIX
+        if (process) {
+            int status = 0;
+            join_err = cb_process_wait(&procs[i], &status);
+            if (!join_err && status != 0) {
+                join_err = CB_ERR_FORK;
+            }
+        } else
+#endif
+        {
+            join_err = cb_thread_join(&threads[i]);
+        }
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    long int sum = 0;
+    for (int i = 0; i < started; i++) {
+        sum += partials[i];
+    }
+    *sum_out = sum;
+    return err;
+}
+
+/** @brief Append one row. */
+static cb_error_t add_row(cb_table_t *table, const char *pattern,
+                          const char *mode, int workers,
+                          const cb_bench_stats_t *stats, double elems,
+                          double bytes, double base_sec, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = stats->mean_sec;
+    cb_table_set(table, 0, "%s", pattern);
+    cb_table_set(table, 1, "%s", mode);
+    cb_table_set(table, 2, "%d", workers);
+    cb_table_set(table, 3, "%.6f", mean);
+    cb_table_set(table, 4, "%.6f", stats->stddev_sec);
+    cb_table_set(table, 5, "%.1f", mean > 0.0 ? elems / mean / 1e6 : 0.0);
+    cb_table_set(table, 6, "%.2f", mean > 0.0 ? bytes / mean / 1e9 : 0.0);
+    cb_table_set(table, 7, "%.2fx",
+                 (base_sec > 0.0 && mean > 0.0) ? base_sec / mean : 1.0);
+    cb_table_set(table, 8, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_access_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out)
+{
+    static const char *const headers[ACCESS_COLS] = {
+        "Pattern", "Mode", "Workers", "Mean (s)", "Stddev (s)", "Melem/s",
+        "GB/s", "Scaling", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    double *times = NULL;
+    long int *partials = NULL;
+    access_arg_t *args = NULL;
+    cb_thread_t *threads = NULL;
+    cb_process_t *procs = NULL;
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    int p = config->num_processes;
+    int most = m > p ? m : p;
+
+    err = cb_table_create(&table, "access", "Access Patterns: Stride, "
+                          "Blocked-Random, Gather", headers, ACCESS_COLS);
+    if (err) {
+        return err;
+    }
+
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    args    = calloc((size_t)most, sizeof(access_arg_t));
+    threads = calloc((size_t)m, sizeof(cb_thread_t));
+    procs   = calloc((size_t)p, sizeof(cb_process_t));
+    if (!times || !args || !threads || !procs) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* Layout: partial sums, then the two index arrays. */
+    size_t partial_bytes = (size_t)CB_MAX_WORKERS * sizeof(long int);
+    size_t index_bytes = (size_t)n * sizeof(int);
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_access_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name,
+                               partial_bytes + 2 * index_bytes);
+    if (err) {
+        goto cleanup;
+    }
+    shm_created = true;
+
+    char *base = cb_shared_mem_ptr(&shm);
+    partials = (long int *)base;
+    int *blocked_index = (int *)(base + partial_bytes);
+    int *gather_index = (int *)(base + partial_bytes + index_bytes);
+
+    double t_index = cb_time_now();
+    err = build_index(blocked_index, n, CB_ACCESS_BLOCK,
+                      config->seed ^ ACCESS_KEY_BLOCKED, m);
+    if (!err) {
+        err = build_index(gather_index, n, n,
+                          config->seed ^ ACCESS_KEY_GATHER, m);
+    }
+    if (err) {
+        goto cleanup;
+    }
+    t_index = cb_time_now() - t_index;
+
+    long int expected = 0;
+    for (int i = 0; i < n; i++) {
+        expected += dataset[i];
+    }
+
+    /* Pattern list: seq, the strides, blocked, gather. */
+    int strides[ACCESS_STRIDE_STEPS];
+    int nstrides = 0;
+    if (config->access_stride > 0) {
+        strides[nstrides++] = config->access_stride;
+    } else {
+        for (int s = ACCESS_STRIDE_FACTOR; nstrides < ACCESS_STRIDE_STEPS;
+             s *= ACCESS_STRIDE_FACTOR) {
+            strides[nstrides++] = s;
+        }
+    }
+    int npatterns = 3 + nstrides;
+
+    for (int pi = 0; pi < npatterns; pi++) {
+        access_work_t work;
+        char name[32];
+        double bytes_per_elem = sizeof(int);
+
+        memset(&work, 0, sizeof(work));
+        work.dataset = dataset;
+        if (pi == 0) {
+            work.pattern = PATTERN_SEQ;
+            snprintf(name, sizeof(name), "seq");
+        } else if (pi <= nstrides) {
+            work.pattern = PATTERN_STRIDE;
+            work.stride = strides[pi - 1];
+            snprintf(name, sizeof(name), "stride-%d", work.stride);
+        } else if (pi == nstrides + 1) {
+            work.pattern = PATTERN_BLOCKED;
+            work.index = blocked_index;
+            bytes_per_elem += sizeof(int);
+            snprintf(name, sizeof(name), "blocked");
+        } else {
+            work.pattern = PATTERN_GATHER;
+            work.index = gather_index;
+            bytes_per_elem += sizeof(int);
+            snprintf(name, sizeof(name), "gather");
+        }
+
+        double base_sec = 0.0;
+        int last_workers = 0;
+
+        /* Threads at 1, 2, 4, ..., m; then processes at p (Unix). */
+        for (int workers = 1; ;) {
+            bool process = last_workers == m;
+            if (process) {
+#ifdef CB_PLATFORM_UNIX
+                workers = p;
+#else
+                break;
+#endif
+            }
+
+            bool all_ok = true;
+            for (int iter = 0; iter < config->iterations; iter++) {
+                long int sum = 0;
+                double t_start = cb_time_now();
+                err = run_once(&work, n, workers, process, partials, args,
+                               threads, procs, &sum);
+                times[iter] = cb_time_now() - t_start;
+                if (err) {
+                    goto cleanup;
+                }
+                if (sum != expected) {
+                    all_ok = false;
+                }
+                if (config->verbose) {
+                    fprintf(stdout, "  access %s %s %d iteration %d/%d: "
+                            "%.6fs\n", name, process ? "process" : "thread",
+                            workers, iter + 1, config->iterations,
+                            times[iter]);
+                }
+            }
+
+            cb_bench_stats_t stats;
+            err = cb_stats_compute(times, config->iterations, &stats);
+            if (!err) {
+                if (base_sec == 0.0) {
+                    base_sec = stats.mean_sec;
+                }
+                err = add_row(table, name, process ? "process" : "thread",
+                              workers, &stats, (double)n,
+                              (double)n * bytes_per_elem, base_sec,
+                              all_ok ? "PASS" : "FAIL");
+            }
+            if (err) {
+                goto cleanup;
+            }
+
+            if (process) {
+                break;
+            }
+            last_workers = workers;
+            if (workers < m) {
+                workers = workers * 2 > m ? m : workers * 2;
+            }
+        }
+    }
+
+    cb_table_add_note(table, "blocked permutes within %d-element (%d KiB) "
+                      "blocks; gather permutes the whole array.",
+                      CB_ACCESS_BLOCK,
+                      (int)(CB_ACCESS_BLOCK * sizeof(int) / 1024));
+    cb_table_add_note(table, "Index arrays (%.1f MiB each) built by %d "
+                      "thread%s in %.3f s, shared read-only with all "
+                      "workers.", (double)index_bytes / (1024.0 * 1024.0),
+                      m, m == 1 ? "" : "s", t_index);
+    cb_table_add_note(table, "GB/s counts requested bytes (data plus index), "
+                      "not cache-line traffic; Scaling is vs 1 thread.");
+#ifndef CB_PLATFORM_UNIX
+    cb_table_add_note(table, "Process rows require fork() and are not "
+                      "available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+    free(times);
+    free(args);
+    free(threads);
+    free(procs);
+    cb_table_destroy(table);
+    return err;
+}
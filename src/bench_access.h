@@ -0,0 +1,35 @@
+/**
+ * @file bench_access.h
+ * @brief Access-pattern workloads: strided, blocked-random and gather.
+ *
+ * The core modes walk contiguous slices, which is the best case for
+ * caches and hardware prefetchers. This suite sums the same dataset
+ * in other orders: a constant stride (swept), a random permutation
+ * inside cache-sized blocks, and a full random gather. The random
+ * orders are read through an index array that is generated in
+ * parallel and shared read-only by every worker, thread or process.
+ * Each pattern is timed at increasing worker counts and reported in
+ * elements/s and effective bandwidth.
+ */
+
+#ifndef CB_BENCH_ACCESS_H
+#define CB_BENCH_ACCESS_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the access-pattern suite and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, num_processes, iterations, seed,
+ *                   access_stride, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_FORK, CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_access_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out);
+
+#endif /* CB_BENCH_ACCESS_H */
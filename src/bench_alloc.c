@@ -0,0 +1,674 @@
+/**
+ * @file bench_alloc.c
+ * @brief Implementation of the allocator contention workload.
+ *
+ * Threads start together through a gate, run their operations, and
+ * meet at a barrier. Participant 0 then stamps the end time and samples
+ * RSS while every thread still holds its live window. A second barrier
+ * keeps teardown frees out of that sample. Operations count both
+ * allocations and frees.
+ */
+
+#include "bench_alloc.h"
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "barrier.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Slots in each producer-consumer ring (power of two). */
+#define ALLOC_RING_SIZE  1024
+
+/** @brief Bytes per MiB, for reporting. */
+#define ALLOC_MIB        (1024.0 * 1024.0)
+
+/** @brief Allocators under test, in table order. */
+typedef enum {
+    ALLOCATOR_MALLOC = 0, /**< malloc()/free() as linked or preloaded. */
+    ALLOCATOR_ARENA,      /**< Built-in per-thread slab arena. */
+    ALLOCATOR_COUNT
+} allocator_t;
+
+/** @brief Table labels for allocator_t. */
+static const char *const ALLOCATOR_NAMES[ALLOCATOR_COUNT] = {
+    "malloc", "arena"
+};
+
+/** @brief Request size distributions. */
+typedef enum {
+    SIZES_SMALL = 0, /**< Uniform 16 - 256 bytes. */
+    SIZES_MIXED      /**< Log-uniform 16 B - 16 KiB. */
+} size_dist_t;
+
+/**
+ * @brief An allocation pattern.
+ */
+typedef struct {
+    const char  *name;          /**< Pattern name (table and CLI). */
+    size_dist_t  sizes;         /**< Request size distribution. */
+    int          window;        /**< Live objects per thread (0 = ring). */
+    bool         cross_thread;  /**< Producer allocates, consumer frees. */
+} alloc_pattern_t;
+
+/** @brief All patterns, in table order. */
+static const alloc_pattern_t PATTERNS[] = {
+    { "short-small", SIZES_SMALL, 16,    false },
+    { "long-small",  SIZES_SMALL, 16384, false },
+    { "long-mixed",  SIZES_MIXED, 4096,  false },
+    { "prod-cons",   SIZES_SMALL, 0,     true  }
+};
+
+/** @brief Number of entries in PATTERNS. */
+#define NUM_PATTERNS ((int)(sizeof(PATTERNS) / sizeof(PATTERNS[0])))
+
+/**
+ * @brief Single-producer single-consumer pointer ring.
+ */
+typedef struct {
+    alignas(64) _Atomic uint32_t head;  /**< Next slot to consume. */
+    alignas(64) _Atomic uint32_t tail;  /**< Next slot to fill. */
+    void *items[ALLOC_RING_SIZE];       /**< Pointers in flight. */
+} alloc_ring_t;
+
+typedef struct alloc_run alloc_run_t;
+
+/**
+ * @brief Per-thread state.
+ */
+typedef struct {
+    alloc_run_t *run;         /**< Shared run state. */
+    int          id;          /**< Thread index. */
+    cb_arena_t  *arena;       /**< Thread's arena (arena allocator only). */
+    void       **slots;       /**< Live window (window patterns only). */
+    size_t      *slot_sizes;  /**< Requested size of each live slot. */
+    size_t       live_bytes;  /**< Requested bytes currently live. */
+    uint32_t     rng;         /**< xorshift32 state. */
+} alloc_worker_t;
+
+/**
+ * @brief State shared by all threads of one measurement.
+ */
+struct alloc_run {
+    const alloc_pattern_t *pattern;     /**< Pattern under test. */
+    allocator_t            allocator;   /**< Allocator under test. */
+    int                    threads;     /**< Participating threads. */
+    long                   ops;         /**< Operations per thread. */
+    alloc_worker_t        *workers;     /**< Per-thread state. */
+    alloc_ring_t          *rings;       /**< One ring per producer/consumer pair. */
+    cb_barrier_t          *barrier;     /**< Phase barrier. */
+    cb_start_gate_t        gate;        /**< Start gate. */
+    _Atomic int            failed;      /**< Nonzero if an allocation failed. */
+    double                 t_go;        /**< Time the gate opened. */
+    double                 t_done;      /**< Time all threads finished. */
+    size_t                 rss_base;    /**< RSS before the first iteration. */
+    size_t                 peak_growth; /**< Largest RSS growth at a sample. */
+    size_t                 peak_live;   /**< Largest live bytes at a sample. */
+    bool                   rss_ok;      /**< RSS is available on this platform. */
+};
+
+/**
+ * @brief Outcome of one measurement.
+ *
+ * Contains no pointers so it can be written by a child process into
+ * shared memory.
+ */
+typedef struct {
+    cb_error_t err;          /**< Error from the measurement. */
+    int        threads;      /**< Threads used (0 = not applicable). */
+    bool       rss_ok;       /**< RSS figures are valid. */
+    double     peak_growth;  /**< RSS growth at peak, bytes. */
+    double     peak_live;    /**< Requested bytes live at peak. */
+    double     retained;     /**< RSS growth after everything was freed. */
+    double     ops;          /**< Operations per iteration, all threads. */
+    double     times[];      /**< Per-iteration elapsed times. */
+} alloc_result_t;
+
+/** @brief Advance a worker's xorshift32 generator. */
+static uint32_t next_rand(alloc_worker_t *w)
+{
+    uint32_t x = w->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    w->rng = x;
+    return x;
+}
+
+/** @brief Draw a request size from the pattern's distribution. */
+static size_t draw_size(alloc_worker_t *w)
+{
+    uint32_t r = next_rand(w);
+
+    if (w->run->pattern->sizes == SIZES_SMALL) {
+        return 16 + r % 241;
+    }
+
+    /* Pick a power-of-two bucket 16 .. 8192, then a size within it. */
+    size_t base = (size_t)16 << ((r >> 24) % 10);
+    return base + (r & 0xFFFFFF) % base;
+}
+
+/** @brief Allocate and touch @p size bytes with the allocator under test. */
+static void *do_alloc(alloc_worker_t *w, size_t size)
+{
+    void *p = (w->run->allocator == ALLOCATOR_ARENA)
+              ? cb_arena_alloc(w->arena, size)
+              : malloc(size);
+
+    if (!p) {
+        atomic_store(&w->run->failed, 1);
+        return NULL;
+    }
+
+    /* Touch both ends so the pages count toward RSS. */
+    ((volatile char *)p)[0] = 1;
+    ((volatile char *)p)[size - 1] = 1;
+    return p;
+}
+
+/** @brief Free with the allocator under test. */
+static void do_free(alloc_worker_t *w, void *p)
+{
+    if (w->run->allocator == ALLOCATOR_ARENA) {
+        cb_arena_free(w->arena, p);
+    } else {
+        free(p);
+    }
+}
+
+/** @brief Window patterns: replace random slots until ops are spent. */
+static void run_window(alloc_worker_t *w)
+{
+    int window = w->run->pattern->window;
+    long ops = 0;
+
+    while (ops < w->run->ops) {
+        int idx = (int)(next_rand(w) % (uint32_t)window);
+
+        if (w->slots[idx]) {
+            do_free(w, w->slots[idx]);
+            w->live_bytes -= w->slot_sizes[idx];
+            w->slots[idx] = NULL;
+            ops++;
+        }
+
+        size_t size = draw_size(w);
+        w->slots[idx] = do_alloc(w, size);
+        if (w->slots[idx]) {
+            w->slot_sizes[idx] = size;
+            w->live_bytes += size;
+        }
+        ops++;
+    }
+}
+
+/** @brief Producer side of prod-cons: allocate and hand off. */
+static void run_producer(alloc_worker_t *w, alloc_ring_t *ring)
+{
+    for (long i = 0; i < w->run->ops; i++) {
+        void *p = do_alloc(w, draw_size(w));
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+        while (tail - atomic_load_explicit(&ring->head, memory_order_acquire)
+               == ALLOC_RING_SIZE) {
+            cb_thread_yield();
+        }
+        ring->items[tail % ALLOC_RING_SIZE] = p;
+        atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    }
+}
+
+/** @brief Consumer side of prod-cons: receive and free. */
+static void run_consumer(alloc_worker_t *w, alloc_ring_t *ring)
+{
+    for (long i = 0; i < w->run->ops; i++) {
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+        while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head) {
+            cb_thread_yield();
+        }
+        void *p = ring->items[head % ALLOC_RING_SIZE];
+        atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+        do_free(w, p);
+    }
+}
+
+/** @brief Thread entry point for one participant. */
+static void *alloc_thread_fn(void *arg)
+{
+    alloc_worker_t *w = (alloc_worker_t *)arg;
+    alloc_run_t *run = w->run;
+
+    if (!cb_start_gate_wait(&run->gate)) {
+        return NULL;
+    }
+
+    if (run->pattern->cross_thread) {
+        alloc_ring_t *ring = &run->rings[w->id / 2];
+        if (w->id % 2 == 0) {
+            run_producer(w, ring);
+        } else {
+            run_consumer(w, ring);
+        }
+    } else {
+        run_window(w);
+    }
+
+    cb_barrier_wait(run->barrier, w->id);
+
+    if (w->id == 0) {
+        run->t_done = cb_time_now();
+
+        size_t rss = 0, live = 0;
+        for (int i = 0; i < run->threads; i++) {
+            live += run->workers[i].live_bytes;
+        }
+        if (live > run->peak_live) {
+            run->peak_live = live;
+        }
+        if (run->rss_ok && cb_process_rss(&rss) == CB_OK) {
+            size_t growth = (rss > run->rss_base) ? rss - run->rss_base : 0;
+            if (growth > run->peak_growth) {
+                run->peak_growth = growth;
+            }
+        }
+    }
+
+    cb_barrier_wait(run->barrier, w->id);
+
+    if (!run->pattern->cross_thread) {
+        for (int i = 0; i < run->pattern->window; i++) {
+            if (w->slots[i]) {
+                do_free(w, w->slots[i]);
+                w->slots[i] = NULL;
+            }
+        }
+        w->live_bytes = 0;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Run one iteration: create threads, open the gate, join.
+ */
+static cb_error_t run_iteration(alloc_run_t *run, cb_thread_t *threads)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    cb_start_gate_init(&run->gate);
+
+    for (int i = 0; i < run->threads; i++) {
+        err = cb_thread_create(&threads[i], alloc_thread_fn, &run->workers[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    run->t_go = cb_time_now();
+    if (err) {
+        cb_start_gate_abort(&run->gate);
+    } else {
+        cb_start_gate_open(&run->gate);
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    if (!err && atomic_load(&run->failed)) {
+        err = CB_ERR_ALLOC;
+    }
+
+    return err;
+}
+
+/**
+ * @brief Measure one allocator on one pattern, in the calling process.
+ *
+ * @param config     Benchmark configuration.
+ * @param allocator  Allocator under test.
+ * @param pattern    Pattern under test.
+ * @param result     Output; has room for config->iterations times.
+ */
+static void measure(const cb_config_t *config, allocator_t allocator,
+                    const alloc_pattern_t *pattern, alloc_result_t *result)
+{
+    cb_error_t err = CB_OK;
+    alloc_run_t run;
+    cb_thread_t *threads = NULL;
+    int threads_used = config->num_threads;
+
+    memset(&run, 0, sizeof(run));
+
+    if (pattern->cross_thread) {
+        threads_used = (threads_used / 2) * 2;
+    }
+    result->threads = threads_used;
+    if (threads_used == 0) {
+        result->err = CB_OK;
+        return;
+    }
+
+    run.pattern = pattern;
+    run.allocator = allocator;
+    run.threads = threads_used;
+    run.ops = config->alloc_ops;
+
+    threads      = calloc((size_t)threads_used, sizeof(cb_thread_t));
+    run.workers  = calloc((size_t)threads_used, sizeof(alloc_worker_t));
+    run.barrier  = cb_aligned_alloc(CB_CACHE_LINE, sizeof(cb_barrier_t));
+    if (pattern->cross_thread) {
+        run.rings = cb_aligned_alloc(CB_CACHE_LINE, (size_t)(threads_used / 2) *
+                                     sizeof(alloc_ring_t));
+    }
+    if (!threads || !run.workers || !run.barrier ||
+        (pattern->cross_thread && !run.rings)) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    for (int i = 0; pattern->cross_thread && i < threads_used / 2; i++) {
+        atomic_init(&run.rings[i].head, 0);
+        atomic_init(&run.rings[i].tail, 0);
+    }
+
+    for (int i = 0; i < threads_used; i++) {
+        alloc_worker_t *w = &run.workers[i];
+        w->run = &run;
+        w->id = i;
+        w->rng = 0x9E3779B9u * (uint32_t)(i + 1);
+        if (pattern->window > 0) {
+            w->slots = calloc((size_t)pattern->window, sizeof(void *));
+            w->slot_sizes = calloc((size_t)pattern->window, sizeof(size_t));
+            if (!w->slots || !w->slot_sizes) {
+                err = CB_ERR_ALLOC;
+                goto cleanup;
+            }
+            /* Fault the bookkeeping in now so it is not counted as growth. */
+            memset(w->slots, 0, (size_t)pattern->window * sizeof(void *));
+            memset(w->slot_sizes, 0, (size_t)pattern->window * sizeof(size_t));
+        }
+        if (allocator == ALLOCATOR_ARENA) {
+            err = cb_arena_create(&w->arena);
+            if (err) {
+                goto cleanup;
+            }
+        }
+    }
+
+    err = cb_barrier_init(run.barrier, CB_BARRIER_CENTRAL, CB_WAIT_SPIN_FUTEX,
+                          threads_used, false);
+    if (err) {
+        goto cleanup;
+    }
+
+    run.rss_ok = (cb_process_rss(&run.rss_base) == CB_OK);
+
+    for (int iter = 0; iter < config->iterations && !err; iter++) {
+        err = run_iteration(&run, threads);
+        result->times[iter] = run.t_done - run.t_go;
+    }
+
+    cb_barrier_destroy(run.barrier);
+
+    size_t rss_end = 0;
+    if (run.rss_ok && cb_process_rss(&rss_end) != CB_OK) {
+        run.rss_ok = false;
+    }
+
+    result->rss_ok = run.rss_ok;
+    result->peak_growth = (double)run.peak_growth;
+    result->peak_live = (double)run.peak_live;
+    result->retained = (rss_end > run.rss_base) ? (double)(rss_end - run.rss_base) : 0.0;
+    result->ops = (double)config->alloc_ops * threads_used;
+
+cleanup:
+    for (int i = 0; run.workers && i < threads_used; i++) {
+        free(run.workers[i].slots);
+        free(run.workers[i].slot_sizes);
+        cb_arena_destroy(run.workers[i].arena);
+    }
+    free(threads);
+    free(run.workers);
+    cb_aligned_free(run.barrier);
+    cb_aligned_free(run.rings);
+    result->err = err;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/**
+ * @brief Arguments for a measurement run in a child process.
+ */
+typedef struct {
+    const cb_config_t     *config;     /**< Benchmark configuration. */
+    allocator_t            allocator;  /**< Allocator under test. */
+    const alloc_pattern_t *pattern;    /**< Pattern under test. */
+    alloc_result_t        *result;     /**< Result in shared memory. */
+} alloc_child_t;
+
+/** @brief Child process entry point: measure, then exit. */
+static void alloc_child_fn(void *arg)
+{
+    alloc_child_t *c = (alloc_child_t *)arg;
+    measure(c->config, c->allocator, c->pattern, c->result);
+    _Exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Measure in a freshly forked child for clean RSS figures.
+ */
+static cb_error_t measure_isolated(const cb_config_t *config,
+                                   allocator_t allocator,
+                                   const alloc_pattern_t *pattern,
+                                   alloc_result_t *result, size_t result_size)
+{
+    cb_error_t err = CB_OK;
+    cb_shared_mem_t shm;
+    cb_process_t proc;
+    char shm_name[64];
+    int status = 0;
+
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_alloc_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name, result_size);
+    if (err) {
+        return err;
+    }
+
+    alloc_result_t *shared = cb_shared_mem_ptr(&shm);
+    memset(shared, 0, result_size);
+    shared->err = CB_ERR_FORK; /* Overwritten if the child completes. */
+
+    alloc_child_t child = { config, allocator, pattern, shared };
+    err = cb_process_spawn(&proc, NULL, alloc_child_fn, &child);
+    if (!err) {
+        err = cb_process_wait(&proc, &status);
+    }
+    if (!err) {
+        memcpy(result, shared, result_size);
+    }
+
+    cb_shared_mem_destroy(&shm);
+    return err;
+}
+#endif
+
+bool cb_bench_alloc_pattern_valid(const char *name)
+{
+    for (int p = 0; name && p < NUM_PATTERNS; p++) {
+        if (strcmp(PATTERNS[p].name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Append one measurement's table row.
+ */
+static cb_error_t add_row(cb_table_t *table, allocator_t allocator,
+                          const alloc_pattern_t *pattern,
+                          const alloc_result_t *result, int iterations)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    cb_table_set(table, 0, "%s", ALLOCATOR_NAMES[allocator]);
+    cb_table_set(table, 1, "%s", pattern->name);
+
+    if (result->threads == 0) {
+        cb_table_set(table, 2, "0");
+        for (int c = 3; c < 10; c++) {
+            cb_table_set(table, c, "n/a");
+        }
+        return CB_OK;
+    }
+
+    cb_bench_stats_t stats;
+    err = cb_stats_compute(result->times, iterations, &stats);
+    if (err) {
+        return err;
+    }
+
+    cb_table_set(table, 2, "%d", result->threads);
+    cb_table_set(table, 3, "%.6f", stats.mean_sec);
+    cb_table_set(table, 4, "%.6f", stats.stddev_sec);
+    cb_table_set(table, 5, "%.2f", stats.mean_sec > 0.0
+                 ? result->ops / stats.mean_sec / 1e6 : 0.0);
+    cb_table_set(table, 6, "%.2f", result->peak_live / ALLOC_MIB);
+
+    if (result->rss_ok) {
+        cb_table_set(table, 7, "%.2f", result->peak_growth / ALLOC_MIB);
+        if (result->peak_live >= ALLOC_MIB) {
+            cb_table_set(table, 8, "%.2fx", result->peak_growth / result->peak_live);
+        } else {
+            cb_table_set(table, 8, "n/a");
+        }
+        cb_table_set(table, 9, "%.2f", result->retained / ALLOC_MIB);
+    } else {
+        cb_table_set(table, 7, "n/a");
+        cb_table_set(table, 8, "n/a");
+        cb_table_set(table, 9, "n/a");
+    }
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_alloc_run(const cb_config_t *config, cb_table_t **table_out)
+{
+    static const char *const headers[] = {
+        "Allocator", "Pattern", "Threads", "Mean (s)", "Stddev (s)", "Mops/s",
+        "Peak live (MiB)", "RSS growth (MiB)", "Overhead", "Retained (MiB)"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    alloc_result_t *result = NULL;
+
+    if (!config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    size_t result_size = sizeof(alloc_result_t) +
+                         (size_t)config->iterations * sizeof(double);
+
+    err = cb_table_create(&table, "alloc", "Allocator Contention Workload",
+                          headers, (int)(sizeof(headers) / sizeof(headers[0])));
+    if (err) {
+        return err;
+    }
+
+    result = calloc(1, result_size);
+    if (!result) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    for (int p = 0; p < NUM_PATTERNS; p++) {
+        const alloc_pattern_t *pattern = &PATTERNS[p];
+
+        if (config->alloc_pattern[0] != '\0' &&
+            strcmp(config->alloc_pattern, pattern->name) != 0) {
+            continue;
+        }
+
+        for (int a = 0; a < ALLOCATOR_COUNT; a++) {
+            memset(result, 0, result_size);
+#ifdef CB_PLATFORM_UNIX
+            err = measure_isolated(config, (allocator_t)a, pattern, result,
+                                   result_size);
+            if (!err) {
+                err = result->err;
+            }
+#else
+            measure(config, (allocator_t)a, pattern, result);
+            err = result->err;
+#endif
+            if (err) {
+                goto cleanup;
+            }
+
+            if (config->verbose) {
+                fprintf(stdout, "  %s / %s: %d thread%s done\n",
+                        ALLOCATOR_NAMES[a], pattern->name, result->threads,
+                        result->threads == 1 ? "" : "s");
+            }
+
+            err = add_row(table, (allocator_t)a, pattern, result,
+                          config->iterations);
+            if (err) {
+                goto cleanup;
+            }
+        }
+    }
+
+    const char *preload = getenv("LD_PRELOAD");
+    if (preload && preload[0] != '\0') {
+        cb_table_add_note(table, "malloc rows measure the preloaded allocator "
+                          "(LD_PRELOAD=%.100s).", preload);
+    } else {
+#ifdef __GLIBC__
+        cb_table_add_note(table, "malloc rows measure glibc malloc; set "
+                          "LD_PRELOAD to measure another allocator.");
+#else
+        cb_table_add_note(table, "malloc rows measure the C library "
+                          "allocator.");
+#endif
+    }
+    cb_table_add_note(table, "%ld ops (allocs + frees) per thread per "
+                      "iteration. Overhead = RSS growth / live bytes at peak; "
+                      "Retained = RSS growth after all frees.",
+                      (long)config->alloc_ops);
+#ifdef CB_PLATFORM_UNIX
+    cb_table_add_note(table, "Each row runs in a fresh child process so RSS "
+                      "is not inflated by earlier rows.");
+#else
+    cb_table_add_note(table, "Rows run in one process; RSS growth of later "
+                      "rows is reduced by memory retained from earlier ones.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    free(result);
+    cb_table_destroy(table);
+    return err;
+}
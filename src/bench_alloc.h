@@ -0,0 +1,50 @@
+/**
+ * @file bench_alloc.h
+ * @brief Multithreaded allocator contention workload for concur-bench.
+ *
+ * Threads hammer an allocator with one of several patterns:
+ * - short-small: 16-256 B blocks with very short lifetimes.
+ * - long-small:  16-256 B blocks in a large window of live objects.
+ * - long-mixed:  16 B - 16 KiB log-uniform sizes, large live window.
+ * - prod-cons:   threads in pairs; producers allocate, consumers free,
+ *                so every free is cross-thread.
+ *
+ * Each pattern runs against the process's malloc()/free() (whatever
+ * allocator is linked or LD_PRELOADed) and against the built-in
+ * per-thread slab arena (arena.h). The suite reports throughput, RSS
+ * growth at peak, memory overhead relative to live bytes (a measure
+ * of fragmentation), and memory still resident after every block is
+ * freed.
+ */
+
+#ifndef CB_BENCH_ALLOC_H
+#define CB_BENCH_ALLOC_H
+
+#include <stdbool.h>
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Check whether @p name is a known allocation pattern.
+ * @param name  Pattern name, e.g. "long-mixed".
+ * @return true if the pattern exists.
+ */
+bool cb_bench_alloc_pattern_valid(const char *name);
+
+/**
+ * @brief Run the alloc workload and produce a result table.
+ *
+ * On Unix every measurement runs in a freshly forked child so that
+ * RSS figures are not polluted by memory retained from earlier
+ * measurements. Elsewhere measurements run in-process.
+ *
+ * @param config     Benchmark configuration (reads num_threads,
+ *                   iterations, alloc_ops, alloc_pattern, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD, CB_ERR_FORK,
+ *         CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_alloc_run(const cb_config_t *config, cb_table_t **table_out);
+
+#endif /* CB_BENCH_ALLOC_H */
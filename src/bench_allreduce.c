@@ -0,0 +1,385 @@
+/**
+ * @file bench_allreduce.c
+ * @brief Implementation of the allreduce suite.
+ *
+ * For each vector size the parent creates one shared region holding a
+ * control block, rank 0's timings and the cb_allreduce_t with all
+ * vectors, then forks the workers. Each worker fills its input (so the
+ * pages are first touched by their user), and for each algorithm runs
+ * one warm-up allreduce and then iterations samples. A sample is a
+ * barrier followed by Reps back-to-back allreduces and another barrier;
+ * rank 0 times it from the first barrier's release to the second's, so
+ * barrier cost is amortized over Reps. After the last sample every
+ * worker checks its own output against the expected sums.
+ *
+ * Inputs are small integers stored as floats, so every summation order
+ * gives the exact same result and outputs are compared exactly.
+ */
+
+#include "bench_allreduce.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allreduce.h"
+#include "barrier.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define ALLREDUCE_COLS 9
+
+/** @brief Smallest vector size, in bytes. */
+#define ALLREDUCE_MIN_BYTES 8
+
+/** @brief Bytes moved per sample that pick Reps for small vectors. */
+#define ALLREDUCE_SAMPLE_BYTES (16u << 20)
+
+/** @brief Upper bound on allreduces per sample. */
+#define ALLREDUCE_MAX_REPS 256
+
+/** @brief Round @p n up to a whole number of cache lines. */
+static size_t line_round(size_t n)
+{
+    return (n + CB_CACHE_LINE - 1) / CB_CACHE_LINE * CB_CACHE_LINE;
+}
+
+/** @brief Format a power-of-two-ish byte count as "8 B", "2 KiB", ... */
+static void format_size(char *buf, size_t buf_size, size_t bytes)
+{
+    if (bytes >= (1u << 20) && bytes % (1u << 20) == 0) {
+        snprintf(buf, buf_size, "%zu MiB", bytes >> 20);
+    } else if (bytes >= 1024 && bytes % 1024 == 0) {
+        snprintf(buf, buf_size, "%zu KiB", bytes >> 10);
+    } else {
+        snprintf(buf, buf_size, "%zu B", bytes);
+    }
+}
+
+/** @brief Input element @p i of @p rank. */
+static float input_value(size_t i, int rank)
+{
+    return (float)((i + 3 * (size_t)rank) % 7 + 1);
+}
+
+#ifdef CB_PLATFORM_UNIX
+/**
+ * @brief Control block at the start of the shared region.
+ */
+typedef struct {
+    cb_barrier_t barrier;  /**< Sample start and end barrier. */
+    bool ok[CB_ALLREDUCE_ALGO_COUNT][CB_MAX_WORKERS]; /**< Per rank: output correct. */
+} allreduce_ctl_t;
+
+/**
+ * @brief Argument of one worker process.
+ */
+typedef struct {
+    allreduce_ctl_t *ctl;         /**< Control block (shared). */
+    double          *times;       /**< Rank 0: per-op time per algorithm and sample. */
+    cb_allreduce_t  *ar;          /**< Allreduce state and vectors (shared). */
+    int              rank;        /**< Worker index. */
+    int              iterations;  /**< Samples per algorithm. */
+    int              reps;        /**< Allreduces per sample. */
+} allreduce_child_t;
+
+/** @brief True if @p out holds the sum of every rank's input. */
+static bool check_output(const float *out, size_t length, int count)
+{
+    for (size_t i = 0; i < length; i++) {
+        float expected = 0.0f;
+        for (int r = 0; r < count; r++) {
+            expected += input_value(i, r);
+        }
+        if (out[i] != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Worker body: all algorithms for one vector size. */
+static void allreduce_child_fn(void *arg)
+{
+    allreduce_child_t *c = (allreduce_child_t *)arg;
+    cb_allreduce_t *ar = c->ar;
+    float *in = cb_allreduce_input(ar, c->rank);
+
+    for (size_t i = 0; i < ar->length; i++) {
+        in[i] = input_value(i, c->rank);
+    }
+
+    for (int a = 0; a < CB_ALLREDUCE_ALGO_COUNT; a++) {
+        cb_allreduce_algo_t algo = (cb_allreduce_algo_t)a;
+
+        cb_barrier_wait(&c->ctl->barrier, c->rank);
+        cb_allreduce(ar, algo, c->rank);
+
+        for (int iter = 0; iter < c->iterations; iter++) {
+            cb_barrier_wait(&c->ctl->barrier, c->rank);
+            double t_start = cb_time_now();
+            for (int rep = 0; rep < c->reps; rep++) {
+                cb_allreduce(ar, algo, c->rank);
+            }
+            cb_barrier_wait(&c->ctl->barrier, c->rank);
+            if (c->rank == 0) {
+                c->times[a * c->iterations + iter] =
+                    (cb_time_now() - t_start) / c->reps;
+            }
+        }
+
+        c->ctl->ok[a][c->rank] = check_output(cb_allreduce_output(ar, c->rank),
+                                              ar->length, ar->count);
+    }
+
+    _Exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Run every algorithm at one vector size.
+ *
+ * @param times  Output: per-op times, CB_ALLREDUCE_ALGO_COUNT x
+ *               iterations, algorithm-major.
+ * @param ok     Output: per algorithm, every rank's output was correct.
+ */
+static cb_error_t run_size(size_t bytes, int p, int iterations, int reps,
+                           cb_process_t *procs, allreduce_child_t *children,
+                           double *times, bool *ok)
+{
+    cb_error_t err = CB_OK;
+    cb_shared_mem_t shm;
+    char shm_name[64];
+    int spawned = 0;
+    size_t length = bytes / sizeof(float);
+    size_t ctl_size = line_round(sizeof(allreduce_ctl_t));
+    size_t times_size = line_round((size_t)CB_ALLREDUCE_ALGO_COUNT *
+                                   (size_t)iterations * sizeof(double));
+
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_allreduce_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name, ctl_size + times_size +
+                               cb_allreduce_size(p, length));
+    if (err) {
+        return err;
+    }
+
+    char *base = cb_shared_mem_ptr(&shm);
+    allreduce_ctl_t *ctl = (allreduce_ctl_t *)base;
+    double *shm_times = (double *)(base + ctl_size);
+    cb_allreduce_t *ar = (cb_allreduce_t *)(base + ctl_size + times_size);
+
+    err = cb_barrier_init(&ctl->barrier, CB_BARRIER_CENTRAL,
+                          CB_WAIT_SPIN_FUTEX, p, true);
+    if (!err) {
+        err = cb_allreduce_init(ar, p, length, CB_WAIT_SPIN_FUTEX, true);
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    for (int i = 0; i < p; i++) {
+        children[i].ctl = ctl;
+        children[i].times = shm_times;
+        children[i].ar = ar;
+        children[i].rank = i;
+        children[i].iterations = iterations;
+        children[i].reps = reps;
+
+        err = cb_process_spawn(&procs[i], NULL, allreduce_child_fn,
+                               &children[i]);
+        if (err) {
+            break;
+        }
+        spawned++;
+    }
+
+    if (err) {
+        /* Spawned workers would wait at the barrier forever. */
+        for (int i = 0; i < spawned; i++) {
+            cb_process_kill(&procs[i]);
+        }
+    }
+
+    for (int i = 0; i < spawned; i++) {
+        int status = 0;
+        cb_error_t wait_err = cb_process_wait(&procs[i], &status);
+        if (!wait_err && status != 0) {
+            wait_err = CB_ERR_FORK;
+        }
+        if (wait_err && !err) {
+            err = wait_err;
+        }
+    }
+
+    if (!err) {
+        memcpy(times, shm_times, (size_t)CB_ALLREDUCE_ALGO_COUNT *
+               (size_t)iterations * sizeof(double));
+        for (int a = 0; a < CB_ALLREDUCE_ALGO_COUNT; a++) {
+            ok[a] = true;
+            for (int i = 0; i < p; i++) {
+                ok[a] = ok[a] && ctl->ok[a][i];
+            }
+        }
+    }
+
+cleanup:
+    cb_barrier_destroy(&ctl->barrier);
+    cb_shared_mem_destroy(&shm);
+    return err;
+}
+#endif /* CB_PLATFORM_UNIX */
+
+cb_error_t cb_bench_allreduce_run(const cb_config_t *config,
+                                  cb_table_t **table_out)
+{
+    static const char *const headers[ALLREDUCE_COLS] = {
+        "Algorithm", "Processes", "Size", "Reps", "Latency (us)",
+        "Stddev (us)", "Alg BW (GB/s)", "Bus BW (GB/s)", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+#ifdef CB_PLATFORM_UNIX
+    cb_process_t *procs = NULL;
+    allreduce_child_t *children = NULL;
+    double *times = NULL;
+#endif
+
+    if (!config || !table_out || config->num_processes < 1 ||
+        config->num_processes > CB_MAX_WORKERS ||
+        config->allreduce_max < ALLREDUCE_MIN_BYTES) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    err = cb_table_create(&table, "allreduce", "Allreduce: Ring vs "
+                          "Recursive Doubling vs Reduce-Scatter + Allgather",
+                          headers, ALLREDUCE_COLS);
+    if (err) {
+        return err;
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    int p = config->num_processes;
+    int iterations = config->iterations;
+    size_t max_bytes = (size_t)config->allreduce_max / sizeof(float) *
+                       sizeof(float);
+
+    procs    = calloc((size_t)p, sizeof(cb_process_t));
+    children = calloc((size_t)p, sizeof(allreduce_child_t));
+    times    = calloc((size_t)CB_ALLREDUCE_ALGO_COUNT * (size_t)iterations,
+                      sizeof(double));
+    if (!procs || !children || !times) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* Fastest algorithm at the smallest and largest size, for the notes. */
+    int first_best = 0, last_best = 0;
+    double first_lat = 0.0, last_bw = 0.0;
+    size_t bytes = ALLREDUCE_MIN_BYTES;
+
+    for (;;) {
+        bool ok[CB_ALLREDUCE_ALGO_COUNT];
+        char size_text[32];
+        size_t per_sample = ALLREDUCE_SAMPLE_BYTES / bytes;
+        int reps = per_sample < 1 ? 1 :
+                   per_sample > ALLREDUCE_MAX_REPS ? ALLREDUCE_MAX_REPS
+                                                   : (int)per_sample;
+
+        format_size(size_text, sizeof(size_text), bytes);
+        err = run_size(bytes, p, iterations, reps, procs, children, times, ok);
+        if (err) {
+            goto cleanup;
+        }
+
+        double best_lat = 0.0;
+        int best = 0;
+        for (int a = 0; a < CB_ALLREDUCE_ALGO_COUNT; a++) {
+            cb_bench_stats_t stats;
+            err = cb_stats_compute(&times[a * iterations], iterations, &stats);
+            if (!err) {
+                err = cb_table_add_row(table);
+            }
+            if (err) {
+                goto cleanup;
+            }
+
+            double lat = stats.mean_sec;
+            double algbw = lat > 0.0 ? (double)bytes / lat / 1e9 : 0.0;
+
+            cb_table_set(table, 0, "%s",
+                         cb_allreduce_algo_name((cb_allreduce_algo_t)a));
+            cb_table_set(table, 1, "%d", p);
+            cb_table_set(table, 2, "%s", size_text);
+            cb_table_set(table, 3, "%d", reps);
+            cb_table_set(table, 4, "%.2f", lat * 1e6);
+            cb_table_set(table, 5, "%.2f", stats.stddev_sec * 1e6);
+            cb_table_set(table, 6, "%.3f", algbw);
+            cb_table_set(table, 7, "%.3f", algbw * 2.0 * (p - 1) / p);
+            cb_table_set(table, 8, "%s", ok[a] ? "PASS" : "FAIL");
+
+            if (a == 0 || lat < best_lat) {
+                best_lat = lat;
+                best = a;
+            }
+            if (config->verbose) {
+                fprintf(stdout, "  allreduce %s %s: %.2f us, %.3f GB/s\n",
+                        cb_allreduce_algo_name((cb_allreduce_algo_t)a),
+                        size_text, lat * 1e6, algbw);
+            }
+        }
+
+        if (bytes == ALLREDUCE_MIN_BYTES) {
+            first_best = best;
+            first_lat = best_lat;
+        }
+        last_best = best;
+        last_bw = best_lat > 0.0 ? (double)bytes / best_lat / 1e9 : 0.0;
+
+        if (bytes >= max_bytes) {
+            break;
+        }
+        bytes = bytes * 4 > max_bytes ? max_bytes : bytes * 4;
+    }
+
+    char max_text[32];
+    format_size(max_text, sizeof(max_text), max_bytes);
+    cb_table_add_note(table, "Fastest at %d B: %s (%.2f us); at %s: %s "
+                      "(%.3f GB/s).", ALLREDUCE_MIN_BYTES,
+                      cb_allreduce_algo_name((cb_allreduce_algo_t)first_best),
+                      first_lat * 1e6, max_text,
+                      cb_allreduce_algo_name((cb_allreduce_algo_t)last_best),
+                      last_bw);
+    cb_table_add_note(table, "Latency: one float32 allreduce, averaged over "
+                      "Reps back-to-back calls between two barriers.");
+    cb_table_add_note(table, "Alg BW = size / latency; Bus BW = Alg BW x "
+                      "2(P-1)/P, the per-rank traffic of an optimal "
+                      "allreduce.");
+    cb_table_add_note(table, "Vectors share one region; ranks read peers' "
+                      "vectors directly and wait on per-rank step flags "
+                      "(spin-then-futex).");
+    if (p == 1) {
+        cb_table_add_note(table, "One process: every algorithm is a copy "
+                          "of the input.");
+    }
+#else
+    cb_table_add_note(table, "The allreduce suite requires fork() and is "
+                      "not available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+#ifdef CB_PLATFORM_UNIX
+cleanup:
+    free(procs);
+    free(children);
+    free(times);
+#endif
+    cb_table_destroy(table);
+    return err;
+}
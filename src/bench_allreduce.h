@@ -0,0 +1,31 @@
+/**
+ * @file bench_allreduce.h
+ * @brief Allreduce suite: collectives among worker processes.
+ *
+ * Process mode combines partial sums in the parent, so only the parent
+ * learns the total. This suite times the allreduce collectives from
+ * allreduce.h, after which every worker process holds the element-wise
+ * sum of all workers' float vectors, over vector sizes from 8 B up to
+ * --allreduce-max in steps of 4x. Each row reports the latency of one
+ * allreduce and the algorithm and bus bandwidth it reaches.
+ */
+
+#ifndef CB_BENCH_ALLREDUCE_H
+#define CB_BENCH_ALLREDUCE_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the allreduce suite and produce a result table.
+ *
+ * @param config     Benchmark configuration (reads num_processes,
+ *                   iterations, allreduce_max, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_FORK,
+ *         CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_allreduce_run(const cb_config_t *config,
+                                  cb_table_t **table_out);
+
+#endif /* CB_BENCH_ALLREDUCE_H */
@@ -0,0 +1,679 @@
+/**
+ * @file bench_autotune.c
+ * @brief Implementation of the configuration search.
+ *
+ * Search space, per mode:
+ * - Workers: powers of two up to twice the core count, the core count
+ *   itself, and the count entered at the prompt.
+ * - Chunks per worker: 1, 4, 16, 64. The array is cut into
+ *   workers x chunks equal chunks that workers claim from a shared
+ *   atomic counter, so 1 is the static split of the core modes and
+ *   larger values trade claim traffic for load balance.
+ * - Pinning: none; linear (worker i on CPU i mod cores); interleave
+ *   (even workers on the lower half of the CPUs, odd workers on the
+ *   upper half, spreading neighbours across packages or SMT pairs).
+ *   Only "none" is searched where pinning is unsupported.
+ *
+ * Successive halving: each live configuration is sampled up to the
+ * round's target (2 runs in round 1, doubling each round). Any
+ * configuration whose mean minus AUTOTUNE_Z standard errors is still
+ * above the best mean plus AUTOTUNE_Z standard errors is dominated and
+ * dropped; the slower half of the remainder is then dropped. The
+ * search ends when one configuration is left or the next target would
+ * exceed AUTOTUNE_MAX_SAMPLES.
+ *
+ * Every run creates its workers (threads, or forked children on Unix)
+ * and is timed like the core modes, creation included.
+ */
+
+#include "bench_autotune.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "kernel.h"
+#include "platform.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define AUTOTUNE_COLS 10
+
+/** @brief Samples per configuration in the first round. */
+#define AUTOTUNE_FIRST_SAMPLES 2
+
+/** @brief Upper bound on samples per configuration. */
+#define AUTOTUNE_MAX_SAMPLES 32
+
+/** @brief Standard errors on each side of the dominance test. */
+#define AUTOTUNE_Z 2.0
+
+/** @brief Configurations listed per mode (plus the prompt default). */
+#define AUTOTUNE_SHOW 5
+
+/** @brief Maximum distinct worker counts in the search. */
+#define AUTOTUNE_MAX_WORKER_STEPS 16
+
+/** @brief Chunks-per-worker values in the search. */
+static const int chunk_steps[] = { 1, 4, 16, 64 };
+
+/** @brief Number of chunk_steps entries. */
+#define AUTOTUNE_CHUNK_STEPS ((int)(sizeof(chunk_steps) / sizeof(chunk_steps[0])))
+
+/** @brief Pinning policies. */
+enum {
+    PIN_NONE       = 0, /**< Leave placement to the scheduler. */
+    PIN_LINEAR     = 1, /**< Worker i on CPU i mod cores. */
+    PIN_INTERLEAVE = 2, /**< Alternate between the CPU halves. */
+    PIN_COUNT      = 3
+};
+
+/** @brief Display names, indexed by PIN_*. */
+static const char *const pin_names[PIN_COUNT] = {
+    "none", "linear", "interleave"
+};
+
+/**
+ * @brief State of one run, on the heap (threads) or in shared memory
+ *        (processes).
+ */
+typedef struct {
+    const int    *dataset;  /**< Input array (inherited through fork). */
+    int           length;   /**< Elements in the array. */
+    int           chunk;    /**< Elements per chunk. */
+    int           chunks;   /**< Number of chunks. */
+    int           pin;      /**< Pinning policy (PIN_*). */
+    int           cores;    /**< Logical CPUs to pin onto. */
+    _Atomic int   next;     /**< Next unclaimed chunk. */
+    cb_start_gate_t gate;   /**< Start gate. */
+    atomic_long   total;    /**< Sum of all partials. */
+} autotune_run_t;
+
+/**
+ * @brief Per-worker argument.
+ */
+typedef struct {
+    autotune_run_t *run;  /**< Shared run state. */
+    int             id;   /**< Worker index. */
+} autotune_arg_t;
+
+/**
+ * @brief One point of the search space and its samples so far.
+ */
+typedef struct {
+    int    workers;    /**< Worker count. */
+    int    per_worker; /**< Chunks per worker. */
+    int    pin;        /**< Pinning policy (PIN_*). */
+    int    samples;    /**< Runs timed. */
+    double sum;        /**< Sum of run times (s). */
+    double sumsq;      /**< Sum of squared run times. */
+    int    dropped;    /**< Round it was dropped in, or 0 if live. */
+    bool   dominated;  /**< Dropped by the dominance test. */
+    bool   ok;         /**< Every run produced the expected sum. */
+} candidate_t;
+
+/**
+ * @brief Everything needed to time one candidate in one mode.
+ */
+typedef struct {
+    autotune_run_t *run;      /**< Run state. */
+    bool            process;  /**< Fork children instead of threads. */
+    cb_thread_t    *threads;  /**< Thread mode: handles. */
+    cb_process_t   *procs;    /**< Process mode: handles. */
+    autotune_arg_t *args;     /**< Per-worker arguments. */
+    long int        expected; /**< Correct total. */
+    int             runs;     /**< Runs performed so far. */
+} autotune_ctx_t;
+
+/** @brief Mean run time of @p c. */
+static double cand_mean(const candidate_t *c)
+{
+    return c->samples > 0 ? c->sum / c->samples : 0.0;
+}
+
+/** @brief Sample standard deviation of @p c. */
+static double cand_stddev(const candidate_t *c)
+{
+    if (c->samples < 2) {
+        return 0.0;
+    }
+    double mean = cand_mean(c);
+    double var = (c->sumsq - c->samples * mean * mean) / (c->samples - 1);
+    return var > 0.0 ? sqrt(var) : 0.0;
+}
+
+/** @brief Standard error of the mean of @p c. */
+static double cand_se(const candidate_t *c)
+{
+    return c->samples > 0 ? cand_stddev(c) / sqrt((double)c->samples) : 0.0;
+}
+
+/** @brief CPU for worker @p id under @p pin, or -1 for no pinning. */
+static int pin_cpu(int pin, int id, int cores)
+{
+    if (pin == PIN_LINEAR) {
+        return id % cores;
+    }
+    if (pin == PIN_INTERLEAVE) {
+        int half = (cores + 1) / 2;
+        if (id % 2 == 0 || cores == 1) {
+            return (id / 2) % half;
+        }
+        return half + (id / 2) % (cores - half);
+    }
+    return -1;
+}
+
+/** @brief Worker body shared by threads and children. */
+static void pull_chunks(autotune_run_t *r, int id)
+{
+    int cpu = pin_cpu(r->pin, id, r->cores);
+    if (cpu >= 0) {
+        /* Best effort: a CPU outside our cpuset just stays unpinned. */
+        (void)cb_thread_pin_self(cpu);
+    }
+
+    if (!cb_start_gate_wait(&r->gate)) {
+        return;
+    }
+
+    long int partial = 0;
+    for (;;) {
+        int c = atomic_fetch_add(&r->next, 1);
+        if (c >= r->chunks) {
+            break;
+        }
+        int start = c * r->chunk;
+        int len = r->length - start < r->chunk ? r->length - start : r->chunk;
+        partial += cb_kernel_sum(r->dataset + start, len);
+    }
+    atomic_fetch_add(&r->total, partial);
+}
+
+/** @brief Thread entry point. */
+static void *autotune_thread_fn(void *arg)
+{
+    autotune_arg_t *a = (autotune_arg_t *)arg;
+    pull_chunks(a->run, a->id);
+    return NULL;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child entry point. */
+static void autotune_child_fn(void *arg)
+{
+    autotune_arg_t *a = (autotune_arg_t *)arg;
+    pull_chunks(a->run, a->id);
+    _Exit(EXIT_SUCCESS);
+}
+#endif
+
+/** @brief Create @p workers workers, open the gate, and wait for them. */
+static cb_error_t run_workers(autotune_ctx_t *ctx, int workers)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    for (int i = 0; i < workers; i++) {
+        ctx->args[i].run = ctx->run;
+        ctx->args[i].id = i;
+#ifdef CB_PLATFORM_UNIX
+        if (ctx->process) {
+            err = cb_process_spawn(&ctx->procs[i], NULL, autotune_child_fn,
+                                   &ctx->args[i]);
+        } else
+#endif
+        {
+            err = cb_thread_create(&ctx->threads[i], autotune_thread_fn,
+                                   &ctx->args[i]);
+        }
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    if (err) {
+        cb_start_gate_abort(&ctx->run->gate);
+    } else {
+        cb_start_gate_open(&ctx->run->gate);
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err;
+#ifdef CB_PLATFORM_UNIX
+        if (ctx->process) {
+            int status = 0;
+            join_err = cb_process_wait(&ctx->procs[i], &status);
+            if (!join_err && status != 0) {
+                join_err = CB_ERR_FORK;
+            }
+        } else
+#endif
+        {
+            join_err = cb_thread_join(&ctx->threads[i]);
+        }
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    return err;
+}
+
+/** @brief Time one run of @p c and add it to its samples. */
+static cb_error_t sample(autotune_ctx_t *ctx, candidate_t *c)
+{
+    autotune_run_t *r = ctx->run;
+    int pieces = c->workers * c->per_worker;
+
+    r->chunk = r->length / pieces + (r->length % pieces ? 1 : 0);
+    r->chunks = r->length / r->chunk + (r->length % r->chunk ? 1 : 0);
+    r->pin = c->pin;
+    atomic_store(&r->next, 0);
+    atomic_store(&r->total, 0);
+    cb_start_gate_init(&r->gate);
+
+    double t_start = cb_time_now();
+    cb_error_t err = run_workers(ctx, c->workers);
+    double elapsed = cb_time_now() - t_start;
+    if (err) {
+        return err;
+    }
+
+    c->samples++;
+    c->sum += elapsed;
+    c->sumsq += elapsed * elapsed;
+    if (atomic_load(&r->total) != ctx->expected) {
+        c->ok = false;
+    }
+    ctx->runs++;
+    return CB_OK;
+}
+
+/** @brief qsort order: live first, then later drop, then faster. */
+static int cand_order(const void *a, const void *b)
+{
+    const candidate_t *x = *(const candidate_t *const *)a;
+    const candidate_t *y = *(const candidate_t *const *)b;
+    int xr = x->dropped ? x->dropped : 1 << 30;
+    int yr = y->dropped ? y->dropped : 1 << 30;
+    if (xr != yr) {
+        return xr > yr ? -1 : 1;
+    }
+    double xm = cand_mean(x), ym = cand_mean(y);
+    return (xm > ym) - (xm < ym);
+}
+
+/**
+ * @brief Successive halving over @p cands.
+ *
+ * On return @p order lists every candidate best first.
+ */
+static cb_error_t search(autotune_ctx_t *ctx, const char *mode,
+                         candidate_t *cands, int ncands,
+                         candidate_t **order, bool verbose, int *rounds_out)
+{
+    int target = AUTOTUNE_FIRST_SAMPLES;
+    int live = ncands;
+    int round = 0;
+
+    for (;;) {
+        round++;
+        if (verbose) {
+            fprintf(stdout, "  autotune %s round %d: %d configuration%s, "
+                    "%d samples each\n", mode, round, live,
+                    live == 1 ? "" : "s", target);
+        }
+
+        candidate_t *best = NULL;
+        for (int i = 0; i < ncands; i++) {
+            candidate_t *c = &cands[i];
+            if (c->dropped) {
+                continue;
+            }
+            while (c->samples < target) {
+                cb_error_t err = sample(ctx, c);
+                if (err) {
+                    return err;
+                }
+            }
+            if (!best || cand_mean(c) < cand_mean(best)) {
+                best = c;
+            }
+        }
+
+        /* Drop every configuration that is slower beyond doubt. */
+        double bound = cand_mean(best) + AUTOTUNE_Z * cand_se(best);
+        for (int i = 0; i < ncands; i++) {
+            candidate_t *c = &cands[i];
+            if (!c->dropped && c != best &&
+                cand_mean(c) - AUTOTUNE_Z * cand_se(c) > bound) {
+                c->dropped = round;
+                c->dominated = true;
+                live--;
+            }
+        }
+
+        if (live <= 1 || target * 2 > AUTOTUNE_MAX_SAMPLES) {
+            break;
+        }
+
+        /* Keep the faster half of the rest. */
+        int k = 0;
+        for (int i = 0; i < ncands; i++) {
+            if (!cands[i].dropped) {
+                order[k++] = &cands[i];
+            }
+        }
+        qsort(order, (size_t)k, sizeof(order[0]), cand_order);
+        int keep = (k + 1) / 2;
+        for (int i = keep; i < k; i++) {
+            order[i]->dropped = round;
+        }
+        live = keep;
+        target *= 2;
+    }
+
+    for (int i = 0; i < ncands; i++) {
+        order[i] = &cands[i];
+    }
+    qsort(order, (size_t)ncands, sizeof(order[0]), cand_order);
+    *rounds_out = round;
+    return CB_OK;
+}
+
+/** @brief Append one row. */
+static cb_error_t add_row(cb_table_t *table, const char *mode, int rank,
+                          const candidate_t *c, double baseline_sec)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = cand_mean(c);
+    double speedup = (baseline_sec > 0.0 && mean > 0.0) ? baseline_sec / mean : 1.0;
+
+    cb_table_set(table, 0, "%s", mode);
+    cb_table_set(table, 1, "%d", rank);
+    cb_table_set(table, 2, "%d", c->workers);
+    cb_table_set(table, 3, "%d", c->per_worker);
+    cb_table_set(table, 4, "%s", pin_names[c->pin]);
+    cb_table_set(table, 5, "%d", c->samples);
+    cb_table_set(table, 6, "%.6f", mean);
+    cb_table_set(table, 7, "%.6f", cand_stddev(c));
+    cb_table_set(table, 8, "%.2fx", speedup);
+    cb_table_set(table, 9, "%s", c->ok ? "PASS" : "FAIL");
+
+    return CB_OK;
+}
+
+/** @brief Probe on a scratch thread so the main thread stays unpinned. */
+static void *pin_probe_fn(void *arg)
+{
+    *(cb_error_t *)arg = cb_thread_pin_self(0);
+    return NULL;
+}
+
+/** @brief True if cb_thread_pin_self() works on this host. */
+static bool pinning_supported(void)
+{
+    cb_thread_t thread;
+    cb_error_t result = CB_ERR_PLATFORM;
+
+    if (cb_thread_create(&thread, pin_probe_fn, &result) != CB_OK) {
+        return false;
+    }
+    cb_thread_join(&thread);
+    return result == CB_OK;
+}
+
+/** @brief Insert @p w into the sorted set @p steps unless present. */
+static void add_worker_step(int *steps, int *count, int w)
+{
+    if (w < 1 || w > CB_MAX_WORKERS || *count >= AUTOTUNE_MAX_WORKER_STEPS) {
+        return;
+    }
+    int i = 0;
+    while (i < *count && steps[i] < w) {
+        i++;
+    }
+    if (i < *count && steps[i] == w) {
+        return;
+    }
+    memmove(&steps[i + 1], &steps[i], (size_t)(*count - i) * sizeof(int));
+    steps[i] = w;
+    (*count)++;
+}
+
+/**
+ * @brief Search one mode and append its rows and recommendation.
+ *
+ * @param prompt_workers  Worker count from the prompt; its statically
+ *                        split, unpinned configuration is the speedup
+ *                        baseline and is always listed.
+ */
+static cb_error_t tune_mode(cb_table_t *table, autotune_ctx_t *ctx,
+                            const char *mode, int prompt_workers,
+                            int cores, int pins, bool verbose,
+                            int *configs_out, int *runs_out)
+{
+    cb_error_t err = CB_OK;
+    int steps[AUTOTUNE_MAX_WORKER_STEPS];
+    int nsteps = 0;
+
+    add_worker_step(steps, &nsteps, prompt_workers);
+    add_worker_step(steps, &nsteps, cores);
+    for (int w = 1; w <= 2 * cores; w *= 2) {
+        add_worker_step(steps, &nsteps, w);
+    }
+
+    int ncands = nsteps * AUTOTUNE_CHUNK_STEPS * pins;
+    candidate_t *cands = calloc((size_t)ncands, sizeof(candidate_t));
+    candidate_t **order = calloc((size_t)ncands, sizeof(candidate_t *));
+    if (!cands || !order) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    candidate_t *baseline = NULL;
+    int k = 0;
+    for (int w = 0; w < nsteps; w++) {
+        for (int g = 0; g < AUTOTUNE_CHUNK_STEPS; g++) {
+            for (int p = 0; p < pins; p++) {
+                candidate_t *c = &cands[k++];
+                c->workers = steps[w];
+                c->per_worker = chunk_steps[g];
+                c->pin = p;
+                c->ok = true;
+                if (c->workers == prompt_workers && g == 0 && p == PIN_NONE) {
+                    baseline = c;
+                }
+            }
+        }
+    }
+
+    int runs_before = ctx->runs;
+    int dominated = 0;
+    int rounds = 0;
+    err = search(ctx, mode, cands, ncands, order, verbose, &rounds);
+    if (err) {
+        goto cleanup;
+    }
+
+    for (int i = 0; i < ncands; i++) {
+        dominated += cands[i].dominated;
+    }
+
+    double baseline_sec = cand_mean(baseline);
+    bool baseline_shown = false;
+    for (int i = 0; i < ncands; i++) {
+        if (i < AUTOTUNE_SHOW || order[i] == baseline) {
+            err = add_row(table, mode, i + 1, order[i], baseline_sec);
+            if (err) {
+                goto cleanup;
+            }
+            if (order[i] == baseline) {
+                baseline_shown = true;
+            }
+        }
+        if (i + 1 >= AUTOTUNE_SHOW && baseline_shown) {
+            break;
+        }
+    }
+
+    const candidate_t *best = order[0];
+    int pieces = best->workers * best->per_worker;
+    int n = ctx->run->length;
+    cb_table_add_note(table, "Recommended %s pool: %d worker%s, chunks of %d "
+                      "elements (%d per worker), pinning %s; %.2fx over "
+                      "%d static unpinned.", mode, best->workers,
+                      best->workers == 1 ? "" : "s", n / pieces + (n % pieces ? 1 : 0), best->per_worker,
+                      pin_names[best->pin], baseline_sec / cand_mean(best),
+                      prompt_workers);
+    cb_table_add_note(table, "%s search: %d configurations, %d rounds, "
+                      "%d runs, %d dropped as dominated.", mode, ncands,
+                      rounds, ctx->runs - runs_before, dominated);
+
+    *configs_out += ncands;
+    *runs_out += ctx->runs - runs_before;
+
+cleanup:
+    free(cands);
+    free(order);
+    return err;
+}
+
+cb_error_t cb_bench_autotune_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out)
+{
+    static const char *const headers[AUTOTUNE_COLS] = {
+        "Mode", "Rank", "Workers", "Chunks/worker", "Pinning", "Samples",
+        "Mean (s)", "Stddev (s)", "Speedup", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    autotune_ctx_t ctx;
+    cb_thread_t *threads = NULL;
+    autotune_arg_t *args = NULL;
+    autotune_run_t *run = NULL;
+#ifdef CB_PLATFORM_UNIX
+    cb_process_t *procs = NULL;
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+#endif
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int cores = cb_cpu_budget();
+    if (cores < 1) {
+        cores = 1;
+    }
+    int pins = pinning_supported() ? PIN_COUNT : 1;
+    int configs = 0, runs = 0;
+    double t_start = cb_time_now();
+
+    err = cb_table_create(&table, "autotune", "Configuration Autotune",
+                          headers, AUTOTUNE_COLS);
+    if (err) {
+        return err;
+    }
+
+    threads = calloc(CB_MAX_WORKERS, sizeof(cb_thread_t));
+    args    = calloc(CB_MAX_WORKERS, sizeof(autotune_arg_t));
+    run     = calloc(1, sizeof(autotune_run_t));
+    if (!threads || !args || !run) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.threads = threads;
+    ctx.args = args;
+    ctx.expected = cb_kernel_sum(dataset, config->array_length);
+
+    /* ---- thread mode ---- */
+    run->dataset = dataset;
+    run->length = config->array_length;
+    run->cores = cores;
+    ctx.run = run;
+    err = tune_mode(table, &ctx, "thread", config->num_threads, cores, pins,
+                    config->verbose, &configs, &runs);
+    if (err) {
+        goto cleanup;
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    /* ---- process mode ---- */
+    procs = calloc(CB_MAX_WORKERS, sizeof(cb_process_t));
+    if (!procs) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_autotune_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name, sizeof(autotune_run_t));
+    if (err) {
+        goto cleanup;
+    }
+    shm_created = true;
+
+    autotune_run_t *srun = cb_shared_mem_ptr(&shm);
+    srun->dataset = dataset;
+    srun->length = config->array_length;
+    srun->cores = cores;
+    ctx.run = srun;
+    ctx.process = true;
+    ctx.procs = procs;
+    err = tune_mode(table, &ctx, "process", config->num_processes, cores,
+                    pins, config->verbose, &configs, &runs);
+    if (err) {
+        goto cleanup;
+    }
+#else
+    cb_table_add_note(table, "Process search requires fork() and is not "
+                      "available on this platform.");
+#endif
+
+    if (pins == 1) {
+        cb_table_add_note(table, "Thread pinning is not supported here; "
+                          "only unpinned configurations were searched.");
+    }
+    cb_table_add_note(table, "Successive halving from %d samples, dropping "
+                      "configurations slower by more than %.0f standard "
+                      "errors; %d configurations, %d runs, %.1f s in total.",
+                      AUTOTUNE_FIRST_SAMPLES, AUTOTUNE_Z, configs, runs,
+                      cb_time_now() - t_start);
+    cb_table_add_note(table, "Rank orders by the round a configuration "
+                      "survived to, then by mean; means from fewer samples "
+                      "are noisier.");
+    cb_table_add_note(table, "Speedup is over the prompt's worker count with "
+                      "one static chunk per worker and no pinning.");
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+#ifdef CB_PLATFORM_UNIX
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+    free(procs);
+#endif
+    free(threads);
+    free(args);
+    free(run);
+    cb_table_destroy(table);
+    return err;
+}
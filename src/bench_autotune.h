@@ -0,0 +1,34 @@
+/**
+ * @file bench_autotune.h
+ * @brief Configuration search for the thread and process modes.
+ *
+ * Instead of timing the one worker count entered at the prompt, this
+ * suite searches worker count, partition granularity (chunks per
+ * worker, pulled dynamically from a shared counter) and pinning policy
+ * with successive halving: every configuration starts with a few
+ * samples, statistically dominated ones are dropped, the slower half
+ * of the rest is dropped, and the survivors get twice the samples in
+ * the next round. The table lists the leading configurations per mode
+ * and the notes give a recommended setting for a production pool.
+ */
+
+#ifndef CB_BENCH_AUTOTUNE_H
+#define CB_BENCH_AUTOTUNE_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the configuration search and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, num_processes, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_FORK, CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_autotune_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out);
+
+#endif /* CB_BENCH_AUTOTUNE_H */
@@ -0,0 +1,406 @@
+/**
+ * @file bench_barrier.c
+ * @brief Implementation of the barrier algorithm suite.
+ *
+ * Every measurement places a barrier_arena_t (the barrier plus a small
+ * control block) either on the cache-line-aligned heap (thread variant)
+ * or in a named shared memory segment inherited across fork() (process
+ * variant). Participants are released together through a start gate,
+ * pass one warm-up episode, and then run batches of CB_BARRIER_BATCH
+ * episodes. Participant 0 decides before the last episode of each
+ * batch whether to stop, so every participant observes the same
+ * decision after that episode without any extra synchronization.
+ */
+
+#include "bench_barrier.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/**
+ * @brief Barrier plus measurement control block.
+ *
+ * Contains no pointers so it can live in shared memory.
+ */
+typedef struct {
+    cb_barrier_t barrier;                                /**< Barrier under test. */
+    _Alignas(CB_CACHE_LINE) cb_start_gate_t gate;        /**< Start gate. */
+    _Alignas(CB_CACHE_LINE) _Atomic uint32_t stop;       /**< Stop decision by participant 0. */
+    double   elapsed_sec;                                /**< Measured by participant 0. */
+    uint32_t episodes;                                   /**< Episodes timed by participant 0. */
+} barrier_arena_t;
+
+/**
+ * @brief Arguments for one barrier participant (thread or process).
+ */
+typedef struct {
+    barrier_arena_t *arena;         /**< Shared arena. */
+    int              id;            /**< Participant index. */
+    uint32_t         max_episodes;  /**< Episode cap for this measurement. */
+} participant_t;
+
+/**
+ * @brief Body shared by thread and process participants.
+ */
+static void run_participant(const participant_t *p)
+{
+    barrier_arena_t *a = p->arena;
+
+    if (!cb_start_gate_wait(&a->gate)) {
+        return;
+    }
+
+    cb_barrier_wait(&a->barrier, p->id); /* Warm-up: everyone is present. */
+
+    double t_start = cb_time_now();
+    uint32_t done = 0;
+
+    for (;;) {
+        for (int k = 0; k < CB_BARRIER_BATCH; k++) {
+            if (p->id == 0 && k == CB_BARRIER_BATCH - 1) {
+                bool stop = done + CB_BARRIER_BATCH >= p->max_episodes ||
+                            cb_time_now() - t_start >= CB_BARRIER_BUDGET_SEC;
+                atomic_store(&a->stop, stop ? 1u : 0u);
+            }
+            cb_barrier_wait(&a->barrier, p->id);
+        }
+        done += CB_BARRIER_BATCH;
+
+        if (atomic_load(&a->stop)) {
+            break;
+        }
+    }
+
+    if (p->id == 0) {
+        a->elapsed_sec = cb_time_now() - t_start;
+        a->episodes = done;
+    }
+}
+
+/** @brief Thread entry point for a participant. */
+static void *participant_thread_fn(void *arg)
+{
+    run_participant((const participant_t *)arg);
+    return NULL;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child process entry point for a participant. */
+static void participant_child_fn(void *arg)
+{
+    run_participant((const participant_t *)arg);
+    _Exit(EXIT_SUCCESS);
+}
+#endif
+
+/**
+ * @brief Handles reused across measurements of one variant.
+ */
+typedef struct {
+    barrier_arena_t *arena;     /**< Heap or shared memory arena. */
+    bool             use_procs; /**< True for the process variant. */
+    participant_t   *parts;     /**< CB_MAX_WORKERS participant args. */
+    cb_thread_t     *threads;   /**< CB_MAX_WORKERS thread handles. */
+    cb_process_t    *procs;     /**< CB_MAX_WORKERS process handles. */
+} barrier_ctx_t;
+
+/**
+ * @brief Join (or wait for) the first @p spawned participants.
+ */
+static cb_error_t reap_participants(barrier_ctx_t *ctx, int spawned)
+{
+    cb_error_t err = CB_OK;
+
+    for (int i = 0; i < spawned; i++) {
+        cb_error_t e;
+        if (ctx->use_procs) {
+            int status = 0;
+            e = cb_process_wait(&ctx->procs[i], &status);
+            if (!e && status != 0) {
+                e = CB_ERR_FORK;
+            }
+        } else {
+            e = cb_thread_join(&ctx->threads[i]);
+        }
+        if (e && !err) {
+            err = e;
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Run one measurement and return the time per episode.
+ *
+ * @return CB_OK on success, CB_ERR_PLATFORM if the combination is
+ *         unsupported, or another error if participants cannot be created.
+ */
+static cb_error_t measure(barrier_ctx_t *ctx, cb_barrier_algo_t algo,
+                          cb_wait_policy_t policy, int n,
+                          uint32_t max_episodes, double *sec_per_episode)
+{
+    barrier_arena_t *a = ctx->arena;
+    cb_error_t err = cb_barrier_init(&a->barrier, algo, policy, n,
+                                     ctx->use_procs);
+    if (err) {
+        return err;
+    }
+
+    cb_start_gate_init(&a->gate);
+    atomic_store(&a->stop, 0u);
+    a->elapsed_sec = 0.0;
+    a->episodes = 0;
+
+    int spawned = 0;
+    for (int i = 0; i < n; i++) {
+        ctx->parts[i].arena = a;
+        ctx->parts[i].id = i;
+        ctx->parts[i].max_episodes = max_episodes;
+
+        if (ctx->use_procs) {
+#ifdef CB_PLATFORM_UNIX
+            err = cb_process_spawn(&ctx->procs[i], NULL, participant_child_fn,
+                                   &ctx->parts[i]);
+#else
+            err = CB_ERR_PLATFORM;
+#endif
+        } else {
+            err = cb_thread_create(&ctx->threads[i], participant_thread_fn,
+                                   &ctx->parts[i]);
+        }
+        if (err) {
+            break;
+        }
+        spawned++;
+    }
+
+    if (err) {
+        cb_start_gate_abort(&a->gate);
+    } else {
+        cb_start_gate_open(&a->gate);
+    }
+
+    cb_error_t reap_err = reap_participants(ctx, spawned);
+    if (!err) {
+        err = reap_err;
+    }
+
+    cb_barrier_destroy(&a->barrier);
+
+    if (!err) {
+        *sec_per_episode = (a->episodes > 0)
+            ? a->elapsed_sec / (double)a->episodes : 0.0;
+    }
+
+    return err;
+}
+
+/**
+ * @brief Build the participant-count sweep.
+ *
+ * @param cores   CPU budget (cb_cpu_budget()).
+ * @param counts  Output array (at least 16 entries).
+ * @return Number of entries written.
+ */
+static int build_worker_counts(int cores, int *counts)
+{
+    int num = 0;
+    int candidates[16];
+    int num_candidates = 0;
+
+    for (int c = 2; c < cores && num_candidates < 13; c *= 2) {
+        candidates[num_candidates++] = c;
+    }
+    candidates[num_candidates++] = cores;
+    candidates[num_candidates++] = 2 * cores;
+
+    for (int i = 0; i < num_candidates; i++) {
+        int c = candidates[i] > CB_MAX_WORKERS ? CB_MAX_WORKERS : candidates[i];
+        if (c < 2 || (num > 0 && counts[num - 1] >= c)) {
+            continue;
+        }
+        counts[num++] = c;
+    }
+
+    return num;
+}
+
+/**
+ * @brief Sweep every algorithm, policy, and worker count for one variant.
+ */
+static cb_error_t sweep_variant(barrier_ctx_t *ctx, const cb_config_t *config,
+                                const int *counts, int num_counts, int cores,
+                                double *times, cb_table_t *table)
+{
+    const char *variant = ctx->use_procs ? "process" : "thread";
+
+    for (int algo = 0; algo < CB_BARRIER_ALGO_COUNT; algo++) {
+        int num_policies = (algo == CB_BARRIER_NATIVE) ? 1 : CB_WAIT_POLICY_COUNT;
+
+        for (int policy = 0; policy < num_policies; policy++) {
+            const char *policy_name = (algo == CB_BARRIER_NATIVE)
+                ? "native" : cb_wait_policy_name((cb_wait_policy_t)policy);
+
+            for (int c = 0; c < num_counts; c++) {
+                int n = counts[c];
+                cb_error_t err = CB_OK;
+
+                for (int iter = 0; iter < config->iterations && !err; iter++) {
+                    err = measure(ctx, (cb_barrier_algo_t)algo,
+                                  (cb_wait_policy_t)policy, n,
+                                  (uint32_t)config->barrier_episodes,
+                                  &times[iter]);
+                }
+
+                if (err && err != CB_ERR_PLATFORM) {
+                    return err;
+                }
+
+                if (cb_table_add_row(table)) {
+                    return CB_ERR_ALLOC;
+                }
+                cb_table_set(table, 0, "%s", cb_barrier_algo_name((cb_barrier_algo_t)algo));
+                cb_table_set(table, 1, "%s", policy_name);
+                cb_table_set(table, 2, "%s", variant);
+                cb_table_set(table, 3, "%d", n);
+                cb_table_set(table, 4, "%s", n > cores ? "yes" : "no");
+
+                if (err == CB_ERR_PLATFORM) {
+                    for (int col = 5; col < 9; col++) {
+                        cb_table_set(table, col, "n/a");
+                    }
+                    continue;
+                }
+
+                cb_bench_stats_t stats;
+                cb_stats_compute(times, config->iterations, &stats);
+
+                cb_table_set(table, 5, "%.1f", stats.mean_sec * 1e9);
+                cb_table_set(table, 6, "%.1f", stats.stddev_sec * 1e9);
+                cb_table_set(table, 7, "%.0f",
+                             stats.mean_sec > 0.0 ? 1.0 / stats.mean_sec : 0.0);
+                cb_table_set(table, 8, "%.0f",
+                             stats.min_sec > 0.0 ? 1.0 / stats.min_sec : 0.0);
+
+                if (config->verbose) {
+                    fprintf(stdout, "  %s/%s %s x%d: %.0f episodes/s\n",
+                            cb_barrier_algo_name((cb_barrier_algo_t)algo),
+                            policy_name, variant, n,
+                            stats.mean_sec > 0.0 ? 1.0 / stats.mean_sec : 0.0);
+                }
+            }
+        }
+    }
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_barrier_run(const cb_config_t *config,
+                                cb_table_t **table_out)
+{
+    static const char *const headers[] = {
+        "Algorithm", "Policy", "Variant", "Workers", "Oversub",
+        "Mean (ns/ep)", "Stddev (ns)", "Episodes/s", "Best ep/s"
+    };
+
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    barrier_ctx_t ctx;
+    double *times = NULL;
+    barrier_arena_t *heap_arena = NULL;
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+
+    if (!config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&shm, 0, sizeof(shm));
+
+    err = cb_table_create(&table, "barrier",
+                          "Barrier Suite (episodes per second)", headers, 9);
+    if (err) {
+        return err;
+    }
+
+    ctx.parts   = calloc(CB_MAX_WORKERS, sizeof(participant_t));
+    ctx.threads = calloc(CB_MAX_WORKERS, sizeof(cb_thread_t));
+    ctx.procs   = calloc(CB_MAX_WORKERS, sizeof(cb_process_t));
+    times       = calloc((size_t)config->iterations, sizeof(double));
+    heap_arena  = cb_aligned_alloc(CB_CACHE_LINE, sizeof(barrier_arena_t));
+
+    if (!ctx.parts || !ctx.threads || !ctx.procs || !times || !heap_arena) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+    memset(heap_arena, 0, sizeof(*heap_arena));
+
+    int cores = cb_cpu_budget();
+    int counts[16];
+    int num_counts = build_worker_counts(cores, counts);
+
+    /* Thread variant: arena on the heap. */
+    ctx.arena = heap_arena;
+    ctx.use_procs = false;
+    err = sweep_variant(&ctx, config, counts, num_counts, cores, times, table);
+    if (err) {
+        goto cleanup;
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    /* Process variant: arena in shared memory, inherited across fork(). */
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_barrier_%u",
+             cb_process_self_id());
+
+    err = cb_shared_mem_create(&shm, shm_name, sizeof(barrier_arena_t));
+    if (err) {
+        goto cleanup;
+    }
+    shm_created = true;
+
+    ctx.arena = cb_shared_mem_ptr(&shm);
+    ctx.use_procs = true;
+    err = sweep_variant(&ctx, config, counts, num_counts, cores, times, table);
+    if (err) {
+        goto cleanup;
+    }
+#else
+    cb_table_add_note(table, "Process variants require fork() and are "
+                      "not available on this platform.");
+#endif
+
+    cb_table_add_note(table, "Oversubscribed rows run more participants "
+                      "than the CPU budget of %d.", cores);
+    cb_table_add_note(table, "spin-futex spins %d times before sleeping; "
+                      "block sleeps as soon as the flag is unset.",
+                      CB_BARRIER_SPIN_LIMIT);
+    cb_table_add_note(table, "Each measurement stops after %d episodes or "
+                      "%.2fs, whichever comes first.",
+                      config->barrier_episodes, CB_BARRIER_BUDGET_SEC);
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+    cb_aligned_free(heap_arena);
+    free(ctx.parts);
+    free(ctx.threads);
+    free(ctx.procs);
+    free(times);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file bench_barrier.h
+ * @brief Barrier algorithm suite for concur-bench.
+ *
+ * Measures barrier episodes per second for every combination of
+ * algorithm (central, dissemination, tournament, pthread), wait policy
+ * (spin, spin-futex, block), and placement (threads sharing heap memory,
+ * or forked processes sharing a cb_shared_mem_t region), across a sweep
+ * of participant counts that includes oversubscribed configurations.
+ */
+
+#ifndef CB_BENCH_BARRIER_H
+#define CB_BENCH_BARRIER_H
+
+#include "error.h"
+#include "types.h"
+
+/** @brief Episodes between stop-condition checks (must be >= 2). */
+#define CB_BARRIER_BATCH        32
+
+/** @brief Wall-clock budget per measurement before stopping early (seconds). */
+#define CB_BARRIER_BUDGET_SEC   0.2
+
+/**
+ * @brief Run the barrier suite and produce a result table.
+ *
+ * Participant counts sweep powers of two from 2 up to the CPU budget
+ * (cb_cpu_budget()), the budget itself, and twice it (oversubscribed),
+ * capped at CB_MAX_WORKERS. Each point runs config->iterations
+ * measurements of up to config->barrier_episodes episodes, each stopped
+ * early after CB_BARRIER_BUDGET_SEC so that oversubscribed spin barriers
+ * remain tractable.
+ *
+ * Process-shared variants are only available on Unix; combinations the
+ * platform cannot provide are reported as "n/a".
+ *
+ * @param config     Benchmark configuration (reads iterations,
+ *                   barrier_episodes, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD, CB_ERR_FORK,
+ *         CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_barrier_run(const cb_config_t *config,
+                                cb_table_t **table_out);
+
+#endif /* CB_BENCH_BARRIER_H */
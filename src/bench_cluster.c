@@ -0,0 +1,496 @@
+/**
+ * @file bench_cluster.c
+ * @brief Implementation of the cluster-mode coordinator.
+ *
+ * Each round, one coordinator thread per node sends that node its JOB
+ * and waits for the RESULT, timing the round trip on its own; the
+ * round's wall time runs from the first send to the last reply. Per
+ * node, the round trip is split as
+ *
+ *     round trip = coordinator (de)serialization + network + node busy
+ *     node busy  = node (de)serialization + compute + thread start/join
+ *
+ * so network time is what remains after the coordinator subtracts the
+ * node's busy time and its own encode/decode time. Nodes keep their
+ * partition between rounds; its generation time comes from the warm-up
+ * round, which is not timed.
+ *
+ * The coordinator also generates the whole array with the same
+ * counter-based generator, to check every partial sum and to time a
+ * local threaded sum of the same data as the baseline.
+ */
+
+#include "bench_cluster.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cluster.h"
+#include "dataset.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define CLUSTER_COLS 10
+
+/** @brief How long the coordinator waits for each node to connect. */
+#define CLUSTER_ACCEPT_MS 60000
+
+/** @brief Loopback address of nodes spawned with --cluster-local. */
+#define CLUSTER_LOCAL_HOST "127.0.0.1"
+
+/**
+ * @brief Coordinator-side state of one node.
+ */
+typedef struct {
+    cb_socket_t         sock;          /**< Connection to the node. */
+    char                host[64];      /**< Peer address. */
+    cb_cluster_hello_t  hello;         /**< Node introduction. */
+    cb_cluster_msg_t    job;           /**< JOB of the current round. */
+    cb_cluster_result_t result;        /**< RESULT of the current round. */
+    long int            expected;      /**< Correct partial sum. */
+    double              rtt;           /**< Round trip of this round. */
+    double              serialize;     /**< Coordinator encode + decode. */
+    cb_error_t          err;           /**< Result of this round. */
+    double              generate_sec;  /**< Partition generation (warm-up). */
+    double              compute_sum;   /**< Accumulated compute time. */
+    double              serialize_sum; /**< Accumulated serialization. */
+    double              network_sum;   /**< Accumulated network time. */
+    double              rtt_sum;       /**< Accumulated round trips. */
+    bool                all_ok;        /**< Every partial sum was correct. */
+} node_t;
+
+/** @brief Thread body: one JOB / RESULT exchange with one node. */
+static void *exchange_fn(void *arg)
+{
+    node_t *nd = (node_t *)arg;
+    cb_cluster_msg_t reply;
+    double enc = 0.0, dec = 0.0;
+
+    double t_start = cb_time_now();
+    nd->err = cb_cluster_send(&nd->sock, &nd->job, &enc);
+    if (!nd->err) {
+        nd->err = cb_cluster_recv(&nd->sock, &reply, &dec);
+    }
+    nd->rtt = cb_time_now() - t_start;
+    nd->serialize = enc + dec;
+
+    if (!nd->err && (reply.type != CB_CLUSTER_RESULT ||
+                     reply.u.result.iteration != nd->job.u.job.iteration)) {
+        nd->err = CB_ERR_NET;
+    }
+    if (!nd->err) {
+        nd->result = reply.u.result;
+    }
+    return NULL;
+}
+
+/** @brief Run one round on all nodes; @p wall is first send to last reply. */
+static cb_error_t run_round(node_t *nodes, int count, cb_thread_t *threads,
+                            uint32_t iteration, double *wall)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    for (int i = 0; i < count; i++) {
+        nodes[i].job.u.job.iteration = iteration;
+    }
+
+    double t_start = cb_time_now();
+    for (int i = 0; i < count; i++) {
+        err = cb_thread_create(&threads[i], exchange_fn, &nodes[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+    *wall = cb_time_now() - t_start;
+
+    for (int i = 0; i < created && !err; i++) {
+        err = nodes[i].err;
+    }
+    return err;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child entry point of a --cluster-local node. */
+static void node_child_fn(void *arg)
+{
+    _Exit(cb_cluster_node_main(CLUSTER_LOCAL_HOST, *(const int *)arg, false));
+}
+#endif
+
+/** @brief Spawn @p count nodes on this host that connect to @p port. */
+static cb_error_t spawn_local_nodes(cb_process_t *procs, int count,
+                                   int *port, int *spawned)
+{
+    cb_error_t err = CB_OK;
+#ifdef CB_PLATFORM_UNIX
+    for (int i = 0; i < count; i++) {
+        err = cb_process_spawn(&procs[i], NULL, node_child_fn, port);
+        if (err) {
+            break;
+        }
+        (*spawned)++;
+    }
+#else
+    char exe_path[CB_MAX_PATH];
+    char endpoint[64];
+
+    err = cb_get_exe_path(exe_path, sizeof(exe_path));
+    if (err) {
+        return err;
+    }
+    snprintf(endpoint, sizeof(endpoint), "%s:%d", CLUSTER_LOCAL_HOST, *port);
+    for (int i = 0; i < count; i++) {
+        const char *child_argv[] = {
+            exe_path, "--cluster-worker", endpoint, NULL
+        };
+        err = cb_process_spawn(&procs[i], child_argv, NULL, NULL);
+        if (err) {
+            break;
+        }
+        (*spawned)++;
+    }
+#endif
+    return err;
+}
+
+/** @brief Append one row; NULL text cells print "-". */
+static cb_error_t add_row(cb_table_t *table, const char *node,
+                          const char *host, long long elements, int threads,
+                          double generate, double compute,
+                          const double *serialize, const double *network,
+                          double wall, bool ok)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    cb_table_set(table, 0, "%s", node);
+    cb_table_set(table, 1, "%s", host);
+    cb_table_set(table, 2, "%lld", elements);
+    cb_table_set(table, 3, "%d", threads);
+    cb_table_set(table, 4, "%.6f", generate);
+    cb_table_set(table, 5, "%.6f", compute);
+    if (serialize) {
+        cb_table_set(table, 6, "%.1f", *serialize * 1e6);
+    } else {
+        cb_table_set(table, 6, "-");
+    }
+    if (network) {
+        cb_table_set(table, 7, "%.1f", *network * 1e6);
+    } else {
+        cb_table_set(table, 7, "-");
+    }
+    cb_table_set(table, 8, "%.6f", wall);
+    cb_table_set(table, 9, "%s", ok ? "PASS" : "FAIL");
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_cluster_run(const cb_config_t *config,
+                                cb_table_t **table_out)
+{
+    static const char *const headers[CLUSTER_COLS] = {
+        "Node", "Host", "Elements", "Threads", "Generate (s)", "Compute (s)",
+        "Serialize (us)", "Network (us)", "Wall (s)", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    cb_socket_t listener;
+    bool listening = false;
+    node_t *nodes = NULL;
+    cb_thread_t *threads = NULL;
+    cb_process_t *procs = NULL;
+    int *data = NULL;
+    double *walls = NULL, *local_times = NULL;
+    int spawned = 0, connected = 0;
+
+    if (!config || !table_out || config->cluster_nodes < 1 ||
+        config->cluster_nodes > CB_CLUSTER_MAX_NODES) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+    memset(&listener, 0, sizeof(listener));
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    int count = config->cluster_nodes;
+    bool local = config->cluster_local;
+    int port = config->cluster_port ? config->cluster_port :
+               (local ? 0 : CB_DEFAULT_CLUSTER_PORT);
+
+    err = cb_table_create(&table, "cluster", "Cluster Mode: Coordinator and "
+                          "Nodes over TCP", headers, CLUSTER_COLS);
+    if (err) {
+        return err;
+    }
+
+    nodes       = calloc((size_t)count, sizeof(node_t));
+    threads     = calloc((size_t)count, sizeof(cb_thread_t));
+    procs       = calloc((size_t)count, sizeof(cb_process_t));
+    data        = malloc((size_t)n * sizeof(int));
+    walls       = calloc((size_t)config->iterations, sizeof(double));
+    local_times = calloc((size_t)config->iterations, sizeof(double));
+    if (!nodes || !threads || !procs || !data || !walls || !local_times) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* ---- Local baseline over the same counter-based data ---- */
+    double t_gen = cb_time_now();
+    cb_dataset_fill_range(config->seed, 0, n, data);
+    double local_generate = cb_time_now() - t_gen;
+
+    long int expected = 0;
+    for (int i = 0; i < n; i++) {
+        expected += data[i];
+    }
+
+    bool local_ok = true;
+    for (int iter = 0; iter < config->iterations; iter++) {
+        long int sum = 0;
+        double compute = 0.0;
+        double t_start = cb_time_now();
+        err = cb_cluster_sum(data, n, m, &sum, &compute);
+        local_times[iter] = cb_time_now() - t_start;
+        if (err) {
+            goto cleanup;
+        }
+        if (sum != expected) {
+            local_ok = false;
+        }
+    }
+
+    /* ---- Connect the nodes ---- */
+    err = cb_socket_listen(&listener, local ? CLUSTER_LOCAL_HOST : NULL,
+                           port, &port);
+    if (err) {
+        goto cleanup;
+    }
+    listening = true;
+
+    if (local) {
+        err = spawn_local_nodes(procs, count, &port, &spawned);
+        if (err) {
+            goto cleanup;
+        }
+    } else {
+        fprintf(stdout, "  Waiting for %d cluster node%s on port %d "
+                "(--cluster-worker <host>:%d)...\n", count,
+                count == 1 ? "" : "s", port, port);
+        fflush(stdout);
+    }
+
+    for (int i = 0; i < count; i++) {
+        cb_cluster_msg_t hello;
+        err = cb_socket_accept(&listener, &nodes[i].sock, CLUSTER_ACCEPT_MS,
+                               nodes[i].host, sizeof(nodes[i].host));
+        if (err) {
+            goto cleanup;
+        }
+        connected++;
+        err = cb_cluster_recv(&nodes[i].sock, &hello, NULL);
+        if (!err && (hello.type != CB_CLUSTER_HELLO ||
+                     hello.u.hello.version != CB_CLUSTER_VERSION)) {
+            err = CB_ERR_NET;
+        }
+        if (err) {
+            goto cleanup;
+        }
+        nodes[i].hello = hello.u.hello;
+        if (config->verbose) {
+            fprintf(stdout, "  cluster node %d: %s (pid %u, CPU budget %u)\n",
+                    i, nodes[i].host, hello.u.hello.pid,
+                    hello.u.hello.budget);
+        }
+    }
+
+    /* ---- Partition: the first n % count nodes get one extra element ---- */
+    int base_len = n / count, remainder = n % count;
+    long long offset = 0;
+    for (int i = 0; i < count; i++) {
+        node_t *nd = &nodes[i];
+        int length = base_len + (i < remainder ? 1 : 0);
+
+        nd->job.type = CB_CLUSTER_JOB;
+        nd->job.u.job.seed = config->seed;
+        nd->job.u.job.threads = (uint32_t)m;
+        nd->job.u.job.length = (uint32_t)length;
+        nd->job.u.job.first = (uint64_t)offset;
+        nd->expected = 0;
+        for (int k = 0; k < length; k++) {
+            nd->expected += data[offset + k];
+        }
+        nd->all_ok = true;
+        offset += length;
+    }
+
+    /* ---- Warm-up: nodes generate their partitions ---- */
+    double wall = 0.0;
+    err = run_round(nodes, count, threads, 0, &wall);
+    if (err) {
+        goto cleanup;
+    }
+    for (int i = 0; i < count; i++) {
+        nodes[i].generate_sec = nodes[i].result.generate_ns * 1e-9;
+        if (nodes[i].result.sum != nodes[i].expected) {
+            nodes[i].all_ok = false;
+        }
+    }
+
+    /* ---- Timed rounds ---- */
+    bool cluster_ok = true;
+    double slowest_sum = 0.0;
+    for (int iter = 0; iter < config->iterations; iter++) {
+        err = run_round(nodes, count, threads, (uint32_t)iter + 1,
+                        &walls[iter]);
+        if (err) {
+            goto cleanup;
+        }
+
+        long int total = 0;
+        double slowest = 0.0;
+        for (int i = 0; i < count; i++) {
+            node_t *nd = &nodes[i];
+            const cb_cluster_result_t *r = &nd->result;
+            double compute = r->compute_ns * 1e-9;
+            double network = nd->rtt - r->busy_ns * 1e-9 - nd->serialize;
+
+            total += (long int)r->sum;
+            if (r->sum != nd->expected) {
+                nd->all_ok = false;
+            }
+            nd->compute_sum += compute;
+            nd->serialize_sum += nd->serialize + r->serialize_ns * 1e-9;
+            nd->network_sum += network > 0.0 ? network : 0.0;
+            nd->rtt_sum += nd->rtt;
+            slowest = compute > slowest ? compute : slowest;
+        }
+        slowest_sum += slowest;
+        if (total != expected) {
+            cluster_ok = false;
+        }
+
+        if (config->verbose) {
+            fprintf(stdout, "  cluster iteration %d/%d: sum=%ld (%.6fs)\n",
+                    iter + 1, config->iterations, total, walls[iter]);
+        }
+    }
+
+    /* ---- Rows ---- */
+    cb_bench_stats_t local_stats, wall_stats;
+    err = cb_stats_compute(local_times, config->iterations, &local_stats);
+    if (!err) {
+        err = cb_stats_compute(walls, config->iterations, &wall_stats);
+    }
+    if (!err) {
+        err = add_row(table, "local", "coordinator", n, m < n ? m : n,
+                      local_generate, local_stats.mean_sec, NULL, NULL,
+                      local_stats.mean_sec, local_ok);
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    double iters = (double)config->iterations;
+    int total_threads = 0;
+    double generate_max = 0.0;
+    for (int i = 0; i < count; i++) {
+        node_t *nd = &nodes[i];
+        char label[16];
+        double serialize = nd->serialize_sum / iters;
+        double network = nd->network_sum / iters;
+
+        snprintf(label, sizeof(label), "node %d", i);
+        err = add_row(table, label, nd->host, (long long)nd->job.u.job.length,
+                      (int)nd->result.threads, nd->generate_sec,
+                      nd->compute_sum / iters, &serialize, &network,
+                      nd->rtt_sum / iters, nd->all_ok);
+        if (err) {
+            goto cleanup;
+        }
+        total_threads += (int)nd->result.threads;
+        generate_max = nd->generate_sec > generate_max ? nd->generate_sec
+                                                       : generate_max;
+        cluster_ok = cluster_ok && nd->all_ok;
+    }
+
+    err = add_row(table, "cluster", "-", n, total_threads, generate_max,
+                  slowest_sum / iters, NULL, NULL, wall_stats.mean_sec,
+                  cluster_ok);
+    if (err) {
+        goto cleanup;
+    }
+
+    double overhead = wall_stats.mean_sec - local_stats.mean_sec;
+    cb_table_add_note(table, "Partitioning overhead: cluster wall %.6f s vs "
+                      "local %.6f s (%+.6f s, %+.1f%%).",
+                      wall_stats.mean_sec, local_stats.mean_sec, overhead,
+                      local_stats.mean_sec > 0.0
+                          ? 100.0 * overhead / local_stats.mean_sec : 0.0);
+    cb_table_add_note(table, "Node wall is the round trip; network is the "
+                      "round trip minus node busy time and coordinator "
+                      "(de)serialization.");
+    cb_table_add_note(table, "Node busy time beyond compute and "
+                      "serialization is thread start-up and join.");
+    cb_table_add_note(table, "Cluster compute is the slowest node per round. "
+                      "Messages: JOB %zu bytes, RESULT %zu bytes; no "
+                      "dataset bytes cross the network.",
+                      cb_cluster_wire_size(CB_CLUSTER_JOB),
+                      cb_cluster_wire_size(CB_CLUSTER_RESULT));
+    cb_table_add_note(table, "Data: counter-based generator, seed %u, "
+                      "generated per partition by each node (not the main "
+                      "dataset).", config->seed);
+    if (local) {
+        cb_table_add_note(table, "--cluster-local: %d node process%s on "
+                          "%s:%d share this host with the coordinator.",
+                          count, count == 1 ? "" : "es", CLUSTER_LOCAL_HOST,
+                          port);
+    }
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    for (int i = 0; i < connected; i++) {
+        if (!err) {
+            cb_cluster_msg_t bye;
+            memset(&bye, 0, sizeof(bye));
+            bye.type = CB_CLUSTER_BYE;
+            cb_cluster_send(&nodes[i].sock, &bye, NULL);
+        }
+        cb_socket_close(&nodes[i].sock);
+    }
+    if (listening) {
+        cb_socket_close(&listener);
+    }
+    for (int i = 0; i < spawned; i++) {
+        int status = 0;
+        if (err) {
+            /* A node that never connected would keep retrying. */
+            cb_process_kill(&procs[i]);
+        }
+        cb_process_wait(&procs[i], &status);
+    }
+    free(nodes);
+    free(threads);
+    free(procs);
+    free(data);
+    free(walls);
+    free(local_times);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file bench_cluster.h
+ * @brief Cluster mode: a coordinator and worker nodes over TCP.
+ *
+ * The coordinator splits the array into one contiguous partition per
+ * node and sends each node a JOB over its TCP connection (cluster.h).
+ * Nodes generate their partition from the seed, sum it with threads
+ * and reply with the partial sum and their own timings, from which the
+ * coordinator separates compute, serialization and network time per
+ * node. A local threaded sum of the same data shows what partitioning
+ * across nodes costs.
+ *
+ * Nodes are started with --cluster-worker <host:port> on any machine,
+ * or spawned by the coordinator on 127.0.0.1 with --cluster-local.
+ */
+
+#ifndef CB_BENCH_CLUSTER_H
+#define CB_BENCH_CLUSTER_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Coordinate a cluster run and produce a result table.
+ *
+ * Waits for config->cluster_nodes nodes (spawning them first when
+ * config->cluster_local is set), runs one untimed warm-up job that
+ * also makes every node generate its partition, then
+ * config->iterations timed rounds, and finally sends BYE.
+ *
+ * @param config     Benchmark configuration (reads array_length, seed,
+ *                   num_threads, iterations, cluster_nodes,
+ *                   cluster_port, cluster_local, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_FORK, CB_ERR_NET, CB_ERR_TIMEOUT on failure.
+ */
+cb_error_t cb_bench_cluster_run(const cb_config_t *config,
+                                cb_table_t **table_out);
+
+#endif /* CB_BENCH_CLUSTER_H */
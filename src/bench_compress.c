@@ -0,0 +1,295 @@
+/**
+ * @file bench_compress.c
+ * @brief Implementation of the compressed-scan suite.
+ *
+ * Each encoding is built once, before any timing. Thread counts run in
+ * powers of two up to config->num_threads (always included); at each
+ * count every encoding is summed, split statically on block
+ * boundaries. Workers are created before the clock starts and released
+ * through a start gate, as in the prefetch sweep, so a row times the
+ * scan and the join only.
+ *
+ * An encoding that cannot hold the data (a value outside 0 - 127 for
+ * pack7, 0 - 255 for u8) is skipped with a note.
+ */
+
+#include "bench_compress.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "barrier.h"
+#include "encoding.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define COMPRESS_COLS 8
+
+/**
+ * @brief State shared by the threads of one run.
+ */
+typedef struct {
+    const cb_encoded_t *enc;     /**< Encoded dataset. */
+    const int          *bounds;  /**< workers + 1 block boundaries. */
+    atomic_long         total;   /**< Sum of all partials. */
+    cb_start_gate_t     gate;    /**< Start gate. */
+} compress_shared_t;
+
+/**
+ * @brief Per-thread argument.
+ */
+typedef struct {
+    compress_shared_t *shared;  /**< Shared run state. */
+    int                id;      /**< Worker index. */
+} compress_arg_t;
+
+/** @brief Thread body: wait for the gate, sum the blocks. */
+static void *compress_thread_fn(void *arg)
+{
+    compress_arg_t *a = (compress_arg_t *)arg;
+    compress_shared_t *s = a->shared;
+
+    if (!cb_start_gate_wait(&s->gate)) {
+        return NULL;
+    }
+
+    long int partial = cb_encoding_sum(s->enc, s->bounds[a->id],
+                                       s->bounds[a->id + 1]);
+    atomic_fetch_add(&s->total, partial);
+    return NULL;
+}
+
+/** @brief Run one timed sum on @p workers threads. */
+static cb_error_t run_once(compress_shared_t *s, int workers,
+                           cb_thread_t *threads, compress_arg_t *args,
+                           double *elapsed)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    atomic_store(&s->total, 0);
+    cb_start_gate_init(&s->gate);
+
+    for (int i = 0; i < workers; i++) {
+        args[i].shared = s;
+        args[i].id = i;
+        err = cb_thread_create(&threads[i], compress_thread_fn, &args[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    double t_start = cb_time_now();
+    if (err) {
+        cb_start_gate_abort(&s->gate);
+    } else {
+        cb_start_gate_open(&s->gate);
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+    *elapsed = cb_time_now() - t_start;
+
+    return err;
+}
+
+/** @brief Fill workers + 1 boundaries over @p n blocks. */
+static void split(int *bounds, int n, int workers)
+{
+    int base_len = n / workers, remainder = n % workers;
+    bounds[0] = 0;
+    for (int i = 0; i < workers; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+}
+
+/** @brief Append one row; @p base_mean is 0 for the reference row. */
+static cb_error_t add_row(cb_table_t *table, const cb_encoded_t *enc,
+                          int workers, const cb_bench_stats_t *stats,
+                          double base_mean, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = stats->mean_sec;
+    cb_table_set(table, 0, "%s", cb_encoding_name(enc->encoding));
+    cb_table_set(table, 1, "%d", workers);
+    cb_table_set(table, 2, "%.3f", (double)enc->bytes / enc->length);
+    cb_table_set(table, 3, "%.6f", mean);
+    cb_table_set(table, 4, "%.1f",
+                 mean > 0.0 ? (double)enc->length / mean / 1e6 : 0.0);
+    cb_table_set(table, 5, "%.2f",
+                 mean > 0.0 ? (double)enc->bytes / mean / 1e9 : 0.0);
+    if (base_mean > 0.0 && mean > 0.0) {
+        cb_table_set(table, 6, "%.2fx", base_mean / mean);
+    } else {
+        cb_table_set(table, 6, "baseline");
+    }
+    cb_table_set(table, 7, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_compress_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out)
+{
+    static const char *const headers[COMPRESS_COLS] = {
+        "Encoding", "Threads", "Bytes/elem", "Mean (s)", "Melem/s",
+        "GB/s", "vs int32", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    cb_encoded_t encs[CB_ENCODING_COUNT];
+    bool have[CB_ENCODING_COUNT] = {false};
+    double encode_sec[CB_ENCODING_COUNT] = {0.0};
+    int *bounds = NULL;
+    double *times = NULL;
+    cb_thread_t *threads = NULL;
+    compress_arg_t *args = NULL;
+    compress_shared_t *shared = NULL;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+
+    err = cb_table_create(&table, "compress",
+                          "Compressed Scan: Fused Decode and Sum",
+                          headers, COMPRESS_COLS);
+    if (err) {
+        return err;
+    }
+
+    bounds  = calloc((size_t)m + 1, sizeof(int));
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    threads = calloc((size_t)m, sizeof(cb_thread_t));
+    args    = calloc((size_t)m, sizeof(compress_arg_t));
+    shared  = calloc(1, sizeof(compress_shared_t));
+    if (!bounds || !times || !threads || !args || !shared) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    for (int e = 0; e < CB_ENCODING_COUNT; e++) {
+        double t_start = cb_time_now();
+        cb_error_t enc_err = cb_encoding_create(&encs[e], dataset, n,
+                                                (cb_encoding_t)e);
+        encode_sec[e] = cb_time_now() - t_start;
+        if (enc_err == CB_ERR_OVERFLOW) {
+            cb_table_add_note(table, "%s skipped: the dataset has values "
+                              "outside its range.",
+                              cb_encoding_name((cb_encoding_t)e));
+            continue;
+        }
+        if (enc_err) {
+            err = enc_err;
+            goto cleanup;
+        }
+        have[e] = true;
+    }
+
+    long int expected = cb_encoding_sum(&encs[CB_ENCODING_INT32], 0,
+                                        encs[CB_ENCODING_INT32].blocks);
+    int blocks = encs[CB_ENCODING_INT32].blocks;
+
+    for (int workers = 1; workers <= m;
+         workers = (workers < m && workers * 2 > m) ? m : workers * 2) {
+        /* More threads than blocks would leave some without work. */
+        int active = workers < blocks ? workers : blocks;
+        double base_mean = 0.0;
+
+        split(bounds, blocks, active);
+        shared->bounds = bounds;
+
+        for (int e = 0; e < CB_ENCODING_COUNT; e++) {
+            if (!have[e]) {
+                continue;
+            }
+
+            bool all_ok = true;
+            shared->enc = &encs[e];
+
+            for (int iter = 0; iter < config->iterations; iter++) {
+                err = run_once(shared, active, threads, args, &times[iter]);
+                if (err) {
+                    goto cleanup;
+                }
+                if (atomic_load(&shared->total) != expected) {
+                    all_ok = false;
+                }
+                if (config->verbose) {
+                    fprintf(stdout, "  compress %s %d thread%s iteration "
+                            "%d/%d: %.6fs\n",
+                            cb_encoding_name((cb_encoding_t)e), active,
+                            active == 1 ? "" : "s", iter + 1,
+                            config->iterations, times[iter]);
+                }
+            }
+
+            cb_bench_stats_t stats;
+            err = cb_stats_compute(times, config->iterations, &stats);
+            if (!err) {
+                err = add_row(table, &encs[e], active, &stats,
+                              e == CB_ENCODING_INT32 ? 0.0 : base_mean,
+                              all_ok ? "PASS" : "FAIL");
+            }
+            if (err) {
+                goto cleanup;
+            }
+            if (e == CB_ENCODING_INT32) {
+                base_mean = stats.mean_sec;
+            }
+        }
+
+        if (workers >= blocks) {
+            break;
+        }
+    }
+
+    for (int e = 0; e < CB_ENCODING_COUNT; e++) {
+        if (have[e]) {
+            cb_table_add_note(table, "%s: %.1f MiB, encoded in %.3f s.",
+                              cb_encoding_name((cb_encoding_t)e),
+                              (double)encs[e].bytes / (1024.0 * 1024.0),
+                              encode_sec[e]);
+        }
+    }
+    cb_table_add_note(table, "GB/s is encoded bytes read; Melem/s is the "
+                      "effective scan rate. Compression pays while the "
+                      "scan is memory-bound, until decoding is the limit.");
+    cb_table_add_note(table, "Bytes/elem includes FOR block headers "
+                      "(base, width, offset per %d elements).",
+                      CB_ENCODING_BLOCK);
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    for (int e = 0; e < CB_ENCODING_COUNT; e++) {
+        if (have[e]) {
+            cb_encoding_destroy(&encs[e]);
+        }
+    }
+    free(bounds);
+    free(times);
+    free(threads);
+    free(args);
+    free(shared);
+    cb_table_destroy(table);
+    return err;
+}
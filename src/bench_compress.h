@@ -0,0 +1,31 @@
+/**
+ * @file bench_compress.h
+ * @brief Parallel scan over compressed dataset encodings.
+ *
+ * Encodes the dataset with every representation in encoding.h (32-bit
+ * reference, 8-bit, 7-bit packed, frame of reference) and sums each
+ * one with its fused decode-and-sum kernel at several thread counts.
+ * Rows report bytes per element, effective elements/s and the encoded
+ * bandwidth actually consumed, showing how far compression lifts a
+ * bandwidth-bound scan and where decoding becomes the limit.
+ */
+
+#ifndef CB_BENCH_COMPRESS_H
+#define CB_BENCH_COMPRESS_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the compressed-scan suite and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD on failure.
+ */
+cb_error_t cb_bench_compress_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out);
+
+#endif /* CB_BENCH_COMPRESS_H */
@@ -0,0 +1,488 @@
+/**
+ * @file bench_copy.c
+ * @brief Implementation of the copy suite.
+ *
+ * For each thread count the suite starts a phase pool (pool.h; the
+ * main thread is worker 0). In a setup phase every worker
+ * allocates its own page-aligned source and destination, sized for
+ * the largest copy of that thread count plus the alignment offsets,
+ * and fills the source, so its pages are first touched by their user.
+ * A sample is one run phase: every worker does Reps back-to-back calls
+ * on its buffers, and the main thread times the phase from releasing
+ * the workers to the last one arriving, so barrier cost is amortized
+ * over Reps. Each method gets one untimed warm-up sample and then
+ * iterations samples.
+ *
+ * After the samples a check phase has every worker compare its
+ * destination with the source (or the fill value) and clear it, so the
+ * next method must rewrite all of it.
+ *
+ * The fastest method of the first size wins it outright. At each larger
+ * size the previous winner keeps the title unless another method is
+ * faster by more than COPY_MARGIN and by more than both stddevs, so
+ * noise between close methods does not show up as a threshold.
+ */
+
+#include "bench_copy.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "copy.h"
+#include "platform.h"
+#include "pool.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define COPY_COLS (6 + CB_COPY_METHOD_COUNT)
+
+/** @brief Smallest size, in bytes. */
+#define COPY_MIN_BYTES 64
+
+/** @brief Bytes per worker per sample that pick Reps for small sizes. */
+#define COPY_SAMPLE_BYTES ((size_t)64 << 20)
+
+/** @brief Upper bound on calls per sample. */
+#define COPY_MAX_REPS 65536
+
+/** @brief Sizes per thread count (64 B x 4^k up to 16 GiB fits). */
+#define COPY_MAX_SIZES 24
+
+/** @brief Buffer alignment before the offsets are applied. */
+#define COPY_PAGE 4096
+
+/** @brief Relative lead a method needs to take over from the previous winner. */
+#define COPY_MARGIN 0.05
+
+/** @brief Value written by the fill operation. */
+#define COPY_FILL_VALUE 0xA5
+
+/** @brief Operations, in table order within each thread count. */
+typedef enum {
+    OP_COPY = 0,
+    OP_FILL,
+    OP_COUNT
+} copy_op_t;
+
+/** @brief Operation labels indexed by copy_op_t. */
+static const char *const OP_NAMES[OP_COUNT] = { "copy", "set" };
+
+/** @brief Pool phases. */
+enum {
+    PHASE_SETUP = 0, /**< Allocate and fill the buffers. */
+    PHASE_RUN,       /**< Reps calls of the current job. */
+    PHASE_CHECK,     /**< Verify and clear the destination. */
+    PHASE_FREE       /**< Release the buffers. */
+};
+
+/**
+ * @brief One worker's buffers and flags, padded to their own line.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) unsigned char *src;  /**< Source buffer. */
+    unsigned char *dst;     /**< Destination buffer. */
+    bool           failed;  /**< Setup could not allocate. */
+    bool           ok;      /**< Last check passed. */
+} copy_slot_t;
+
+/**
+ * @brief State shared by the pool's workers.
+ */
+typedef struct {
+    copy_slot_t     *slots;      /**< One per worker. */
+    size_t           capacity;   /**< Largest size for this pool. */
+    int              src_align;  /**< Source offset from a page. */
+    int              dst_align;  /**< Destination offset from a page. */
+    copy_op_t        op;         /**< Job: operation. */
+    cb_copy_method_t method;     /**< Job: method. */
+    size_t           size;       /**< Job: bytes per call. */
+    int              reps;       /**< Job: calls per sample. */
+} copy_job_t;
+
+/** @brief Format a byte count as "64 B", "4 KiB", "16 MiB", "1 GiB". */
+static void format_size(char *buf, size_t buf_size, size_t bytes)
+{
+    if (bytes >= ((size_t)1 << 30) && bytes % ((size_t)1 << 30) == 0) {
+        snprintf(buf, buf_size, "%zu GiB", bytes >> 30);
+    } else if (bytes >= (1u << 20) && bytes % (1u << 20) == 0) {
+        snprintf(buf, buf_size, "%zu MiB", bytes >> 20);
+    } else if (bytes >= 1024 && bytes % 1024 == 0) {
+        snprintf(buf, buf_size, "%zu KiB", bytes >> 10);
+    } else {
+        snprintf(buf, buf_size, "%zu B", bytes);
+    }
+}
+
+/** @brief Pool step: do worker @p id's part of the current phase. */
+static void copy_step(void *ctx, int id, int phase)
+{
+    copy_job_t *job = (copy_job_t *)ctx;
+    copy_slot_t *slot = &job->slots[id];
+    unsigned char *src = slot->src ? slot->src + job->src_align : NULL;
+    unsigned char *dst = slot->dst ? slot->dst + job->dst_align : NULL;
+
+    switch (phase) {
+    case PHASE_SETUP:
+        slot->src = cb_aligned_alloc(COPY_PAGE, job->capacity + COPY_PAGE);
+        slot->dst = cb_aligned_alloc(COPY_PAGE, job->capacity + COPY_PAGE);
+        slot->failed = !slot->src || !slot->dst;
+        if (!slot->failed) {
+            for (size_t i = 0; i < job->capacity + COPY_PAGE; i++) {
+                slot->src[i] = (unsigned char)(i * 31u + (unsigned)id + 7u);
+            }
+            memset(slot->dst, 0, job->capacity + COPY_PAGE);
+        }
+        break;
+    case PHASE_RUN:
+        for (int r = 0; r < job->reps; r++) {
+            if (job->op == OP_COPY) {
+                cb_copy(job->method, dst, src, job->size);
+            } else {
+                cb_fill(job->method, dst, COPY_FILL_VALUE, job->size);
+            }
+        }
+        break;
+    case PHASE_CHECK:
+        if (job->op == OP_COPY) {
+            slot->ok = memcmp(dst, src, job->size) == 0;
+        } else {
+            slot->ok = true;
+            for (size_t i = 0; i < job->size; i++) {
+                if (dst[i] != COPY_FILL_VALUE) {
+                    slot->ok = false;
+                    break;
+                }
+            }
+        }
+        memset(dst, 0, job->size);
+        break;
+    case PHASE_FREE:
+        cb_aligned_free(slot->src);
+        cb_aligned_free(slot->dst);
+        slot->src = slot->dst = NULL;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Add notes listing where the fastest method changes.
+ *
+ * Lists " <method> to <size>," for each run of one winner, starting a
+ * new note whenever the next entry would not fit. If @p budget notes
+ * are not enough, the last one points to the Best from column instead.
+ *
+ * @param label   Note prefix, e.g. "Fastest copy, 4 threads:".
+ * @param best    Winner per size.
+ * @param sizes   The sizes.
+ * @param count   Number of sizes.
+ * @param budget  Notes that may be added.
+ * @return Number of notes added.
+ */
+static int add_threshold_notes(cb_table_t *table, const char *label,
+                               const int *best, const size_t *sizes,
+                               int count, int budget)
+{
+    static const char more[] = " ... see Best from.";
+    char note[CB_TABLE_NOTE_LEN];
+    int added = 0;
+    int used = snprintf(note, sizeof(note), "%s", label);
+
+    for (int s = 0; s < count && budget > 0; s++) {
+        if (s + 1 < count && best[s + 1] == best[s]) {
+            continue;
+        }
+        char size_text[32], entry[64];
+        format_size(size_text, sizeof(size_text), sizes[s]);
+        int len = snprintf(entry, sizeof(entry), " %s to %s%s",
+                           cb_copy_method_name((cb_copy_method_t)best[s]),
+                           size_text, s + 1 == count ? "." : ",");
+
+        /* Keep room for the pointer to the column on the last note. */
+        int limit = (int)sizeof(note) - 1 -
+                    (added + 1 == budget ? (int)sizeof(more) - 1 : 0);
+        if (used + len > limit) {
+            if (added + 1 == budget) {
+                snprintf(note + used, sizeof(note) - (size_t)used, "%s", more);
+                cb_table_add_note(table, "%s", note);
+                return budget;
+            }
+            cb_table_add_note(table, "%s", note);
+            added++;
+            used = snprintf(note, sizeof(note), "  ...");
+        }
+        used += snprintf(note + used, sizeof(note) - (size_t)used, "%s",
+                         entry);
+    }
+
+    if (budget > 0) {
+        cb_table_add_note(table, "%s", note);
+        added++;
+    }
+    return added;
+}
+
+/**
+ * @brief Measure every operation, size and method with @p workers workers.
+ *
+ * @param best    Output: winner per operation and size.
+ * @param sizes   Output: the sizes measured.
+ * @param count   Output: number of sizes.
+ */
+static cb_error_t run_pool(const cb_config_t *config, int workers,
+                           size_t max_total, cb_table_t *table, double *times,
+                           int best[OP_COUNT][COPY_MAX_SIZES], size_t *sizes,
+                           int *count_out)
+{
+    cb_error_t err = CB_OK;
+    copy_job_t job;
+    cb_pool_t *pool = NULL;
+    bool setup_done = false;
+    int count = 0;
+
+    memset(&job, 0, sizeof(job));
+
+    /* Sizes from 64 B up to this thread count's share of --copy-max. */
+    size_t cap = max_total / (size_t)workers;
+    cap = cap < COPY_MIN_BYTES ? COPY_MIN_BYTES : cap;
+    for (size_t bytes = COPY_MIN_BYTES; count < COPY_MAX_SIZES; ) {
+        sizes[count++] = bytes;
+        if (bytes >= cap) {
+            break;
+        }
+        bytes = bytes * 4 > cap ? cap : bytes * 4;
+    }
+    *count_out = count;
+
+    job.capacity = sizes[count - 1];
+    job.src_align = config->copy_src_align;
+    job.dst_align = config->copy_dst_align;
+    job.slots = cb_aligned_alloc(CB_CACHE_LINE,
+                                 (size_t)workers * sizeof(copy_slot_t));
+    if (!job.slots) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+    memset(job.slots, 0, (size_t)workers * sizeof(copy_slot_t));
+
+    err = cb_pool_create(&pool, workers, copy_step, &job);
+    if (err) {
+        goto cleanup;
+    }
+
+    cb_pool_run(pool, PHASE_SETUP);
+    setup_done = true;
+    for (int i = 0; i < workers; i++) {
+        if (job.slots[i].failed) {
+            err = CB_ERR_ALLOC;
+            goto cleanup;
+        }
+    }
+
+    for (int op = 0; op < OP_COUNT; op++) {
+        int run_start = 0;
+
+        for (int s = 0; s < count; s++) {
+            size_t per_sample = COPY_SAMPLE_BYTES / sizes[s];
+            double gbps[CB_COPY_METHOD_COUNT] = { 0.0 };
+            double sd[CB_COPY_METHOD_COUNT] = { 0.0 };
+            int leader = CB_COPY_LIBC;
+            bool all_ok = true;
+            char size_text[32];
+
+            job.op = (copy_op_t)op;
+            job.size = sizes[s];
+            job.reps = per_sample < 1 ? 1 :
+                        per_sample > COPY_MAX_REPS ? COPY_MAX_REPS
+                                                   : (int)per_sample;
+            format_size(size_text, sizeof(size_text), sizes[s]);
+
+            err = cb_table_add_row(table);
+            if (err) {
+                goto cleanup;
+            }
+            cb_table_set(table, 0, "%s", OP_NAMES[op]);
+            cb_table_set(table, 1, "%d", workers);
+            cb_table_set(table, 2, "%s", size_text);
+
+            for (int m = 0; m < CB_COPY_METHOD_COUNT; m++) {
+                if (!cb_copy_available((cb_copy_method_t)m)) {
+                    cb_table_set(table, 3 + m, "n/a");
+                    continue;
+                }
+                job.method = (cb_copy_method_t)m;
+
+                cb_pool_run(pool, PHASE_RUN);
+                for (int iter = 0; iter < config->iterations; iter++) {
+                    times[iter] = cb_pool_run(pool, PHASE_RUN) / job.reps;
+                }
+                cb_pool_run(pool, PHASE_CHECK);
+                for (int i = 0; i < workers; i++) {
+                    all_ok = all_ok && job.slots[i].ok;
+                }
+
+                cb_bench_stats_t stats;
+                err = cb_stats_compute(times, config->iterations, &stats);
+                if (err) {
+                    goto cleanup;
+                }
+                if (stats.mean_sec > 0.0) {
+                    gbps[m] = (double)sizes[s] * workers / stats.mean_sec / 1e9;
+                    sd[m] = gbps[m] * stats.stddev_sec / stats.mean_sec;
+                }
+                cb_table_set(table, 3 + m, "%.2f", gbps[m]);
+                if (gbps[m] > gbps[leader]) {
+                    leader = m;
+                }
+
+                if (config->verbose) {
+                    fprintf(stdout, "  copy %s %s x%d %s: %.2f GB/s\n",
+                            OP_NAMES[op], size_text, workers,
+                            cb_copy_method_name((cb_copy_method_t)m), gbps[m]);
+                }
+            }
+
+            /* The previous winner stays unless clearly beaten. */
+            int held = s > 0 ? best[op][s - 1] : leader;
+            if (leader != held &&
+                gbps[leader] > gbps[held] * (1.0 + COPY_MARGIN) &&
+                gbps[leader] - gbps[held] > sd[leader] + sd[held]) {
+                held = leader;
+            }
+            if (s == 0 || held != best[op][s - 1]) {
+                run_start = s;
+            }
+            best[op][s] = held;
+
+            format_size(size_text, sizeof(size_text), sizes[run_start]);
+            cb_table_set(table, 3 + CB_COPY_METHOD_COUNT, "%s",
+                         cb_copy_method_name((cb_copy_method_t)held));
+            cb_table_set(table, 4 + CB_COPY_METHOD_COUNT, "%s", size_text);
+            cb_table_set(table, 5 + CB_COPY_METHOD_COUNT, "%s",
+                         all_ok ? "PASS" : "FAIL");
+        }
+    }
+
+cleanup:
+    if (setup_done) {
+        cb_pool_run(pool, PHASE_FREE);
+    }
+    cb_pool_destroy(pool);
+    cb_aligned_free(job.slots);
+    return err;
+}
+
+cb_error_t cb_bench_copy_run(const cb_config_t *config,
+                             cb_table_t **table_out)
+{
+    static const char *const headers[COPY_COLS] = {
+        "Op", "Threads", "Size", "libc GB/s", "rep GB/s", "avx2 GB/s",
+        "avx512 GB/s", "nt GB/s", "Best", "Best from", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    double *times = NULL;
+
+    if (!config || !table_out || config->num_threads < 1 ||
+        config->num_threads > CB_MAX_WORKERS || config->copy_max_mib < 1 ||
+        config->copy_src_align < 0 || config->copy_src_align >= COPY_PAGE ||
+        config->copy_dst_align < 0 || config->copy_dst_align >= COPY_PAGE) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    err = cb_table_create(&table, "copy", "Copy and Set: libc vs rep vs "
+                          "AVX2 vs AVX-512 vs Non-Temporal", headers,
+                          COPY_COLS);
+    if (err) {
+        return err;
+    }
+
+    times = calloc((size_t)config->iterations, sizeof(double));
+    if (!times) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    int n = config->num_threads;
+    size_t max_total = (size_t)config->copy_max_mib << 20;
+
+    /* Winners of the 1-thread pool [0], the num_threads pool [1], and
+     * scratch [2] for the thread counts in between. */
+    int best[3][OP_COUNT][COPY_MAX_SIZES];
+    size_t sizes[3][COPY_MAX_SIZES];
+    int counts[3] = { 0, 0, 0 };
+
+    /* 1, 2, 4, ... threads, then num_threads itself. */
+    for (int workers = 1; ; workers *= 2) {
+        int w = workers < n ? workers : n;
+        int k = w == n ? 1 : w == 1 ? 0 : 2;
+        err = run_pool(config, w, max_total, table, times, best[k], sizes[k],
+                       &counts[k]);
+        if (err || w == n) {
+            break;
+        }
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    char unavailable[64] = "";
+    size_t used = 0;
+    for (int m = 0; m < CB_COPY_METHOD_COUNT; m++) {
+        if (!cb_copy_available((cb_copy_method_t)m)) {
+            int w = snprintf(unavailable + used, sizeof(unavailable) - used,
+                             "%s%s", used ? ", " : "",
+                             cb_copy_method_name((cb_copy_method_t)m));
+            used += w > 0 ? (size_t)w : 0;
+        }
+    }
+    int notes = 3;
+    cb_table_add_note(table, "GB/s: bytes copied or set per call by all "
+                      "threads together, over the mean call time; a copy "
+                      "moves twice that.");
+    cb_table_add_note(table, "Each thread has its own buffers; sizes stop "
+                      "at %d MiB / threads. Source +%d B, destination +%d B "
+                      "from a page.", config->copy_max_mib,
+                      config->copy_src_align, config->copy_dst_align);
+    cb_table_add_note(table, "Best keeps the previous size's winner unless "
+                      "another method beats it by over %.0f%% and by more "
+                      "than both stddevs; Best from is where that run "
+                      "began.", COPY_MARGIN * 100.0);
+    if (used > 0) {
+        cb_table_add_note(table, "Not available on this build or CPU: %s.",
+                          unavailable);
+        notes++;
+    }
+
+    /* One group per operation for 1 thread and, if different, for n. */
+    int groups = (n > 1 ? 2 : 1) * OP_COUNT;
+    int g = 0;
+    for (int k = n > 1 ? 0 : 1; k < 2; k++) {
+        int workers = k == 0 ? 1 : n;
+        for (int op = 0; op < OP_COUNT; op++, g++) {
+            char label[64];
+            snprintf(label, sizeof(label), "Fastest %s, %d thread%s:",
+                     OP_NAMES[op], workers, workers == 1 ? "" : "s");
+            /* Leave at least one note for each later group; the THROTTLED
+             * warning has its own slot (cb_table_set_warning()). */
+            int budget = CB_TABLE_MAX_NOTES - notes - (groups - g - 1);
+            notes += add_threshold_notes(table, label, best[k][op], sizes[k],
+                                         counts[k], budget);
+        }
+    }
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    free(times);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file bench_copy.h
+ * @brief Copy suite: memcpy / memset strategies across sizes and threads.
+ *
+ * Times every method of copy.h, for both copy and fill, from 64 B up
+ * to --copy-max, with 1, 2, 4, ... up to num_threads threads each
+ * working on its own buffers at the same time. Source and destination
+ * can be offset from a page boundary (--copy-align). Each row reports
+ * every method's aggregate GB/s, the fastest one (which has to win by
+ * a margin to take over from the previous size's) and the size its run
+ * began at, and the notes list the sizes at which it changes.
+ */
+
+#ifndef CB_BENCH_COPY_H
+#define CB_BENCH_COPY_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the copy suite and produce a result table.
+ *
+ * @param config     Benchmark configuration (reads num_threads,
+ *                   iterations, copy_max_mib, copy_src_align,
+ *                   copy_dst_align, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_THREAD
+ *         on failure.
+ */
+cb_error_t cb_bench_copy_run(const cb_config_t *config,
+                             cb_table_t **table_out);
+
+#endif /* CB_BENCH_COPY_H */
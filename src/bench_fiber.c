@@ -0,0 +1,442 @@
+/**
+ * @file bench_fiber.c
+ * @brief Implementation of the fiber execution mode.
+ *
+ * Four measurements, each repeated config->iterations times:
+ * - fiber-sum:     many tasks on config->num_threads scheduler threads,
+ *                  yielding every config->fiber_yield elements.
+ * - thread-sum:    the same slices summed by plain OS threads, one
+ *                  after another, with no fibers and no yields.
+ * - fiber-switch:  two tasks on one thread yielding back and forth.
+ * - thread-switch: two OS threads handing a token back and forth
+ *                  through blocking flag waits.
+ *
+ * Task slices come from the same array_sum kernel as the core modes.
+ * A switch is one transfer of control. A fiber yield is two switches
+ * (task to scheduler and back), and so is each task's first resume
+ * and final return.
+ */
+
+#include "bench_fiber.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "fiber.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+#include "worker.h"
+
+/** @brief Yields per task in the fiber-switch microbenchmark. */
+#define FIBER_SWITCH_ROUNDS   100000
+
+/** @brief Round trips in the thread-switch microbenchmark. */
+#define THREAD_SWITCH_ROUNDS  20000
+
+/** @brief Number of table columns. */
+#define FIBER_COLS 9
+
+/**
+ * @brief Context shared by the sum tasks.
+ */
+typedef struct {
+    const int *dataset;      /**< Input array. */
+    const int *bounds;       /**< num_tasks + 1 slice boundaries. */
+    int        num_tasks;    /**< Number of tasks. */
+    int        num_threads;  /**< Threads for thread-sum. */
+    int        yield_every;  /**< Elements summed between yields. */
+    long int  *partials;     /**< Per-task partial sums. */
+} sum_ctx_t;
+
+/** @brief Fiber task: sum one slice, yielding between pieces. */
+static void sum_task(cb_fiber_task_t *task, int task_id, void *ctx)
+{
+    sum_ctx_t *c = (sum_ctx_t *)ctx;
+    int pos = c->bounds[task_id];
+    int end = c->bounds[task_id + 1];
+    long int sum = 0;
+
+    while (pos < end) {
+        int len = (end - pos < c->yield_every) ? end - pos : c->yield_every;
+        sum += cb_array_sum(c->dataset, pos, len).sum;
+        pos += len;
+        if (pos < end) {
+            cb_fiber_yield(task);
+        }
+    }
+
+    c->partials[task_id] = sum;
+}
+
+/** @brief Fiber task: yield FIBER_SWITCH_ROUNDS times. */
+static void switch_task(cb_fiber_task_t *task, int task_id, void *ctx)
+{
+    (void)task_id;
+    (void)ctx;
+
+    for (int r = 0; r < FIBER_SWITCH_ROUNDS; r++) {
+        cb_fiber_yield(task);
+    }
+}
+
+/**
+ * @brief Argument for one thread-sum thread.
+ */
+typedef struct {
+    sum_ctx_t *ctx;  /**< Shared sum context. */
+    int        id;   /**< Thread index. */
+} sum_thread_arg_t;
+
+/** @brief Thread-sum: sum tasks id, id + T, id + 2T, ... without fibers. */
+static void *sum_thread_fn(void *arg)
+{
+    sum_thread_arg_t *a = (sum_thread_arg_t *)arg;
+    sum_ctx_t *c = a->ctx;
+
+    for (int t = a->id; t < c->num_tasks; t += c->num_threads) {
+        c->partials[t] = cb_array_sum(c->dataset, c->bounds[t],
+                                      c->bounds[t + 1] - c->bounds[t]).sum;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Token passed between the two thread-switch threads.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) cb_flag_t ping;  /**< Set by thread 0. */
+    _Alignas(CB_CACHE_LINE) cb_flag_t pong;  /**< Set by thread 1. */
+    uint32_t base;                           /**< Episode offset of this run. */
+} handoff_t;
+
+/** @brief Thread-switch side 0: ping, then wait for pong. */
+static void *ping_thread_fn(void *arg)
+{
+    handoff_t *h = (handoff_t *)arg;
+
+    for (uint32_t r = 1; r <= THREAD_SWITCH_ROUNDS; r++) {
+        cb_flag_publish(&h->ping, h->base + r, 1, false);
+        cb_flag_wait(&h->pong, h->base + r, CB_WAIT_BLOCK, false);
+    }
+
+    return NULL;
+}
+
+/** @brief Thread-switch side 1: wait for ping, then pong. */
+static void *pong_thread_fn(void *arg)
+{
+    handoff_t *h = (handoff_t *)arg;
+
+    for (uint32_t r = 1; r <= THREAD_SWITCH_ROUNDS; r++) {
+        cb_flag_wait(&h->ping, h->base + r, CB_WAIT_BLOCK, false);
+        cb_flag_publish(&h->pong, h->base + r, 1, false);
+    }
+
+    return NULL;
+}
+
+/** @brief Run the thread-sum once across c->num_threads threads. */
+static cb_error_t run_thread_sum(sum_ctx_t *c, cb_thread_t *threads,
+                                 sum_thread_arg_t *args)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    for (int i = 0; i < c->num_threads; i++) {
+        args[i].ctx = c;
+        args[i].id = i;
+        err = cb_thread_create(&threads[i], sum_thread_fn, &args[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    return err;
+}
+
+/** @brief Run the thread-switch ping-pong once. */
+static cb_error_t run_thread_switch(handoff_t *h)
+{
+    cb_thread_t ping, pong;
+    cb_error_t err = cb_thread_create(&pong, pong_thread_fn, h);
+    if (err) {
+        return err;
+    }
+
+    err = cb_thread_create(&ping, ping_thread_fn, h);
+    if (err) {
+        /* Let the waiting side finish on its own. */
+        for (uint32_t r = 1; r <= THREAD_SWITCH_ROUNDS; r++) {
+            cb_flag_publish(&h->ping, h->base + r, 1, false);
+        }
+        cb_thread_join(&pong);
+        h->base += THREAD_SWITCH_ROUNDS;
+        return err;
+    }
+
+    cb_error_t join_err = cb_thread_join(&ping);
+    cb_error_t join_err2 = cb_thread_join(&pong);
+    h->base += THREAD_SWITCH_ROUNDS;
+
+    return join_err ? join_err : join_err2;
+}
+
+/**
+ * @brief Append one row.
+ *
+ * @param tasks       Tasks per run.
+ * @param switches    Switches per run, or 0 to print "n/a".
+ * @param per_switch  True for the switch microbenchmarks: report time
+ *                    per switch instead of task throughput.
+ */
+static cb_error_t add_row(cb_table_t *table, const char *mode, int threads,
+                          int tasks, const cb_bench_stats_t *stats,
+                          double switches, bool per_switch, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = stats->mean_sec;
+
+    cb_table_set(table, 0, "%s", mode);
+    cb_table_set(table, 1, "%d", threads);
+    cb_table_set(table, 2, "%d", tasks);
+    cb_table_set(table, 3, "%.6f", mean);
+    cb_table_set(table, 4, "%.6f", stats->stddev_sec);
+    if (per_switch) {
+        cb_table_set(table, 5, "n/a");
+    } else {
+        cb_table_set(table, 5, "%.0f", mean > 0.0 ? tasks / mean : 0.0);
+    }
+    if (switches > 0.0) {
+        cb_table_set(table, 6, "%.0f", switches);
+    } else {
+        cb_table_set(table, 6, "n/a");
+    }
+    if (per_switch && switches > 0.0) {
+        cb_table_set(table, 7, "%.1f", mean / switches * 1e9);
+    } else {
+        cb_table_set(table, 7, "n/a");
+    }
+    cb_table_set(table, 8, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_fiber_run(const int *dataset, const cb_config_t *config,
+                              cb_table_t **table_out)
+{
+    static const char *const headers[FIBER_COLS] = {
+        "Mode", "Threads", "Tasks", "Mean (s)", "Stddev (s)", "Tasks/s",
+        "Switches", "ns/switch", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    cb_fiber_rt_t *sum_rt = NULL, *switch_rt = NULL;
+    int *bounds = NULL;
+    long int *partials = NULL;
+    double *times = NULL;
+    cb_thread_t *threads = NULL;
+    sum_thread_arg_t *args = NULL;
+    handoff_t *handoff = NULL;
+    sum_ctx_t ctx;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    int tasks = config->fiber_tasks;
+
+    err = cb_table_create(&table, "fiber", "Fiber (M:N) Execution Mode",
+                          headers, FIBER_COLS);
+    if (err) {
+        return err;
+    }
+
+    bounds   = calloc((size_t)tasks + 1, sizeof(int));
+    partials = calloc((size_t)tasks, sizeof(long int));
+    times    = calloc((size_t)config->iterations, sizeof(double));
+    threads  = calloc((size_t)m, sizeof(cb_thread_t));
+    args     = calloc((size_t)m, sizeof(sum_thread_arg_t));
+    handoff  = cb_aligned_alloc(CB_CACHE_LINE, sizeof(handoff_t));
+    if (!bounds || !partials || !times || !threads || !args || !handoff) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* First (n % tasks) tasks get one extra element. */
+    int base_len = n / tasks, remainder = n % tasks;
+    for (int i = 0; i < tasks; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+
+    long int expected = cb_array_sum(dataset, 0, n).sum;
+
+    ctx.dataset = dataset;
+    ctx.bounds = bounds;
+    ctx.num_tasks = tasks;
+    ctx.num_threads = m;
+    ctx.yield_every = config->fiber_yield;
+    ctx.partials = partials;
+
+    err = cb_fiber_rt_create(&sum_rt, m, tasks, CB_FIBER_STACK_SIZE);
+    if (!err) {
+        err = cb_fiber_rt_create(&switch_rt, 1, 2, CB_FIBER_STACK_SIZE);
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    cb_bench_stats_t stats;
+
+    /* ---- fiber-sum ---- */
+    cb_fiber_stats_t fstats = { 0, 0 };
+    bool all_ok = true;
+    for (int iter = 0; iter < config->iterations; iter++) {
+        memset(partials, 0, (size_t)tasks * sizeof(long int));
+        double t_start = cb_time_now();
+        err = cb_fiber_rt_run(sum_rt, sum_task, &ctx, &fstats);
+        times[iter] = cb_time_now() - t_start;
+        if (err) {
+            goto cleanup;
+        }
+
+        long int total = 0;
+        for (int i = 0; i < tasks; i++) {
+            total += partials[i];
+        }
+        if (total != expected || fstats.completions != (uint64_t)tasks) {
+            all_ok = false;
+        }
+        if (config->verbose) {
+            fprintf(stdout, "  fiber-sum iteration %d/%d: %.6fs, %llu yields\n",
+                    iter + 1, config->iterations, times[iter],
+                    (unsigned long long)fstats.yields);
+        }
+    }
+    err = cb_stats_compute(times, config->iterations, &stats);
+    if (!err) {
+        err = add_row(table, "fiber-sum", m, tasks, &stats,
+                      2.0 * (double)(fstats.yields + fstats.completions),
+                      false, all_ok ? "PASS" : "FAIL");
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    /* ---- thread-sum ---- */
+    all_ok = true;
+    for (int iter = 0; iter < config->iterations; iter++) {
+        memset(partials, 0, (size_t)tasks * sizeof(long int));
+        double t_start = cb_time_now();
+        err = run_thread_sum(&ctx, threads, args);
+        times[iter] = cb_time_now() - t_start;
+        if (err) {
+            goto cleanup;
+        }
+
+        long int total = 0;
+        for (int i = 0; i < tasks; i++) {
+            total += partials[i];
+        }
+        if (total != expected) {
+            all_ok = false;
+        }
+    }
+    err = cb_stats_compute(times, config->iterations, &stats);
+    if (!err) {
+        err = add_row(table, "thread-sum", m, tasks, &stats, 0.0, false,
+                      all_ok ? "PASS" : "FAIL");
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    /* ---- fiber-switch ---- */
+    double fiber_ns = 0.0;
+    all_ok = true;
+    for (int iter = 0; iter < config->iterations; iter++) {
+        double t_start = cb_time_now();
+        err = cb_fiber_rt_run(switch_rt, switch_task, NULL, &fstats);
+        times[iter] = cb_time_now() - t_start;
+        if (err) {
+            goto cleanup;
+        }
+        if (fstats.yields != 2ull * FIBER_SWITCH_ROUNDS) {
+            all_ok = false;
+        }
+    }
+    double fiber_switches = 2.0 * (double)(fstats.yields + fstats.completions);
+    err = cb_stats_compute(times, config->iterations, &stats);
+    if (!err) {
+        fiber_ns = stats.mean_sec / fiber_switches * 1e9;
+        err = add_row(table, "fiber-switch", 1, 2, &stats, fiber_switches,
+                      true, all_ok ? "PASS" : "FAIL");
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    /* ---- thread-switch ---- */
+    memset(handoff, 0, sizeof(*handoff));
+    for (int iter = 0; iter < config->iterations; iter++) {
+        double t_start = cb_time_now();
+        err = run_thread_switch(handoff);
+        times[iter] = cb_time_now() - t_start;
+        if (err) {
+            goto cleanup;
+        }
+    }
+    double thread_switches = 2.0 * THREAD_SWITCH_ROUNDS;
+    err = cb_stats_compute(times, config->iterations, &stats);
+    if (!err) {
+        err = add_row(table, "thread-switch", 2, 2, &stats, thread_switches,
+                      true, "PASS");
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+    double thread_ns = stats.mean_sec / thread_switches * 1e9;
+    cb_table_add_note(table, "fiber-sum yields every %d elements; "
+                      "thread-sum runs the same slices on plain threads.",
+                      config->fiber_yield);
+    if (fiber_ns > 0.0) {
+        cb_table_add_note(table, "An OS thread handoff (blocking wait) costs "
+                          "%.1fx a fiber switch (%.1f ns vs %.1f ns).",
+                          thread_ns / fiber_ns, thread_ns, fiber_ns);
+    }
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    cb_fiber_rt_destroy(sum_rt);
+    cb_fiber_rt_destroy(switch_rt);
+    free(bounds);
+    free(partials);
+    free(times);
+    free(threads);
+    free(args);
+    cb_aligned_free(handoff);
+    cb_table_destroy(table);
+    return err;
+}
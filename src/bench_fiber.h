@@ -0,0 +1,33 @@
+/**
+ * @file bench_fiber.h
+ * @brief Fiber (M:N coroutine) execution mode for concur-bench.
+ *
+ * Models coroutine-based servers, where thousands of lightweight tasks
+ * share a few OS threads. The dataset is split into many tasks that
+ * each sum their slice in pieces and yield between pieces. The same
+ * slices are also summed by plain OS threads without fibers, and two
+ * ping-pong microbenchmarks compare the cost of a fiber switch with an
+ * OS thread handoff.
+ */
+
+#ifndef CB_BENCH_FIBER_H
+#define CB_BENCH_FIBER_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the fiber mode and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, fiber_tasks, fiber_yield,
+ *                   verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_PLATFORM (no fiber support) on failure.
+ */
+cb_error_t cb_bench_fiber_run(const int *dataset, const cb_config_t *config,
+                              cb_table_t **table_out);
+
+#endif /* CB_BENCH_FIBER_H */
@@ -0,0 +1,206 @@
+/**
+ * @file bench_forkjoin.c
+ * @brief Implementation of the fork-join execution mode.
+ *
+ * The first row times a serial cb_array_sum() over the whole array and
+ * is the speedup baseline. Each following row sums the array with the
+ * fork-join pool on config->num_threads workers at one grain size. By
+ * default the grains run from CB_FORKJOIN_MIN_GRAIN upward in powers
+ * of four until one grain covers the whole array.
+ *
+ * Leaves and spawns are fixed for a given length and grain; steals
+ * depend on timing and are averaged over the iterations.
+ */
+
+#include "bench_forkjoin.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "forkjoin.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+#include "worker.h"
+
+/** @brief Number of table columns. */
+#define FORKJOIN_COLS 10
+
+/** @brief Growth factor between grains in the default sweep. */
+#define FORKJOIN_GRAIN_STEP 4
+
+/**
+ * @brief Append one row.
+ *
+ * @param grain        Grain size, or 0 for the serial row.
+ * @param baseline_sec Mean time of the serial row.
+ * @param fstats       Counters, or NULL for the serial row.
+ * @param mean_steals  Steals per run, averaged over the iterations.
+ */
+static cb_error_t add_row(cb_table_t *table, const char *mode, int grain,
+                          int workers, const cb_bench_stats_t *stats,
+                          double baseline_sec,
+                          const cb_forkjoin_stats_t *fstats,
+                          double mean_steals, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = stats->mean_sec;
+    double speedup = (baseline_sec > 0.0 && mean > 0.0) ? baseline_sec / mean : 1.0;
+
+    cb_table_set(table, 0, "%s", mode);
+    if (grain > 0) {
+        cb_table_set(table, 1, "%d", grain);
+    } else {
+        cb_table_set(table, 1, "n/a");
+    }
+    cb_table_set(table, 2, "%d", workers);
+    cb_table_set(table, 3, "%.6f", mean);
+    cb_table_set(table, 4, "%.6f", stats->stddev_sec);
+    cb_table_set(table, 5, "%.2fx", speedup);
+    if (fstats) {
+        cb_table_set(table, 6, "%llu", (unsigned long long)fstats->leaves);
+        cb_table_set(table, 7, "%llu", (unsigned long long)fstats->spawns);
+        cb_table_set(table, 8, "%.1f", mean_steals);
+    } else {
+        cb_table_set(table, 6, "1");
+        cb_table_set(table, 7, "0");
+        cb_table_set(table, 8, "0");
+    }
+    cb_table_set(table, 9, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_forkjoin_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out)
+{
+    static const char *const headers[FORKJOIN_COLS] = {
+        "Mode", "Grain", "Workers", "Mean (s)", "Stddev (s)", "Speedup",
+        "Leaves", "Spawns", "Steals", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    cb_forkjoin_t *pool = NULL;
+    double *times = NULL;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+
+    err = cb_table_create(&table, "forkjoin", "Fork-Join (Work-Stealing) Mode",
+                          headers, FORKJOIN_COLS);
+    if (err) {
+        return err;
+    }
+
+    times = calloc((size_t)config->iterations, sizeof(double));
+    if (!times) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    err = cb_forkjoin_create(&pool, m);
+    if (err) {
+        goto cleanup;
+    }
+
+    cb_bench_stats_t stats;
+
+    /* ---- serial baseline ---- */
+    long int expected = 0;
+    for (int iter = 0; iter < config->iterations; iter++) {
+        cb_result_t r = cb_array_sum(dataset, 0, n);
+        times[iter] = r.elapsed_sec;
+        expected = r.sum;
+    }
+    err = cb_stats_compute(times, config->iterations, &stats);
+    if (!err) {
+        err = add_row(table, "serial", 0, 1, &stats, 0.0, NULL, 0.0, "PASS");
+    }
+    if (err) {
+        goto cleanup;
+    }
+    double baseline = stats.mean_sec;
+
+    /* ---- fork-join grain sweep ---- */
+    int grain = config->forkjoin_grain > 0 ? config->forkjoin_grain
+                                           : CB_FORKJOIN_MIN_GRAIN;
+    int best_grain = 0;
+    double best_mean = 0.0;
+
+    for (;;) {
+        cb_forkjoin_stats_t fstats = { 0, 0, 0 };
+        uint64_t total_steals = 0;
+        bool all_ok = true;
+
+        for (int iter = 0; iter < config->iterations; iter++) {
+            long int sum = 0;
+            double t_start = cb_time_now();
+            err = cb_forkjoin_sum(pool, dataset, n, grain, &sum, &fstats);
+            times[iter] = cb_time_now() - t_start;
+            if (err) {
+                goto cleanup;
+            }
+
+            total_steals += fstats.steals;
+            if (sum != expected) {
+                all_ok = false;
+            }
+            if (config->verbose) {
+                fprintf(stdout, "  forkjoin grain %d iteration %d/%d: %.6fs, "
+                        "%llu steals\n", grain, iter + 1, config->iterations,
+                        times[iter], (unsigned long long)fstats.steals);
+            }
+        }
+
+        err = cb_stats_compute(times, config->iterations, &stats);
+        if (!err) {
+            err = add_row(table, "forkjoin", grain, m, &stats, baseline,
+                          &fstats,
+                          (double)total_steals / config->iterations,
+                          all_ok ? "PASS" : "FAIL");
+        }
+        if (err) {
+            goto cleanup;
+        }
+
+        if (best_grain == 0 || stats.mean_sec < best_mean) {
+            best_grain = grain;
+            best_mean = stats.mean_sec;
+        }
+
+        if (config->forkjoin_grain > 0 || grain >= n ||
+            grain > INT_MAX / FORKJOIN_GRAIN_STEP) {
+            break;
+        }
+        grain *= FORKJOIN_GRAIN_STEP;
+    }
+
+    cb_table_add_note(table, "Ranges above the grain are halved; the right "
+                      "half is pushed for stealing and the left half recursed.");
+    if (config->forkjoin_grain == 0 && best_mean > 0.0) {
+        cb_table_add_note(table, "Fastest grain: %d (%.2fx over serial).",
+                          best_grain, baseline / best_mean);
+    }
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    cb_forkjoin_destroy(pool);
+    free(times);
+    cb_table_destroy(table);
+    return err;
+}
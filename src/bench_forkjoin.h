@@ -0,0 +1,31 @@
+/**
+ * @file bench_forkjoin.h
+ * @brief Recursive fork-join execution mode for concur-bench.
+ *
+ * Models divide-and-conquer codebases, where work is split recursively
+ * and scheduled by work stealing instead of a flat N-way split. The
+ * sum is repeated across a sweep of grain sizes (or a single grain set
+ * with --forkjoin-grain) and each row reports speedup over a serial
+ * sum together with the leaf, spawn and steal counts, so a cutoff can
+ * be chosen empirically.
+ */
+
+#ifndef CB_BENCH_FORKJOIN_H
+#define CB_BENCH_FORKJOIN_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the fork-join mode and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, forkjoin_grain, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD on failure.
+ */
+cb_error_t cb_bench_forkjoin_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out);
+
+#endif /* CB_BENCH_FORKJOIN_H */
@@ -0,0 +1,456 @@
+/**
+ * @file bench_gemm.c
+ * @brief Implementation of the gemm workload.
+ *
+ * Rows of C are split into panels whose boundaries are multiples of
+ * the micro-kernel height, so no worker computes a partial register
+ * tile that a neighbour also computes. Every worker packs its own copy
+ * of each B panel; this duplicates a small amount of work per worker
+ * but needs no synchronization between them.
+ */
+
+#include "bench_gemm.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gemm.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of C entries spot-checked after every run. */
+#define GEMM_CHECK_SAMPLES 64
+
+/**
+ * @brief One worker's share of a multiply.
+ */
+typedef struct {
+    int                    n;          /**< Matrix order. */
+    bool                   dbl;        /**< Double precision if true. */
+    const void            *a;          /**< A (float or double). */
+    const void            *b;          /**< B (float or double). */
+    void                  *c;          /**< C (float or double). */
+    int                    row_begin;  /**< First row of C. */
+    int                    row_end;    /**< One past the last row of C. */
+    const cb_gemm_tiles_t *tiles;      /**< Cache blocking parameters. */
+    cb_error_t             err;        /**< Result of the multiply. */
+} gemm_job_t;
+
+/** @brief Run one job with the kernel of its precision. */
+static cb_error_t run_job(const gemm_job_t *job)
+{
+    if (job->dbl) {
+        return cb_dgemm_rows(job->n, job->a, job->b, job->c,
+                             job->row_begin, job->row_end, job->tiles);
+    }
+    return cb_sgemm_rows(job->n, job->a, job->b, job->c,
+                         job->row_begin, job->row_end, job->tiles);
+}
+
+/** @brief Thread entry point: run one job and record its result. */
+static void *gemm_thread_fn(void *arg)
+{
+    gemm_job_t *job = (gemm_job_t *)arg;
+    job->err = run_job(job);
+    return NULL;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child process entry point: run one job into shared memory. */
+static void gemm_child_fn(void *arg)
+{
+    _Exit(run_job((const gemm_job_t *)arg) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+#endif
+
+/**
+ * @brief Split n rows into @p parts panels aligned to CB_GEMM_MR.
+ *
+ * The first (units % parts) panels get one extra micro-panel.
+ */
+static void fill_row_bounds(int n, int parts, int *bounds)
+{
+    int units     = (n + CB_GEMM_MR - 1) / CB_GEMM_MR;
+    int base_len  = units / parts;
+    int remainder = units % parts;
+
+    bounds[0] = 0;
+    for (int i = 0; i < parts; i++) {
+        int row = bounds[i] + (base_len + (i < remainder ? 1 : 0)) * CB_GEMM_MR;
+        bounds[i + 1] = (row < n) ? row : n;
+    }
+}
+
+/**
+ * @brief Generate an n x n matrix exactly representable as float.
+ *
+ * Values are k / 1024 for integer k in [-1024, 1024], drawn from a
+ * xorshift32 stream so the matrices depend only on the seed.
+ */
+static void fill_matrix(double *m, int n, uint32_t *state)
+{
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        uint32_t x = *state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        *state = x;
+        m[i] = ((int)(x % 2049u) - 1024) / 1024.0;
+    }
+}
+
+/**
+ * @brief Spot-check C against a double-precision reference.
+ *
+ * Positions include both corners and a fixed pseudo-random sample.
+ * The tolerance is the standard forward error bound for a length-n
+ * dot product, n * eps * sum |a_ik * b_kj|, doubled for slack.
+ */
+static bool verify_sample(int n, const double *a, const double *b,
+                          const void *c, bool dbl)
+{
+    double eps = dbl ? DBL_EPSILON : FLT_EPSILON;
+    uint32_t pick = 0x9E3779B9u;
+
+    for (int s = 0; s < GEMM_CHECK_SAMPLES; s++) {
+        int i, j;
+
+        if (s == 0) {
+            i = 0;
+            j = 0;
+        } else if (s == 1) {
+            i = n - 1;
+            j = n - 1;
+        } else {
+            pick = pick * 1664525u + 1013904223u;
+            i = (int)((pick >> 8) % (uint32_t)n);
+            pick = pick * 1664525u + 1013904223u;
+            j = (int)((pick >> 8) % (uint32_t)n);
+        }
+
+        double ref = 0.0, mag = 0.0;
+        for (int k = 0; k < n; k++) {
+            double prod = a[(size_t)i * n + k] * b[(size_t)k * n + j];
+            ref += prod;
+            mag += fabs(prod);
+        }
+
+        double got = dbl ? ((const double *)c)[(size_t)i * n + j]
+                         : (double)((const float *)c)[(size_t)i * n + j];
+        if (fabs(got - ref) > 2.0 * n * eps * mag) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Execution modes, in table order within each precision. */
+typedef enum {
+    MODE_SINGLE = 0,
+    MODE_THREAD,
+    MODE_PROCESS,
+    MODE_COUNT
+} gemm_mode_t;
+
+/** @brief Table labels indexed by [precision][mode]. */
+static const char *const MODE_LABELS[2][MODE_COUNT] = {
+    { "single-sgemm", "thread-sgemm", "process-sgemm" },
+    { "single-dgemm", "thread-dgemm", "process-dgemm" }
+};
+
+/**
+ * @brief Run one parallel multiply across threads.
+ */
+static cb_error_t run_threads(gemm_job_t *jobs, cb_thread_t *threads,
+                              int workers)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    for (int i = 0; i < workers; i++) {
+        err = cb_thread_create(&threads[i], gemm_thread_fn, &jobs[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+        if (jobs[i].err && !err) {
+            err = jobs[i].err;
+        }
+    }
+
+    return err;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/**
+ * @brief Run one parallel multiply across child processes.
+ *
+ * The children inherit A and B through fork() and write their rows
+ * into C, which must live in shared memory.
+ */
+static cb_error_t run_processes(gemm_job_t *jobs, cb_process_t *procs,
+                                int workers)
+{
+    cb_error_t err = CB_OK;
+    int spawned = 0;
+
+    for (int i = 0; i < workers; i++) {
+        err = cb_process_spawn(&procs[i], NULL, gemm_child_fn, &jobs[i]);
+        if (err) {
+            break;
+        }
+        spawned++;
+    }
+
+    for (int i = 0; i < spawned; i++) {
+        int status = 0;
+        cb_error_t wait_err = cb_process_wait(&procs[i], &status);
+        if (!wait_err && status != 0) {
+            wait_err = CB_ERR_ALLOC;
+        }
+        if (wait_err && !err) {
+            err = wait_err;
+        }
+    }
+
+    return err;
+}
+#endif
+
+/**
+ * @brief Measure one mode of one precision and append its table row.
+ *
+ * @param baseline  In/out: mean time of the single mode of this
+ *                  precision (written when mode is MODE_SINGLE).
+ */
+static cb_error_t measure_mode(const cb_config_t *config,
+                               const cb_gemm_tiles_t *tiles, bool dbl,
+                               gemm_mode_t mode, const double *ref_a,
+                               const double *ref_b, const void *a,
+                               const void *b, void *c, double *times,
+                               double *baseline, cb_table_t *table)
+{
+    cb_error_t err = CB_OK;
+    int n = config->gemm_size;
+    int workers = 1;
+    size_t c_bytes = (size_t)n * n * (dbl ? sizeof(double) : sizeof(float));
+    gemm_job_t *jobs = NULL;
+    cb_thread_t *threads = NULL;
+    cb_process_t *procs = NULL;
+    int *bounds = NULL;
+    bool all_ok = true;
+#ifdef CB_PLATFORM_UNIX
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+#endif
+
+    if (mode == MODE_THREAD) {
+        workers = config->num_threads;
+    } else if (mode == MODE_PROCESS) {
+        workers = config->num_processes;
+    }
+
+    jobs    = calloc((size_t)workers, sizeof(gemm_job_t));
+    threads = calloc((size_t)workers, sizeof(cb_thread_t));
+    procs   = calloc((size_t)workers, sizeof(cb_process_t));
+    bounds  = calloc((size_t)workers + 1, sizeof(int));
+    if (!jobs || !threads || !procs || !bounds) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    if (mode == MODE_PROCESS) {
+        char shm_name[64];
+        snprintf(shm_name, sizeof(shm_name), "concur_bench_gemm_%u",
+                 cb_process_self_id());
+        err = cb_shared_mem_create(&shm, shm_name, c_bytes);
+        if (err) {
+            goto cleanup;
+        }
+        shm_created = true;
+        c = cb_shared_mem_ptr(&shm);
+    }
+#endif
+
+    fill_row_bounds(n, workers, bounds);
+    for (int i = 0; i < workers; i++) {
+        jobs[i].n = n;
+        jobs[i].dbl = dbl;
+        jobs[i].a = a;
+        jobs[i].b = b;
+        jobs[i].c = c;
+        jobs[i].row_begin = bounds[i];
+        jobs[i].row_end = bounds[i + 1];
+        jobs[i].tiles = tiles;
+    }
+
+    for (int iter = 0; iter < config->iterations; iter++) {
+        memset(c, 0, c_bytes);
+
+        double t_start = cb_time_now();
+        if (mode == MODE_SINGLE) {
+            err = run_job(&jobs[0]);
+        } else if (mode == MODE_THREAD) {
+            err = run_threads(jobs, threads, workers);
+        } else {
+#ifdef CB_PLATFORM_UNIX
+            err = run_processes(jobs, procs, workers);
+#endif
+        }
+        times[iter] = cb_time_now() - t_start;
+        if (err) {
+            goto cleanup;
+        }
+
+        bool ok = verify_sample(n, ref_a, ref_b, c, dbl);
+        if (!ok) {
+            all_ok = false;
+            fprintf(stderr, "  WARNING: %s result out of tolerance in "
+                    "iteration %d\n", MODE_LABELS[dbl][mode], iter + 1);
+        }
+
+        if (config->verbose) {
+            fprintf(stdout, "  %s iteration %d/%d: %.6fs (%.2f GFLOP/s, %s)\n",
+                    MODE_LABELS[dbl][mode], iter + 1, config->iterations,
+                    times[iter],
+                    times[iter] > 0.0 ? 2.0 * n * n * (double)n / times[iter] / 1e9
+                                      : 0.0,
+                    ok ? "verified" : "FAILED");
+        }
+    }
+
+    cb_bench_stats_t stats;
+    err = cb_stats_compute(times, config->iterations, &stats);
+    if (err) {
+        goto cleanup;
+    }
+
+    if (mode == MODE_SINGLE) {
+        *baseline = stats.mean_sec;
+    }
+
+    err = cb_table_add_timing_row(table, MODE_LABELS[dbl][mode], workers,
+                                  &stats, mode == MODE_SINGLE ? 0.0 : *baseline,
+                                  2.0 * n * n * (double)n / 1e9,
+                                  all_ok ? "PASS" : "FAIL");
+
+cleanup:
+#ifdef CB_PLATFORM_UNIX
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+#endif
+    free(jobs);
+    free(threads);
+    free(procs);
+    free(bounds);
+    return err;
+}
+
+cb_error_t cb_bench_gemm_run(const cb_config_t *config, cb_table_t **table_out)
+{
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    double *a64 = NULL, *b64 = NULL, *c64 = NULL;
+    float *a32 = NULL, *b32 = NULL, *c32 = NULL;
+    double *times = NULL;
+
+    if (!config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->gemm_size;
+    size_t count = (size_t)n * n;
+    cb_gemm_tiles_t tiles = { config->gemm_mc, config->gemm_kc, config->gemm_nc };
+    char title[96];
+
+    snprintf(title, sizeof(title), "GEMM Workload (n=%d, C = A * B)", n);
+    err = cb_table_create_timing(&table, "gemm", title, "GFLOP/s");
+    if (err) {
+        return err;
+    }
+
+    a64   = malloc(count * sizeof(double));
+    b64   = malloc(count * sizeof(double));
+    c64   = malloc(count * sizeof(double));
+    a32   = malloc(count * sizeof(float));
+    b32   = malloc(count * sizeof(float));
+    c32   = malloc(count * sizeof(float));
+    times = calloc((size_t)config->iterations, sizeof(double));
+    if (!a64 || !b64 || !c64 || !a32 || !b32 || !c32 || !times) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    uint32_t state = config->seed ? config->seed : 1u;
+    fill_matrix(a64, n, &state);
+    fill_matrix(b64, n, &state);
+    for (size_t i = 0; i < count; i++) {
+        a32[i] = (float)a64[i];
+        b32[i] = (float)b64[i];
+    }
+
+    for (int prec = 0; prec < 2; prec++) {
+        bool dbl = (prec == 1);
+        double baseline = 0.0;
+
+        for (int mode = 0; mode < MODE_COUNT; mode++) {
+#ifndef CB_PLATFORM_UNIX
+            if (mode == MODE_PROCESS) {
+                continue;
+            }
+#endif
+            err = measure_mode(config, &tiles, dbl, (gemm_mode_t)mode,
+                               a64, b64,
+                               dbl ? (const void *)a64 : (const void *)a32,
+                               dbl ? (const void *)b64 : (const void *)b32,
+                               dbl ? (void *)c64 : (void *)c32,
+                               times, &baseline, table);
+            if (err) {
+                goto cleanup;
+            }
+        }
+    }
+
+    cb_table_add_note(table, "Kernel: %s, %dx%d (sgemm) / %dx%d (dgemm) "
+                      "register tiles; MC=%d KC=%d NC=%d.",
+                      cb_gemm_kernel_name(), CB_GEMM_MR, CB_SGEMM_NR,
+                      CB_GEMM_MR, CB_DGEMM_NR, tiles.mc, tiles.kc, tiles.nc);
+    cb_table_add_note(table, "GFLOP/s counts 2*n^3 operations per run; "
+                      "speedups are relative to single mode of the same "
+                      "precision.");
+#ifndef CB_PLATFORM_UNIX
+    cb_table_add_note(table, "Process modes require fork() and are not "
+                      "available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    free(a64);
+    free(b64);
+    free(c64);
+    free(a32);
+    free(b32);
+    free(c32);
+    free(times);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file bench_gemm.h
+ * @brief Compute-bound matrix multiply workload for concur-bench.
+ *
+ * The core sum is memory-bound: a few cores saturate DRAM bandwidth
+ * and speedups plateau regardless of how many more are added. This
+ * workload multiplies two square matrices with a cache-blocked GEMM
+ * whose working set stays in cache, so its scaling shows what extra
+ * cores buy for compute-bound work.
+ *
+ * Both SGEMM and DGEMM run sequentially, across threads, and across
+ * processes (Unix only), with rows of C split into panels per worker.
+ */
+
+#ifndef CB_BENCH_GEMM_H
+#define CB_BENCH_GEMM_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the gemm workload in every mode and produce a result table.
+ *
+ * The input matrices are generated from config->seed with values that
+ * are exact in both precisions. Every result is spot-checked against
+ * a double-precision dot product at sampled positions. Throughput is
+ * reported in GFLOP/s (2 * n^3 floating-point operations per run);
+ * speedups are relative to the sequential run of the same precision.
+ *
+ * @param config     Benchmark configuration (reads gemm_size, gemm_mc,
+ *                   gemm_kc, gemm_nc, num_threads, num_processes,
+ *                   iterations, seed, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD, CB_ERR_FORK,
+ *         CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_gemm_run(const cb_config_t *config, cb_table_t **table_out);
+
+#endif /* CB_BENCH_GEMM_H */
@@ -0,0 +1,631 @@
+/**
+ * @file bench_layout.c
+ * @brief Implementation of the record-layout suite.
+ *
+ * Every layout is described by the same three numbers per field, so
+ * one generator and one kernel serve all of them. Records are grouped
+ * into strips of `tile` records, and field f of record r lives at
+ *
+ *     base[f] + (r / tile) * strip[f] + (r % tile) * elem[f]
+ *
+ * - AoS:   base = offset in the record, elem = record size,
+ *          strip = tile * record size. Fields are naturally aligned and
+ *          the record is padded to its widest field, as a C struct is.
+ * - SoA:   base = start of the field's array, elem = width,
+ *          strip = tile * width.
+ * - AoSoA: base = start of the field's run within a tile, elem = width,
+ *          strip = tile * record bytes.
+ *
+ * The tile is one cache line of the narrowest field, so every field's
+ * run in an AoSoA tile is a whole number of lines. The kernel walks a
+ * strip at a time and sums each touched field with a loop typed by its
+ * width; for AoS that keeps the scan record-local, for SoA and AoSoA
+ * the loop is contiguous. Work is split on strip boundaries, and the
+ * last strip is zero-padded.
+ *
+ * Fetched bytes count the distinct cache lines holding a touched field:
+ * walked record by record for AoS, where fields share lines, and field
+ * by field otherwise, where each field's lines are its own.
+ */
+
+#include "bench_layout.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define LAYOUT_COLS 9
+
+/** @brief Cache line assumed for tiling and fetched-byte accounting. */
+#define LAYOUT_LINE 64
+
+/** @brief Layouts, in table order. */
+typedef enum {
+    LAYOUT_AOS = 0,  /**< Array of structs. */
+    LAYOUT_SOA,      /**< Struct of arrays. */
+    LAYOUT_AOSOA,    /**< Array of tiles, each a struct of short arrays. */
+    LAYOUT_COUNT
+} layout_kind_t;
+
+/** @brief Layout labels indexed by layout_kind_t. */
+static const char *const LAYOUT_NAMES[LAYOUT_COUNT] = {
+    "AoS", "SoA", "AoSoA"
+};
+
+/** @brief Execution modes, in table order within each layout. */
+typedef enum {
+    MODE_SINGLE = 0,
+    MODE_THREAD,
+    MODE_PROCESS,
+    MODE_COUNT
+} layout_mode_t;
+
+/** @brief Mode labels indexed by layout_mode_t. */
+static const char *const MODE_LABELS[MODE_COUNT] = {
+    "single", "thread", "process"
+};
+
+/**
+ * @brief One layout of the records.
+ */
+typedef struct {
+    layout_kind_t  kind;     /**< Layout. */
+    unsigned char *data;     /**< Records (owned, line-aligned). */
+    size_t         bytes;    /**< Size of data. */
+    int            n;        /**< Records. */
+    int            tile;     /**< Records per strip. */
+    int            strips;   /**< Strips, the last one possibly partial. */
+    int            fields;   /**< Fields per record. */
+    int            width[CB_LAYOUT_MAX_FIELDS];  /**< Field widths. */
+    size_t         base[CB_LAYOUT_MAX_FIELDS];   /**< Offset of record 0. */
+    size_t         elem[CB_LAYOUT_MAX_FIELDS];   /**< Step between records. */
+    size_t         strip[CB_LAYOUT_MAX_FIELDS];  /**< Step between strips. */
+    int            touched;  /**< Number of summed fields. */
+    int            touch[CB_LAYOUT_MAX_FIELDS];  /**< Summed fields, ascending. */
+} layout_view_t;
+
+/**
+ * @brief Per-worker argument.
+ */
+typedef struct {
+    const layout_view_t *view;     /**< Layout to scan. */
+    int                  first;    /**< First strip. */
+    int                  last;     /**< One past the last strip. */
+    long int            *partial;  /**< Where to store the partial sum. */
+} layout_arg_t;
+
+/* ---- Geometry ---- */
+
+/** @brief Byte offset of field @p f of record @p r. */
+static size_t field_offset(const layout_view_t *v, int f, int r)
+{
+    return v->base[f] + (size_t)(r / v->tile) * v->strip[f] +
+           (size_t)(r % v->tile) * v->elem[f];
+}
+
+/** @brief Round @p x up to a multiple of @p align (a power of two). */
+static size_t align_up(size_t x, size_t align)
+{
+    return (x + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Fill the per-field geometry of @p kind.
+ *
+ * @param record_out  AoS record size, padding included.
+ */
+static void layout_geometry(layout_view_t *v, layout_kind_t kind,
+                            size_t *record_out)
+{
+    size_t padded = (size_t)v->strips * v->tile;
+    size_t record = 0, packed = 0;
+    int widest = 1;
+
+    for (int f = 0; f < v->fields; f++) {
+        record = align_up(record, (size_t)v->width[f]) + (size_t)v->width[f];
+        packed += (size_t)v->width[f];
+        widest = v->width[f] > widest ? v->width[f] : widest;
+    }
+    record = align_up(record, (size_t)widest);
+    *record_out = record;
+
+    v->kind = kind;
+    size_t offset = 0;
+    for (int f = 0; f < v->fields; f++) {
+        size_t w = (size_t)v->width[f];
+        switch (kind) {
+        case LAYOUT_AOS:
+            offset = align_up(offset, w);
+            v->base[f] = offset;
+            v->elem[f] = record;
+            v->strip[f] = (size_t)v->tile * record;
+            offset += w;
+            break;
+        case LAYOUT_SOA:
+            v->base[f] = offset;
+            v->elem[f] = w;
+            v->strip[f] = (size_t)v->tile * w;
+            offset += padded * w;
+            break;
+        default:
+            v->base[f] = offset;
+            v->elem[f] = w;
+            v->strip[f] = (size_t)v->tile * packed;
+            offset += (size_t)v->tile * w;
+            break;
+        }
+    }
+
+    v->bytes = padded * (kind == LAYOUT_AOS ? record : packed);
+}
+
+/** @brief Store @p value into a field of @p width bytes. */
+static void store_field(unsigned char *p, int width, int value)
+{
+    switch (width) {
+    case 1:
+        *(uint8_t *)p = (uint8_t)value;
+        break;
+    case 2:
+        *(uint16_t *)p = (uint16_t)value;
+        break;
+    case 4:
+        *(uint32_t *)p = (uint32_t)value;
+        break;
+    default:
+        *(uint64_t *)p = (uint64_t)value;
+        break;
+    }
+}
+
+/**
+ * @brief Allocate and fill one layout; field f of record r is
+ *        dataset[r] + f.
+ */
+static cb_error_t layout_build(layout_view_t *v, layout_kind_t kind,
+                               const int *dataset, size_t *record_out)
+{
+    layout_geometry(v, kind, record_out);
+
+    v->data = cb_aligned_alloc(LAYOUT_LINE, v->bytes);
+    if (!v->data) {
+        return CB_ERR_ALLOC;
+    }
+    memset(v->data, 0, v->bytes);
+
+    for (int r = 0; r < v->n; r++) {
+        for (int f = 0; f < v->fields; f++) {
+            store_field(v->data + field_offset(v, f, r), v->width[f],
+                        dataset[r] + f);
+        }
+    }
+    return CB_OK;
+}
+
+/**
+ * @brief Count the cache lines a scan of the touched fields fetches.
+ *
+ * For a fixed field, offsets grow with the record index, so distinct
+ * lines are counted by comparing with the previous one. Fields never
+ * straddle lines: each is aligned to its width, which divides the line.
+ */
+static unsigned long long fetched_lines(const layout_view_t *v)
+{
+    unsigned long long lines = 0;
+
+    if (v->kind == LAYOUT_AOS) {
+        /* Touched fields share lines; walk them in address order. */
+        size_t prev = SIZE_MAX;
+        for (int r = 0; r < v->n; r++) {
+            for (int k = 0; k < v->touched; k++) {
+                size_t line = field_offset(v, v->touch[k], r) / LAYOUT_LINE;
+                if (line != prev) {
+                    lines++;
+                    prev = line;
+                }
+            }
+        }
+        return lines;
+    }
+
+    /* SoA and AoSoA runs are line-aligned, so no line holds two fields. */
+    for (int k = 0; k < v->touched; k++) {
+        size_t prev = SIZE_MAX;
+        for (int r = 0; r < v->n; r++) {
+            size_t line = field_offset(v, v->touch[k], r) / LAYOUT_LINE;
+            if (line != prev) {
+                lines++;
+                prev = line;
+            }
+        }
+    }
+    return lines;
+}
+
+/* ---- Kernel ---- */
+
+/**
+ * @brief Define a field sum for one width: @p count values, @p stride
+ *        bytes apart. A contiguous run gets its own loop so the
+ *        compiler can vectorize it.
+ */
+#define LAYOUT_SUM_DEFINE(NAME, TYPE)                                      \
+    static uint64_t NAME(const unsigned char *p, size_t stride, int count) \
+    {                                                                      \
+        uint64_t sum = 0;                                                  \
+        if (stride == sizeof(TYPE)) {                                      \
+            const TYPE *v = (const TYPE *)p;                               \
+            for (int i = 0; i < count; i++) {                              \
+                sum += v[i];                                               \
+            }                                                              \
+        } else {                                                           \
+            for (int i = 0; i < count; i++) {                              \
+                sum += *(const TYPE *)(p + (size_t)i * stride);            \
+            }                                                              \
+        }                                                                  \
+        return sum;                                                        \
+    }
+
+LAYOUT_SUM_DEFINE(sum_u8, uint8_t)
+LAYOUT_SUM_DEFINE(sum_u16, uint16_t)
+LAYOUT_SUM_DEFINE(sum_u32, uint32_t)
+LAYOUT_SUM_DEFINE(sum_u64, uint64_t)
+
+/** @brief Sum the touched fields of strips [@p first, @p last). */
+static long int layout_sum(const layout_view_t *v, int first, int last)
+{
+    uint64_t sum = 0;
+
+    for (int s = first; s < last; s++) {
+        long long left = v->n - (long long)s * v->tile;
+        int count = left < v->tile ? (int)left : v->tile;
+        for (int k = 0; k < v->touched; k++) {
+            int f = v->touch[k];
+            const unsigned char *p = v->data + v->base[f] +
+                                     (size_t)s * v->strip[f];
+            switch (v->width[f]) {
+            case 1:
+                sum += sum_u8(p, v->elem[f], count);
+                break;
+            case 2:
+                sum += sum_u16(p, v->elem[f], count);
+                break;
+            case 4:
+                sum += sum_u32(p, v->elem[f], count);
+                break;
+            default:
+                sum += sum_u64(p, v->elem[f], count);
+                break;
+            }
+        }
+    }
+    return (long int)sum;
+}
+
+/** @brief Thread entry point. */
+static void *layout_thread_fn(void *arg)
+{
+    layout_arg_t *a = (layout_arg_t *)arg;
+    *a->partial = layout_sum(a->view, a->first, a->last);
+    return NULL;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child entry point; the partial lands in shared memory. */
+static void layout_child_fn(void *arg)
+{
+    layout_arg_t *a = (layout_arg_t *)arg;
+    *a->partial = layout_sum(a->view, a->first, a->last);
+    _Exit(EXIT_SUCCESS);
+}
+#endif
+
+/**
+ * @brief Scan the layout once in @p mode on @p workers workers.
+ *
+ * @param partials  One slot per worker; shared memory for processes.
+ */
+static cb_error_t run_once(const layout_view_t *v, layout_mode_t mode,
+                           int workers, long int *partials,
+                           layout_arg_t *args, cb_thread_t *threads,
+                           cb_process_t *procs, long int *sum_out)
+{
+    cb_error_t err = CB_OK;
+    int started = 0;
+    int base_len = v->strips / workers, remainder = v->strips % workers;
+    int offset = 0;
+
+#ifndef CB_PLATFORM_UNIX
+    (void)procs;
+#endif
+
+    if (mode == MODE_SINGLE) {
+        *sum_out = layout_sum(v, 0, v->strips);
+        return CB_OK;
+    }
+
+    for (int i = 0; i < workers; i++) {
+        args[i].view = v;
+        args[i].first = offset;
+        args[i].last = offset + base_len + (i < remainder ? 1 : 0);
+        args[i].partial = &partials[i];
+        offset = args[i].last;
+
+#ifdef CB_PLATFORM_UNIX
+        if (mode == MODE_PROCESS) {
+            err = cb_process_spawn(&procs[i], NULL, layout_child_fn, &args[i]);
+        } else
+#endif
+        {
+            err = cb_thread_create(&threads[i], layout_thread_fn, &args[i]);
+        }
+        if (err) {
+            break;
+        }
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        cb_error_t join_err;
+#ifdef CB_PLATFORM_UNIX
+        if (mode == MODE_PROCESS) {
+            int status = 0;
+            join_err = cb_process_wait(&procs[i], &status);
+            if (!join_err && status != 0) {
+                join_err = CB_ERR_FORK;
+            }
+        } else
+#endif
+        {
+            join_err = cb_thread_join(&threads[i]);
+        }
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    long int sum = 0;
+    for (int i = 0; i < started; i++) {
+        sum += partials[i];
+    }
+    *sum_out = sum;
+    return err;
+}
+
+/** @brief Append one row; @p base_sec is 0 for the single-mode row. */
+static cb_error_t add_row(cb_table_t *table, const layout_view_t *v,
+                          layout_mode_t mode, int workers,
+                          const cb_bench_stats_t *stats, double useful,
+                          double fetched, double base_sec, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = stats->mean_sec;
+    cb_table_set(table, 0, "%s", LAYOUT_NAMES[v->kind]);
+    cb_table_set(table, 1, "%s", MODE_LABELS[mode]);
+    cb_table_set(table, 2, "%d", workers);
+    cb_table_set(table, 3, "%.6f", mean);
+    cb_table_set(table, 4, "%.2fx",
+                 (base_sec > 0.0 && mean > 0.0) ? base_sec / mean : 1.0);
+    cb_table_set(table, 5, "%.2f", mean > 0.0 ? useful / mean / 1e9 : 0.0);
+    cb_table_set(table, 6, "%.2f", mean > 0.0 ? fetched / mean / 1e9 : 0.0);
+    cb_table_set(table, 7, "%.1f%%",
+                 fetched > 0.0 ? 100.0 * (1.0 - useful / fetched) : 0.0);
+    cb_table_set(table, 8, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_layout_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out)
+{
+    static const char *const headers[LAYOUT_COLS] = {
+        "Layout", "Mode", "Workers", "Mean (s)", "Speedup", "Useful GB/s",
+        "Fetched GB/s", "Wasted", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    layout_view_t view;
+    double *times = NULL;
+    long int *partials = NULL;
+    layout_arg_t *args = NULL;
+    cb_thread_t *threads = NULL;
+    cb_process_t *procs = NULL;
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+    double mib[LAYOUT_COUNT] = {0.0};
+    size_t record = 0;
+
+    if (!dataset || !config || !table_out || config->layout_fields < 1 ||
+        config->layout_fields > CB_LAYOUT_MAX_FIELDS) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+    memset(&view, 0, sizeof(view));
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    int p = config->num_processes;
+    int most = m > p ? m : p;
+
+    /* Geometry shared by all layouts. */
+    int narrowest = 8;
+    view.n = n;
+    view.fields = config->layout_fields;
+    for (int f = 0; f < view.fields; f++) {
+        view.width[f] = config->layout_width[f];
+        narrowest = view.width[f] < narrowest ? view.width[f] : narrowest;
+    }
+    view.tile = LAYOUT_LINE / narrowest;
+    view.strips = (int)(((long long)n + view.tile - 1) / view.tile);
+
+    unsigned int mask = config->layout_touch;
+    if (mask == 0) {
+        mask = 1u | 1u << (view.fields / 2);
+    }
+    size_t useful_per_record = 0, packed = 0;
+    for (int f = 0; f < view.fields; f++) {
+        packed += (size_t)view.width[f];
+        if (mask & (1u << f)) {
+            view.touch[view.touched++] = f;
+            useful_per_record += (size_t)view.width[f];
+        }
+    }
+    if (view.touched == 0) {
+        return CB_ERR_ARGS;
+    }
+
+    err = cb_table_create(&table, "layout", "Record Layouts: AoS vs SoA "
+                          "vs AoSoA", headers, LAYOUT_COLS);
+    if (err) {
+        return err;
+    }
+
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    args    = calloc((size_t)most, sizeof(layout_arg_t));
+    threads = calloc((size_t)m, sizeof(cb_thread_t));
+    procs   = calloc((size_t)p, sizeof(cb_process_t));
+    if (!times || !args || !threads || !procs) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_layout_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name,
+                               (size_t)CB_MAX_WORKERS * sizeof(long int));
+    if (err) {
+        goto cleanup;
+    }
+    shm_created = true;
+    partials = cb_shared_mem_ptr(&shm);
+
+    long int expected = 0;
+    for (int i = 0; i < n; i++) {
+        expected += (long int)dataset[i] * view.touched;
+    }
+    for (int k = 0; k < view.touched; k++) {
+        expected += (long int)view.touch[k] * n;
+    }
+
+    double useful = (double)n * (double)useful_per_record;
+
+    /* One layout at a time, so only one copy of the records exists. */
+    for (int kind = 0; kind < LAYOUT_COUNT; kind++) {
+        err = layout_build(&view, (layout_kind_t)kind, dataset, &record);
+        if (err) {
+            goto cleanup;
+        }
+        mib[kind] = (double)view.bytes / (1024.0 * 1024.0);
+        double fetched = (double)fetched_lines(&view) * LAYOUT_LINE;
+        double base_sec = 0.0;
+
+        for (int mode = 0; mode < MODE_COUNT; mode++) {
+#ifndef CB_PLATFORM_UNIX
+            if (mode == MODE_PROCESS) {
+                continue;
+            }
+#endif
+            int workers = mode == MODE_THREAD ? m :
+                          mode == MODE_PROCESS ? p : 1;
+            workers = workers < view.strips ? workers : view.strips;
+
+            bool all_ok = true;
+            for (int iter = 0; iter < config->iterations; iter++) {
+                long int sum = 0;
+                double t_start = cb_time_now();
+                err = run_once(&view, (layout_mode_t)mode, workers, partials,
+                               args, threads, procs, &sum);
+                times[iter] = cb_time_now() - t_start;
+                if (err) {
+                    goto cleanup;
+                }
+                if (sum != expected) {
+                    all_ok = false;
+                }
+                if (config->verbose) {
+                    fprintf(stdout, "  layout %s %s %d iteration %d/%d: "
+                            "%.6fs\n", LAYOUT_NAMES[kind], MODE_LABELS[mode],
+                            workers, iter + 1, config->iterations,
+                            times[iter]);
+                }
+            }
+
+            cb_bench_stats_t stats;
+            err = cb_stats_compute(times, config->iterations, &stats);
+            if (!err) {
+                if (mode == MODE_SINGLE) {
+                    base_sec = stats.mean_sec;
+                }
+                err = add_row(table, &view, (layout_mode_t)mode, workers,
+                              &stats, useful, fetched,
+                              mode == MODE_SINGLE ? 0.0 : base_sec,
+                              all_ok ? "PASS" : "FAIL");
+            }
+            if (err) {
+                goto cleanup;
+            }
+        }
+
+        cb_aligned_free(view.data);
+        view.data = NULL;
+    }
+
+    char widths[4 * CB_LAYOUT_MAX_FIELDS], touched[4 * CB_LAYOUT_MAX_FIELDS];
+    int wlen = 0, tlen = 0;
+    for (int f = 0; f < view.fields; f++) {
+        wlen += snprintf(widths + wlen, sizeof(widths) - (size_t)wlen,
+                         "%s%d", f ? "," : "", view.width[f]);
+    }
+    for (int k = 0; k < view.touched; k++) {
+        tlen += snprintf(touched + tlen, sizeof(touched) - (size_t)tlen,
+                         "%s%d", k ? "," : "", view.touch[k]);
+    }
+    cb_table_add_note(table, "Record: %d fields of %s bytes; AoS record "
+                      "%zu bytes (%zu padding).", view.fields, widths,
+                      record, record - packed);
+    cb_table_add_note(table, "Summing fields %s: %zu bytes per record.",
+                      touched, useful_per_record);
+    cb_table_add_note(table, "Strips and AoSoA tiles hold %d records (one "
+                      "%d-byte line of the narrowest field). Sizes: AoS "
+                      "%.1f MiB, SoA %.1f MiB, AoSoA %.1f MiB.", view.tile,
+                      LAYOUT_LINE, mib[LAYOUT_AOS], mib[LAYOUT_SOA],
+                      mib[LAYOUT_AOSOA]);
+    cb_table_add_note(table, "Fetched counts distinct %d-byte lines holding "
+                      "a touched field (adjacent-line prefetch not "
+                      "counted).", LAYOUT_LINE);
+    cb_table_add_note(table, "Wasted is the share of fetched lines spent on "
+                      "other fields and padding.");
+    cb_table_add_note(table, "Speedup is vs single mode of the same layout.");
+#ifndef CB_PLATFORM_UNIX
+    cb_table_add_note(table, "Process modes require fork() and are not "
+                      "available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    cb_aligned_free(view.data);
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+    free(times);
+    free(args);
+    free(threads);
+    free(procs);
+    cb_table_destroy(table);
+    return err;
+}
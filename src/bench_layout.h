@@ -0,0 +1,41 @@
+/**
+ * @file bench_layout.h
+ * @brief Array-of-structs vs struct-of-arrays record layouts.
+ *
+ * The core modes scan a flat int array. Real records have several
+ * fields of different widths, and a scan that reads only some of them
+ * pays for the rest in whatever layout drags them through the cache.
+ * This suite builds the same records, one per dataset element, as an
+ * array of structs (AoS), a struct of arrays (SoA) and a tiled hybrid
+ * (AoSoA: each tile holds one cache line or more of every field), and
+ * sums a subset of the fields in single, thread and process mode.
+ *
+ * Rows report the bandwidth of the bytes the reduction needs, the
+ * bandwidth of the cache lines it has to fetch for them, and the share
+ * of fetched bytes that belong to untouched fields or padding.
+ */
+
+#ifndef CB_BENCH_LAYOUT_H
+#define CB_BENCH_LAYOUT_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the record-layout suite and produce a result table.
+ *
+ * Field f of record r holds dataset[r] + f, so every layout and mode
+ * must reproduce the same sum of the touched fields.
+ *
+ * @param dataset    Pointer to the integer array (one record per element).
+ * @param config     Benchmark configuration (reads array_length,
+ *                   layout_fields, layout_width, layout_touch,
+ *                   num_threads, num_processes, iterations, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_FORK, CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_layout_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out);
+
+#endif /* CB_BENCH_LAYOUT_H */
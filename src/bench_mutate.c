@@ -0,0 +1,398 @@
+/**
+ * @file bench_mutate.c
+ * @brief Implementation of the mutating workload.
+ *
+ * One writer thread and num_threads reader threads stay alive for the
+ * whole suite in a phase pool (pool.h) whose participant 0, the
+ * coordinating main thread, only chooses the phases:
+ *
+ * - update:      the writer sets Updates random elements to new values
+ *                and sets the bit of each touched block in the dirty
+ *                bitmap; readers idle.
+ * - incremental: each reader takes a share of the bitmap words, clears
+ *                them, re-sums the dirty blocks and returns the change
+ *                against the cached block partials, which it updates.
+ * - full:        each reader sums a contiguous slice from scratch, as
+ *                thread mode does.
+ *
+ * The writer also returns the change its updates made, so the
+ * coordinator tracks the exact total to check both queries against.
+ * Every thread times its own part of a phase, and a query's latency is
+ * that of the slowest reader, so no column includes the phase barrier;
+ * the cost of an empty phase is measured and reported for reference.
+ */
+
+#include "bench_mutate.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "kernel.h"
+#include "platform.h"
+#include "pool.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define MUTATE_COLS 9
+
+/** @brief Elements per dirty-tracking block (16 KiB of ints). */
+#define MUTATE_BLOCK 4096
+
+/** @brief Empty phases timed to estimate the barrier round trip. */
+#define MUTATE_IDLE_PHASES 16
+
+/** @brief Mutation rates of the sweep, in percent of the elements. */
+static const double MUTATE_RATES[] = { 0.001, 0.01, 0.1, 1.0, 10.0 };
+
+/** @brief Number of entries in MUTATE_RATES. */
+#define MUTATE_RATE_COUNT ((int)(sizeof(MUTATE_RATES) / sizeof(MUTATE_RATES[0])))
+
+/** @brief Phases run by the pool. */
+enum {
+    PHASE_IDLE = 0,     /**< Nobody works (barrier cost only). */
+    PHASE_UPDATE,       /**< Writer mutates and marks dirty blocks. */
+    PHASE_INCREMENTAL,  /**< Readers re-sum dirty blocks. */
+    PHASE_FULL          /**< Readers rescan the whole array. */
+};
+
+/**
+ * @brief One thread's phase result, padded to its own cache line.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) long int value;  /**< Change or sum. */
+    double seconds;  /**< Time spent on this thread's part of the phase. */
+} mutate_slot_t;
+
+/**
+ * @brief State shared by the pool.
+ */
+typedef struct {
+    int              *data;      /**< Mutable copy of the dataset. */
+    int               n;         /**< Elements. */
+    int               blocks;    /**< Blocks of MUTATE_BLOCK elements. */
+    int               words;     /**< 64-bit words in the dirty bitmap. */
+    long int         *partial;   /**< Cached sum per block. */
+    _Atomic uint64_t *dirty;     /**< Dirty bitmap, one bit per block. */
+    int               readers;   /**< Reader threads. */
+    long long         updates;   /**< Element updates per update phase. */
+    uint32_t          rng;       /**< Writer's xorshift32 state. */
+    mutate_slot_t    *slots;     /**< [0] writer, [1 ..] readers. */
+} mutate_shared_t;
+
+/** @brief Writer: apply the updates; returns the change in the total. */
+static long int apply_updates(mutate_shared_t *s)
+{
+    uint32_t x = s->rng;
+    long int delta = 0;
+
+    for (long long u = 0; u < s->updates; u++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        int idx = (int)(x % (uint32_t)s->n);
+        int value = (int)((x >> 7) % 100u) + 1;
+
+        delta += value - s->data[idx];
+        s->data[idx] = value;
+
+        /* Skip the atomic read-modify-write when the bit is already set. */
+        int b = idx / MUTATE_BLOCK;
+        _Atomic uint64_t *word = &s->dirty[b / 64];
+        uint64_t bit = (uint64_t)1 << (b % 64);
+        if (!(atomic_load_explicit(word, memory_order_relaxed) & bit)) {
+            atomic_fetch_or_explicit(word, bit, memory_order_relaxed);
+        }
+    }
+
+    s->rng = x;
+    return delta;
+}
+
+/** @brief Reader @p r: re-sum dirty blocks; returns the change. */
+static long int rereduce_dirty(mutate_shared_t *s, int r)
+{
+    int w_first = (int)((long long)s->words * r / s->readers);
+    int w_end = (int)((long long)s->words * (r + 1) / s->readers);
+    long int delta = 0;
+
+    for (int w = w_first; w < w_end; w++) {
+        uint64_t bits = atomic_exchange_explicit(&s->dirty[w], 0,
+                                                 memory_order_relaxed);
+        for (int j = 0; bits != 0; j++, bits >>= 1) {
+            if (!(bits & 1)) {
+                continue;
+            }
+            int b = w * 64 + j;
+            int start = b * MUTATE_BLOCK;
+            int length = s->n - start < MUTATE_BLOCK ? s->n - start
+                                                     : MUTATE_BLOCK;
+            long int sum = cb_kernel_sum(s->data + start, length);
+            delta += sum - s->partial[b];
+            s->partial[b] = sum;
+        }
+    }
+
+    return delta;
+}
+
+/** @brief Reader @p r: sum its contiguous slice from scratch. */
+static long int full_rescan(mutate_shared_t *s, int r)
+{
+    int start = (int)((long long)s->n * r / s->readers);
+    int end = (int)((long long)s->n * (r + 1) / s->readers);
+    return cb_kernel_sum(s->data + start, end - start);
+}
+
+/**
+ * @brief Pool step: participant 1 is the writer, 2 .. readers + 1 the
+ *        readers; the coordinator (0) does no work.
+ */
+static void mutate_step(void *ctx, int id, int phase)
+{
+    mutate_shared_t *s = (mutate_shared_t *)ctx;
+    int t = id - 1;
+
+    if (t < 0 || phase == PHASE_IDLE) {
+        return;
+    }
+
+    double t_start = cb_time_now();
+    if (t == 0) {
+        if (phase == PHASE_UPDATE) {
+            s->slots[0].value = apply_updates(s);
+        }
+    } else if (phase == PHASE_INCREMENTAL) {
+        s->slots[t].value = rereduce_dirty(s, t - 1);
+    } else if (phase == PHASE_FULL) {
+        s->slots[t].value = full_rescan(s, t - 1);
+    }
+    s->slots[t].seconds = cb_time_now() - t_start;
+}
+
+/** @brief Slowest reader's time in the last phase. */
+static double reader_seconds(const mutate_shared_t *s)
+{
+    double slowest = 0.0;
+    for (int r = 1; r <= s->readers; r++) {
+        if (s->slots[r].seconds > slowest) {
+            slowest = s->slots[r].seconds;
+        }
+    }
+    return slowest;
+}
+
+/** @brief Sum of the readers' phase results. */
+static long int reader_total(const mutate_shared_t *s)
+{
+    long int total = 0;
+    for (int r = 1; r <= s->readers; r++) {
+        total += s->slots[r].value;
+    }
+    return total;
+}
+
+/** @brief Number of set bits in the dirty bitmap. */
+static int count_dirty(mutate_shared_t *s)
+{
+    int count = 0;
+    for (int w = 0; w < s->words; w++) {
+        uint64_t bits = atomic_load_explicit(&s->dirty[w],
+                                             memory_order_relaxed);
+        for (; bits != 0; bits &= bits - 1) {
+            count++;
+        }
+    }
+    return count;
+}
+
+cb_error_t cb_bench_mutate_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out)
+{
+    static const char *const headers[MUTATE_COLS] = {
+        "Rate", "Updates", "Dirty blocks", "Update (us)", "ns/update",
+        "Incremental (us)", "Full rescan (us)", "Speedup", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    mutate_shared_t *s = NULL;
+    cb_pool_t *pool = NULL;
+
+    if (!dataset || !config || !table_out || config->num_threads < 1) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+
+    err = cb_table_create(&table, "mutate", "Mutating Dataset: Incremental "
+                          "Re-reduction vs Full Rescan", headers, MUTATE_COLS);
+    if (err) {
+        return err;
+    }
+
+    s = calloc(1, sizeof(mutate_shared_t));
+    if (!s) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    s->n = n;
+    s->readers = m;
+    s->blocks = (n + MUTATE_BLOCK - 1) / MUTATE_BLOCK;
+    s->words = (s->blocks + 63) / 64;
+    s->rng = config->seed ? config->seed : 1u;
+    s->data = malloc((size_t)n * sizeof(int));
+    s->partial = calloc((size_t)s->blocks, sizeof(long int));
+    s->dirty = calloc((size_t)s->words, sizeof(uint64_t));
+    s->slots = cb_aligned_alloc(CB_CACHE_LINE,
+                                (size_t)(m + 1) * sizeof(mutate_slot_t));
+    if (!s->data || !s->partial || !s->dirty || !s->slots) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* ---- Private copy and initial block partials ---- */
+    memcpy(s->data, dataset, (size_t)n * sizeof(int));
+    long int expected = 0;
+    double t_build = cb_time_now();
+    for (int b = 0; b < s->blocks; b++) {
+        int start = b * MUTATE_BLOCK;
+        int length = n - start < MUTATE_BLOCK ? n - start : MUTATE_BLOCK;
+        s->partial[b] = cb_kernel_sum(s->data + start, length);
+        expected += s->partial[b];
+    }
+    t_build = cb_time_now() - t_build;
+    long int cached = expected;
+
+    /* ---- Start the pool: coordinator, writer and readers ---- */
+    err = cb_pool_create(&pool, m + 2, mutate_step, s);
+    if (err) {
+        goto cleanup;
+    }
+
+    double idle = 0.0;
+    for (int i = 0; i < MUTATE_IDLE_PHASES; i++) {
+        double t = cb_pool_run(pool, PHASE_IDLE);
+        idle = (i == 0 || t < idle) ? t : idle;
+    }
+
+    /* ---- Rates ---- */
+    bool sweep = config->mutate_rate <= 0.0;
+    int rate_count = sweep ? MUTATE_RATE_COUNT : 1;
+    double crossover = 0.0;
+    bool lost = false;
+
+    for (int ri = 0; ri < rate_count; ri++) {
+        double rate = sweep ? MUTATE_RATES[ri] : config->mutate_rate;
+        long long updates = llround(rate / 100.0 * n);
+        double update_sum = 0.0, inc_sum = 0.0, full_sum = 0.0;
+        double dirty_sum = 0.0;
+        bool all_ok = true;
+
+        s->updates = updates < 1 ? 1 : updates;
+
+        /* Iteration 0 is an untimed warm-up. */
+        for (int iter = 0; iter <= config->iterations; iter++) {
+            cb_pool_run(pool, PHASE_UPDATE);
+            double t_update = s->slots[0].seconds;
+            expected += s->slots[0].value;
+            int dirty = count_dirty(s);
+
+            cb_pool_run(pool, PHASE_INCREMENTAL);
+            double t_inc = reader_seconds(s);
+            cached += reader_total(s);
+
+            cb_pool_run(pool, PHASE_FULL);
+            double t_full = reader_seconds(s);
+            long int full = reader_total(s);
+
+            if (cached != expected || full != expected) {
+                all_ok = false;
+            }
+            if (iter == 0) {
+                continue;
+            }
+
+            update_sum += t_update;
+            inc_sum += t_inc;
+            full_sum += t_full;
+            dirty_sum += dirty;
+
+            if (config->verbose) {
+                fprintf(stdout, "  mutate %g%% iteration %d/%d: update %.1fus, "
+                        "%d dirty, incremental %.1fus, full %.1fus\n", rate,
+                        iter, config->iterations, t_update * 1e6, dirty,
+                        t_inc * 1e6, t_full * 1e6);
+            }
+        }
+
+        double iters = (double)config->iterations;
+        double update_mean = update_sum / iters;
+        double inc_mean = inc_sum / iters;
+        double full_mean = full_sum / iters;
+
+        err = cb_table_add_row(table);
+        if (err) {
+            goto cleanup;
+        }
+        cb_table_set(table, 0, "%g%%", rate);
+        cb_table_set(table, 1, "%lld", s->updates);
+        cb_table_set(table, 2, "%.1f%%",
+                     100.0 * dirty_sum / iters / s->blocks);
+        cb_table_set(table, 3, "%.1f", update_mean * 1e6);
+        cb_table_set(table, 4, "%.1f", update_mean * 1e9 / (double)s->updates);
+        cb_table_set(table, 5, "%.1f", inc_mean * 1e6);
+        cb_table_set(table, 6, "%.1f", full_mean * 1e6);
+        cb_table_set(table, 7, "%.2fx", inc_mean > 0.0 ? full_mean / inc_mean
+                                                       : 0.0);
+        cb_table_set(table, 8, "%s", all_ok ? "PASS" : "FAIL");
+
+        /* Rates ascend, so the crossover ends the first losing rate. */
+        if (inc_mean < full_mean && !lost) {
+            crossover = rate;
+        } else {
+            lost = true;
+        }
+    }
+
+    cb_table_add_note(table, "%d blocks of %d elements (%d KiB); %d reader "
+                      "thread%s and one writer; partials built in %.6f s.",
+                      s->blocks, MUTATE_BLOCK,
+                      (int)(MUTATE_BLOCK * sizeof(int) / 1024), m,
+                      m == 1 ? "" : "s", t_build);
+    cb_table_add_note(table, "Times are measured by the threads (a query by "
+                      "its slowest reader), without the phase barrier; an "
+                      "empty phase takes %.1f us.", idle * 1e6);
+    if (crossover > 0.0) {
+        cb_table_add_note(table, "Incremental beats a full rescan up to a "
+                          "%g%% mutation rate here.", crossover);
+    } else {
+        cb_table_add_note(table, "Incremental did not beat a full rescan at "
+                          "any rate measured.");
+    }
+    cb_table_add_note(table, "Data: a private copy of the dataset; updates "
+                      "write values 1 - 100 at seeded random positions.");
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    cb_pool_destroy(pool);
+    if (s) {
+        cb_aligned_free(s->slots);
+        free(s->data);
+        free(s->partial);
+        free((void *)s->dirty);
+        free(s);
+    }
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file bench_mutate.h
+ * @brief Mutating workload: incremental re-reduction of dirty blocks.
+ *
+ * Every core mode recomputes the whole sum on every iteration, even
+ * when only a few elements changed since the last one. This suite
+ * keeps a per-block partial sum of a private copy of the dataset. Each
+ * iteration a writer thread updates a fraction of the elements and
+ * marks their blocks in a dirty bitmap; reader threads then re-sum
+ * only the dirty blocks against the cached partials. The update cost,
+ * the incremental query latency and a full rescan of the same data are
+ * reported for each mutation rate.
+ */
+
+#ifndef CB_BENCH_MUTATE_H
+#define CB_BENCH_MUTATE_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the mutating workload and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array (copied, not modified).
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, seed, mutate_rate, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_THREAD
+ *         on failure.
+ */
+cb_error_t cb_bench_mutate_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out);
+
+#endif /* CB_BENCH_MUTATE_H */
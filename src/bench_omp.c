@@ -0,0 +1,243 @@
+/**
+ * @file bench_omp.c
+ * @brief Implementation of the OpenMP comparison mode.
+ *
+ * Rows:
+ * - single, thread:  the core modes, rerun so they share this table.
+ * - omp-static:      one slice per thread, as in thread mode, under
+ *                    schedule(static).
+ * - omp-dynamic:     CB_OMP_BLOCK-element blocks under schedule(dynamic).
+ * - omp-guided:      the same blocks under schedule(guided).
+ * - omp-reduction:   the cb_array_sum() loop written inline with a
+ *                    reduction(+) clause, leaving the split to OpenMP.
+ *
+ * Partial sums are combined serially, as in thread mode. Thread mode
+ * creates its threads in every run; the OpenMP runtime keeps its team
+ * alive, so one untimed parallel region warms it up first.
+ */
+
+#include "bench_omp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_single.h"
+#include "bench_thread.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+#include "worker.h"
+
+#ifdef CB_HAVE_OPENMP
+
+/** @brief OpenMP variants. */
+typedef enum {
+    OMP_STATIC,
+    OMP_DYNAMIC,
+    OMP_GUIDED,
+    OMP_REDUCTION,
+    OMP_NUM_KINDS
+} omp_kind_t;
+
+/** @brief Row labels, indexed by omp_kind_t. */
+static const char *const omp_kind_names[OMP_NUM_KINDS] = {
+    "omp-static", "omp-dynamic", "omp-guided", "omp-reduction"
+};
+
+/**
+ * @brief Sum the dataset once with one OpenMP variant.
+ *
+ * @param bounds    num_threads + 1 slice boundaries (omp-static).
+ * @param partials  One slot per slice or block.
+ */
+static long int omp_sum_once(omp_kind_t kind, const int *dataset, int n,
+                             int num_threads, const int *bounds,
+                             long int *partials)
+{
+    int nblocks = (n + CB_OMP_BLOCK - 1) / CB_OMP_BLOCK;
+    int nparts = nblocks;
+    long int sum = 0;
+
+    switch (kind) {
+    case OMP_STATIC:
+        nparts = num_threads;
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+        for (int i = 0; i < num_threads; i++) {
+            partials[i] = cb_array_sum(dataset, bounds[i],
+                                       bounds[i + 1] - bounds[i]).sum;
+        }
+        break;
+
+    case OMP_DYNAMIC:
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (int b = 0; b < nblocks; b++) {
+            int start = b * CB_OMP_BLOCK;
+            int len = (n - start < CB_OMP_BLOCK) ? n - start : CB_OMP_BLOCK;
+            partials[b] = cb_array_sum(dataset, start, len).sum;
+        }
+        break;
+
+    case OMP_GUIDED:
+#pragma omp parallel for num_threads(num_threads) schedule(guided)
+        for (int b = 0; b < nblocks; b++) {
+            int start = b * CB_OMP_BLOCK;
+            int len = (n - start < CB_OMP_BLOCK) ? n - start : CB_OMP_BLOCK;
+            partials[b] = cb_array_sum(dataset, start, len).sum;
+        }
+        break;
+
+    case OMP_REDUCTION:
+    default:
+#pragma omp parallel for num_threads(num_threads) schedule(static) reduction(+:sum)
+        for (int i = 0; i < n; i++) {
+            sum += dataset[i];
+        }
+        return sum;
+    }
+
+    for (int i = 0; i < nparts; i++) {
+        sum += partials[i];
+    }
+    return sum;
+}
+
+/** @brief Value of an environment variable, or "unset". */
+static const char *env_or_unset(const char *name)
+{
+    const char *v = getenv(name);
+    return (v && v[0]) ? v : "unset";
+}
+
+#endif /* CB_HAVE_OPENMP */
+
+bool cb_bench_omp_available(void)
+{
+#ifdef CB_HAVE_OPENMP
+    return true;
+#else
+    return false;
+#endif
+}
+
+cb_error_t cb_bench_omp_run(const int *dataset, const cb_config_t *config,
+                            cb_table_t **table_out)
+{
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    cb_run_report_t single, thread;
+#ifdef CB_HAVE_OPENMP
+    int *bounds = NULL;
+    long int *partials = NULL;
+    double *times = NULL;
+#endif
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    double melems = n / 1e6;
+
+    err = cb_table_create_timing(&table, "omp", "OpenMP vs Hand-Rolled Threads",
+                                 "Melem/s");
+    if (err) {
+        return err;
+    }
+
+    /* ---- baselines: the core single and thread modes ---- */
+    err = cb_bench_single_run(dataset, config, &single);
+    if (!err) {
+        err = cb_table_add_timing_row(table, "single", 1, &single.stats,
+                                      single.stats.mean_sec, melems, "PASS");
+    }
+    if (!err) {
+        err = cb_bench_thread_run(dataset, config, &thread);
+    }
+    if (!err) {
+        err = cb_table_add_timing_row(table, "thread", m, &thread.stats,
+                                      single.stats.mean_sec, melems,
+                                      thread.sum == single.sum ? "PASS" : "FAIL");
+    }
+    if (err) {
+        goto cleanup;
+    }
+
+#ifdef CB_HAVE_OPENMP
+    int nblocks = (n + CB_OMP_BLOCK - 1) / CB_OMP_BLOCK;
+    int nparts = nblocks > m ? nblocks : m;
+
+    bounds   = calloc((size_t)m + 1, sizeof(int));
+    partials = calloc((size_t)nparts, sizeof(long int));
+    times    = calloc((size_t)config->iterations, sizeof(double));
+    if (!bounds || !partials || !times) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* Same split as thread mode: first (n % m) slices get one extra. */
+    int base_len = n / m, remainder = n % m;
+    for (int i = 0; i < m; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+
+    /* Warm-up: start the OpenMP team outside the timed runs. */
+    (void)omp_sum_once(OMP_STATIC, dataset, n, m, bounds, partials);
+
+    for (int k = 0; k < OMP_NUM_KINDS; k++) {
+        bool all_ok = true;
+
+        for (int iter = 0; iter < config->iterations; iter++) {
+            double t_start = cb_time_now();
+            long int sum = omp_sum_once((omp_kind_t)k, dataset, n, m,
+                                        bounds, partials);
+            times[iter] = cb_time_now() - t_start;
+
+            if (sum != single.sum) {
+                all_ok = false;
+            }
+            if (config->verbose) {
+                fprintf(stdout, "  %s iteration %d/%d: %.6fs\n",
+                        omp_kind_names[k], iter + 1, config->iterations,
+                        times[iter]);
+            }
+        }
+
+        cb_bench_stats_t stats;
+        err = cb_stats_compute(times, config->iterations, &stats);
+        if (!err) {
+            err = cb_table_add_timing_row(table, omp_kind_names[k], m, &stats,
+                                          single.stats.mean_sec, melems,
+                                          all_ok ? "PASS" : "FAIL");
+        }
+        if (err) {
+            goto cleanup;
+        }
+    }
+
+    cb_table_add_note(table, "OpenMP %d; OMP_PROC_BIND=%s, OMP_PLACES=%s.",
+                      _OPENMP, env_or_unset("OMP_PROC_BIND"),
+                      env_or_unset("OMP_PLACES"));
+    cb_table_add_note(table, "thread creates its threads every run; the "
+                      "OpenMP team is warmed up once and reused. "
+                      "omp-dynamic and omp-guided use %d-element blocks.",
+                      CB_OMP_BLOCK);
+#else
+    cb_table_add_note(table, "Built without OpenMP: omp-* rows skipped. "
+                      "Reconfigure with an OpenMP-capable compiler.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+#ifdef CB_HAVE_OPENMP
+    free(bounds);
+    free(partials);
+    free(times);
+#endif
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file bench_omp.h
+ * @brief OpenMP comparison mode for concur-bench.
+ *
+ * Answers whether the hand-written thread code beats OpenMP: the same
+ * dataset is summed by the core single and thread modes and by four
+ * OpenMP variants (static, dynamic and guided loop schedules around
+ * cb_array_sum(), and a plain reduction loop), all in one table.
+ *
+ * OpenMP support is detected by CMake and is optional. In a build
+ * without it (CB_HAVE_OPENMP undefined) only the baseline rows are
+ * produced and a note says why.
+ */
+
+#ifndef CB_BENCH_OMP_H
+#define CB_BENCH_OMP_H
+
+#include "error.h"
+#include "types.h"
+
+/** @brief Elements per block for the dynamic and guided schedules. */
+#define CB_OMP_BLOCK  16384
+
+/**
+ * @brief Run the OpenMP comparison and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_MUTEX on failure.
+ */
+cb_error_t cb_bench_omp_run(const int *dataset, const cb_config_t *config,
+                            cb_table_t **table_out);
+
+/**
+ * @brief Whether this build includes the OpenMP modes.
+ * @return true if compiled with OpenMP.
+ */
+bool cb_bench_omp_available(void);
+
+#endif /* CB_BENCH_OMP_H */
@@ -0,0 +1,335 @@
+/**
+ * @file bench_prefetch.c
+ * @brief Implementation of the prefetch-distance sweep.
+ *
+ * Thread counts run in powers of two up to config->num_threads (which
+ * is always included). At each count the rows are: plain loads; T0
+ * and NTA software prefetch at every distance of the sweep (from
+ * CB_PREFETCH_MIN_DISTANCE in steps of four, or only
+ * config->prefetch_distance); then SSE4.1 MOVDQA and MOVNTDQA loads.
+ * The prefetch rows are scalar and compared with the plain row; the
+ * streaming row is compared with the MOVDQA row, which runs the same
+ * vector loop, so that vectorization is not credited to the load. The
+ * last row of each thread count also names the best prefetch row.
+ *
+ * Threads split the array statically, as in thread mode. Workers are
+ * created before the clock starts and released through a start gate,
+ * so a row times only the sums (and the join), not thread creation.
+ */
+
+#include "bench_prefetch.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "barrier.h"
+#include "kernel.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define PREFETCH_COLS 8
+
+/** @brief Distances in the default sweep. */
+#define PREFETCH_SWEEP_STEPS 5
+
+/** @brief Growth factor between distances. */
+#define PREFETCH_SWEEP_FACTOR 4
+
+/** @brief Gain (in percent) below which prefetching is judged useless. */
+#define PREFETCH_GAIN_PCT 3.0
+
+/**
+ * @brief State shared by the threads of one run.
+ */
+typedef struct {
+    const int     *dataset;   /**< Input array. */
+    const int     *bounds;    /**< workers + 1 slice boundaries. */
+    cb_load_kind_t kind;      /**< Load strategy. */
+    int            distance;  /**< Prefetch distance in elements. */
+    atomic_long    total;     /**< Sum of all partials. */
+    cb_start_gate_t gate;     /**< Start gate. */
+} prefetch_shared_t;
+
+/**
+ * @brief Per-thread argument.
+ */
+typedef struct {
+    prefetch_shared_t *shared;  /**< Shared run state. */
+    int                id;      /**< Worker index. */
+} prefetch_arg_t;
+
+/** @brief Thread body: wait for the gate, sum the slice. */
+static void *prefetch_thread_fn(void *arg)
+{
+    prefetch_arg_t *a = (prefetch_arg_t *)arg;
+    prefetch_shared_t *s = a->shared;
+
+    if (!cb_start_gate_wait(&s->gate)) {
+        return NULL;
+    }
+
+    int start = s->bounds[a->id];
+    long int partial = cb_kernel_sum_load(s->dataset + start,
+                                          s->bounds[a->id + 1] - start,
+                                          s->kind, s->distance);
+    atomic_fetch_add(&s->total, partial);
+    return NULL;
+}
+
+/** @brief Run one timed sum on @p workers threads. */
+static cb_error_t run_once(prefetch_shared_t *s, int workers,
+                           cb_thread_t *threads, prefetch_arg_t *args,
+                           double *elapsed)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    atomic_store(&s->total, 0);
+    cb_start_gate_init(&s->gate);
+
+    for (int i = 0; i < workers; i++) {
+        args[i].shared = s;
+        args[i].id = i;
+        err = cb_thread_create(&threads[i], prefetch_thread_fn, &args[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    double t_start = cb_time_now();
+    if (err) {
+        cb_start_gate_abort(&s->gate);
+    } else {
+        cb_start_gate_open(&s->gate);
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+    *elapsed = cb_time_now() - t_start;
+
+    return err;
+}
+
+/** @brief Fill workers + 1 slice boundaries, as in thread mode. */
+static void split(int *bounds, int n, int workers)
+{
+    int base_len = n / workers, remainder = n % workers;
+    bounds[0] = 0;
+    for (int i = 0; i < workers; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+}
+
+/** @brief Append one row; @p base_gbps is 0 for a baseline row. */
+static cb_error_t add_row(cb_table_t *table, int workers, cb_load_kind_t kind,
+                          int distance, const cb_bench_stats_t *stats,
+                          double gbps, double base_gbps, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    cb_table_set(table, 0, "%d", workers);
+    cb_table_set(table, 1, "%s", cb_load_kind_name(kind));
+    if (kind == CB_LOAD_PREFETCH || kind == CB_LOAD_PREFETCH_NTA) {
+        cb_table_set(table, 2, "%zu", (size_t)distance * sizeof(int));
+    } else {
+        cb_table_set(table, 2, "n/a");
+    }
+    cb_table_set(table, 3, "%.6f", stats->mean_sec);
+    cb_table_set(table, 4, "%.2f", gbps);
+    if (base_gbps > 0.0) {
+        cb_table_set(table, 5, "%+.1f%%", (gbps / base_gbps - 1.0) * 100.0);
+    } else {
+        cb_table_set(table, 5, "baseline");
+    }
+    cb_table_set(table, 7, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_prefetch_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out)
+{
+    static const char *const headers[PREFETCH_COLS] = {
+        "Threads", "Loads", "Distance (B)", "Mean (s)", "GB/s", "Gain",
+        "Best prefetch", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    int *bounds = NULL;
+    double *times = NULL;
+    cb_thread_t *threads = NULL;
+    prefetch_arg_t *args = NULL;
+    prefetch_shared_t *shared = NULL;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    double bytes = (double)n * sizeof(int);
+
+    int distances[PREFETCH_SWEEP_STEPS];
+    int ndist = 0;
+    if (config->prefetch_distance > 0) {
+        distances[ndist++] = config->prefetch_distance;
+    } else {
+        for (int d = CB_PREFETCH_MIN_DISTANCE; ndist < PREFETCH_SWEEP_STEPS;
+             d *= PREFETCH_SWEEP_FACTOR) {
+            distances[ndist++] = d;
+        }
+    }
+
+    err = cb_table_create(&table, "prefetch",
+                          "Prefetch Distance and Streaming Loads",
+                          headers, PREFETCH_COLS);
+    if (err) {
+        return err;
+    }
+
+    bounds  = calloc((size_t)m + 1, sizeof(int));
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    threads = calloc((size_t)m, sizeof(cb_thread_t));
+    args    = calloc((size_t)m, sizeof(prefetch_arg_t));
+    shared  = calloc(1, sizeof(prefetch_shared_t));
+    if (!bounds || !times || !threads || !args || !shared) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    long int expected = cb_kernel_sum_load(dataset, n, CB_LOAD_PLAIN, 0);
+    bool stream = cb_kernel_stream_supported();
+    shared->dataset = dataset;
+    shared->bounds = bounds;
+
+    /* Rows per thread count: plain, T0 and NTA per distance, vector,
+     * stream. */
+    int nrows = 3 + 2 * ndist;
+
+    for (int workers = 1; workers <= m;
+         workers = (workers < m && workers * 2 > m) ? m : workers * 2) {
+        double plain_gbps = 0.0, best_gbps = 0.0, vector_gbps = 0.0;
+        cb_load_kind_t best_kind = CB_LOAD_PLAIN;
+        int best_distance = 0;
+
+        split(bounds, n, workers);
+
+        for (int r = 0; r < nrows; r++) {
+            cb_load_kind_t kind;
+            int distance = 0;
+            if (r == 0) {
+                kind = CB_LOAD_PLAIN;
+            } else if (r == nrows - 2) {
+                kind = CB_LOAD_VECTOR;
+            } else if (r == nrows - 1) {
+                kind = CB_LOAD_STREAM;
+            } else {
+                kind = (r - 1) < ndist ? CB_LOAD_PREFETCH : CB_LOAD_PREFETCH_NTA;
+                distance = distances[(r - 1) % ndist];
+            }
+
+            bool all_ok = true;
+            shared->kind = kind;
+            shared->distance = distance;
+
+            for (int iter = 0; iter < config->iterations; iter++) {
+                err = run_once(shared, workers, threads, args, &times[iter]);
+                if (err) {
+                    goto cleanup;
+                }
+                if (atomic_load(&shared->total) != expected) {
+                    all_ok = false;
+                }
+                if (config->verbose) {
+                    fprintf(stdout, "  prefetch %d thread%s %s %d iteration "
+                            "%d/%d: %.6fs\n", workers,
+                            workers == 1 ? "" : "s", cb_load_kind_name(kind),
+                            distance, iter + 1, config->iterations,
+                            times[iter]);
+                }
+            }
+
+            cb_bench_stats_t stats;
+            err = cb_stats_compute(times, config->iterations, &stats);
+            if (err) {
+                goto cleanup;
+            }
+
+            double gbps = stats.mean_sec > 0.0 ? bytes / stats.mean_sec / 1e9
+                                               : 0.0;
+            double base = 0.0;
+            if (kind == CB_LOAD_STREAM) {
+                base = vector_gbps;
+            } else if (kind != CB_LOAD_PLAIN && kind != CB_LOAD_VECTOR) {
+                base = plain_gbps;
+            }
+            err = add_row(table, workers, kind, distance, &stats, gbps, base,
+                          all_ok ? "PASS" : "FAIL");
+            if (err) {
+                goto cleanup;
+            }
+
+            if (kind == CB_LOAD_PLAIN) {
+                plain_gbps = gbps;
+                best_gbps = gbps;
+            } else if (kind == CB_LOAD_VECTOR) {
+                vector_gbps = gbps;
+            } else if (kind != CB_LOAD_STREAM && gbps > best_gbps) {
+                best_gbps = gbps;
+                best_kind = kind;
+                best_distance = distance;
+            }
+        }
+
+        /* Summarize on the stream row, whose Gain is stream vs MOVDQA. */
+        double gain = plain_gbps > 0.0 ? (best_gbps / plain_gbps - 1.0) * 100.0
+                                       : 0.0;
+        if (best_kind == CB_LOAD_PLAIN || gain < PREFETCH_GAIN_PCT) {
+            cb_table_set(table, 6, "none");
+        } else {
+            cb_table_set(table, 6, "%s %zu B %+.1f%%",
+                         cb_load_kind_name(best_kind),
+                         (size_t)best_distance * sizeof(int), gain);
+        }
+    }
+
+    cb_table_add_note(table, "Working set %.1f MiB; prefetching only matters "
+                      "well beyond the last-level cache.",
+                      bytes / (1024.0 * 1024.0));
+    cb_table_add_note(table, "Gain: prefetch rows vs plain, stream vs "
+                      "vector (the same SSE4.1 loop with MOVDQA).");
+    cb_table_add_note(table, "Best prefetch: the fastest prefetch row per "
+                      "thread count, or none if none beats plain loads by "
+                      "%.0f%% or more.", PREFETCH_GAIN_PCT);
+    cb_table_add_note(table, stream
+                      ? "On ordinary write-back memory most CPUs treat "
+                        "MOVNTDQA as a normal load."
+                      : "SSE4.1 unavailable; the vector and stream rows use "
+                        "plain loads.");
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    free(bounds);
+    free(times);
+    free(threads);
+    free(args);
+    free(shared);
+    cb_table_destroy(table);
+    return err;
+}
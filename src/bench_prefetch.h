@@ -0,0 +1,33 @@
+/**
+ * @file bench_prefetch.h
+ * @brief Prefetch-distance and streaming-load sweep.
+ *
+ * Sums the dataset with the runtime-distance kernels from kernel.h:
+ * plain loads, software prefetch (into all levels and non-temporal)
+ * at a range of distances, and MOVNTDQA streaming loads, each at
+ * several thread counts. Throughput is reported per row and relative
+ * to plain loads at the same thread count, which shows whether the
+ * hardware prefetcher already saturates memory bandwidth. The effect
+ * is only meaningful for arrays well beyond the last-level cache.
+ */
+
+#ifndef CB_BENCH_PREFETCH_H
+#define CB_BENCH_PREFETCH_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the prefetch sweep and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, prefetch_distance,
+ *                   verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD on failure.
+ */
+cb_error_t cb_bench_prefetch_run(const int *dataset, const cb_config_t *config,
+                                 cb_table_t **table_out);
+
+#endif /* CB_BENCH_PREFETCH_H */
@@ -35,6 +35,7 @@
 #include <windows.h>
 
 #include "input.h"
+#include "kernel.h"
 #include "platform.h"
 #include "stats.h"
 #include "worker.h"
@@ -156,9 +157,13 @@ cb_error_t cb_bench_process_run(const int *dataset,
             snprintf(start_str, sizeof(start_str), "%d", offset);
             snprintf(len_str, sizeof(len_str), "%d", chunk);
 
+            cb_kernel_info_t kinfo;
+            cb_kernel_get_info(&kinfo);
+
             const char *child_argv[] = {
                 exe_path, "--worker", id_str, shm_name,
-                size_str, nw_str, start_str, len_str, NULL
+                size_str, nw_str, start_str, len_str,
+                "--kernel", kinfo.kernel->name, NULL
             };
 
             err = cb_process_spawn(&procs[i], child_argv, NULL, NULL);
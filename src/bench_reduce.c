@@ -0,0 +1,562 @@
+/**
+ * @file bench_reduce.c
+ * @brief Implementation of the result-combine suite.
+ *
+ * Rows:
+ * - thread-mutex:  threads add their partials to one shared sum under
+ *                  a mutex, as in thread mode.
+ * - thread-tree:   threads combine through padded slots and spin-then-
+ *                  futex flags in log2(N) rounds.
+ * - process-pipe:  children send their partials through one pipe each,
+ *                  read by the parent in order, as in process mode.
+ * - process-tree:  children combine through slots in shared memory;
+ *                  child 0 leaves the total there.
+ *
+ * Every worker records when it finished its slice. The combine tail of
+ * a run is the time from the latest of those to the moment the total
+ * exists (the last mutex release, the last pipe read, or participant
+ * 0 finishing the tree). Worker creation is timed in the run time, as
+ * in the core modes.
+ */
+
+#include "bench_reduce.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "platform.h"
+#include "reduce.h"
+#include "stats.h"
+#include "table.h"
+#include "worker.h"
+
+/** @brief Number of table columns. */
+#define REDUCE_COLS 8
+
+/**
+ * @brief State shared by the threads of one run.
+ */
+typedef struct {
+    const int    *dataset;      /**< Input array. */
+    const int    *bounds;       /**< workers + 1 slice boundaries. */
+    bool          tree;         /**< Tree combine instead of the mutex. */
+    cb_mutex_t    mutex;        /**< Serial combine lock. */
+    cb_reduce_t  *reduce;       /**< Tree combine state. */
+    uint32_t      episode;      /**< Tree episode of this run. */
+    long int      sum;          /**< Combined total. */
+    double        combine_end;  /**< When the total was complete. */
+    double       *compute_end; /**< Per worker: when its slice was summed. */
+    cb_start_gate_t gate;       /**< Start gate. */
+} reduce_shared_t;
+
+/**
+ * @brief Per-thread argument.
+ */
+typedef struct {
+    reduce_shared_t *shared;  /**< Shared run state. */
+    int              id;      /**< Worker index. */
+} reduce_arg_t;
+
+/** @brief Thread body: sum the slice, then combine. */
+static void *reduce_thread_fn(void *arg)
+{
+    reduce_arg_t *a = (reduce_arg_t *)arg;
+    reduce_shared_t *s = a->shared;
+
+    if (!cb_start_gate_wait(&s->gate)) {
+        return NULL;
+    }
+
+    long int partial = cb_array_sum(s->dataset, s->bounds[a->id],
+                                    s->bounds[a->id + 1] - s->bounds[a->id]).sum;
+    s->compute_end[a->id] = cb_time_now();
+
+    if (s->tree) {
+        long int total = cb_reduce_tree(s->reduce, a->id, s->episode, partial);
+        if (a->id == 0) {
+            s->sum = total;
+            s->combine_end = cb_time_now();
+        }
+    } else {
+        /* The last holder of the lock completes the total. */
+        cb_mutex_lock(&s->mutex);
+        s->sum += partial;
+        s->combine_end = cb_time_now();
+        cb_mutex_unlock(&s->mutex);
+    }
+
+    return NULL;
+}
+
+/** @brief Run one thread sum; leaves the total and timestamps in @p s. */
+static cb_error_t run_threads(reduce_shared_t *s, int workers,
+                              cb_thread_t *threads, reduce_arg_t *args)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    s->sum = 0;
+    cb_start_gate_init(&s->gate);
+
+    for (int i = 0; i < workers; i++) {
+        args[i].shared = s;
+        args[i].id = i;
+        err = cb_thread_create(&threads[i], reduce_thread_fn, &args[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    if (err) {
+        cb_start_gate_abort(&s->gate);
+    } else {
+        cb_start_gate_open(&s->gate);
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    return err;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/**
+ * @brief Shared-memory layout of the process-tree row.
+ */
+typedef struct {
+    cb_reduce_t reduce;                       /**< Tree combine state. */
+    double      compute_end[CB_MAX_WORKERS];  /**< Per child: slice summed. */
+    double      combine_end;                  /**< Set by child 0. */
+    long int    sum;                          /**< Set by child 0. */
+} reduce_shm_t;
+
+/**
+ * @brief What a process-pipe child sends to the parent.
+ */
+typedef struct {
+    long int sum;          /**< Partial sum. */
+    double   compute_end;  /**< When the slice was summed. */
+} pipe_msg_t;
+
+/**
+ * @brief Argument of one child process.
+ */
+typedef struct {
+    const int    *dataset;  /**< Input array (inherited through fork). */
+    int           start;    /**< First element of the slice. */
+    int           length;   /**< Elements in the slice. */
+    int           id;       /**< Child index. */
+    uint32_t      episode;  /**< Tree episode of this run. */
+    reduce_shm_t *shm;      /**< Tree row: shared state, else NULL. */
+    cb_pipe_t    *pipe;     /**< Pipe row: result pipe, else NULL. */
+} reduce_child_t;
+
+/** @brief Child body for both process rows. */
+static void reduce_child_fn(void *arg)
+{
+    reduce_child_t *c = (reduce_child_t *)arg;
+    long int partial = cb_array_sum(c->dataset, c->start, c->length).sum;
+    double compute_end = cb_time_now();
+
+    if (c->shm) {
+        c->shm->compute_end[c->id] = compute_end;
+        long int total = cb_reduce_tree(&c->shm->reduce, c->id, c->episode,
+                                        partial);
+        if (c->id == 0) {
+            c->shm->sum = total;
+            c->shm->combine_end = cb_time_now();
+        }
+        _Exit(EXIT_SUCCESS);
+    }
+
+    pipe_msg_t msg = { partial, compute_end };
+    cb_error_t err = cb_pipe_write(c->pipe, &msg, sizeof(msg));
+    cb_pipe_close_write(c->pipe);
+    _Exit(err ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/**
+ * @brief Run one process sum.
+ *
+ * @param shm          Shared state for the tree row, or NULL for pipes.
+ * @param sum_out      Output: the total.
+ * @param compute_end  Output (pipe row): per-child slice end times.
+ * @param combine_end  Output (pipe row): when the last pipe was read.
+ */
+static cb_error_t run_processes(const int *dataset, const int *bounds,
+                                int workers, reduce_shm_t *shm,
+                                uint32_t episode, cb_process_t *procs,
+                                reduce_child_t *children, cb_pipe_t *pipes,
+                                long int *sum_out, double *compute_end,
+                                double *combine_end)
+{
+    cb_error_t err = CB_OK;
+    int spawned = 0;
+
+    for (int i = 0; i < workers; i++) {
+        children[i].dataset = dataset;
+        children[i].start = bounds[i];
+        children[i].length = bounds[i + 1] - bounds[i];
+        children[i].id = i;
+        children[i].episode = episode;
+        children[i].shm = shm;
+        children[i].pipe = NULL;
+
+        if (!shm) {
+            err = cb_pipe_create(&pipes[i]);
+            if (err) {
+                break;
+            }
+            children[i].pipe = &pipes[i];
+        }
+
+        err = cb_process_spawn(&procs[i], NULL, reduce_child_fn, &children[i]);
+        if (!shm) {
+            cb_pipe_close_write(&pipes[i]);
+            if (err) {
+                cb_pipe_close_read(&pipes[i]);
+            }
+        }
+        if (err) {
+            break;
+        }
+        spawned++;
+    }
+
+    if (err) {
+        /* Tree children may be waiting for a partner that never came. */
+        for (int i = 0; i < spawned; i++) {
+            cb_process_kill(&procs[i]);
+        }
+    }
+
+    long int sum = 0;
+    for (int i = 0; i < spawned && !shm; i++) {
+        pipe_msg_t msg;
+        cb_error_t read_err = err ? CB_OK
+                                  : cb_pipe_read(&pipes[i], &msg, sizeof(msg));
+        cb_pipe_close_read(&pipes[i]);
+        if (read_err) {
+            err = read_err;
+            continue;
+        }
+        if (!err) {
+            sum += msg.sum;
+            compute_end[i] = msg.compute_end;
+        }
+    }
+    if (!shm) {
+        *combine_end = cb_time_now();
+    }
+
+    for (int i = 0; i < spawned; i++) {
+        int status = 0;
+        cb_error_t wait_err = cb_process_wait(&procs[i], &status);
+        if (!wait_err && status != 0 && !err) {
+            wait_err = CB_ERR_PIPE;
+        }
+        if (wait_err && !err) {
+            err = wait_err;
+        }
+    }
+
+    *sum_out = shm ? shm->sum : sum;
+    return err;
+}
+#endif /* CB_PLATFORM_UNIX */
+
+/** @brief Latest of @p n timestamps. */
+static double max_time(const double *t, int n)
+{
+    double m = t[0];
+    for (int i = 1; i < n; i++) {
+        if (t[i] > m) {
+            m = t[i];
+        }
+    }
+    return m;
+}
+
+/** @brief Append one row. Combine times are in seconds. */
+static cb_error_t add_row(cb_table_t *table, const char *mode, int workers,
+                          const cb_bench_stats_t *stats,
+                          const cb_bench_stats_t *combine, const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    cb_table_set(table, 0, "%s", mode);
+    cb_table_set(table, 1, "%d", workers);
+    cb_table_set(table, 2, "%.6f", stats->mean_sec);
+    cb_table_set(table, 3, "%.6f", stats->stddev_sec);
+    cb_table_set(table, 4, "%.1f", combine->min_sec * 1e6);
+    cb_table_set(table, 5, "%.1f", combine->mean_sec * 1e6);
+    cb_table_set(table, 6, "%.1f", combine->max_sec * 1e6);
+    cb_table_set(table, 7, "%s", check);
+
+    return CB_OK;
+}
+
+/** @brief Fill workers + 1 slice boundaries, as in thread mode. */
+static void split(int *bounds, int n, int workers)
+{
+    int base_len = n / workers, remainder = n % workers;
+    bounds[0] = 0;
+    for (int i = 0; i < workers; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+}
+
+cb_error_t cb_bench_reduce_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out)
+{
+    static const char *const headers[REDUCE_COLS] = {
+        "Mode", "Workers", "Mean (s)", "Stddev (s)", "Combine min (us)",
+        "Combine mean (us)", "Combine max (us)", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    int *bounds = NULL;
+    double *times = NULL, *combines = NULL, *compute_end = NULL;
+    cb_thread_t *threads = NULL;
+    reduce_arg_t *args = NULL;
+    reduce_shared_t *shared = NULL;
+    bool mutex_ready = false;
+#ifdef CB_PLATFORM_UNIX
+    cb_process_t *procs = NULL;
+    reduce_child_t *children = NULL;
+    cb_pipe_t *pipes = NULL;
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+#endif
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    int p = config->num_processes;
+    int most = m > p ? m : p;
+
+    err = cb_table_create(&table, "reduce", "Result Combine: Serial vs Tree",
+                          headers, REDUCE_COLS);
+    if (err) {
+        return err;
+    }
+
+    bounds      = calloc((size_t)most + 1, sizeof(int));
+    times       = calloc((size_t)config->iterations, sizeof(double));
+    combines    = calloc((size_t)config->iterations, sizeof(double));
+    compute_end = calloc((size_t)most, sizeof(double));
+    threads     = calloc((size_t)m, sizeof(cb_thread_t));
+    args        = calloc((size_t)m, sizeof(reduce_arg_t));
+    shared      = calloc(1, sizeof(reduce_shared_t));
+    if (!bounds || !times || !combines || !compute_end || !threads ||
+        !args || !shared) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    shared->reduce = cb_aligned_alloc(CB_CACHE_LINE, sizeof(cb_reduce_t));
+    if (!shared->reduce) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    err = cb_mutex_init(&shared->mutex);
+    if (err) {
+        goto cleanup;
+    }
+    mutex_ready = true;
+
+    long int expected = cb_array_sum(dataset, 0, n).sum;
+    cb_bench_stats_t stats, combine;
+    double serial_tail[2] = { 0.0, 0.0 }, tree_tail[2] = { 0.0, 0.0 };
+
+    /* ---- thread-mutex, thread-tree ---- */
+    split(bounds, n, m);
+    shared->dataset = dataset;
+    shared->bounds = bounds;
+    shared->compute_end = compute_end;
+
+    err = cb_reduce_init(shared->reduce, m, CB_WAIT_SPIN_FUTEX, false);
+    if (err) {
+        goto cleanup;
+    }
+
+    for (int tree = 0; tree <= 1; tree++) {
+        bool all_ok = true;
+
+        shared->tree = tree;
+        for (int iter = 0; iter < config->iterations; iter++) {
+            shared->episode = (uint32_t)iter + 1;
+            double t_start = cb_time_now();
+            err = run_threads(shared, m, threads, args);
+            times[iter] = cb_time_now() - t_start;
+            if (err) {
+                goto cleanup;
+            }
+
+            combines[iter] = shared->combine_end - max_time(compute_end, m);
+            if (shared->sum != expected) {
+                all_ok = false;
+            }
+            if (config->verbose) {
+                fprintf(stdout, "  thread-%s iteration %d/%d: %.6fs, "
+                        "combine %.1fus\n", tree ? "tree" : "mutex",
+                        iter + 1, config->iterations, times[iter],
+                        combines[iter] * 1e6);
+            }
+        }
+
+        err = cb_stats_compute(times, config->iterations, &stats);
+        if (!err) {
+            err = cb_stats_compute(combines, config->iterations, &combine);
+        }
+        if (!err) {
+            err = add_row(table, tree ? "thread-tree" : "thread-mutex", m,
+                          &stats, &combine, all_ok ? "PASS" : "FAIL");
+        }
+        if (err) {
+            goto cleanup;
+        }
+        if (tree) {
+            tree_tail[0] = combine.mean_sec;
+        } else {
+            serial_tail[0] = combine.mean_sec;
+        }
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    /* ---- process-pipe, process-tree ---- */
+    procs    = calloc((size_t)p, sizeof(cb_process_t));
+    children = calloc((size_t)p, sizeof(reduce_child_t));
+    pipes    = calloc((size_t)p, sizeof(cb_pipe_t));
+    if (!procs || !children || !pipes) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_reduce_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name, sizeof(reduce_shm_t));
+    if (err) {
+        goto cleanup;
+    }
+    shm_created = true;
+
+    reduce_shm_t *rshm = cb_shared_mem_ptr(&shm);
+    err = cb_reduce_init(&rshm->reduce, p, CB_WAIT_SPIN_FUTEX, true);
+    if (err) {
+        goto cleanup;
+    }
+
+    split(bounds, n, p);
+
+    for (int tree = 0; tree <= 1; tree++) {
+        bool all_ok = true;
+
+        for (int iter = 0; iter < config->iterations; iter++) {
+            long int sum = 0;
+            double combine_end = 0.0;
+            double t_start = cb_time_now();
+            err = run_processes(dataset, bounds, p, tree ? rshm : NULL,
+                                (uint32_t)iter + 1, procs, children, pipes,
+                                &sum, compute_end, &combine_end);
+            times[iter] = cb_time_now() - t_start;
+            if (err) {
+                goto cleanup;
+            }
+
+            if (tree) {
+                combines[iter] = rshm->combine_end -
+                                 max_time(rshm->compute_end, p);
+            } else {
+                combines[iter] = combine_end - max_time(compute_end, p);
+            }
+            if (sum != expected) {
+                all_ok = false;
+            }
+            if (config->verbose) {
+                fprintf(stdout, "  process-%s iteration %d/%d: %.6fs, "
+                        "combine %.1fus\n", tree ? "tree" : "pipe",
+                        iter + 1, config->iterations, times[iter],
+                        combines[iter] * 1e6);
+            }
+        }
+
+        err = cb_stats_compute(times, config->iterations, &stats);
+        if (!err) {
+            err = cb_stats_compute(combines, config->iterations, &combine);
+        }
+        if (!err) {
+            err = add_row(table, tree ? "process-tree" : "process-pipe", p,
+                          &stats, &combine, all_ok ? "PASS" : "FAIL");
+        }
+        if (err) {
+            goto cleanup;
+        }
+        if (tree) {
+            tree_tail[1] = combine.mean_sec;
+        } else {
+            serial_tail[1] = combine.mean_sec;
+        }
+    }
+#else
+    cb_table_add_note(table, "process-pipe and process-tree require fork() "
+                      "and are not available on this platform.");
+#endif
+
+    cb_table_add_note(table, "Combine = time from the last worker finishing "
+                      "its slice to the total being available.");
+    cb_table_add_note(table, "Mean combine tail, serial vs tree: threads "
+                      "%.1f vs %.1f us.", serial_tail[0] * 1e6,
+                      tree_tail[0] * 1e6);
+#ifdef CB_PLATFORM_UNIX
+    cb_table_add_note(table, "Mean combine tail, serial vs tree: processes "
+                      "%.1f vs %.1f us.", serial_tail[1] * 1e6,
+                      tree_tail[1] * 1e6);
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+#ifdef CB_PLATFORM_UNIX
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+    free(procs);
+    free(children);
+    free(pipes);
+#endif
+    if (mutex_ready) {
+        cb_mutex_destroy(&shared->mutex);
+    }
+    if (shared) {
+        cb_aligned_free(shared->reduce);
+    }
+    free(shared);
+    free(bounds);
+    free(times);
+    free(combines);
+    free(compute_end);
+    free(threads);
+    free(args);
+    cb_table_destroy(table);
+    return err;
+}
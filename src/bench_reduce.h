@@ -0,0 +1,32 @@
+/**
+ * @file bench_reduce.h
+ * @brief Result-combine suite: serial combine vs tree reduction.
+ *
+ * The core modes combine partial sums serially: thread mode adds them
+ * under one mutex and process mode reads one pipe after another. This
+ * suite runs the same sums with those serial combines and with the
+ * log2(N)-round tree reduction from reduce.h, and reports the combine
+ * tail (from the last worker finishing its slice to the total being
+ * available) separately from the total run time.
+ */
+
+#ifndef CB_BENCH_REDUCE_H
+#define CB_BENCH_REDUCE_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the combine suite and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, num_processes, iterations, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD,
+ *         CB_ERR_MUTEX, CB_ERR_FORK, CB_ERR_SHM, CB_ERR_PIPE on failure.
+ */
+cb_error_t cb_bench_reduce_run(const int *dataset, const cb_config_t *config,
+                               cb_table_t **table_out);
+
+#endif /* CB_BENCH_REDUCE_H */
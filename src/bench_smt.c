@@ -0,0 +1,569 @@
+/**
+ * @file bench_smt.c
+ * @brief Implementation of the SMT sibling interference benchmark.
+ *
+ * cb_cpu_topology() groups the usable logical CPUs into physical cores;
+ * the suite takes P = min(num_threads, cores with two siblings) cores
+ * and pins every worker. Rows, all summing the whole dataset:
+ * - 1/core:           P reduction threads, one per core, siblings free.
+ * - 2/core:           2P reduction threads on both siblings of the cores.
+ * - 1/core + <name>:  P reduction threads plus P antagonists, one on
+ *                     each sibling:
+ *                     compute - independent integer multiply-add chains
+ *                               (execution ports, no memory traffic);
+ *                     memory  - read-modify-write of a private buffer
+ *                               beyond the cache (shared L1/L2 and
+ *                               memory bandwidth);
+ *                     idle    - a PAUSE spin that occupies the sibling
+ *                               without competing for resources.
+ *
+ * Workers pin themselves and wait at a start gate; antagonists start
+ * working as soon as they are pinned, so they are at full rate when
+ * the gate opens. Wall time runs from the gate to the last reduction
+ * join, and each reduction thread also times its own slice.
+ */
+
+#include "bench_smt.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "kernel.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define SMT_COLS 10
+
+/** @brief Logical CPUs the topology is read for. */
+#define SMT_MAX_CPUS 1024
+
+/** @brief Buffer each memory antagonist sweeps (well beyond L2). */
+#define SMT_MEMORY_BYTES ((size_t)16 * 1024 * 1024)
+
+/** @brief Integer multiply-add chains of the compute antagonist. */
+#define SMT_COMPUTE_CHAINS 4
+
+/** @brief Antagonist iterations or cache lines between stop checks. */
+#define SMT_STOP_CHECK 4096
+
+/** @brief Ints per 64-byte cache line. */
+#define SMT_LINE_INTS 16
+
+/** @brief Antagonist kinds; ANT_NONE marks a row without one. */
+typedef enum {
+    ANT_NONE = -1,
+    ANT_COMPUTE = 0,
+    ANT_MEMORY,
+    ANT_IDLE,
+    ANT_COUNT
+} antagonist_t;
+
+/** @brief Antagonist names, indexed by antagonist_t. */
+static const char *const ANTAGONISTS[ANT_COUNT] = {
+    "compute", "memory", "idle"
+};
+
+/**
+ * @brief State shared by the workers of one run.
+ */
+typedef struct {
+    const int    *dataset;     /**< Input array. */
+    const int    *bounds;      /**< reducers + 1 slice boundaries. */
+    const int    *cpus;        /**< CPU per worker, reducers first. */
+    int           reducers;    /**< Reduction threads. */
+    antagonist_t  antagonist;  /**< What the remaining workers run. */
+    atomic_long   total;       /**< Sum of all partials. */
+    cb_start_gate_t gate;      /**< Start gate. */
+    _Atomic int   ready;       /**< Workers pinned so far. */
+    _Atomic int   stop;        /**< Set when antagonists must return. */
+    _Atomic int   pin_failed;  /**< Workers that could not be pinned. */
+} smt_shared_t;
+
+/**
+ * @brief Per-worker argument and result.
+ */
+typedef struct {
+    smt_shared_t *shared;   /**< Shared run state. */
+    int           id;       /**< Worker index. */
+    int          *buffer;   /**< Memory antagonist buffer. */
+    double        elapsed;  /**< Reducer: time for its slice. */
+    double        work;     /**< Antagonist: operations or bytes done. */
+    double        seconds;  /**< Antagonist: time it ran. */
+    uint64_t      sink;     /**< Keeps the compute chains live. */
+} smt_arg_t;
+
+/** @brief Run the antagonist until the stop flag is set. */
+static void antagonist_loop(smt_arg_t *a)
+{
+    smt_shared_t *s = a->shared;
+    double t_start = cb_time_now();
+    double work = 0.0;
+
+    switch (s->antagonist) {
+    case ANT_COMPUTE: {
+        uint64_t x[SMT_COMPUTE_CHAINS];
+        for (int c = 0; c < SMT_COMPUTE_CHAINS; c++) {
+            x[c] = (uint64_t)a->id * 2654435761u + (uint64_t)c;
+        }
+        while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+            for (int i = 0; i < SMT_STOP_CHECK; i++) {
+                for (int c = 0; c < SMT_COMPUTE_CHAINS; c++) {
+                    x[c] = x[c] * 6364136223846793005u + 1442695040888963407u;
+                }
+            }
+            work += (double)SMT_STOP_CHECK * SMT_COMPUTE_CHAINS;
+        }
+        for (int c = 0; c < SMT_COMPUTE_CHAINS; c++) {
+            a->sink ^= x[c];
+        }
+        break;
+    }
+    case ANT_MEMORY: {
+        size_t n = SMT_MEMORY_BYTES / sizeof(int);
+        size_t i = 0;
+        while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+            for (int l = 0; l < SMT_STOP_CHECK; l++) {
+                a->buffer[i]++;
+                i += SMT_LINE_INTS;
+                if (i >= n) {
+                    i = 0;
+                }
+            }
+            /* Each line is read and written back. */
+            work += 2.0 * SMT_STOP_CHECK * SMT_LINE_INTS * sizeof(int);
+        }
+        break;
+    }
+    default:
+        while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+            cb_cpu_relax();
+        }
+        break;
+    }
+
+    a->work = work;
+    a->seconds = cb_time_now() - t_start;
+}
+
+/** @brief Thread body: pin, then sum a slice or run the antagonist. */
+static void *smt_thread_fn(void *arg)
+{
+    smt_arg_t *a = (smt_arg_t *)arg;
+    smt_shared_t *s = a->shared;
+
+    if (cb_thread_pin_self(s->cpus[a->id]) != CB_OK) {
+        atomic_fetch_add(&s->pin_failed, 1);
+    }
+    atomic_fetch_add(&s->ready, 1);
+
+    if (a->id >= s->reducers) {
+        antagonist_loop(a);
+        return NULL;
+    }
+
+    if (!cb_start_gate_wait(&s->gate)) {
+        return NULL;
+    }
+
+    int start = s->bounds[a->id];
+    double t_start = cb_time_now();
+    long int partial = cb_kernel_sum(s->dataset + start,
+                                     s->bounds[a->id + 1] - start);
+    a->elapsed = cb_time_now() - t_start;
+    atomic_fetch_add(&s->total, partial);
+    return NULL;
+}
+
+/**
+ * @brief Run one timed sum.
+ *
+ * @param workers  Reducers plus antagonists; args[i].buffer must be
+ *                 set for memory antagonists.
+ */
+static cb_error_t run_once(smt_shared_t *s, int workers, cb_thread_t *threads,
+                           smt_arg_t *args, double *elapsed)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    atomic_store(&s->total, 0);
+    cb_start_gate_init(&s->gate);
+    atomic_store(&s->ready, 0);
+    atomic_store(&s->stop, 0);
+
+    for (int i = 0; i < workers; i++) {
+        args[i].shared = s;
+        args[i].id = i;
+        args[i].elapsed = 0.0;
+        args[i].work = 0.0;
+        args[i].seconds = 0.0;
+        err = cb_thread_create(&threads[i], smt_thread_fn, &args[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    if (!err) {
+        while (atomic_load(&s->ready) < workers) {
+            cb_thread_yield();
+        }
+    }
+
+    double t_start = cb_time_now();
+    if (err) {
+        cb_start_gate_abort(&s->gate);
+    } else {
+        cb_start_gate_open(&s->gate);
+    }
+
+    int joined = 0;
+    for (; joined < created && joined < s->reducers; joined++) {
+        cb_error_t join_err = cb_thread_join(&threads[joined]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+    *elapsed = cb_time_now() - t_start;
+
+    atomic_store(&s->stop, 1);
+    for (; joined < created; joined++) {
+        cb_error_t join_err = cb_thread_join(&threads[joined]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    return err;
+}
+
+/** @brief Fill workers + 1 slice boundaries, as in thread mode. */
+static void split(int *bounds, int n, int workers)
+{
+    int base_len = n / workers, remainder = n % workers;
+    bounds[0] = 0;
+    for (int i = 0; i < workers; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+}
+
+bool cb_bench_smt_antagonist_valid(const char *name)
+{
+    for (int a = 0; name && a < ANT_COUNT; a++) {
+        if (strcmp(ANTAGONISTS[a], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Throughput of one layout, averaged over the iterations.
+ */
+typedef struct {
+    double gbps;         /**< Aggregate reduction throughput. */
+    double thread_gbps;  /**< Mean per-reducer throughput. */
+    double rate;         /**< Antagonist rate (ops/s or bytes/s), summed. */
+} smt_result_t;
+
+/** @brief Append one row; @p base is NULL for the 1/core row. */
+static cb_error_t add_row(cb_table_t *table, const char *layout,
+                          antagonist_t ant, int threads, int cores,
+                          const cb_bench_stats_t *stats,
+                          const smt_result_t *r, const smt_result_t *base,
+                          const char *check)
+{
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    cb_table_set(table, 0, "%s", layout);
+    cb_table_set(table, 1, "%s", ant == ANT_NONE ? (threads > cores
+                                                    ? "reduce" : "free")
+                                                 : ANTAGONISTS[ant]);
+    cb_table_set(table, 2, "%d", threads);
+    cb_table_set(table, 3, "%d", cores);
+    cb_table_set(table, 4, "%.6f", stats->mean_sec);
+    cb_table_set(table, 5, "%.2f", r->gbps);
+    cb_table_set(table, 6, "%.2f", r->thread_gbps);
+    if (base && base->gbps > 0.0) {
+        cb_table_set(table, 7, "%+.1f%%", (r->gbps / base->gbps - 1.0) * 100.0);
+    } else {
+        cb_table_set(table, 7, "baseline");
+    }
+    if (ant == ANT_COMPUTE) {
+        cb_table_set(table, 8, "%.2f Gop/s", r->rate / 1e9);
+    } else if (ant == ANT_MEMORY) {
+        cb_table_set(table, 8, "%.2f GB/s", r->rate / 1e9);
+    } else {
+        cb_table_set(table, 8, "n/a");
+    }
+    cb_table_set(table, 9, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_bench_smt_run(const int *dataset, const cb_config_t *config,
+                            cb_table_t **table_out)
+{
+    static const char *const headers[SMT_COLS] = {
+        "Layout", "Sibling", "Threads", "Cores", "Mean (s)", "GB/s",
+        "GB/s/thread", "vs 1/core", "Sibling rate", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    int *core_of = NULL;
+    int *first = NULL, *second = NULL;
+    int *bounds = NULL, *cpus = NULL;
+    double *times = NULL;
+    cb_thread_t *threads = NULL;
+    smt_arg_t *args = NULL;
+    smt_shared_t *shared = NULL;
+    int use = 0, buffers = 0;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    double bytes = (double)n * sizeof(int);
+
+    err = cb_table_create(&table, "smt", "SMT Sibling Interference",
+                          headers, SMT_COLS);
+    if (err) {
+        return err;
+    }
+
+    core_of = calloc(SMT_MAX_CPUS, sizeof(int));
+    first   = calloc(SMT_MAX_CPUS, sizeof(int));
+    second  = calloc(SMT_MAX_CPUS, sizeof(int));
+    bounds  = calloc(2 * CB_MAX_WORKERS + 1, sizeof(int));
+    cpus    = calloc(2 * CB_MAX_WORKERS, sizeof(int));
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    threads = calloc(2 * CB_MAX_WORKERS, sizeof(cb_thread_t));
+    args    = calloc(2 * CB_MAX_WORKERS, sizeof(smt_arg_t));
+    shared  = calloc(1, sizeof(smt_shared_t));
+    if (!core_of || !first || !second || !bounds || !cpus || !times ||
+        !threads || !args || !shared) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* ---- Topology: first and second usable sibling of each core ---- */
+    int num_cpus = 0, cores = 0, smt_cores = 0;
+    if (cb_cpu_topology(core_of, SMT_MAX_CPUS, &num_cpus) != CB_OK) {
+        cb_table_add_note(table, "CPU topology unavailable on this "
+                          "platform; SMT layouts were not measured.");
+        goto done;
+    }
+    for (int c = 0; c < SMT_MAX_CPUS; c++) {
+        first[c] = second[c] = -1;
+    }
+    for (int cpu = 0; cpu < num_cpus; cpu++) {
+        int c = core_of[cpu];
+        if (c < 0) {
+            continue;
+        }
+        if (first[c] < 0) {
+            first[c] = cpu;
+            cores++;
+        } else if (second[c] < 0) {
+            second[c] = cpu;
+            smt_cores++;
+        }
+    }
+
+    /* Use SMT cores first so that every row runs on the same cores. */
+    int order[SMT_MAX_CPUS];
+    int norder = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int c = 0; c < SMT_MAX_CPUS; c++) {
+            if (first[c] >= 0 && (second[c] >= 0) == (pass == 0)) {
+                order[norder++] = c;
+            }
+        }
+    }
+
+    use = smt_cores > 0 ? smt_cores : cores;
+    if (use > config->num_threads) {
+        use = config->num_threads;
+    }
+
+    shared->dataset = dataset;
+    shared->bounds = bounds;
+    shared->cpus = cpus;
+
+    /* Memory antagonist buffers (antagonist i is worker use + i),
+     * allocated once and reused by every run. */
+    bool want[ANT_COUNT];
+    for (int a = 0; a < ANT_COUNT; a++) {
+        want[a] = smt_cores > 0 && (config->smt_antagonist[0] == '\0' ||
+                                    strcmp(config->smt_antagonist,
+                                           ANTAGONISTS[a]) == 0);
+    }
+    if (want[ANT_MEMORY]) {
+        for (; buffers < use; buffers++) {
+            args[use + buffers].buffer = cb_aligned_alloc(64, SMT_MEMORY_BYTES);
+            if (!args[use + buffers].buffer) {
+                err = CB_ERR_ALLOC;
+                goto cleanup;
+            }
+            memset(args[use + buffers].buffer, 0, SMT_MEMORY_BYTES);
+        }
+    }
+
+    long int expected = cb_kernel_sum(dataset, n);
+    smt_result_t base = {0.0, 0.0, 0.0}, pair = {0.0, 0.0, 0.0};
+    smt_result_t with[ANT_COUNT];
+    memset(with, 0, sizeof(with));
+    int pin_failed = 0;
+
+    /* Rows: 1/core, 2/core, then 1/core with each antagonist. */
+    for (int row = 0; row < 2 + ANT_COUNT; row++) {
+        antagonist_t ant = row >= 2 ? (antagonist_t)(row - 2) : ANT_NONE;
+        if ((row == 1 && smt_cores == 0) || (ant != ANT_NONE && !want[ant])) {
+            continue;
+        }
+
+        int reducers = row == 1 ? 2 * use : use;
+        int workers = ant != ANT_NONE ? 2 * use : reducers;
+        for (int i = 0; i < use; i++) {
+            int c = order[i];
+            if (row == 1) {
+                cpus[2 * i] = first[c];
+                cpus[2 * i + 1] = second[c];
+            } else {
+                cpus[i] = first[c];
+                cpus[use + i] = second[c];
+            }
+        }
+        split(bounds, n, reducers);
+        shared->reducers = reducers;
+        shared->antagonist = ant;
+
+        smt_result_t r = {0.0, 0.0, 0.0};
+        bool all_ok = true;
+
+        for (int iter = 0; iter < config->iterations; iter++) {
+            atomic_store(&shared->pin_failed, 0);
+            err = run_once(shared, workers, threads, args, &times[iter]);
+            if (err) {
+                goto cleanup;
+            }
+            if (atomic_load(&shared->total) != expected) {
+                all_ok = false;
+            }
+            if (atomic_load(&shared->pin_failed) > pin_failed) {
+                pin_failed = atomic_load(&shared->pin_failed);
+            }
+
+            double thread_gbps = 0.0, rate = 0.0;
+            for (int i = 0; i < reducers; i++) {
+                double len = (double)(bounds[i + 1] - bounds[i]) * sizeof(int);
+                if (args[i].elapsed > 0.0) {
+                    thread_gbps += len / args[i].elapsed / 1e9;
+                }
+            }
+            for (int i = reducers; i < workers; i++) {
+                if (args[i].seconds > 0.0) {
+                    rate += args[i].work / args[i].seconds;
+                }
+            }
+            r.thread_gbps += thread_gbps / reducers / config->iterations;
+            r.rate += rate / config->iterations;
+
+            if (config->verbose) {
+                fprintf(stdout, "  smt %s%s%s iteration %d/%d: %.6fs\n",
+                        row == 1 ? "2/core" : "1/core",
+                        ant != ANT_NONE ? " + " : "",
+                        ant != ANT_NONE ? ANTAGONISTS[ant] : "", iter + 1,
+                        config->iterations, times[iter]);
+            }
+        }
+
+        cb_bench_stats_t stats;
+        err = cb_stats_compute(times, config->iterations, &stats);
+        if (err) {
+            goto cleanup;
+        }
+        r.gbps = stats.mean_sec > 0.0 ? bytes / stats.mean_sec / 1e9 : 0.0;
+
+        err = add_row(table, row == 1 ? "2/core" : "1/core", ant, reducers,
+                      use, &stats, &r, row == 0 ? NULL : &base,
+                      all_ok ? "PASS" : "FAIL");
+        if (err) {
+            goto cleanup;
+        }
+
+        if (row == 0) {
+            base = r;
+        } else if (row == 1) {
+            pair = r;
+        } else {
+            with[ant] = r;
+        }
+    }
+
+    cb_table_add_note(table, "Topology: %d usable core%s, %d with two "
+                      "usable SMT siblings; rows use %d core%s.", cores,
+                      cores == 1 ? "" : "s", smt_cores, use,
+                      use == 1 ? "" : "s");
+    if (smt_cores == 0) {
+        cb_table_add_note(table, "No core has two usable siblings (SMT off, "
+                          "or siblings outside the affinity mask); only "
+                          "the 1/core row was measured.");
+    } else {
+        if (base.gbps > 0.0 && base.thread_gbps > 0.0) {
+            cb_table_add_note(table, "Second sibling running the reduction: "
+                              "%+.1f%% aggregate; each thread runs at "
+                              "%.0f%% of its 1/core rate.",
+                              (pair.gbps / base.gbps - 1.0) * 100.0,
+                              pair.thread_gbps / base.thread_gbps * 100.0);
+        }
+        for (int a = 0; a < ANT_COUNT; a++) {
+            if (want[a] && base.thread_gbps > 0.0) {
+                cb_table_add_note(table, "%s sibling: reduction threads "
+                                  "run at %.0f%% of their 1/core rate.",
+                                  ANTAGONISTS[a],
+                                  with[a].thread_gbps / base.thread_gbps
+                                  * 100.0);
+            }
+        }
+    }
+    if (pin_failed > 0) {
+        cb_table_add_note(table, "Pinning failed for %d worker%s; those "
+                          "rows are not placed as labelled.", pin_failed,
+                          pin_failed == 1 ? "" : "s");
+    }
+    cb_table_add_note(table, "Sibling rate: compute in 64-bit multiply-adds "
+                      "per second, memory in bytes read plus written.");
+
+done:
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    for (int i = 0; args && i < buffers; i++) {
+        cb_aligned_free(args[use + i].buffer);
+    }
+    free(core_of);
+    free(first);
+    free(second);
+    free(bounds);
+    free(cpus);
+    free(times);
+    free(threads);
+    free(args);
+    free(shared);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file bench_smt.h
+ * @brief SMT sibling interference benchmark.
+ *
+ * Reads the core topology to pin the reduction onto physical cores and
+ * compares three layouts: one reduction thread per core with the SMT
+ * sibling left free, reduction threads on both siblings of each core,
+ * and one reduction thread per core with an antagonist (compute,
+ * memory or idle spin) pinned on its sibling. Aggregate and
+ * per-thread throughput, and the antagonist's own rate, quantify what
+ * the second hardware thread is worth for this workload.
+ */
+
+#ifndef CB_BENCH_SMT_H
+#define CB_BENCH_SMT_H
+
+#include <stdbool.h>
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Check whether @p name is a known antagonist.
+ * @param name  Antagonist name: "compute", "memory" or "idle".
+ * @return true if the antagonist exists.
+ */
+bool cb_bench_smt_antagonist_valid(const char *name);
+
+/**
+ * @brief Run the SMT suite and produce a result table.
+ *
+ * Uses min(num_threads, cores with two usable siblings) cores. Without
+ * SMT only the one-per-core row runs; without a readable topology or
+ * thread pinning the table holds only a note.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, smt_antagonist, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD on failure.
+ */
+cb_error_t cb_bench_smt_run(const int *dataset, const cb_config_t *config,
+                            cb_table_t **table_out);
+
+#endif /* CB_BENCH_SMT_H */
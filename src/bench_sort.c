@@ -0,0 +1,514 @@
+/**
+ * @file bench_sort.c
+ * @brief Implementation of the sort workload.
+ *
+ * Thread-parallel sorts share one sort_shared_t. Workers start behind a
+ * gate so that a failed thread creation can release the workers that
+ * already exist instead of leaving them blocked in the phase barrier.
+ * Phases are separated by a central spin-then-futex barrier from
+ * barrier.h, which degrades gracefully when threads outnumber cores.
+ */
+
+#include "bench_sort.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "platform.h"
+#include "sort.h"
+#include "stats.h"
+#include "table.h"
+
+/**
+ * @brief State shared by all threads of one parallel sort.
+ */
+typedef struct {
+    int           *work;         /**< Unsorted copy; sorted in place by slice. */
+    int           *scratch;      /**< Scratch buffer of n elements. */
+    int           *output;       /**< Set to the buffer holding the result. */
+    int            n;            /**< Number of elements. */
+    int            num_threads;  /**< Number of worker threads. */
+    const int     *bounds;       /**< num_threads + 1 slice boundaries. */
+    int           *splits;       /**< (num_threads + 1) x num_threads merge splits. */
+    int           *hists;        /**< num_threads x CB_RADIX_BUCKETS histograms. */
+    cb_barrier_t  *barrier;      /**< Phase barrier. */
+    cb_start_gate_t gate;        /**< Start gate. */
+    _Atomic int    failed;       /**< Nonzero if any worker hit an error. */
+} sort_shared_t;
+
+/**
+ * @brief Per-thread argument.
+ */
+typedef struct {
+    sort_shared_t *shared;  /**< Shared sort state. */
+    int            id;      /**< Worker index. */
+} sort_arg_t;
+
+/**
+ * @brief Thread body for the partition + multiway merge sort.
+ *
+ * Phase 1 sorts the thread's slice. Phase 2 computes the split of all
+ * sorted slices at global rank n * id / T. Phase 3 merges the elements
+ * between this thread's split and the next one into scratch.
+ */
+static void *merge_thread_fn(void *arg)
+{
+    sort_arg_t *a = (sort_arg_t *)arg;
+    sort_shared_t *s = a->shared;
+    int t = s->num_threads;
+    int lo = s->bounds[a->id];
+    int hi = s->bounds[a->id + 1];
+
+    if (!cb_start_gate_wait(&s->gate)) {
+        return NULL;
+    }
+
+    cb_sort_merge(s->work + lo, s->scratch + lo, hi - lo);
+    cb_barrier_wait(s->barrier, a->id);
+
+    long rank = (long)((long long)s->n * a->id / t);
+    cb_sort_split_runs(s->work, s->bounds, t, rank, &s->splits[a->id * t]);
+    cb_barrier_wait(s->barrier, a->id);
+
+    if (cb_sort_kway_merge(s->work, &s->splits[a->id * t],
+                           &s->splits[(a->id + 1) * t], t,
+                           s->scratch + rank)) {
+        atomic_store(&s->failed, 1);
+    }
+
+    if (a->id == 0) {
+        s->output = s->scratch;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Thread body for the parallel LSD radix sort.
+ *
+ * Per pass: build a local digit histogram, wait, derive this thread's
+ * bucket offsets (all lower digits globally, plus the same digit in
+ * lower-numbered threads, which keeps the sort stable), scatter, wait.
+ * A pass whose digit is constant across all keys is skipped by every
+ * thread, since each computes the same global totals.
+ */
+static void *radix_thread_fn(void *arg)
+{
+    sort_arg_t *a = (sort_arg_t *)arg;
+    sort_shared_t *s = a->shared;
+    int t = s->num_threads;
+    int lo = s->bounds[a->id];
+    int hi = s->bounds[a->id + 1];
+    int *src = s->work;
+    int *dst = s->scratch;
+    int offsets[CB_RADIX_BUCKETS];
+
+    if (!cb_start_gate_wait(&s->gate)) {
+        return NULL;
+    }
+
+    for (int pass = 0; pass < CB_RADIX_PASSES; pass++) {
+        cb_sort_radix_histogram(src + lo, hi - lo, pass,
+                                &s->hists[a->id * CB_RADIX_BUCKETS]);
+        cb_barrier_wait(s->barrier, a->id);
+
+        bool trivial = false;
+        int base = 0;
+        for (int d = 0; d < CB_RADIX_BUCKETS; d++) {
+            int total = 0, before = 0;
+            for (int j = 0; j < t; j++) {
+                int c = s->hists[j * CB_RADIX_BUCKETS + d];
+                total += c;
+                if (j < a->id) {
+                    before += c;
+                }
+            }
+            if (total == s->n) {
+                trivial = true;
+            }
+            offsets[d] = base + before;
+            base += total;
+        }
+
+        if (!trivial) {
+            cb_sort_radix_scatter(src + lo, hi - lo, pass, offsets, dst);
+        }
+        cb_barrier_wait(s->barrier, a->id);
+
+        if (!trivial) {
+            int *tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+    }
+
+    if (a->id == 0) {
+        s->output = src;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Run one parallel sort with @p fn on every thread.
+ */
+static cb_error_t run_threads(sort_shared_t *s, cb_thread_fn_t fn,
+                              cb_thread_t *threads, sort_arg_t *args)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    cb_start_gate_init(&s->gate);
+    atomic_store(&s->failed, 0);
+
+    err = cb_barrier_init(s->barrier, CB_BARRIER_CENTRAL, CB_WAIT_SPIN_FUTEX,
+                          s->num_threads, false);
+    if (err) {
+        return err;
+    }
+
+    for (int i = 0; i < s->num_threads; i++) {
+        args[i].shared = s;
+        args[i].id = i;
+        err = cb_thread_create(&threads[i], fn, &args[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    if (err) {
+        cb_start_gate_abort(&s->gate);
+    } else {
+        cb_start_gate_open(&s->gate);
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    cb_barrier_destroy(s->barrier);
+
+    if (!err && atomic_load(&s->failed)) {
+        err = CB_ERR_ALLOC;
+    }
+
+    return err;
+}
+
+/**
+ * @brief Fill num_parts + 1 slice boundaries, first (n % parts) slices +1.
+ */
+static void fill_bounds(int n, int num_parts, int *bounds)
+{
+    int base_len  = n / num_parts;
+    int remainder = n % num_parts;
+
+    bounds[0] = 0;
+    for (int i = 0; i < num_parts; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+}
+
+#ifdef CB_PLATFORM_UNIX
+/**
+ * @brief Arguments for a child that sorts one slice in shared memory.
+ */
+typedef struct {
+    int *data;    /**< Shared memory array. */
+    int  start;   /**< Slice start. */
+    int  length;  /**< Slice length. */
+} sort_child_t;
+
+/** @brief Child process entry: merge-sort one slice in place, then exit. */
+static void sort_child_fn(void *arg)
+{
+    sort_child_t *c = (sort_child_t *)arg;
+    int *scratch = malloc((size_t)(c->length > 0 ? c->length : 1) * sizeof(int));
+
+    if (!scratch) {
+        _Exit(EXIT_FAILURE);
+    }
+
+    cb_sort_merge(c->data + c->start, scratch, c->length);
+    free(scratch);
+    _Exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Sort in child processes, then merge in the parent.
+ *
+ * @param shm_data  Shared array already holding an unsorted copy.
+ * @param p         Number of child processes.
+ * @param bounds    p + 1 slice boundaries.
+ * @param out       Output buffer for the merged result.
+ * @param elapsed   Output: wall time for spawn, sort, wait, and merge.
+ */
+static cb_error_t run_processes(int *shm_data, int p, const int *bounds,
+                                int *out, double *elapsed)
+{
+    cb_error_t err = CB_OK;
+    cb_process_t *procs = calloc((size_t)p, sizeof(cb_process_t));
+    sort_child_t *work  = calloc((size_t)p, sizeof(sort_child_t));
+    int spawned = 0;
+
+    if (!procs || !work) {
+        free(procs);
+        free(work);
+        return CB_ERR_ALLOC;
+    }
+
+    double t_start = cb_time_now();
+
+    for (int i = 0; i < p; i++) {
+        work[i].data = shm_data;
+        work[i].start = bounds[i];
+        work[i].length = bounds[i + 1] - bounds[i];
+        err = cb_process_spawn(&procs[i], NULL, sort_child_fn, &work[i]);
+        if (err) {
+            break;
+        }
+        spawned++;
+    }
+
+    for (int i = 0; i < spawned; i++) {
+        int status = 0;
+        cb_error_t wait_err = cb_process_wait(&procs[i], &status);
+        if (!wait_err && status != 0) {
+            wait_err = CB_ERR_ALLOC;
+        }
+        if (wait_err && !err) {
+            err = wait_err;
+        }
+    }
+
+    if (!err) {
+        err = cb_sort_kway_merge(shm_data, bounds, bounds + 1, p, out);
+    }
+
+    *elapsed = cb_time_now() - t_start;
+
+    free(procs);
+    free(work);
+    return err;
+}
+#endif
+
+/**
+ * @brief Verify one output against the input fingerprint.
+ */
+static bool verify_output(const int *out, int n, uint64_t expected)
+{
+    return cb_sort_is_sorted(out, n) && cb_sort_fingerprint(out, n) == expected;
+}
+
+/** @brief Sort modes, in table order. */
+typedef enum {
+    MODE_SINGLE_MERGE = 0,
+    MODE_SINGLE_RADIX,
+    MODE_THREAD_MERGE,
+    MODE_THREAD_RADIX,
+    MODE_PROCESS_MERGE,
+    MODE_COUNT
+} sort_mode_t;
+
+/** @brief Table labels for sort_mode_t. */
+static const char *const MODE_LABELS[MODE_COUNT] = {
+    "single-merge", "single-radix", "thread-merge", "thread-radix",
+    "process-merge"
+};
+
+cb_error_t cb_bench_sort_run(const int *dataset, const cb_config_t *config,
+                             cb_table_t **table_out)
+{
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    int *work = NULL, *scratch = NULL, *out = NULL;
+    int *bounds = NULL, *splits = NULL, *hists = NULL;
+    cb_thread_t *threads = NULL;
+    sort_arg_t *args = NULL;
+    cb_barrier_t *barrier = NULL;
+    double *times = NULL;
+    sort_shared_t shared;
+
+    if (!dataset || !config || !table_out) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+    memset(&shared, 0, sizeof(shared));
+
+    int n = config->array_length;
+    int t = config->num_threads;
+    int p = config->num_processes;
+    int max_parts = (t > p) ? t : p;
+
+    err = cb_table_create_timing(&table, "sort",
+                                 "Sort Workload (sorted and permutation-checked)",
+                                 "Melem/s");
+    if (err) {
+        return err;
+    }
+
+    work    = malloc((size_t)n * sizeof(int));
+    scratch = malloc((size_t)n * sizeof(int));
+    out     = malloc((size_t)n * sizeof(int));
+    bounds  = calloc((size_t)max_parts + 1, sizeof(int));
+    splits  = calloc(((size_t)t + 1) * (size_t)t, sizeof(int));
+    hists   = calloc((size_t)t * CB_RADIX_BUCKETS, sizeof(int));
+    threads = calloc((size_t)t, sizeof(cb_thread_t));
+    args    = calloc((size_t)t, sizeof(sort_arg_t));
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    barrier = cb_aligned_alloc(CB_CACHE_LINE, sizeof(cb_barrier_t));
+
+    if (!work || !scratch || !out || !bounds || !splits || !hists ||
+        !threads || !args || !times || !barrier) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    uint64_t expected = cb_sort_fingerprint(dataset, n);
+    double baseline[2] = { 0.0, 0.0 }; /* single-merge, single-radix means. */
+
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        int workers = 1;
+        bool all_ok = true;
+
+        if (mode == MODE_THREAD_MERGE || mode == MODE_THREAD_RADIX) {
+            workers = t;
+        } else if (mode == MODE_PROCESS_MERGE) {
+            workers = p;
+#ifndef CB_PLATFORM_UNIX
+            cb_table_add_note(table, "process-merge requires fork() and is "
+                              "not available on this platform.");
+            continue;
+#endif
+        }
+
+        fill_bounds(n, workers, bounds);
+
+        for (int iter = 0; iter < config->iterations; iter++) {
+            const int *result = NULL;
+
+            memcpy(work, dataset, (size_t)n * sizeof(int));
+
+            if (mode == MODE_SINGLE_MERGE || mode == MODE_SINGLE_RADIX) {
+                double t_start = cb_time_now();
+                if (mode == MODE_SINGLE_MERGE) {
+                    cb_sort_merge(work, scratch, n);
+                } else {
+                    cb_sort_radix(work, scratch, n);
+                }
+                times[iter] = cb_time_now() - t_start;
+                result = work;
+            } else if (mode == MODE_THREAD_MERGE || mode == MODE_THREAD_RADIX) {
+                shared.work = work;
+                shared.scratch = scratch;
+                shared.output = NULL;
+                shared.n = n;
+                shared.num_threads = t;
+                shared.bounds = bounds;
+                shared.splits = splits;
+                shared.hists = hists;
+                shared.barrier = barrier;
+
+                /* Row T of the split matrix is the end of every slice. */
+                for (int j = 0; j < t; j++) {
+                    splits[t * t + j] = bounds[j + 1];
+                }
+
+                double t_start = cb_time_now();
+                err = run_threads(&shared, mode == MODE_THREAD_MERGE
+                                  ? merge_thread_fn : radix_thread_fn,
+                                  threads, args);
+                times[iter] = cb_time_now() - t_start;
+                if (err) {
+                    goto cleanup;
+                }
+                result = shared.output;
+            } else {
+#ifdef CB_PLATFORM_UNIX
+                cb_shared_mem_t shm;
+                char shm_name[64];
+                snprintf(shm_name, sizeof(shm_name), "concur_bench_sort_%u",
+                         cb_process_self_id());
+
+                err = cb_shared_mem_create(&shm, shm_name, (size_t)n * sizeof(int));
+                if (err) {
+                    goto cleanup;
+                }
+                int *shm_data = cb_shared_mem_ptr(&shm);
+                memcpy(shm_data, dataset, (size_t)n * sizeof(int));
+
+                err = run_processes(shm_data, p, bounds, out, &times[iter]);
+                cb_shared_mem_destroy(&shm);
+                if (err) {
+                    goto cleanup;
+                }
+                result = out;
+#endif
+            }
+
+            bool ok = result && verify_output(result, n, expected);
+            if (!ok) {
+                all_ok = false;
+                fprintf(stderr, "  WARNING: %s produced an unsorted or "
+                        "non-permuted result in iteration %d\n",
+                        MODE_LABELS[mode], iter + 1);
+            }
+
+            if (config->verbose) {
+                fprintf(stdout, "  %s iteration %d/%d: %.6fs (%s)\n",
+                        MODE_LABELS[mode], iter + 1, config->iterations,
+                        times[iter], ok ? "verified" : "FAILED");
+            }
+        }
+
+        cb_bench_stats_t stats;
+        err = cb_stats_compute(times, config->iterations, &stats);
+        if (err) {
+            goto cleanup;
+        }
+
+        double base = 0.0;
+        if (mode == MODE_SINGLE_MERGE || mode == MODE_SINGLE_RADIX) {
+            baseline[mode] = stats.mean_sec;
+        } else {
+            base = baseline[mode == MODE_THREAD_RADIX ? 1 : 0];
+        }
+
+        err = cb_table_add_timing_row(table, MODE_LABELS[mode], workers, &stats,
+                                      base, (double)n / 1e6,
+                                      all_ok ? "PASS" : "FAIL");
+        if (err) {
+            goto cleanup;
+        }
+    }
+
+    cb_table_add_note(table, "Speedups are relative to the sequential run of "
+                      "the same algorithm; worker creation is timed, input "
+                      "copying is not.");
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    cb_aligned_free(barrier);
+    free(work);
+    free(scratch);
+    free(out);
+    free(bounds);
+    free(splits);
+    free(hists);
+    free(threads);
+    free(args);
+    free(times);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file bench_sort.h
+ * @brief Sort workload for concur-bench.
+ *
+ * Unlike summation, sorting has communication phases between workers,
+ * so its scaling says more about algorithms that must exchange data.
+ * The workload sorts a copy of the shared dataset in five ways:
+ * - single-merge / single-radix: sequential baselines.
+ * - thread-merge: each thread merge-sorts a slice, then every thread
+ *   merges one rank-exact partition of all slices (multiway merge).
+ * - thread-radix: LSD radix sort with per-thread digit histograms and
+ *   a barrier between the histogram and scatter phases of each pass.
+ * - process-merge: children sort slices in shared memory, then the
+ *   parent multiway-merges them (Unix only).
+ */
+
+#ifndef CB_BENCH_SORT_H
+#define CB_BENCH_SORT_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the sort workload in every mode and produce a result table.
+ *
+ * Each mode runs config->iterations times on a fresh copy of the
+ * dataset; copying is not timed, worker creation is. Every output is
+ * checked to be sorted and a permutation of the input (by multiset
+ * fingerprint). Throughput is reported in millions of elements per
+ * second; speedups are relative to the sequential run of the same
+ * algorithm.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, num_processes, iterations, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ALLOC, CB_ERR_THREAD, CB_ERR_FORK,
+ *         CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_sort_run(const int *dataset, const cb_config_t *config,
+                             cb_table_t **table_out);
+
+#endif /* CB_BENCH_SORT_H */
@@ -0,0 +1,485 @@
+/**
+ * @file bench_straggler.c
+ * @brief Implementation of the straggler suite.
+ *
+ * A round forks one child per slice, as process mode does, and ends
+ * when every slice has a result; reaping the children comes after the
+ * clock stops. The two variants alternate round by round so both see
+ * the same machine state:
+ *
+ * - wait-all:    the parent waits for each slice's only child.
+ * - speculative: once half of the slices are done, a slice still
+ *                running k x their median time after it started gets
+ *                one backup child. The first result for a slice wins;
+ *                the other attempt is killed.
+ *
+ * The coordinator never blocks on one pipe: it waits on all open pipes
+ * with a timeout that ends at the earliest pending deadline.
+ *
+ * To make stragglers reproducible, the primary child of one slice in
+ * about half of the rounds (chosen from the seed, the same for both
+ * variants) sleeps before summing, like a child that is descheduled.
+ * Backups never sleep.
+ */
+
+#include "bench_straggler.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+#include "worker.h"
+
+/** @brief Number of table columns. */
+#define STRAGGLER_COLS 11
+
+/** @brief Fewest rounds per variant, so the tail has some samples. */
+#define STRAGGLER_MIN_RUNS 32
+
+#ifdef CB_PLATFORM_UNIX
+/**
+ * @brief Argument of one child process.
+ */
+typedef struct {
+    const int   *dataset;   /**< Input array (inherited through fork). */
+    int          start;     /**< First element of the slice. */
+    int          length;    /**< Elements in the slice. */
+    unsigned int delay_ms;  /**< Injected sleep before summing. */
+    cb_pipe_t   *pipe;      /**< Result pipe. */
+} attempt_arg_t;
+
+/**
+ * @brief One child working on a slice.
+ */
+typedef struct {
+    cb_process_t  proc;     /**< Child process. */
+    cb_pipe_t     pipe;     /**< Result pipe (parent holds the read end). */
+    attempt_arg_t arg;      /**< Child argument. */
+    double        start;    /**< When it was spawned. */
+    bool          spawned;  /**< Needs reaping. */
+    bool          open;     /**< Pipe read end still watched. */
+} attempt_t;
+
+/**
+ * @brief Coordinator state of one slice.
+ */
+typedef struct {
+    attempt_t attempt[2];  /**< [0] primary, [1] backup. */
+    bool      done;        /**< A result has arrived. */
+    bool      backup_won;  /**< The backup's result arrived first. */
+    double    duration;    /**< Primary start to first result. */
+    long int  sum;         /**< First result. */
+} slice_t;
+
+/**
+ * @brief Outcome of one round.
+ */
+typedef struct {
+    double   time;        /**< First spawn to last slice result. */
+    long int sum;         /**< Total of the slice results. */
+    int      stragglers;  /**< Slices counted as stragglers. */
+    int      backups;     /**< Backups launched. */
+    int      wins;        /**< Backups whose result came first. */
+} round_t;
+
+/** @brief Child body: optionally sleep, sum the slice, send the result. */
+static void attempt_fn(void *arg)
+{
+    attempt_arg_t *a = (attempt_arg_t *)arg;
+
+    if (a->delay_ms) {
+        cb_sleep_ms(a->delay_ms);
+    }
+
+    cb_result_t result = cb_array_sum(a->dataset, a->start, a->length);
+    cb_error_t err = cb_pipe_write(a->pipe, &result, sizeof(result));
+    cb_pipe_close_write(a->pipe);
+    _Exit(err ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/** @brief Fork one attempt at slice [start, start + length). */
+static cb_error_t spawn_attempt(attempt_t *at, const int *dataset, int start,
+                                int length, unsigned int delay_ms)
+{
+    cb_error_t err = cb_pipe_create(&at->pipe);
+    if (err) {
+        return err;
+    }
+
+    at->arg.dataset = dataset;
+    at->arg.start = start;
+    at->arg.length = length;
+    at->arg.delay_ms = delay_ms;
+    at->arg.pipe = &at->pipe;
+    at->start = cb_time_now();
+
+    err = cb_process_spawn(&at->proc, NULL, attempt_fn, &at->arg);
+    cb_pipe_close_write(&at->pipe);
+    if (err) {
+        cb_pipe_close_read(&at->pipe);
+        return err;
+    }
+
+    at->spawned = true;
+    at->open = true;
+    return CB_OK;
+}
+
+/** @brief Stop watching an attempt; kill it first if @p cancel. */
+static void close_attempt(attempt_t *at, bool cancel)
+{
+    if (!at->open) {
+        return;
+    }
+    if (cancel) {
+        cb_process_kill(&at->proc);
+    }
+    cb_pipe_close_read(&at->pipe);
+    at->open = false;
+}
+
+/** @brief Comparison function for qsort on doubles. */
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Lower median of the first @p count entries of @p sorted.
+ *
+ * With two slices, a straggler is then measured against the other
+ * slice rather than against the mean of both.
+ */
+static double median_of(const double *sorted, int count)
+{
+    return sorted[(count - 1) / 2];
+}
+
+/**
+ * @brief Run one round.
+ *
+ * @param victim     Slice whose primary sleeps, or -1.
+ * @param speculate  Launch backups past the deadline.
+ * @param scratch    At least p doubles.
+ * @param watch      At least 2 p pipe pointers.
+ */
+static cb_error_t run_round(const int *dataset, const int *bounds, int p,
+                            slice_t *slices, int victim,
+                            unsigned int delay_ms, bool speculate, double k,
+                            double *scratch, cb_pipe_t **watch, round_t *out)
+{
+    cb_error_t err = CB_OK;
+    int done = 0;
+    double median = 0.0;
+
+    memset(slices, 0, (size_t)p * sizeof(slice_t));
+    memset(out, 0, sizeof(*out));
+
+    double t_start = cb_time_now();
+    for (int i = 0; i < p; i++) {
+        err = spawn_attempt(&slices[i].attempt[0], dataset, bounds[i],
+                            bounds[i + 1] - bounds[i],
+                            i == victim ? delay_ms : 0);
+        if (err) {
+            goto reap;
+        }
+    }
+
+    while (done < p) {
+        int timeout_ms = -1;
+        double now = cb_time_now();
+
+        /* Earliest deadline of a running slice without a backup. */
+        if (speculate && 2 * done >= p) {
+            double earliest = 0.0;
+            bool any = false;
+            for (int i = 0; i < p; i++) {
+                slice_t *s = &slices[i];
+                if (s->done || s->attempt[1].spawned) {
+                    continue;
+                }
+                double deadline = s->attempt[0].start + k * median;
+                if (deadline <= now) {
+                    err = spawn_attempt(&s->attempt[1], dataset, bounds[i],
+                                        bounds[i + 1] - bounds[i], 0);
+                    if (err) {
+                        goto reap;
+                    }
+                    out->backups++;
+                    out->stragglers++;
+                    continue;
+                }
+                if (!any || deadline < earliest) {
+                    earliest = deadline;
+                    any = true;
+                }
+            }
+            if (any) {
+                timeout_ms = (int)((earliest - now) * 1000.0) + 1;
+            }
+        }
+
+        for (int i = 0; i < p; i++) {
+            for (int a = 0; a < 2; a++) {
+                attempt_t *at = &slices[i].attempt[a];
+                watch[2 * i + a] = at->open ? &at->pipe : NULL;
+            }
+        }
+
+        int ready = 0;
+        err = cb_pipe_wait_any(watch, 2 * p, timeout_ms, &ready);
+        if (err == CB_ERR_TIMEOUT) {
+            err = CB_OK;
+            continue;
+        }
+        if (err) {
+            goto reap;
+        }
+
+        slice_t *s = &slices[ready / 2];
+        attempt_t *at = &s->attempt[ready % 2];
+        cb_result_t result;
+        cb_error_t read_err = cb_pipe_read(&at->pipe, &result, sizeof(result));
+        close_attempt(at, false);
+
+        if (read_err) {
+            /* That child died; fail only if the slice has no other hope. */
+            if (!s->done && !s->attempt[0].open && !s->attempt[1].open) {
+                err = read_err;
+                goto reap;
+            }
+            continue;
+        }
+        if (s->done) {
+            continue;
+        }
+
+        s->done = true;
+        s->backup_won = ready % 2 == 1;
+        s->duration = cb_time_now() - s->attempt[0].start;
+        s->sum = result.sum;
+        close_attempt(&s->attempt[1 - ready % 2], true);
+
+        out->sum += result.sum;
+        out->wins += s->backup_won;
+        scratch[done++] = s->duration;
+        qsort(scratch, (size_t)done, sizeof(double), compare_double);
+        median = median_of(scratch, done);
+    }
+    out->time = cb_time_now() - t_start;
+
+    if (!speculate) {
+        /* scratch holds all p durations, sorted. */
+        for (int i = 0; i < p; i++) {
+            if (slices[i].duration > k * median) {
+                out->stragglers++;
+            }
+        }
+    }
+
+reap:
+    for (int i = 0; i < p; i++) {
+        for (int a = 0; a < 2; a++) {
+            attempt_t *at = &slices[i].attempt[a];
+            close_attempt(at, true);
+            if (at->spawned) {
+                cb_process_wait(&at->proc, NULL);
+                at->spawned = false;
+            }
+        }
+    }
+    return err;
+}
+
+/** @brief Value at fraction @p q of @p sorted (nearest rank). */
+static double percentile(const double *sorted, int count, double q)
+{
+    int rank = (int)(q * count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[(rank > count ? count : rank) - 1];
+}
+#endif /* CB_PLATFORM_UNIX */
+
+cb_error_t cb_bench_straggler_run(const int *dataset, const cb_config_t *config,
+                                  cb_table_t **table_out)
+{
+    static const char *const headers[STRAGGLER_COLS] = {
+        "Mode", "Workers", "Runs", "Mean (s)", "p50 (s)", "p95 (s)",
+        "Max (s)", "Stragglers", "Backups", "Backup wins", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+#ifdef CB_PLATFORM_UNIX
+    int *bounds = NULL, *victims = NULL;
+    slice_t *slices = NULL;
+    cb_pipe_t **watch = NULL;
+    double *scratch = NULL, *times[2] = { NULL, NULL };
+#endif
+
+    if (!dataset || !config || !table_out || config->num_processes < 1) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    err = cb_table_create(&table, "straggler", "Stragglers: Wait-All vs "
+                          "Speculative Re-execution", headers, STRAGGLER_COLS);
+    if (err) {
+        return err;
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    int n = config->array_length;
+    int p = config->num_processes;
+    int runs = config->iterations > STRAGGLER_MIN_RUNS ? config->iterations
+                                                       : STRAGGLER_MIN_RUNS;
+    double k = config->straggler_k;
+    unsigned int delay_ms = (unsigned int)config->straggler_delay_ms;
+
+    bounds   = calloc((size_t)p + 1, sizeof(int));
+    victims  = calloc((size_t)runs, sizeof(int));
+    slices   = calloc((size_t)p, sizeof(slice_t));
+    watch    = calloc((size_t)p * 2, sizeof(cb_pipe_t *));
+    scratch  = calloc((size_t)p, sizeof(double));
+    times[0] = calloc((size_t)runs, sizeof(double));
+    times[1] = calloc((size_t)runs, sizeof(double));
+    if (!bounds || !victims || !slices || !watch || !scratch ||
+        !times[0] || !times[1]) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    /* Slices as in process mode. */
+    int base_len = n / p, remainder = n % p;
+    for (int i = 0; i < p; i++) {
+        bounds[i + 1] = bounds[i] + base_len + (i < remainder ? 1 : 0);
+    }
+
+    /* Victim schedule: one slice in about half of the rounds. */
+    uint32_t rng = config->seed ? config->seed : 1u;
+    int injected = 0;
+    for (int r = 0; r < runs; r++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int pick = (int)(rng % (uint32_t)(2 * p));
+        victims[r] = delay_ms && pick < p ? pick : -1;
+        injected += victims[r] >= 0;
+    }
+
+    long int expected = cb_array_sum(dataset, 0, n).sum;
+    round_t totals[2];
+    bool all_ok[2] = { true, true };
+    memset(totals, 0, sizeof(totals));
+
+    for (int r = 0; r < runs; r++) {
+        for (int v = 0; v < 2; v++) {
+            round_t round;
+            err = run_round(dataset, bounds, p, slices, victims[r],
+                            delay_ms, v == 1, k, scratch, watch, &round);
+            if (err) {
+                goto cleanup;
+            }
+
+            times[v][r] = round.time;
+            totals[v].stragglers += round.stragglers;
+            totals[v].backups += round.backups;
+            totals[v].wins += round.wins;
+            if (round.sum != expected) {
+                all_ok[v] = false;
+            }
+
+            if (config->verbose) {
+                fprintf(stdout, "  %s run %d/%d: %.6fs, %d straggler%s, "
+                        "%d backup win%s\n", v ? "speculative" : "wait-all",
+                        r + 1, runs, round.time, round.stragglers,
+                        round.stragglers == 1 ? "" : "s", round.wins,
+                        round.wins == 1 ? "" : "s");
+            }
+        }
+    }
+
+    double p95[2];
+    for (int v = 0; v < 2; v++) {
+        cb_bench_stats_t stats;
+        err = cb_stats_compute(times[v], runs, &stats);
+        if (!err) {
+            err = cb_table_add_row(table);
+        }
+        if (err) {
+            goto cleanup;
+        }
+
+        qsort(times[v], (size_t)runs, sizeof(double), compare_double);
+        p95[v] = percentile(times[v], runs, 0.95);
+
+        cb_table_set(table, 0, "%s", v ? "speculative" : "wait-all");
+        cb_table_set(table, 1, "%d", p);
+        cb_table_set(table, 2, "%d", runs);
+        cb_table_set(table, 3, "%.6f", stats.mean_sec);
+        cb_table_set(table, 4, "%.6f", percentile(times[v], runs, 0.50));
+        cb_table_set(table, 5, "%.6f", p95[v]);
+        cb_table_set(table, 6, "%.6f", stats.max_sec);
+        cb_table_set(table, 7, "%.1f%%",
+                     100.0 * totals[v].stragglers / ((double)runs * p));
+        if (v) {
+            cb_table_set(table, 8, "%d", totals[v].backups);
+            cb_table_set(table, 9, "%d", totals[v].wins);
+        } else {
+            cb_table_set(table, 8, "-");
+            cb_table_set(table, 9, "-");
+        }
+        cb_table_set(table, 10, "%s", all_ok[v] ? "PASS" : "FAIL");
+    }
+
+    cb_table_add_note(table, "Deadline: %.2f x the median time of the "
+                      "slices done so far, once half are done; first "
+                      "result wins, the other child is killed.", k);
+    if (delay_ms) {
+        cb_table_add_note(table, "Injected: one primary child sleeps %u ms "
+                          "before summing in %d of %d rounds (from the "
+                          "seed), standing in for descheduling.", delay_ms,
+                          injected, runs);
+    } else {
+        cb_table_add_note(table, "No delay injected (--straggler-delay 0); "
+                          "stragglers are the host's own.");
+    }
+    cb_table_add_note(table, "Stragglers: wait-all counts slices over %.2f x "
+                      "the round's median; speculative counts slices that "
+                      "got a backup.", k);
+    cb_table_add_note(table, "p95 round time: %.6f s wait-all vs %.6f s "
+                      "speculative (%+.1f%%).", p95[0], p95[1],
+                      p95[0] > 0.0 ? 100.0 * (p95[1] - p95[0]) / p95[0]
+                                   : 0.0);
+    if (p == 1) {
+        cb_table_add_note(table, "One process: there is no median of other "
+                          "slices, so no backup is ever launched.");
+    }
+#else
+    cb_table_add_note(table, "The straggler suite requires fork() and is "
+                      "not available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+#ifdef CB_PLATFORM_UNIX
+cleanup:
+    free(bounds);
+    free(victims);
+    free(slices);
+    free(watch);
+    free(scratch);
+    free(times[0]);
+    free(times[1]);
+#endif
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file bench_straggler.h
+ * @brief Straggler suite: speculative re-execution of slow slices.
+ *
+ * In process mode the parent reads the children's pipes in order, so
+ * one descheduled child holds up the whole iteration. This suite runs
+ * the same fork-per-slice sum twice per round: once waiting for every
+ * child, and once with a deadline-aware coordinator that watches all
+ * pipes at once (cb_pipe_wait_any()), gives a slice still running after
+ * k times the median slice time a backup worker on the same slice,
+ * takes whichever result arrives first and kills the other. It reports
+ * how often slices straggle and the round-time tail with and without
+ * speculation.
+ */
+
+#ifndef CB_BENCH_STRAGGLER_H
+#define CB_BENCH_STRAGGLER_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the straggler suite and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array.
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_processes, iterations, seed, straggler_k,
+ *                   straggler_delay_ms, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_FORK,
+ *         CB_ERR_PIPE on failure.
+ */
+cb_error_t cb_bench_straggler_run(const int *dataset, const cb_config_t *config,
+                                  cb_table_t **table_out);
+
+#endif /* CB_BENCH_STRAGGLER_H */
@@ -0,0 +1,572 @@
+/**
+ * @file bench_tenants.c
+ * @brief Implementation of the multi-tenant interference suite.
+ *
+ * A tenant is a forked process that fills its own array_length-element
+ * dataset (seeded per tenant, so no two tenants share pages or cache
+ * lines) and then runs thread-mode iterations over it: num_threads
+ * threads each sum a slice with cb_kernel_sum() and are joined. For
+ * each placement the parent runs every tenant alone, then all K
+ * together, from one shared region holding a start barrier, a "done
+ * timing" counter and the per-iteration times.
+ *
+ * In a run each tenant does one untimed warm-up iteration, waits at
+ * the barrier, times its iterations, and then keeps running untimed
+ * iterations until every tenant has finished timing, so that no
+ * tenant's samples see fewer neighbours than the others'.
+ *
+ * Placements (thread j of tenant t, over the usable CPUs in order):
+ * - none:      unpinned, the scheduler decides.
+ * - disjoint:  CPU (t x num_threads + j), wrapping when tenants x
+ *              threads exceeds the usable CPUs.
+ * - overlap:   CPU j, the same set for every tenant.
+ */
+
+#include "bench_tenants.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "dataset.h"
+#include "kernel.h"
+#include "platform.h"
+#include "stats.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define TENANTS_COLS 8
+
+/** @brief Logical CPUs the topology is read for. */
+#define TENANTS_MAX_CPUS 1024
+
+/** @brief CPU placements, in table order. */
+typedef enum {
+    PLACE_NONE = 0,
+    PLACE_DISJOINT,
+    PLACE_OVERLAP,
+    PLACE_COUNT
+} tenants_place_t;
+
+/** @brief Placement names, indexed by tenants_place_t. */
+static const char *const PLACEMENTS[PLACE_COUNT] = {
+    "none", "disjoint", "overlap"
+};
+
+bool cb_bench_tenants_placement_valid(const char *name)
+{
+    for (int p = 0; name && p < PLACE_COUNT; p++) {
+        if (strcmp(PLACEMENTS[p], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Placement labels for the table. */
+static const char *const PLACEMENT_LABELS[PLACE_COUNT] = {
+    "unpinned", "disjoint", "overlap"
+};
+
+/** @brief Dataset seed of tenant @p t (nonzero, distinct per tenant). */
+static unsigned int tenant_seed(unsigned int seed, int t)
+{
+    unsigned int s = seed * 2654435761u + (unsigned int)t * 40503u + 1u;
+    return s ? s : 1u;
+}
+
+/**
+ * @brief Format a set of CPUs as ranges, e.g. "0-3,8".
+ */
+static void format_cpus(char *buf, size_t buf_size, const int *cpus, int count)
+{
+    int sorted[CB_MAX_WORKERS];
+    int n = 0;
+
+    buf[0] = '\0';
+    if (count < 1 || cpus[0] < 0) {
+        snprintf(buf, buf_size, "any");
+        return;
+    }
+
+    /* Insertion sort without duplicates. */
+    for (int i = 0; i < count && n < CB_MAX_WORKERS; i++) {
+        int j = n;
+        while (j > 0 && sorted[j - 1] > cpus[i]) {
+            j--;
+        }
+        if (j > 0 && sorted[j - 1] == cpus[i]) {
+            continue;
+        }
+        memmove(&sorted[j + 1], &sorted[j], (size_t)(n - j) * sizeof(int));
+        sorted[j] = cpus[i];
+        n++;
+    }
+
+    size_t used = 0;
+    for (int i = 0; i < n && used < buf_size; ) {
+        int k = i;
+        while (k + 1 < n && sorted[k + 1] == sorted[k] + 1) {
+            k++;
+        }
+        int w = k > i ? snprintf(buf + used, buf_size - used, "%s%d-%d",
+                                 used ? "," : "", sorted[i], sorted[k])
+                      : snprintf(buf + used, buf_size - used, "%s%d",
+                                 used ? "," : "", sorted[i]);
+        if (w < 0) {
+            break;
+        }
+        used += (size_t)w;
+        i = k + 1;
+    }
+}
+
+/**
+ * @brief Control block at the start of the shared region.
+ */
+typedef struct {
+    cb_barrier_t barrier;          /**< Start barrier of the tenants. */
+    _Atomic int  done;             /**< Tenants finished timing. */
+    _Atomic int  pin_failed;       /**< Threads that could not be pinned. */
+    bool         ok[CB_MAX_TENANTS]; /**< Per tenant: every sum correct. */
+} tenants_ctl_t;
+
+/**
+ * @brief Argument of one tenant thread.
+ */
+typedef struct {
+    tenants_ctl_t *ctl;     /**< Control block (shared). */
+    const int     *data;    /**< Slice start. */
+    int            length;  /**< Slice length. */
+    int            cpu;     /**< CPU to pin to, or -1. */
+    long int       sum;     /**< Output: slice sum. */
+} tenant_thread_t;
+
+/**
+ * @brief Argument of one tenant process.
+ */
+typedef struct {
+    tenants_ctl_t *ctl;         /**< Control block (shared). */
+    double        *times;       /**< This tenant's timed iterations. */
+    const int     *cpus;        /**< num_threads CPUs, or -1 each. */
+    unsigned int   seed;        /**< Dataset seed. */
+    int            slot;        /**< Index among the running tenants. */
+    int            count;       /**< Running tenants. */
+    int            n;           /**< Dataset elements. */
+    int            threads;     /**< Sum threads per iteration. */
+    int            iterations;  /**< Timed iterations. */
+} tenant_child_t;
+
+/** @brief Thread body: pin, then sum one slice. */
+static void *tenant_thread_fn(void *arg)
+{
+    tenant_thread_t *a = (tenant_thread_t *)arg;
+
+    if (a->cpu >= 0 && cb_thread_pin_self(a->cpu) != CB_OK) {
+        atomic_fetch_add(&a->ctl->pin_failed, 1);
+    }
+    a->sum = cb_kernel_sum(a->data, a->length);
+    return NULL;
+}
+
+/** @brief One thread-mode iteration; @p sum receives the total. */
+static cb_error_t tenant_iteration(tenant_thread_t *targs, cb_thread_t *threads,
+                                   int m, long int *sum)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    for (int j = 0; j < m; j++) {
+        err = cb_thread_create(&threads[j], tenant_thread_fn, &targs[j]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    *sum = 0;
+    for (int j = 0; j < created; j++) {
+        cb_error_t join_err = cb_thread_join(&threads[j]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+        *sum += targs[j].sum;
+    }
+
+    return err;
+}
+
+/** @brief Tenant body: fill, warm up, time, then load until all are done. */
+static void tenant_child_fn(void *arg)
+{
+    tenant_child_t *c = (tenant_child_t *)arg;
+    tenants_ctl_t *ctl = c->ctl;
+    int m = c->threads;
+    int *data = malloc((size_t)c->n * sizeof(int));
+    cb_thread_t *threads = calloc((size_t)m, sizeof(cb_thread_t));
+    tenant_thread_t *targs = calloc((size_t)m, sizeof(tenant_thread_t));
+    cb_error_t err = (data && threads && targs) ? CB_OK : CB_ERR_ALLOC;
+    bool ok = true;
+    long int expected = 0, sum = 0;
+
+    if (!err) {
+        cb_dataset_fill_range(c->seed, 0, c->n, data);
+        expected = cb_kernel_sum(data, c->n);
+
+        int base_len = c->n / m, remainder = c->n % m, start = 0;
+        for (int j = 0; j < m; j++) {
+            targs[j].ctl = ctl;
+            targs[j].data = data + start;
+            targs[j].length = base_len + (j < remainder ? 1 : 0);
+            targs[j].cpu = c->cpus[j];
+            start += targs[j].length;
+        }
+        err = tenant_iteration(targs, threads, m, &sum);
+    }
+
+    /* Always reach the barrier: the other tenants wait for this one. */
+    cb_barrier_wait(&ctl->barrier, c->slot);
+
+    for (int iter = 0; iter < c->iterations && !err; iter++) {
+        double t_start = cb_time_now();
+        err = tenant_iteration(targs, threads, m, &sum);
+        c->times[iter] = cb_time_now() - t_start;
+        ok = ok && sum == expected;
+    }
+
+    atomic_fetch_add(&ctl->done, 1);
+    while (!err && atomic_load(&ctl->done) < c->count) {
+        err = tenant_iteration(targs, threads, m, &sum);
+    }
+
+    ctl->ok[c->slot] = ok;
+    free(data);
+    free(threads);
+    free(targs);
+    _Exit(err ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/**
+ * @brief Settings shared by every run of the suite.
+ */
+typedef struct {
+    int             n;           /**< Dataset elements per tenant. */
+    int             threads;     /**< Sum threads per tenant. */
+    int             iterations;  /**< Timed iterations per tenant. */
+    unsigned int    seed;        /**< Base seed. */
+    const int      *cpu_of;      /**< tenants x threads CPUs (-1 = any). */
+    cb_process_t   *procs;       /**< Scratch, one per tenant. */
+    tenant_child_t *children;    /**< Scratch, one per tenant. */
+} tenants_plan_t;
+
+/**
+ * @brief Run tenants first .. first + count - 1 together.
+ *
+ * @param times       Output: count x iterations, tenant-major.
+ * @param ok          Output: per tenant, every sum correct.
+ * @param pin_failed  Accumulates threads that could not be pinned.
+ */
+static cb_error_t run_tenants(const tenants_plan_t *plan, int first, int count,
+                              double *times, bool *ok, int *pin_failed)
+{
+    cb_error_t err = CB_OK;
+    cb_shared_mem_t shm;
+    char shm_name[64];
+    int spawned = 0;
+    size_t ctl_size = (sizeof(tenants_ctl_t) + CB_CACHE_LINE - 1) /
+                      CB_CACHE_LINE * CB_CACHE_LINE;
+    size_t times_size = (size_t)count * (size_t)plan->iterations *
+                        sizeof(double);
+
+    snprintf(shm_name, sizeof(shm_name), "concur_bench_tenants_%u",
+             cb_process_self_id());
+    err = cb_shared_mem_create(&shm, shm_name, ctl_size + times_size);
+    if (err) {
+        return err;
+    }
+
+    char *base = cb_shared_mem_ptr(&shm);
+    tenants_ctl_t *ctl = (tenants_ctl_t *)base;
+    double *shm_times = (double *)(base + ctl_size);
+
+    atomic_store(&ctl->done, 0);
+    atomic_store(&ctl->pin_failed, 0);
+    err = cb_barrier_init(&ctl->barrier, CB_BARRIER_CENTRAL,
+                          CB_WAIT_SPIN_FUTEX, count, true);
+    if (err) {
+        goto cleanup;
+    }
+
+    for (int i = 0; i < count; i++) {
+        tenant_child_t *c = &plan->children[i];
+        c->ctl = ctl;
+        c->times = shm_times + (size_t)i * (size_t)plan->iterations;
+        c->cpus = plan->cpu_of + (size_t)(first + i) * (size_t)plan->threads;
+        c->seed = tenant_seed(plan->seed, first + i);
+        c->slot = i;
+        c->count = count;
+        c->n = plan->n;
+        c->threads = plan->threads;
+        c->iterations = plan->iterations;
+
+        err = cb_process_spawn(&plan->procs[i], NULL, tenant_child_fn, c);
+        if (err) {
+            break;
+        }
+        spawned++;
+    }
+
+    if (err) {
+        /* Spawned tenants would wait at the barrier forever. */
+        for (int i = 0; i < spawned; i++) {
+            cb_process_kill(&plan->procs[i]);
+        }
+    }
+
+    for (int i = 0; i < spawned; i++) {
+        int status = 0;
+        cb_error_t wait_err = cb_process_wait(&plan->procs[i], &status);
+        if (!wait_err && status != 0) {
+            wait_err = CB_ERR_FORK;
+        }
+        if (wait_err && !err) {
+            err = wait_err;
+        }
+    }
+
+    if (!err) {
+        memcpy(times, shm_times, times_size);
+        for (int i = 0; i < count; i++) {
+            ok[i] = ctl->ok[i];
+        }
+        *pin_failed += atomic_load(&ctl->pin_failed);
+    }
+
+    cb_barrier_destroy(&ctl->barrier);
+
+cleanup:
+    cb_shared_mem_destroy(&shm);
+    return err;
+}
+
+/**
+ * @brief Fill cpu_of for @p place; returns false if CPUs are needed but
+ *        the topology cannot be read.
+ *
+ * @param wrapped  Output: some CPUs serve more than one tenant thread
+ *                 in a disjoint placement.
+ */
+static bool place_threads(tenants_place_t place, int k, int m,
+                          const int *usable, int nusable, int *cpu_of,
+                          bool *wrapped)
+{
+    *wrapped = false;
+    for (int t = 0; t < k; t++) {
+        for (int j = 0; j < m; j++) {
+            int idx = place == PLACE_DISJOINT ? t * m + j : j;
+            if (place != PLACE_NONE && nusable < 1) {
+                return false;
+            }
+            cpu_of[t * m + j] = place == PLACE_NONE ? -1
+                                                    : usable[idx % nusable];
+            if (place == PLACE_DISJOINT && idx >= nusable) {
+                *wrapped = true;
+            }
+        }
+    }
+    return true;
+}
+#endif /* CB_PLATFORM_UNIX */
+
+cb_error_t cb_bench_tenants_run(const cb_config_t *config,
+                                cb_table_t **table_out)
+{
+    static const char *const headers[TENANTS_COLS] = {
+        "Placement", "Tenant", "CPUs", "Solo (ms)", "Shared (ms)",
+        "Shared max (ms)", "Slowdown", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+#ifdef CB_PLATFORM_UNIX
+    tenants_plan_t plan;
+    int *cpu_of = NULL;
+    int *usable = NULL;
+    int *core_of = NULL;
+    double *solo = NULL;
+    double *shared = NULL;
+#endif
+
+    if (!config || !table_out || config->tenants < 1 ||
+        config->tenants > CB_MAX_TENANTS || config->num_threads < 1 ||
+        config->num_threads > CB_MAX_WORKERS) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    err = cb_table_create(&table, "tenants", "Multi-Tenant Interference: "
+                          "Solo vs Shared Host", headers, TENANTS_COLS);
+    if (err) {
+        return err;
+    }
+
+#ifdef CB_PLATFORM_UNIX
+    int k = config->tenants;
+    int m = config->num_threads;
+    int iterations = config->iterations;
+    int nusable = 0, num_cpus = 0, pin_failed = 0;
+    bool any_wrapped = false, no_topology = false;
+
+    memset(&plan, 0, sizeof(plan));
+    cpu_of = calloc((size_t)k * (size_t)m, sizeof(int));
+    usable = calloc(TENANTS_MAX_CPUS, sizeof(int));
+    core_of = calloc(TENANTS_MAX_CPUS, sizeof(int));
+    solo = calloc((size_t)k * (size_t)iterations, sizeof(double));
+    shared = calloc((size_t)k * (size_t)iterations, sizeof(double));
+    plan.procs = calloc((size_t)k, sizeof(cb_process_t));
+    plan.children = calloc((size_t)k, sizeof(tenant_child_t));
+    if (!cpu_of || !usable || !core_of || !solo || !shared || !plan.procs ||
+        !plan.children) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    if (cb_cpu_topology(core_of, TENANTS_MAX_CPUS, &num_cpus) == CB_OK) {
+        for (int cpu = 0; cpu < num_cpus; cpu++) {
+            if (core_of[cpu] >= 0) {
+                usable[nusable++] = cpu;
+            }
+        }
+    }
+
+    plan.n = config->array_length;
+    plan.threads = m;
+    plan.iterations = iterations;
+    plan.seed = config->seed;
+    plan.cpu_of = cpu_of;
+
+    for (int p = 0; p < PLACE_COUNT; p++) {
+        tenants_place_t place = (tenants_place_t)p;
+        bool solo_ok[CB_MAX_TENANTS], shared_ok[CB_MAX_TENANTS];
+        bool wrapped = false;
+
+        if (config->tenant_cpus[0] != '\0' &&
+            strcmp(config->tenant_cpus, PLACEMENTS[p]) != 0) {
+            continue;
+        }
+        if (!place_threads(place, k, m, usable, nusable, cpu_of, &wrapped)) {
+            no_topology = true;
+            continue;
+        }
+        any_wrapped = any_wrapped || wrapped;
+
+        for (int t = 0; t < k; t++) {
+            err = run_tenants(&plan, t, 1, &solo[t * iterations], &solo_ok[t],
+                              &pin_failed);
+            if (err) {
+                goto cleanup;
+            }
+        }
+        err = run_tenants(&plan, 0, k, shared, shared_ok, &pin_failed);
+        if (err) {
+            goto cleanup;
+        }
+
+        double slowdown_sum = 0.0, worst = 0.0;
+        int worst_tenant = 0;
+
+        for (int t = 0; t < k; t++) {
+            cb_bench_stats_t solo_stats, shared_stats;
+            char cpus_text[CB_TABLE_CELL_LEN];
+
+            err = cb_stats_compute(&solo[t * iterations], iterations,
+                                   &solo_stats);
+            if (!err) {
+                err = cb_stats_compute(&shared[t * iterations], iterations,
+                                       &shared_stats);
+            }
+            if (!err) {
+                err = cb_table_add_row(table);
+            }
+            if (err) {
+                goto cleanup;
+            }
+
+            double slowdown = solo_stats.mean_sec > 0.0
+                ? shared_stats.mean_sec / solo_stats.mean_sec : 0.0;
+            slowdown_sum += slowdown;
+            if (t == 0 || slowdown > worst) {
+                worst = slowdown;
+                worst_tenant = t;
+            }
+
+            format_cpus(cpus_text, sizeof(cpus_text), &cpu_of[t * m], m);
+            cb_table_set(table, 0, "%s", PLACEMENT_LABELS[p]);
+            cb_table_set(table, 1, "%d", t);
+            cb_table_set(table, 2, "%s", cpus_text);
+            cb_table_set(table, 3, "%.3f", solo_stats.mean_sec * 1e3);
+            cb_table_set(table, 4, "%.3f", shared_stats.mean_sec * 1e3);
+            cb_table_set(table, 5, "%.3f", shared_stats.max_sec * 1e3);
+            cb_table_set(table, 6, "%.2fx", slowdown);
+            cb_table_set(table, 7, "%s", solo_ok[t] && shared_ok[t]
+                                         ? "PASS" : "FAIL");
+
+            if (config->verbose) {
+                fprintf(stdout, "  tenants %s tenant %d: solo %.3f ms, "
+                        "shared %.3f ms (%.2fx)\n", PLACEMENT_LABELS[p], t,
+                        solo_stats.mean_sec * 1e3,
+                        shared_stats.mean_sec * 1e3, slowdown);
+            }
+        }
+
+        cb_table_add_note(table, "%s: mean slowdown %.2fx, worst %.2fx "
+                          "(tenant %d).", PLACEMENT_LABELS[p],
+                          slowdown_sum / k, worst, worst_tenant);
+    }
+
+    cb_table_add_note(table, "Each tenant is a process with its own "
+                      "%d-element dataset, summed by %d thread%s per "
+                      "iteration as in thread mode.", plan.n, m,
+                      m == 1 ? "" : "s");
+    cb_table_add_note(table, "Shared: all %d tenants start at a barrier "
+                      "and keep running until every one has timed %d "
+                      "iterations.", k, iterations);
+    if (any_wrapped) {
+        cb_table_add_note(table, "%d tenants x %d threads exceed the %d "
+                          "usable CPUs, so disjoint sets wrap and overlap.",
+                          k, m, nusable);
+    }
+    if (pin_failed > 0) {
+        cb_table_add_note(table, "%d thread pinning attempt%s failed; those "
+                          "threads ran unpinned.", pin_failed,
+                          pin_failed == 1 ? "" : "s");
+    }
+    if (no_topology) {
+        cb_table_add_note(table, "CPU topology unavailable on this "
+                          "platform; pinned placements were not measured.");
+    }
+#else
+    cb_table_add_note(table, "The multi-tenant suite requires fork() and "
+                      "is not available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+#ifdef CB_PLATFORM_UNIX
+cleanup:
+    free(cpu_of);
+    free(usable);
+    free(core_of);
+    free(solo);
+    free(shared);
+    free(plan.procs);
+    free(plan.children);
+#endif
+    cb_table_destroy(table);
+    return err;
+}
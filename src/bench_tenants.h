@@ -0,0 +1,43 @@
+/**
+ * @file bench_tenants.h
+ * @brief Multi-tenant interference: concurrent sessions sharing a host.
+ *
+ * Every other mode measures one job with the machine to itself. This
+ * suite forks K tenants, each an independent session with its own
+ * dataset and its own sum threads, times each tenant alone and then
+ * all K at once, and reports every tenant's slowdown, i.e. what its
+ * noisy neighbours cost it in shared LLC and memory bandwidth. Tenant
+ * threads can run unpinned, pinned to disjoint CPU sets, or pinned to
+ * the same (overlapping) CPUs.
+ */
+
+#ifndef CB_BENCH_TENANTS_H
+#define CB_BENCH_TENANTS_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Check whether @p name is a known CPU placement.
+ * @param name  Placement name: "none", "disjoint" or "overlap".
+ * @return true if the placement exists.
+ */
+bool cb_bench_tenants_placement_valid(const char *name);
+
+/**
+ * @brief Run the multi-tenant suite and produce a result table.
+ *
+ * Pinned placements need a readable CPU topology; without one only
+ * the unpinned rows run.
+ *
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, iterations, seed, tenants,
+ *                   tenant_cpus, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_FORK,
+ *         CB_ERR_SHM on failure.
+ */
+cb_error_t cb_bench_tenants_run(const cb_config_t *config,
+                                cb_table_t **table_out);
+
+#endif /* CB_BENCH_TENANTS_H */
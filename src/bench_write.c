@@ -0,0 +1,405 @@
+/**
+ * @file bench_write.c
+ * @brief Implementation of the write-heavy suite.
+ *
+ * Each workload gets one shared region holding its arrays, each padded
+ * to a whole number of 64-byte lines so every array starts on a line:
+ * - transform: one int array, a copy of the dataset, updated in place.
+ * - triad:     float arrays a (output), b (the dataset) and c (the
+ *              dataset mod 7), so every result is a small integer and
+ *              exact in float.
+ *
+ * Work is split on line boundaries, so no two workers write the same
+ * line. For every mode and store kind the suite runs one untimed
+ * warm-up pass and then the timed iterations; process mode forks the
+ * workers for every pass, as the core process mode does.
+ *
+ * After each row the output is checked untimed: the transform array
+ * must sum to the dataset sum plus one per element per pass so far,
+ * and every triad output must equal its inputs' triad exactly. The
+ * triad output is then zeroed, so the next row must rewrite all of it.
+ */
+
+#include "bench_write.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+#include "stats.h"
+#include "store.h"
+#include "table.h"
+
+/** @brief Number of table columns. */
+#define WRITE_COLS 9
+
+/** @brief Triad scalar. */
+#define WRITE_SCALAR 3.0f
+
+/** @brief Workloads, in table order. */
+typedef enum {
+    WORK_TRANSFORM = 0,
+    WORK_TRIAD,
+    WORK_COUNT
+} write_work_t;
+
+/** @brief Workload labels indexed by write_work_t. */
+static const char *const WORK_NAMES[WORK_COUNT] = {
+    "transform", "triad"
+};
+
+/** @brief Arrays in the region of each workload. */
+static const int WORK_ARRAYS[WORK_COUNT] = { 1, 3 };
+
+/** @brief Arrays each workload reads per pass (it writes one). */
+static const int WORK_READS[WORK_COUNT] = { 1, 2 };
+
+/** @brief Execution modes, in table order within each workload. */
+typedef enum {
+    MODE_SINGLE = 0,
+    MODE_THREAD,
+    MODE_PROCESS,
+    MODE_COUNT
+} write_mode_t;
+
+/** @brief Mode labels indexed by write_mode_t. */
+static const char *const MODE_LABELS[MODE_COUNT] = {
+    "single", "thread", "process"
+};
+
+/**
+ * @brief Per-worker argument.
+ */
+typedef struct {
+    write_work_t    work;   /**< Workload. */
+    cb_store_kind_t kind;   /**< Store instruction. */
+    int            *data;   /**< Transform array. */
+    float          *a;      /**< Triad output. */
+    const float    *b;      /**< Triad first input. */
+    const float    *c;      /**< Triad second input. */
+    int             first;  /**< First element. */
+    int             last;   /**< One past the last element. */
+} write_arg_t;
+
+/** @brief Run the workload over one worker's elements. */
+static void write_slice(const write_arg_t *w)
+{
+    int length = w->last - w->first;
+
+    if (w->work == WORK_TRANSFORM) {
+        cb_store_transform(w->data + w->first, length, w->kind);
+    } else {
+        cb_store_triad(w->a + w->first, w->b + w->first, w->c + w->first,
+                       WRITE_SCALAR, length, w->kind);
+    }
+}
+
+/** @brief Thread entry point. */
+static void *write_thread_fn(void *arg)
+{
+    write_slice((const write_arg_t *)arg);
+    return NULL;
+}
+
+#ifdef CB_PLATFORM_UNIX
+/** @brief Child entry point; the output is in shared memory. */
+static void write_child_fn(void *arg)
+{
+    write_slice((const write_arg_t *)arg);
+    _Exit(EXIT_SUCCESS);
+}
+#endif
+
+/**
+ * @brief Run one pass in @p mode on @p workers workers.
+ *
+ * @param proto  Workload, kind and arrays; the range is filled in.
+ */
+static cb_error_t run_once(const write_arg_t *proto, int n, write_mode_t mode,
+                           int workers, write_arg_t *args,
+                           cb_thread_t *threads, cb_process_t *procs)
+{
+    cb_error_t err = CB_OK;
+    int started = 0;
+    long long lines = (n + CB_STORE_LINE_ELEMS - 1) / CB_STORE_LINE_ELEMS;
+
+#ifndef CB_PLATFORM_UNIX
+    (void)procs;
+#endif
+
+    if (mode == MODE_SINGLE) {
+        args[0] = *proto;
+        args[0].first = 0;
+        args[0].last = n;
+        write_slice(&args[0]);
+        return CB_OK;
+    }
+
+    for (int i = 0; i < workers; i++) {
+        long long first = lines * i / workers * CB_STORE_LINE_ELEMS;
+        long long last = lines * (i + 1) / workers * CB_STORE_LINE_ELEMS;
+        args[i] = *proto;
+        args[i].first = (int)(first < n ? first : n);
+        args[i].last = (int)(last < n ? last : n);
+
+#ifdef CB_PLATFORM_UNIX
+        if (mode == MODE_PROCESS) {
+            err = cb_process_spawn(&procs[i], NULL, write_child_fn, &args[i]);
+        } else
+#endif
+        {
+            err = cb_thread_create(&threads[i], write_thread_fn, &args[i]);
+        }
+        if (err) {
+            break;
+        }
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        cb_error_t join_err;
+#ifdef CB_PLATFORM_UNIX
+        if (mode == MODE_PROCESS) {
+            int status = 0;
+            join_err = cb_process_wait(&procs[i], &status);
+            if (!join_err && status != 0) {
+                join_err = CB_ERR_FORK;
+            }
+        } else
+#endif
+        {
+            join_err = cb_thread_join(&threads[i]);
+        }
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Check a workload's output after @p passes passes (untimed).
+ *
+ * Zeroes the triad output afterwards.
+ */
+static bool check_output(const write_arg_t *proto, int n, long int base_sum,
+                         long long passes)
+{
+    if (proto->work == WORK_TRANSFORM) {
+        long int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += proto->data[i];
+        }
+        return sum == base_sum + (long int)(passes * n);
+    }
+
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        if (proto->a[i] != proto->b[i] + WRITE_SCALAR * proto->c[i]) {
+            ok = false;
+        }
+    }
+    memset(proto->a, 0, (size_t)n * sizeof(float));
+    return ok;
+}
+
+cb_error_t cb_bench_write_run(const int *dataset, const cb_config_t *config,
+                              cb_table_t **table_out)
+{
+    static const char *const headers[WRITE_COLS] = {
+        "Workload", "Mode", "Workers", "Stores", "Mean (ms)",
+        "Read GB/s", "Write GB/s", "vs regular", "Check"
+    };
+    cb_error_t err = CB_OK;
+    cb_table_t *table = NULL;
+    double *times = NULL;
+    write_arg_t *args = NULL;
+    cb_thread_t *threads = NULL;
+    cb_process_t *procs = NULL;
+    cb_shared_mem_t shm;
+    bool shm_created = false;
+    double nt_min[WORK_COUNT], nt_max[WORK_COUNT];
+
+    if (!dataset || !config || !table_out || config->num_threads < 1 ||
+        config->num_processes < 1) {
+        return CB_ERR_ARGS;
+    }
+
+    *table_out = NULL;
+
+    int n = config->array_length;
+    int m = config->num_threads;
+    int p = config->num_processes;
+    int most = m > p ? m : p;
+    size_t stride = ((size_t)n + CB_STORE_LINE_ELEMS - 1) /
+                    CB_STORE_LINE_ELEMS * CB_STORE_LINE_ELEMS;
+
+    err = cb_table_create(&table, "write", "Write-Heavy Streaming: Regular "
+                          "vs Non-Temporal Stores", headers, WRITE_COLS);
+    if (err) {
+        return err;
+    }
+
+    times   = calloc((size_t)config->iterations, sizeof(double));
+    args    = calloc((size_t)most, sizeof(write_arg_t));
+    threads = calloc((size_t)m, sizeof(cb_thread_t));
+    procs   = calloc((size_t)p, sizeof(cb_process_t));
+    if (!times || !args || !threads || !procs) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    long int base_sum = 0;
+    for (int i = 0; i < n; i++) {
+        base_sum += dataset[i];
+    }
+
+    for (int w = 0; w < WORK_COUNT; w++) {
+        char shm_name[64];
+        write_arg_t proto;
+        long long passes = 0;
+
+        /* One workload at a time, so only its arrays exist. */
+        snprintf(shm_name, sizeof(shm_name), "concur_bench_write_%u",
+                 cb_process_self_id());
+        err = cb_shared_mem_create(&shm, shm_name, (size_t)WORK_ARRAYS[w] *
+                                   stride * sizeof(int));
+        if (err) {
+            goto cleanup;
+        }
+        shm_created = true;
+
+        memset(&proto, 0, sizeof(proto));
+        proto.work = (write_work_t)w;
+        if (w == WORK_TRANSFORM) {
+            proto.data = cb_shared_mem_ptr(&shm);
+            memcpy(proto.data, dataset, (size_t)n * sizeof(int));
+        } else {
+            float *base = cb_shared_mem_ptr(&shm);
+            float *b = base + stride, *c = base + 2 * stride;
+            for (int i = 0; i < n; i++) {
+                b[i] = (float)dataset[i];
+                c[i] = (float)(dataset[i] % 7);
+            }
+            memset(base, 0, (size_t)n * sizeof(float));
+            proto.a = base;
+            proto.b = b;
+            proto.c = c;
+        }
+
+        double read_bytes = (double)WORK_READS[w] * n * sizeof(int);
+        double write_bytes = (double)n * sizeof(int);
+        nt_min[w] = nt_max[w] = 0.0;
+
+        for (int mode = 0; mode < MODE_COUNT; mode++) {
+#ifndef CB_PLATFORM_UNIX
+            if (mode == MODE_PROCESS) {
+                continue;
+            }
+#endif
+            int workers = mode == MODE_THREAD ? m :
+                          mode == MODE_PROCESS ? p : 1;
+            double regular_mean = 0.0;
+
+            for (int k = 0; k < CB_STORE_KIND_COUNT; k++) {
+                proto.kind = (cb_store_kind_t)k;
+
+                err = run_once(&proto, n, (write_mode_t)mode, workers, args,
+                               threads, procs);
+                passes++;
+                for (int iter = 0; iter < config->iterations && !err; iter++) {
+                    double t_start = cb_time_now();
+                    err = run_once(&proto, n, (write_mode_t)mode, workers,
+                                   args, threads, procs);
+                    times[iter] = cb_time_now() - t_start;
+                    passes++;
+                    if (config->verbose && !err) {
+                        fprintf(stdout, "  write %s %s %s iteration %d/%d: "
+                                "%.6fs\n", WORK_NAMES[w], MODE_LABELS[mode],
+                                cb_store_kind_name(proto.kind), iter + 1,
+                                config->iterations, times[iter]);
+                    }
+                }
+                if (err) {
+                    goto cleanup;
+                }
+
+                bool ok = check_output(&proto, n, base_sum, passes);
+                cb_bench_stats_t stats;
+                err = cb_stats_compute(times, config->iterations, &stats);
+                if (!err) {
+                    err = cb_table_add_row(table);
+                }
+                if (err) {
+                    goto cleanup;
+                }
+
+                double mean = stats.mean_sec;
+                double ratio = 1.0;
+                if (k == CB_STORE_REGULAR) {
+                    regular_mean = mean;
+                } else {
+                    ratio = mean > 0.0 ? regular_mean / mean : 0.0;
+                    if (nt_max[w] == 0.0 || ratio < nt_min[w]) {
+                        nt_min[w] = ratio;
+                    }
+                    if (ratio > nt_max[w]) {
+                        nt_max[w] = ratio;
+                    }
+                }
+
+                cb_table_set(table, 0, "%s", WORK_NAMES[w]);
+                cb_table_set(table, 1, "%s", MODE_LABELS[mode]);
+                cb_table_set(table, 2, "%d", workers);
+                cb_table_set(table, 3, "%s", cb_store_kind_name(proto.kind));
+                cb_table_set(table, 4, "%.3f", mean * 1e3);
+                cb_table_set(table, 5, "%.2f",
+                             mean > 0.0 ? read_bytes / mean / 1e9 : 0.0);
+                cb_table_set(table, 6, "%.2f",
+                             mean > 0.0 ? write_bytes / mean / 1e9 : 0.0);
+                cb_table_set(table, 7, "%.2fx", ratio);
+                cb_table_set(table, 8, "%s", ok ? "PASS" : "FAIL");
+            }
+        }
+
+        cb_shared_mem_destroy(&shm);
+        shm_created = false;
+    }
+
+    cb_table_add_note(table, "Per element, transform reads and writes 4 B; "
+                      "triad reads 8 B and writes 4 B. Arrays: %.1f MiB "
+                      "each, in shared memory.",
+                      (double)stride * sizeof(int) / (1024.0 * 1024.0));
+    cb_table_add_note(table, "Regular stores also read every output line "
+                      "for ownership (not counted above); non-temporal "
+                      "stores skip that read and the cache.");
+    cb_table_add_note(table, "Non-temporal vs regular: transform %.2fx - "
+                      "%.2fx, triad %.2fx - %.2fx across modes.",
+                      nt_min[WORK_TRANSFORM], nt_max[WORK_TRANSFORM],
+                      nt_min[WORK_TRIAD], nt_max[WORK_TRIAD]);
+    if (!cb_store_stream_supported()) {
+        cb_table_add_note(table, "This build has no SSE2: both store kinds "
+                          "ran the same scalar loop.");
+    }
+#ifndef CB_PLATFORM_UNIX
+    cb_table_add_note(table, "Process modes require fork() and are not "
+                      "available on this platform.");
+#endif
+
+    *table_out = table;
+    table = NULL;
+
+cleanup:
+    if (shm_created) {
+        cb_shared_mem_destroy(&shm);
+    }
+    free(times);
+    free(args);
+    free(threads);
+    free(procs);
+    cb_table_destroy(table);
+    return err;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file bench_write.h
+ * @brief Write-heavy suite: in-place transform and triad, regular vs
+ *        non-temporal stores.
+ *
+ * Every core mode only reads the dataset. This suite runs two kernels
+ * that write as much as they read, an in-place transform
+ * (a[i] = a[i] + 1) and an out-of-place triad (a[i] = b[i] + s * c[i]),
+ * in single, thread and process mode, each with regular and with
+ * non-temporal stores (store.h). The arrays live in shared memory so
+ * that process-mode writes land where the parent can check them. Read
+ * and write bandwidth are reported separately.
+ */
+
+#ifndef CB_BENCH_WRITE_H
+#define CB_BENCH_WRITE_H
+
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief Run the write-heavy suite and produce a result table.
+ *
+ * @param dataset    Pointer to the integer array (copied, not modified).
+ * @param config     Benchmark configuration (reads array_length,
+ *                   num_threads, num_processes, iterations, verbose).
+ * @param table_out  Output table; the caller takes ownership.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_SHM,
+ *         CB_ERR_THREAD, CB_ERR_FORK on failure.
+ */
+cb_error_t cb_bench_write_run(const int *dataset, const cb_config_t *config,
+                              cb_table_t **table_out);
+
+#endif /* CB_BENCH_WRITE_H */
@@ -0,0 +1,427 @@
+/**
+ * @file cluster.c
+ * @brief Implementation of the cluster wire protocol and worker node.
+ *
+ * Messages are encoded field by field into a byte buffer, so the wire
+ * format does not depend on struct padding or host byte order. A node
+ * measures its own encode time after the result is encoded and writes
+ * it (and its busy time) into the already-encoded buffer, so the
+ * reported figures cover the bytes actually sent.
+ */
+
+#include "cluster.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataset.h"
+#include "types.h"
+#include "worker.h"
+
+/** @brief Header bytes: magic, type, payload length. */
+#define CLUSTER_HEADER 12
+
+/** @brief Largest payload (RESULT). */
+#define CLUSTER_MAX_PAYLOAD 48
+
+/** @brief Offsets of the node-patched RESULT fields, header included. */
+#define CLUSTER_BUSY_OFFSET      (CLUSTER_HEADER + 32)
+#define CLUSTER_SERIALIZE_OFFSET (CLUSTER_HEADER + 40)
+
+/* ---- Encoding ---- */
+
+static void put_u32(unsigned char *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+static void put_u64(unsigned char *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const unsigned char *p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+static uint64_t get_u64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+/** @brief Payload size of @p type, or -1 if unknown. */
+static int payload_size(uint32_t type)
+{
+    switch (type) {
+    case CB_CLUSTER_HELLO:  return 12;
+    case CB_CLUSTER_JOB:    return 24;
+    case CB_CLUSTER_RESULT: return 48;
+    case CB_CLUSTER_BYE:    return 0;
+    default:                return -1;
+    }
+}
+
+size_t cb_cluster_wire_size(cb_cluster_type_t type)
+{
+    int size = payload_size((uint32_t)type);
+    return size < 0 ? 0 : (size_t)(CLUSTER_HEADER + size);
+}
+
+/** @brief Encode @p msg into @p buf; returns the size, 0 if unknown. */
+static size_t encode(const cb_cluster_msg_t *msg, unsigned char *buf)
+{
+    int size = payload_size((uint32_t)msg->type);
+    unsigned char *p = buf + CLUSTER_HEADER;
+
+    if (size < 0) {
+        return 0;
+    }
+
+    put_u32(buf, CB_CLUSTER_MAGIC);
+    put_u32(buf + 4, (uint32_t)msg->type);
+    put_u32(buf + 8, (uint32_t)size);
+
+    switch (msg->type) {
+    case CB_CLUSTER_HELLO:
+        put_u32(p, msg->u.hello.version);
+        put_u32(p + 4, msg->u.hello.budget);
+        put_u32(p + 8, msg->u.hello.pid);
+        break;
+    case CB_CLUSTER_JOB:
+        put_u32(p, msg->u.job.seed);
+        put_u32(p + 4, msg->u.job.threads);
+        put_u32(p + 8, msg->u.job.iteration);
+        put_u32(p + 12, msg->u.job.length);
+        put_u64(p + 16, msg->u.job.first);
+        break;
+    case CB_CLUSTER_RESULT:
+        put_u32(p, msg->u.result.iteration);
+        put_u32(p + 4, msg->u.result.threads);
+        put_u64(p + 8, (uint64_t)msg->u.result.sum);
+        put_u64(p + 16, msg->u.result.generate_ns);
+        put_u64(p + 24, msg->u.result.compute_ns);
+        put_u64(p + 32, msg->u.result.busy_ns);
+        put_u64(p + 40, msg->u.result.serialize_ns);
+        break;
+    default:
+        break;
+    }
+
+    return (size_t)(CLUSTER_HEADER + size);
+}
+
+/** @brief Decode a payload of @p type from @p p into @p msg. */
+static void decode(uint32_t type, const unsigned char *p,
+                   cb_cluster_msg_t *msg)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->type = (cb_cluster_type_t)type;
+
+    switch (msg->type) {
+    case CB_CLUSTER_HELLO:
+        msg->u.hello.version = get_u32(p);
+        msg->u.hello.budget = get_u32(p + 4);
+        msg->u.hello.pid = get_u32(p + 8);
+        break;
+    case CB_CLUSTER_JOB:
+        msg->u.job.seed = get_u32(p);
+        msg->u.job.threads = get_u32(p + 4);
+        msg->u.job.iteration = get_u32(p + 8);
+        msg->u.job.length = get_u32(p + 12);
+        msg->u.job.first = get_u64(p + 16);
+        break;
+    case CB_CLUSTER_RESULT:
+        msg->u.result.iteration = get_u32(p);
+        msg->u.result.threads = get_u32(p + 4);
+        msg->u.result.sum = (int64_t)get_u64(p + 8);
+        msg->u.result.generate_ns = get_u64(p + 16);
+        msg->u.result.compute_ns = get_u64(p + 24);
+        msg->u.result.busy_ns = get_u64(p + 32);
+        msg->u.result.serialize_ns = get_u64(p + 40);
+        break;
+    default:
+        break;
+    }
+}
+
+cb_error_t cb_cluster_send(cb_socket_t *sock, const cb_cluster_msg_t *msg,
+                           double *encode_sec)
+{
+    unsigned char buf[CLUSTER_HEADER + CLUSTER_MAX_PAYLOAD];
+
+    if (!sock || !msg) {
+        return CB_ERR_ARGS;
+    }
+
+    double t_start = cb_time_now();
+    size_t size = encode(msg, buf);
+    if (encode_sec) {
+        *encode_sec = cb_time_now() - t_start;
+    }
+    if (size == 0) {
+        return CB_ERR_ARGS;
+    }
+
+    return cb_socket_send(sock, buf, size);
+}
+
+cb_error_t cb_cluster_recv(cb_socket_t *sock, cb_cluster_msg_t *msg,
+                           double *decode_sec)
+{
+    unsigned char buf[CLUSTER_HEADER + CLUSTER_MAX_PAYLOAD];
+
+    if (!sock || !msg) {
+        return CB_ERR_ARGS;
+    }
+
+    cb_error_t err = cb_socket_recv(sock, buf, CLUSTER_HEADER);
+    if (err) {
+        return err;
+    }
+
+    double t_start = cb_time_now();
+    uint32_t type = get_u32(buf + 4);
+    int size = payload_size(type);
+    double header_sec = cb_time_now() - t_start;
+    if (get_u32(buf) != CB_CLUSTER_MAGIC || size < 0 ||
+        get_u32(buf + 8) != (uint32_t)size) {
+        return CB_ERR_NET;
+    }
+
+    err = cb_socket_recv(sock, buf + CLUSTER_HEADER, (size_t)size);
+    if (err) {
+        return err;
+    }
+
+    t_start = cb_time_now();
+    decode(type, buf + CLUSTER_HEADER, msg);
+    if (decode_sec) {
+        *decode_sec = header_sec + (cb_time_now() - t_start);
+    }
+    return CB_OK;
+}
+
+cb_error_t cb_cluster_parse_endpoint(const char *text, char *host,
+                                     size_t host_size, int *port)
+{
+    const char *colon = text ? strrchr(text, ':') : NULL;
+    char *endptr;
+
+    if (!colon || colon == text || !host || !port ||
+        (size_t)(colon - text) >= host_size) {
+        return CB_ERR_ARGS;
+    }
+
+    long val = strtol(colon + 1, &endptr, 10);
+    if (endptr == colon + 1 || *endptr != '\0' || val < 1 || val > 65535) {
+        return CB_ERR_ARGS;
+    }
+
+    memcpy(host, text, (size_t)(colon - text));
+    host[colon - text] = '\0';
+    *port = (int)val;
+    return CB_OK;
+}
+
+/* ---- Local compute ---- */
+
+cb_error_t cb_cluster_sum(const int *data, int length, int threads,
+                          long int *sum, double *compute_sec)
+{
+    cb_error_t err = CB_OK;
+    cb_thread_t *handles = NULL;
+    cb_thread_param_t *params = NULL;
+    cb_mutex_t mutex;
+    bool mutex_initialized = false;
+    int created = 0;
+    cb_thread_shared_t shared = {
+        .sum = 0,
+        .earliest_start = -1.0,
+        .latest_end = 0.0
+    };
+
+    if (!data || !sum || !compute_sec || threads < 1) {
+        return CB_ERR_ARGS;
+    }
+
+    *sum = 0;
+    *compute_sec = 0.0;
+    if (length < 1) {
+        return CB_OK;
+    }
+    if (threads > length) {
+        threads = length;
+    }
+
+    handles = calloc((size_t)threads, sizeof(cb_thread_t));
+    params  = calloc((size_t)threads, sizeof(cb_thread_param_t));
+    if (!handles || !params) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    err = cb_mutex_init(&mutex);
+    if (err) {
+        goto cleanup;
+    }
+    mutex_initialized = true;
+
+    int base_len = length / threads, remainder = length % threads;
+    int offset = 0;
+    for (int i = 0; i < threads; i++) {
+        params[i].dataset = data;
+        params[i].start = offset;
+        params[i].length = base_len + (i < remainder ? 1 : 0);
+        params[i].shared = &shared;
+        params[i].mutex = &mutex;
+        params[i].verbose = false;
+        offset += params[i].length;
+
+        err = cb_thread_create(&handles[i], cb_array_sum_thread_fn,
+                               &params[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&handles[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    if (!err) {
+        *sum = shared.sum;
+        *compute_sec = shared.latest_end - shared.earliest_start;
+    }
+
+cleanup:
+    if (mutex_initialized) {
+        cb_mutex_destroy(&mutex);
+    }
+    free(handles);
+    free(params);
+    return err;
+}
+
+/* ---- Worker node ---- */
+
+int cb_cluster_node_main(const char *host, int port, bool verbose)
+{
+    cb_error_t err;
+    cb_socket_t sock;
+    cb_cluster_msg_t msg;
+    unsigned char buf[CLUSTER_HEADER + CLUSTER_MAX_PAYLOAD];
+    int *data = NULL;
+    bool have_data = false;
+    cb_cluster_job_t cached;
+
+    memset(&cached, 0, sizeof(cached));
+
+    err = cb_socket_connect(&sock, host, port, CB_CLUSTER_CONNECT_MS);
+    if (err) {
+        cb_perror("cluster node: connect", err);
+        return 1;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.type = CB_CLUSTER_HELLO;
+    msg.u.hello.version = CB_CLUSTER_VERSION;
+    msg.u.hello.budget = (uint32_t)cb_cpu_budget();
+    msg.u.hello.pid = cb_process_self_id();
+    err = cb_cluster_send(&sock, &msg, NULL);
+
+    while (!err) {
+        double decode_sec = 0.0;
+
+        err = cb_cluster_recv(&sock, &msg, &decode_sec);
+        if (err || msg.type == CB_CLUSTER_BYE) {
+            break;
+        }
+        double t_busy = cb_time_now();
+        if (msg.type != CB_CLUSTER_JOB || msg.u.job.length > INT32_MAX) {
+            err = CB_ERR_NET;
+            break;
+        }
+
+        cb_cluster_job_t job = msg.u.job;
+        int length = (int)job.length;
+        double generate_sec = 0.0;
+
+        /* Keep the partition across jobs unless the job names another. */
+        if (!have_data || job.seed != cached.seed ||
+            job.first != cached.first || job.length != cached.length) {
+            free(data);
+            data = malloc((size_t)(length > 0 ? length : 1) * sizeof(int));
+            if (!data) {
+                have_data = false;
+                err = CB_ERR_ALLOC;
+                break;
+            }
+            double t_gen = cb_time_now();
+            cb_dataset_fill_range(job.seed, (long long)job.first, length,
+                                  data);
+            generate_sec = cb_time_now() - t_gen;
+            cached = job;
+            have_data = true;
+        }
+
+        int threads = job.threads < 1 ? 1 :
+                      job.threads > CB_MAX_WORKERS ? CB_MAX_WORKERS :
+                      (int)job.threads;
+        long int sum = 0;
+        double compute_sec = 0.0;
+        err = cb_cluster_sum(data, length, threads, &sum, &compute_sec);
+        if (err) {
+            break;
+        }
+
+        memset(&msg, 0, sizeof(msg));
+        msg.type = CB_CLUSTER_RESULT;
+        msg.u.result.iteration = job.iteration;
+        msg.u.result.threads = (uint32_t)(threads < length ? threads :
+                                          (length > 0 ? length : 1));
+        msg.u.result.sum = sum;
+        msg.u.result.generate_ns = (uint64_t)(generate_sec * 1e9);
+        msg.u.result.compute_ns = (uint64_t)(compute_sec * 1e9);
+
+        double t_enc = cb_time_now();
+        size_t size = encode(&msg, buf);
+        double t_done = cb_time_now();
+        put_u64(buf + CLUSTER_BUSY_OFFSET,
+                (uint64_t)((t_done - t_busy + decode_sec) * 1e9));
+        put_u64(buf + CLUSTER_SERIALIZE_OFFSET,
+                (uint64_t)((t_done - t_enc + decode_sec) * 1e9));
+        err = cb_socket_send(&sock, buf, size);
+
+        if (verbose) {
+            fprintf(stdout, "  cluster node %u: iteration %u, %d elements "
+                    "from %llu, sum=%ld (%.6fs)\n", cb_process_self_id(),
+                    job.iteration, length, (unsigned long long)job.first,
+                    sum, compute_sec);
+        }
+    }
+
+    if (err) {
+        cb_perror("cluster node", err);
+    }
+    free(data);
+    cb_socket_close(&sock);
+    return err ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file cluster.h
+ * @brief Wire protocol and worker-node role of cluster mode.
+ *
+ * A coordinator (bench_cluster.h) and its worker nodes talk over one
+ * TCP connection per node. Every message is a 12-byte header (magic,
+ * type, payload length) followed by a fixed-size payload, with all
+ * fields little-endian regardless of host byte order:
+ *
+ * - HELLO  (node -> coordinator): protocol version, CPU budget, pid.
+ * - JOB    (coordinator -> node): seed, threads, iteration, partition.
+ * - RESULT (node -> coordinator): partial sum and the node's timings.
+ * - BYE    (coordinator -> node): no payload; the node exits.
+ *
+ * A node generates its partition from the seed with
+ * cb_dataset_fill_range(), so no dataset bytes cross the network; it
+ * keeps the partition between jobs and only regenerates it when the
+ * job names a different one.
+ */
+
+#ifndef CB_CLUSTER_H
+#define CB_CLUSTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "error.h"
+#include "platform.h"
+
+/** @brief First header word of every message ("CBCL" little-endian). */
+#define CB_CLUSTER_MAGIC    0x4C434243u
+
+/** @brief Protocol version exchanged in HELLO. */
+#define CB_CLUSTER_VERSION  1u
+
+/** @brief How long a node keeps retrying a coordinator that refuses. */
+#define CB_CLUSTER_CONNECT_MS  30000
+
+/** @brief Message types. */
+typedef enum {
+    CB_CLUSTER_HELLO  = 1, /**< Node introduction. */
+    CB_CLUSTER_JOB    = 2, /**< Partition to sum. */
+    CB_CLUSTER_RESULT = 3, /**< Partial sum and timings. */
+    CB_CLUSTER_BYE    = 4  /**< End of session. */
+} cb_cluster_type_t;
+
+/** @brief HELLO payload. */
+typedef struct {
+    uint32_t version;  /**< CB_CLUSTER_VERSION. */
+    uint32_t budget;   /**< Node CPU budget (cb_cpu_budget()). */
+    uint32_t pid;      /**< Node process id. */
+} cb_cluster_hello_t;
+
+/** @brief JOB payload. */
+typedef struct {
+    uint32_t seed;       /**< Dataset seed. */
+    uint32_t threads;    /**< Threads to sum with. */
+    uint32_t iteration;  /**< Iteration number (0 = warm-up). */
+    uint32_t length;     /**< Elements in the partition. */
+    uint64_t first;      /**< Index of the first element. */
+} cb_cluster_job_t;
+
+/** @brief RESULT payload. */
+typedef struct {
+    uint32_t iteration;     /**< Iteration of the job answered. */
+    uint32_t threads;       /**< Threads actually used. */
+    int64_t  sum;           /**< Partial sum of the partition. */
+    uint64_t generate_ns;   /**< Partition generation (0 if cached). */
+    uint64_t compute_ns;    /**< Threaded sum, first start to last end. */
+    uint64_t busy_ns;       /**< Job decode to result encoded. */
+    uint64_t serialize_ns;  /**< Job decode plus result encode. */
+} cb_cluster_result_t;
+
+/** @brief One message: a type and its payload. */
+typedef struct {
+    cb_cluster_type_t type;  /**< Message type. */
+    union {
+        cb_cluster_hello_t  hello;
+        cb_cluster_job_t    job;
+        cb_cluster_result_t result;
+    } u;                     /**< Payload selected by type (none for BYE). */
+} cb_cluster_msg_t;
+
+/**
+ * @brief Encode and send one message.
+ *
+ * @param sock        Connected socket.
+ * @param msg         Message to send.
+ * @param encode_sec  Output: time spent encoding, excluding the send.
+ *                    May be NULL.
+ * @return CB_OK on success, CB_ERR_ARGS on an unknown type, CB_ERR_NET
+ *         on a transfer failure.
+ */
+cb_error_t cb_cluster_send(cb_socket_t *sock, const cb_cluster_msg_t *msg,
+                           double *encode_sec);
+
+/**
+ * @brief Receive and decode one message.
+ *
+ * @param sock        Connected socket.
+ * @param msg         Output message.
+ * @param decode_sec  Output: time spent decoding, excluding the wait.
+ *                    May be NULL.
+ * @return CB_OK on success, CB_ERR_NET on a transfer failure, a closed
+ *         peer, or a malformed message.
+ */
+cb_error_t cb_cluster_recv(cb_socket_t *sock, cb_cluster_msg_t *msg,
+                           double *decode_sec);
+
+/** @brief Encoded size of a message of @p type, header included. */
+size_t cb_cluster_wire_size(cb_cluster_type_t type);
+
+/**
+ * @brief Split "host:port" into its parts.
+ *
+ * @param text       Endpoint text; the port is after the last ':'.
+ * @param host       Output host buffer.
+ * @param host_size  Size of @p host.
+ * @param port       Output port (1 - 65535).
+ * @return CB_OK on success, CB_ERR_ARGS on malformed input.
+ */
+cb_error_t cb_cluster_parse_endpoint(const char *text, char *host,
+                                     size_t host_size, int *port);
+
+/**
+ * @brief Sum @p length elements on @p threads threads.
+ *
+ * Uses the thread mode's worker (cb_array_sum_thread_fn), so a node
+ * computes exactly as a local thread run does.
+ *
+ * @param data         Array to sum.
+ * @param length       Number of elements.
+ * @param threads      Thread count (at least 1).
+ * @param sum          Output sum.
+ * @param compute_sec  Output: first thread start to last thread end.
+ * @return CB_OK on success, CB_ERR_ALLOC, CB_ERR_MUTEX or CB_ERR_THREAD.
+ */
+cb_error_t cb_cluster_sum(const int *data, int length, int threads,
+                          long int *sum, double *compute_sec);
+
+/**
+ * @brief Run as a worker node until the coordinator says BYE.
+ *
+ * Connects to @p host:@p port (retrying for CB_CLUSTER_CONNECT_MS),
+ * introduces itself and answers JOB messages.
+ *
+ * @param host     Coordinator address.
+ * @param port     Coordinator port.
+ * @param verbose  Print one line per job.
+ * @return Exit code: 0 on success, 1 on failure.
+ */
+int cb_cluster_node_main(const char *host, int port, bool verbose);
+
+#endif /* CB_CLUSTER_H */
@@ -0,0 +1,263 @@
+/**
+ * @file copy.c
+ * @brief Implementation of the copy and fill strategies.
+ *
+ * The vector loops move four vectors per iteration, then single
+ * vectors, and leave the last partial vector to memcpy() / memset().
+ * They do not align the destination first, so --copy-align shows what
+ * misalignment costs them. The non-temporal versions must store to
+ * 16-byte aligned addresses: they copy or set the head up to the first
+ * aligned byte with the C library, and end with SFENCE so the data is
+ * globally visible when they return.
+ */
+
+#include "copy.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define COPY_HAVE_X86 1
+#define COPY_SSE2_TARGET   __attribute__((target("sse2")))
+#define COPY_AVX2_TARGET   __attribute__((target("avx2")))
+#define COPY_AVX512_TARGET __attribute__((target("avx512f")))
+#include <immintrin.h>
+#endif
+
+#ifdef COPY_HAVE_X86
+/** @brief REP MOVSB. */
+static void copy_rep(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile("rep movsb"
+                     : "+D"(dst), "+S"(src), "+c"(n)
+                     :
+                     : "memory");
+}
+
+/** @brief REP STOSB. */
+static void fill_rep(void *dst, unsigned char value, size_t n)
+{
+    __asm__ volatile("rep stosb"
+                     : "+D"(dst), "+c"(n)
+                     : "a"(value)
+                     : "memory");
+}
+
+/** @brief 32-byte AVX2 copy. */
+COPY_AVX2_TARGET
+static void copy_avx2(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    size_t i = 0;
+
+    for (; n - i >= 128; i += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)(s + i + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *)(s + i + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i *)(s + i + 96));
+        _mm256_storeu_si256((__m256i *)(d + i), v0);
+        _mm256_storeu_si256((__m256i *)(d + i + 32), v1);
+        _mm256_storeu_si256((__m256i *)(d + i + 64), v2);
+        _mm256_storeu_si256((__m256i *)(d + i + 96), v3);
+    }
+    for (; n - i >= 32; i += 32) {
+        _mm256_storeu_si256((__m256i *)(d + i),
+                            _mm256_loadu_si256((const __m256i *)(s + i)));
+    }
+    memcpy(d + i, s + i, n - i);
+}
+
+/** @brief 32-byte AVX2 fill. */
+COPY_AVX2_TARGET
+static void fill_avx2(void *dst, unsigned char value, size_t n)
+{
+    unsigned char *d = dst;
+    __m256i v = _mm256_set1_epi8((char)value);
+    size_t i = 0;
+
+    for (; n - i >= 128; i += 128) {
+        _mm256_storeu_si256((__m256i *)(d + i), v);
+        _mm256_storeu_si256((__m256i *)(d + i + 32), v);
+        _mm256_storeu_si256((__m256i *)(d + i + 64), v);
+        _mm256_storeu_si256((__m256i *)(d + i + 96), v);
+    }
+    for (; n - i >= 32; i += 32) {
+        _mm256_storeu_si256((__m256i *)(d + i), v);
+    }
+    memset(d + i, value, n - i);
+}
+
+/** @brief 64-byte AVX-512 copy. */
+COPY_AVX512_TARGET
+static void copy_avx512(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    size_t i = 0;
+
+    for (; n - i >= 256; i += 256) {
+        __m512i v0 = _mm512_loadu_si512((const void *)(s + i));
+        __m512i v1 = _mm512_loadu_si512((const void *)(s + i + 64));
+        __m512i v2 = _mm512_loadu_si512((const void *)(s + i + 128));
+        __m512i v3 = _mm512_loadu_si512((const void *)(s + i + 192));
+        _mm512_storeu_si512((void *)(d + i), v0);
+        _mm512_storeu_si512((void *)(d + i + 64), v1);
+        _mm512_storeu_si512((void *)(d + i + 128), v2);
+        _mm512_storeu_si512((void *)(d + i + 192), v3);
+    }
+    for (; n - i >= 64; i += 64) {
+        _mm512_storeu_si512((void *)(d + i),
+                            _mm512_loadu_si512((const void *)(s + i)));
+    }
+    memcpy(d + i, s + i, n - i);
+}
+
+/** @brief 64-byte AVX-512 fill. */
+COPY_AVX512_TARGET
+static void fill_avx512(void *dst, unsigned char value, size_t n)
+{
+    unsigned char *d = dst;
+    __m512i v = _mm512_set1_epi8((char)value);
+    size_t i = 0;
+
+    for (; n - i >= 256; i += 256) {
+        _mm512_storeu_si512((void *)(d + i), v);
+        _mm512_storeu_si512((void *)(d + i + 64), v);
+        _mm512_storeu_si512((void *)(d + i + 128), v);
+        _mm512_storeu_si512((void *)(d + i + 192), v);
+    }
+    for (; n - i >= 64; i += 64) {
+        _mm512_storeu_si512((void *)(d + i), v);
+    }
+    memset(d + i, value, n - i);
+}
+
+/** @brief Bytes before the first 16-byte aligned byte of @p d (at most @p n). */
+static size_t head_bytes(const void *d, size_t n)
+{
+    size_t head = (16u - ((uintptr_t)d & 15u)) & 15u;
+    return head < n ? head : n;
+}
+
+/** @brief Non-temporal SSE2 copy. */
+COPY_SSE2_TARGET
+static void copy_stream(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    size_t i = head_bytes(d, n);
+
+    memcpy(d, s, i);
+    for (; n - i >= 64; i += 64) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(s + i + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *)(s + i + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *)(s + i + 48));
+        _mm_stream_si128((__m128i *)(d + i), v0);
+        _mm_stream_si128((__m128i *)(d + i + 16), v1);
+        _mm_stream_si128((__m128i *)(d + i + 32), v2);
+        _mm_stream_si128((__m128i *)(d + i + 48), v3);
+    }
+    for (; n - i >= 16; i += 16) {
+        _mm_stream_si128((__m128i *)(d + i),
+                         _mm_loadu_si128((const __m128i *)(s + i)));
+    }
+    _mm_sfence();
+    memcpy(d + i, s + i, n - i);
+}
+
+/** @brief Non-temporal SSE2 fill. */
+COPY_SSE2_TARGET
+static void fill_stream(void *dst, unsigned char value, size_t n)
+{
+    unsigned char *d = dst;
+    __m128i v = _mm_set1_epi8((char)value);
+    size_t i = head_bytes(d, n);
+
+    memset(d, value, i);
+    for (; n - i >= 64; i += 64) {
+        _mm_stream_si128((__m128i *)(d + i), v);
+        _mm_stream_si128((__m128i *)(d + i + 16), v);
+        _mm_stream_si128((__m128i *)(d + i + 32), v);
+        _mm_stream_si128((__m128i *)(d + i + 48), v);
+    }
+    for (; n - i >= 16; i += 16) {
+        _mm_stream_si128((__m128i *)(d + i), v);
+    }
+    _mm_sfence();
+    memset(d + i, value, n - i);
+}
+#endif /* COPY_HAVE_X86 */
+
+bool cb_copy_available(cb_copy_method_t method)
+{
+    switch (method) {
+    case CB_COPY_LIBC:
+        return true;
+#ifdef COPY_HAVE_X86
+    case CB_COPY_REP:
+        return true;
+    case CB_COPY_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case CB_COPY_AVX512:
+        return __builtin_cpu_supports("avx512f");
+    case CB_COPY_STREAM:
+        return __builtin_cpu_supports("sse2");
+#endif
+    default:
+        return false;
+    }
+}
+
+void cb_copy(cb_copy_method_t method, void *dst, const void *src, size_t n)
+{
+#ifdef COPY_HAVE_X86
+    if (cb_copy_available(method)) {
+        switch (method) {
+        case CB_COPY_REP:    copy_rep(dst, src, n);    return;
+        case CB_COPY_AVX2:   copy_avx2(dst, src, n);   return;
+        case CB_COPY_AVX512: copy_avx512(dst, src, n); return;
+        case CB_COPY_STREAM: copy_stream(dst, src, n); return;
+        default:             break;
+        }
+    }
+#else
+    (void)method;
+#endif
+    memcpy(dst, src, n);
+}
+
+void cb_fill(cb_copy_method_t method, void *dst, unsigned char value,
+             size_t n)
+{
+#ifdef COPY_HAVE_X86
+    if (cb_copy_available(method)) {
+        switch (method) {
+        case CB_COPY_REP:    fill_rep(dst, value, n);    return;
+        case CB_COPY_AVX2:   fill_avx2(dst, value, n);   return;
+        case CB_COPY_AVX512: fill_avx512(dst, value, n); return;
+        case CB_COPY_STREAM: fill_stream(dst, value, n); return;
+        default:             break;
+        }
+    }
+#else
+    (void)method;
+#endif
+    memset(dst, value, n);
+}
+
+const char *cb_copy_method_name(cb_copy_method_t method)
+{
+    switch (method) {
+    case CB_COPY_LIBC:   return "libc";
+    case CB_COPY_REP:    return "rep";
+    case CB_COPY_AVX2:   return "avx2";
+    case CB_COPY_AVX512: return "avx512";
+    case CB_COPY_STREAM: return "nt";
+    default:             break;
+    }
+
+    return "unknown";
+}
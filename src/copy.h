@@ -0,0 +1,59 @@
+/**
+ * @file copy.h
+ * @brief memcpy / memset strategies for the copy shoot-out.
+ *
+ * Each method implements both a copy and a fill:
+ * - libc:    memcpy() / memset() from the C library.
+ * - rep:     REP MOVSB / REP STOSB, which CPUs with ERMSB/FSRM run as
+ *            microcoded bulk moves.
+ * - avx2:    a loop of unaligned 32-byte loads and stores.
+ * - avx512:  a loop of unaligned 64-byte loads and stores.
+ * - nt:      unaligned 16-byte loads and non-temporal stores (SSE2),
+ *            which bypass the cache and skip the read for ownership.
+ *
+ * Everything but libc needs x86 and GCC or Clang; the vector methods
+ * are compiled for their own instruction set only and chosen at run
+ * time, so the build needs no -mavx2. An unavailable method falls
+ * back to libc.
+ */
+
+#ifndef CB_COPY_H
+#define CB_COPY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Copy / fill strategies.
+ */
+typedef enum {
+    CB_COPY_LIBC = 0,     /**< C library memcpy / memset. */
+    CB_COPY_REP,          /**< REP MOVSB / REP STOSB. */
+    CB_COPY_AVX2,         /**< 32-byte AVX2 loop. */
+    CB_COPY_AVX512,       /**< 64-byte AVX-512 loop. */
+    CB_COPY_STREAM,       /**< Non-temporal SSE2 stores. */
+    CB_COPY_METHOD_COUNT  /**< Number of methods. */
+} cb_copy_method_t;
+
+/**
+ * @brief True if @p method runs its own code on this build and CPU.
+ */
+bool cb_copy_available(cb_copy_method_t method);
+
+/**
+ * @brief Copy @p n bytes from @p src to @p dst (no overlap).
+ */
+void cb_copy(cb_copy_method_t method, void *dst, const void *src, size_t n);
+
+/**
+ * @brief Set @p n bytes at @p dst to @p value.
+ */
+void cb_fill(cb_copy_method_t method, void *dst, unsigned char value,
+             size_t n);
+
+/**
+ * @brief Short name of a method ("libc", "rep", ...).
+ */
+const char *cb_copy_method_name(cb_copy_method_t method);
+
+#endif /* CB_COPY_H */
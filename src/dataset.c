@@ -5,10 +5,12 @@
  * Allocates a heap-resident integer array, seeds the PRNG, and fills
  * the array with pseudo-random values. Supports automatic seed
  * generation from the current time when the configured seed is 0.
+ * The counter-based range generator uses the SplitMix64 finalizer.
  */
 
 #include "dataset.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -67,6 +69,21 @@ cb_error_t cb_dataset_create(cb_config_t *config, int **data_out,
     return CB_OK;
 }
 
+void cb_dataset_fill_range(unsigned int seed, long long first, int length,
+                           int *out)
+{
+    uint64_t key = (uint64_t)seed << 32;
+
+    for (int i = 0; i < length; i++) {
+        uint64_t z = key ^ (uint64_t)(first + i);
+        z += 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        out[i] = (int)(z % 100) + 1;
+    }
+}
+
 void cb_dataset_destroy(int *data)
 {
     free(data);
@@ -5,6 +5,10 @@
  * Provides functions to allocate and populate the integer array used
  * as input to all benchmark modes. The array is filled with pseudo-random
  * values in [1, 100] using the configured seed for reproducibility.
+ * Compressed copies of the array for the bandwidth study are built
+ * from it with cb_encoding_create() (encoding.h). A counter-based
+ * variant fills any range independently, for nodes that each generate
+ * their own partition.
  */
 
 #ifndef CB_DATASET_H
@@ -39,6 +43,23 @@
 cb_error_t cb_dataset_create(cb_config_t *config, int **data_out,
                              bool verbose);
 
+/**
+ * @brief Fill a range of the counter-based dataset.
+ *
+ * Element i is a hash of (seed, i) mapped to [1, 100], so any range
+ * can be generated on its own and two nodes that share a seed agree on
+ * every element without exchanging data. This is a different sequence
+ * from cb_dataset_create(), whose rand() stream can only be produced
+ * from the start; cluster mode uses it to generate partitions locally.
+ *
+ * @param seed    Dataset seed (nonzero).
+ * @param first   Index of the first element.
+ * @param length  Number of elements to write.
+ * @param out     Output array of at least @p length elements.
+ */
+void cb_dataset_fill_range(unsigned int seed, long long first, int length,
+                           int *out);
+
 /**
  * @brief Free a dataset array previously allocated by cb_dataset_create().
  *
@@ -0,0 +1,337 @@
+/**
+ * @file encoding.c
+ * @brief Implementation of the dataset encodings and fused sum kernels.
+ *
+ * Layouts (bit streams are little-endian, value i of a stream starting
+ * at bit i * width):
+ * - U8:    one byte per value. Summed 16 bytes at a time with SSE2
+ *          PSADBW, which adds eight bytes into a 64-bit lane.
+ * - PACK7: one 7-bit stream; a block is exactly 112 bytes and every
+ *          group of eight values exactly 7 bytes. A group is loaded as
+ *          one 64-bit word and its even and odd fields are masked into
+ *          four 14-bit lanes and added (SWAR), so one add covers eight
+ *          values and the lanes are folded once per block.
+ * - FOR:   frame of reference: each block stores its minimum and the
+ *          deltas from it at the smallest width that holds the block's
+ *          range, 16 * width bytes per block. A block sums as
+ *          count * base plus the sum of its deltas.
+ *
+ * Every payload has eight bytes of zero padding, so a decoder can
+ * always load a whole 64-bit word.
+ */
+
+#include "encoding.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kernel.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENCODING_HAVE_SSE2 1
+#endif
+
+/** @brief Zero padding after every payload, in bytes. */
+#define ENCODING_PAD 8
+
+/** @brief Bytes of one PACK7 block (128 values * 7 bits). */
+#define PACK7_BLOCK_BYTES (CB_ENCODING_BLOCK * 7 / 8)
+
+/** @brief Fields 0, 2, 4, 6 of a 7-bit group, one per 14-bit lane. */
+#define PACK7_LANES ((uint64_t)0x7F | (uint64_t)0x7F << 14 | \
+                     (uint64_t)0x7F << 28 | (uint64_t)0x7F << 42)
+
+/** @brief One 14-bit SWAR lane. */
+#define PACK7_LANE 0x3FFFu
+
+/** @brief Encoding names, indexed by cb_encoding_t. */
+static const char *const NAMES[CB_ENCODING_COUNT] = {
+    "int32", "u8", "pack7", "for"
+};
+
+const char *cb_encoding_name(cb_encoding_t encoding)
+{
+    return ((int)encoding >= 0 && encoding < CB_ENCODING_COUNT)
+           ? NAMES[encoding] : "unknown";
+}
+
+/* ---- Bit streams ---- */
+
+/** @brief Little-endian 64-bit load; compiles to a single move. */
+static uint64_t load_le64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+/** @brief OR the low @p width bits of @p v into the stream at @p bit. */
+static void put_bits(unsigned char *p, size_t bit, uint32_t v, int width)
+{
+    for (int k = 0; k < width; k++, bit++) {
+        if ((v >> k) & 1u) {
+            p[bit / 8] |= (unsigned char)(1u << (bit % 8));
+        }
+    }
+}
+
+/** @brief Bits needed to hold @p range. */
+static int bit_width(uint32_t range)
+{
+    int w = 0;
+    while (w < 32 && (range >> w) != 0) {
+        w++;
+    }
+    return w;
+}
+
+/* ---- Encoders ---- */
+
+/** @brief Check that every value lies in [0, @p max]. */
+static bool values_fit(const int *data, int length, int max)
+{
+    for (int i = 0; i < length; i++) {
+        if (data[i] < 0 || data[i] > max) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Build the FOR block headers and payload. */
+static cb_error_t encode_for(cb_encoded_t *e, const int *data)
+{
+    e->base   = malloc((size_t)e->blocks * sizeof(int32_t));
+    e->width  = malloc((size_t)e->blocks * sizeof(uint8_t));
+    e->offset = malloc((size_t)e->blocks * sizeof(size_t));
+    if (!e->base || !e->width || !e->offset) {
+        return CB_ERR_ALLOC;
+    }
+
+    size_t payload = 0;
+    for (int b = 0; b < e->blocks; b++) {
+        long long start = (long long)b * CB_ENCODING_BLOCK;
+        long long end = start + CB_ENCODING_BLOCK;
+        if (end > e->length) {
+            end = e->length;
+        }
+        int lo = data[start], hi = data[start];
+        for (long long i = start + 1; i < end; i++) {
+            lo = data[i] < lo ? data[i] : lo;
+            hi = data[i] > hi ? data[i] : hi;
+        }
+        e->base[b] = lo;
+        e->width[b] = (uint8_t)bit_width((uint32_t)((int64_t)hi - lo));
+        e->offset[b] = payload;
+        payload += (size_t)e->width[b] * (CB_ENCODING_BLOCK / 8);
+    }
+
+    e->payload = calloc(payload + ENCODING_PAD, 1);
+    if (!e->payload) {
+        return CB_ERR_ALLOC;
+    }
+    for (int b = 0; b < e->blocks; b++) {
+        long long start = (long long)b * CB_ENCODING_BLOCK;
+        long long end = start + CB_ENCODING_BLOCK;
+        if (end > e->length) {
+            end = e->length;
+        }
+        unsigned char *p = e->payload + e->offset[b];
+        for (long long i = start; i < end; i++) {
+            put_bits(p, (size_t)(i - start) * e->width[b],
+                     (uint32_t)((int64_t)data[i] - e->base[b]), e->width[b]);
+        }
+    }
+
+    e->bytes = payload + (size_t)e->blocks *
+               (sizeof(int32_t) + sizeof(uint8_t) + sizeof(size_t));
+    return CB_OK;
+}
+
+cb_error_t cb_encoding_create(cb_encoded_t *out, const int *data, int length,
+                              cb_encoding_t encoding)
+{
+    cb_error_t err = CB_OK;
+
+    if (!out || !data || length < 1 || (int)encoding < 0 ||
+        encoding >= CB_ENCODING_COUNT) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->encoding = encoding;
+    out->length = length;
+    out->blocks = (int)(((long long)length + CB_ENCODING_BLOCK - 1) /
+                        CB_ENCODING_BLOCK);
+    size_t padded = (size_t)out->blocks * CB_ENCODING_BLOCK;
+
+    switch (encoding) {
+    case CB_ENCODING_U8:
+        if (!values_fit(data, length, 255)) {
+            return CB_ERR_OVERFLOW;
+        }
+        out->payload = calloc(padded + ENCODING_PAD, 1);
+        if (!out->payload) {
+            err = CB_ERR_ALLOC;
+            break;
+        }
+        for (int i = 0; i < length; i++) {
+            out->payload[i] = (unsigned char)data[i];
+        }
+        out->bytes = padded;
+        break;
+    case CB_ENCODING_PACK7:
+        if (!values_fit(data, length, 127)) {
+            return CB_ERR_OVERFLOW;
+        }
+        out->payload = calloc((size_t)out->blocks * PACK7_BLOCK_BYTES +
+                              ENCODING_PAD, 1);
+        if (!out->payload) {
+            err = CB_ERR_ALLOC;
+            break;
+        }
+        for (int i = 0; i < length; i++) {
+            put_bits(out->payload, (size_t)i * 7, (uint32_t)data[i], 7);
+        }
+        out->bytes = (size_t)out->blocks * PACK7_BLOCK_BYTES;
+        break;
+    case CB_ENCODING_FOR:
+        err = encode_for(out, data);
+        break;
+    default:
+        out->raw = data;
+        out->bytes = (size_t)length * sizeof(int);
+        break;
+    }
+
+    if (err) {
+        cb_encoding_destroy(out);
+    }
+    return err;
+}
+
+void cb_encoding_destroy(cb_encoded_t *enc)
+{
+    if (!enc) {
+        return;
+    }
+    free(enc->payload);
+    free(enc->base);
+    free(enc->width);
+    free(enc->offset);
+    memset(enc, 0, sizeof(*enc));
+}
+
+/* ---- Fused decode-and-sum kernels ---- */
+
+/** @brief Sum @p n bytes (a multiple of CB_ENCODING_BLOCK). */
+static long int sum_u8(const unsigned char *p, size_t n)
+{
+#ifdef ENCODING_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = zero, acc1 = zero;
+    uint64_t lanes[2];
+
+    for (size_t i = 0; i < n; i += 32) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + i + 16));
+        acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(a, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(b, zero));
+    }
+    _mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc0, acc1));
+    return (long int)(lanes[0] + lanes[1]);
+#else
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += p[i];
+    }
+    return (long int)sum;
+#endif
+}
+
+/** @brief Sum @p blocks PACK7 blocks. */
+static long int sum_pack7(const unsigned char *p, int blocks)
+{
+    long int sum = 0;
+
+    for (int b = 0; b < blocks; b++, p += PACK7_BLOCK_BYTES) {
+        uint64_t acc = 0;
+        /* Each add puts at most 2 * 127 in a lane; 16 of them stay
+         * below 2^14, so lanes never carry into each other. */
+        for (int g = 0; g < CB_ENCODING_BLOCK / 8; g++) {
+            uint64_t w = load_le64(p + 7 * g);
+            acc += (w & PACK7_LANES) + ((w >> 7) & PACK7_LANES);
+        }
+        sum += (long int)((acc & PACK7_LANE) + (acc >> 14 & PACK7_LANE) +
+                          (acc >> 28 & PACK7_LANE) + (acc >> 42 & PACK7_LANE));
+    }
+    return sum;
+}
+
+/** @brief Sum the CB_ENCODING_BLOCK deltas of one FOR block. */
+static uint64_t sum_deltas(const unsigned char *p, int width)
+{
+    uint64_t sum = 0;
+
+    if (width == 0) {
+        return 0;
+    }
+    uint64_t mask = ((uint64_t)1 << width) - 1;
+
+    /* Eight deltas take exactly width bytes. */
+    for (int g = 0; g < CB_ENCODING_BLOCK / 8; g++, p += width) {
+        if (width <= 8) {
+            uint64_t w = load_le64(p);
+            for (int k = 0; k < 8; k++) {
+                sum += (w >> (k * width)) & mask;
+            }
+        } else {
+            for (int k = 0; k < 8; k++) {
+                int bit = k * width;
+                sum += (load_le64(p + bit / 8) >> (bit % 8)) & mask;
+            }
+        }
+    }
+    return sum;
+}
+
+long int cb_encoding_sum(const cb_encoded_t *enc, int first, int last)
+{
+    long long start = (long long)first * CB_ENCODING_BLOCK;
+    long long end = (long long)last * CB_ENCODING_BLOCK;
+    if (end > enc->length) {
+        end = enc->length;
+    }
+    if (start >= end) {
+        return 0;
+    }
+
+    switch (enc->encoding) {
+    case CB_ENCODING_U8:
+        return sum_u8(enc->payload + start,
+                      (size_t)(last - first) * CB_ENCODING_BLOCK);
+    case CB_ENCODING_PACK7:
+        return sum_pack7(enc->payload + (size_t)first * PACK7_BLOCK_BYTES,
+                         last - first);
+    case CB_ENCODING_FOR: {
+        long int sum = 0;
+        for (int b = first; b < last; b++) {
+            long long count = enc->length - (long long)b * CB_ENCODING_BLOCK;
+            if (count > CB_ENCODING_BLOCK) {
+                count = CB_ENCODING_BLOCK;
+            }
+            sum += (long int)(enc->base[b] * count) +
+                   (long int)sum_deltas(enc->payload + enc->offset[b],
+                                        enc->width[b]);
+        }
+        return sum;
+    }
+    default:
+        return cb_kernel_sum(enc->raw + start, (int)(end - start));
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file encoding.h
+ * @brief Compressed representations of the dataset and fused sum kernels.
+ *
+ * Dataset values lie in [1, 100], so a 32-bit int spends four bytes on
+ * seven bits of information, and a memory-bound scan moves four times
+ * more data than it needs to. An encoded dataset stores the same
+ * values in fewer bytes; its sum kernel decodes in registers and adds
+ * straight away, never writing decoded values back to memory.
+ *
+ * Encodings work on blocks of CB_ENCODING_BLOCK elements, so a block
+ * index is all a worker needs to start anywhere in the array. The
+ * last block is padded with zero deltas, which decode to nothing.
+ */
+
+#ifndef CB_ENCODING_H
+#define CB_ENCODING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "error.h"
+
+/** @brief Elements per encoded block. */
+#define CB_ENCODING_BLOCK 128
+
+/**
+ * @brief Available encodings.
+ */
+typedef enum {
+    CB_ENCODING_INT32 = 0, /**< The original int array (reference). */
+    CB_ENCODING_U8,        /**< One byte per value; SSE2 PSADBW sum. */
+    CB_ENCODING_PACK7,     /**< Seven bits per value; SWAR sum. */
+    CB_ENCODING_FOR,       /**< Per-block base plus minimal bit width. */
+    CB_ENCODING_COUNT      /**< Number of encodings. */
+} cb_encoding_t;
+
+/**
+ * @brief An encoded copy of the dataset.
+ */
+typedef struct {
+    cb_encoding_t  encoding;  /**< Representation. */
+    int            length;    /**< Elements. */
+    int            blocks;    /**< Blocks of CB_ENCODING_BLOCK elements. */
+    size_t         bytes;     /**< Encoded size, block headers included. */
+    const int     *raw;       /**< INT32: the source array (not owned). */
+    unsigned char *payload;   /**< Packed values (owned, zero-padded). */
+    int32_t       *base;      /**< FOR: block minimum (owned). */
+    uint8_t       *width;     /**< FOR: bits per delta (owned). */
+    size_t        *offset;    /**< FOR: payload offset per block (owned). */
+} cb_encoded_t;
+
+/**
+ * @brief Return the name of an encoding ("int32", "u8", "pack7", "for").
+ */
+const char *cb_encoding_name(cb_encoding_t encoding);
+
+/**
+ * @brief Encode @p length values of @p data.
+ *
+ * INT32 only references @p data, which must then outlive @p out.
+ *
+ * @param out       Encoded dataset, released with cb_encoding_destroy().
+ * @param data      Source values.
+ * @param length    Number of values (at least 1).
+ * @param encoding  Target representation.
+ * @return CB_OK on success, CB_ERR_OVERFLOW if a value does not fit the
+ *         encoding (U8: 0 - 255, PACK7: 0 - 127), CB_ERR_ALLOC, or
+ *         CB_ERR_ARGS on bad arguments.
+ */
+cb_error_t cb_encoding_create(cb_encoded_t *out, const int *data, int length,
+                              cb_encoding_t encoding);
+
+/**
+ * @brief Release an encoded dataset; safe on a zeroed struct.
+ */
+void cb_encoding_destroy(cb_encoded_t *enc);
+
+/**
+ * @brief Sum blocks [@p first, @p last) of an encoded dataset.
+ *
+ * Decodes in registers and accumulates directly. The INT32 reference
+ * uses the active cb_kernel_sum() kernel.
+ */
+long int cb_encoding_sum(const cb_encoded_t *enc, int first, int last);
+
+#endif /* CB_ENCODING_H */
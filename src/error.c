@@ -29,6 +29,7 @@ const char *cb_error_str(cb_error_t err)
     case CB_ERR_OVERFLOW: return "overflow detected";
     case CB_ERR_ARGS:     return "invalid arguments";
     case CB_ERR_SHM:      return "shared memory operation failed";
+    case CB_ERR_NET:      return "network operation failed";
     }
 
     return "unknown error";
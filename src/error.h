@@ -36,7 +36,8 @@ typedef enum {
     CB_ERR_TIMEOUT   =  -9, /**< Operation timed out. */
     CB_ERR_OVERFLOW  = -10, /**< Integer or buffer overflow detected. */
     CB_ERR_ARGS      = -11, /**< Invalid function arguments (NULL pointer, bad range). */
-    CB_ERR_SHM       = -12  /**< Shared memory creation or mapping failed. */
+    CB_ERR_SHM       = -12, /**< Shared memory creation or mapping failed. */
+    CB_ERR_NET       = -13  /**< Socket creation, connection or transfer failed. */
 } cb_error_t;
 
 /**
@@ -0,0 +1,238 @@
+/**
+ * @file fiber.c
+ * @brief Implementation of the M:N fiber runtime.
+ *
+ * Every switch goes through the scheduler: a yielding task switches to
+ * its thread's scheduler fiber, which requeues it and switches to the
+ * next task. Run queues are touched only by their own thread, so they
+ * need no locking.
+ */
+
+#include "fiber.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "platform.h"
+#include "types.h"
+
+typedef struct fiber_sched fiber_sched_t;
+
+/**
+ * @brief A task slot: one fiber plus its scheduling state.
+ */
+struct cb_fiber_task {
+    cb_fiber_t    *fiber;    /**< Fiber that runs this slot's tasks. */
+    cb_fiber_rt_t *rt;       /**< Owning runtime. */
+    fiber_sched_t *sched;    /**< Scheduler of the current run. */
+    int            task_id;  /**< Task index. */
+    bool           done;     /**< Task body returned in the current run. */
+};
+
+/**
+ * @brief Per-thread scheduler state.
+ */
+struct fiber_sched {
+    cb_fiber_t       *main;         /**< The OS thread's own fiber. */
+    cb_fiber_task_t **queue;        /**< Circular FIFO run queue. */
+    int               capacity;     /**< Queue slots. */
+    int               head;         /**< Index of the next task to run. */
+    int               count;        /**< Tasks in the queue. */
+    uint64_t          yields;       /**< Yields during the current run. */
+    uint64_t          completions;  /**< Completions during the current run. */
+    cb_error_t        err;          /**< Error from thread setup. */
+};
+
+struct cb_fiber_rt {
+    int                 num_threads;  /**< OS threads per run. */
+    int                 num_tasks;    /**< Tasks (and fibers). */
+    cb_fiber_task_t    *tasks;        /**< One slot per task. */
+    fiber_sched_t      *scheds;       /**< One scheduler per thread. */
+    cb_thread_t        *threads;      /**< Thread handles. */
+    cb_fiber_task_fn_t  fn;           /**< Task body of the current run. */
+    void               *ctx;          /**< Context of the current run. */
+};
+
+/**
+ * @brief Fiber entry point: run one task per resume, forever.
+ */
+static void fiber_body(void *arg)
+{
+    cb_fiber_task_t *t = (cb_fiber_task_t *)arg;
+
+    for (;;) {
+        t->rt->fn(t, t->task_id, t->rt->ctx);
+        t->done = true;
+        cb_fiber_switch(t->fiber, t->sched->main);
+    }
+}
+
+/** @brief Scheduler loop run by each OS thread. */
+static void *sched_thread_fn(void *arg)
+{
+    fiber_sched_t *s = (fiber_sched_t *)arg;
+
+    s->err = cb_fiber_thread_enter(&s->main);
+    if (s->err) {
+        return NULL;
+    }
+
+    while (s->count > 0) {
+        cb_fiber_task_t *t = s->queue[s->head];
+        s->head = (s->head + 1) % s->capacity;
+        s->count--;
+
+        cb_fiber_switch(s->main, t->fiber);
+
+        if (t->done) {
+            s->completions++;
+        } else {
+            s->queue[(s->head + s->count) % s->capacity] = t;
+            s->count++;
+        }
+    }
+
+    cb_fiber_thread_exit(s->main);
+    s->main = NULL;
+    return NULL;
+}
+
+cb_error_t cb_fiber_rt_create(cb_fiber_rt_t **out, int num_threads,
+                              int num_tasks, size_t stack_size)
+{
+    cb_error_t err = CB_OK;
+
+    if (!out || num_threads < 1 || num_threads > CB_MAX_WORKERS ||
+        num_tasks < 1) {
+        return CB_ERR_ARGS;
+    }
+
+    *out = NULL;
+
+    cb_fiber_rt_t *rt = calloc(1, sizeof(*rt));
+    if (!rt) {
+        return CB_ERR_ALLOC;
+    }
+
+    rt->num_threads = num_threads;
+    rt->num_tasks = num_tasks;
+    rt->tasks   = calloc((size_t)num_tasks, sizeof(cb_fiber_task_t));
+    rt->scheds  = calloc((size_t)num_threads, sizeof(fiber_sched_t));
+    rt->threads = calloc((size_t)num_threads, sizeof(cb_thread_t));
+    if (!rt->tasks || !rt->scheds || !rt->threads) {
+        err = CB_ERR_ALLOC;
+        goto fail;
+    }
+
+    int per_thread = (num_tasks + num_threads - 1) / num_threads;
+    for (int i = 0; i < num_threads; i++) {
+        rt->scheds[i].capacity = per_thread;
+        rt->scheds[i].queue = calloc((size_t)per_thread, sizeof(cb_fiber_task_t *));
+        if (!rt->scheds[i].queue) {
+            err = CB_ERR_ALLOC;
+            goto fail;
+        }
+    }
+
+    for (int i = 0; i < num_tasks; i++) {
+        rt->tasks[i].rt = rt;
+        rt->tasks[i].task_id = i;
+        err = cb_fiber_create(&rt->tasks[i].fiber, stack_size, fiber_body,
+                              &rt->tasks[i]);
+        if (err) {
+            goto fail;
+        }
+    }
+
+    *out = rt;
+    return CB_OK;
+
+fail:
+    cb_fiber_rt_destroy(rt);
+    return err;
+}
+
+cb_error_t cb_fiber_rt_run(cb_fiber_rt_t *rt, cb_fiber_task_fn_t fn,
+                           void *ctx, cb_fiber_stats_t *stats)
+{
+    cb_error_t err = CB_OK;
+    int created = 0;
+
+    if (!rt || !fn) {
+        return CB_ERR_ARGS;
+    }
+
+    rt->fn = fn;
+    rt->ctx = ctx;
+
+    for (int i = 0; i < rt->num_threads; i++) {
+        fiber_sched_t *s = &rt->scheds[i];
+        s->head = 0;
+        s->count = 0;
+        s->yields = 0;
+        s->completions = 0;
+        s->err = CB_OK;
+    }
+
+    /* Round-robin: task i runs on thread i % num_threads. */
+    for (int i = 0; i < rt->num_tasks; i++) {
+        fiber_sched_t *s = &rt->scheds[i % rt->num_threads];
+        rt->tasks[i].sched = s;
+        rt->tasks[i].done = false;
+        s->queue[s->count++] = &rt->tasks[i];
+    }
+
+    for (int i = 0; i < rt->num_threads; i++) {
+        err = cb_thread_create(&rt->threads[i], sched_thread_fn, &rt->scheds[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    for (int i = 0; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&rt->threads[i]);
+        if (join_err && !err) {
+            err = join_err;
+        }
+        if (rt->scheds[i].err && !err) {
+            err = rt->scheds[i].err;
+        }
+    }
+
+    if (stats) {
+        stats->yields = 0;
+        stats->completions = 0;
+        for (int i = 0; i < rt->num_threads; i++) {
+            stats->yields += rt->scheds[i].yields;
+            stats->completions += rt->scheds[i].completions;
+        }
+    }
+
+    return err;
+}
+
+void cb_fiber_yield(cb_fiber_task_t *task)
+{
+    task->sched->yields++;
+    cb_fiber_switch(task->fiber, task->sched->main);
+}
+
+void cb_fiber_rt_destroy(cb_fiber_rt_t *rt)
+{
+    if (!rt) {
+        return;
+    }
+
+    for (int i = 0; rt->tasks && i < rt->num_tasks; i++) {
+        cb_fiber_destroy(rt->tasks[i].fiber);
+    }
+    for (int i = 0; rt->scheds && i < rt->num_threads; i++) {
+        free(rt->scheds[i].queue);
+    }
+
+    free(rt->tasks);
+    free(rt->scheds);
+    free(rt->threads);
+    free(rt);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file fiber.h
+ * @brief M:N fiber runtime built on the platform fiber primitives.
+ *
+ * Runs many lightweight tasks on a few OS threads. Each task gets its
+ * own fiber with a small stack; tasks are assigned round-robin to the
+ * threads, and every thread runs its own FIFO run queue. A task gives
+ * up its thread with cb_fiber_yield() and is resumed after every other
+ * runnable task on that thread has had a turn.
+ *
+ * Fibers are created once in cb_fiber_rt_create() and reused by every
+ * cb_fiber_rt_run(): a finished task parks its fiber at the end of the
+ * task loop, and the next run resumes it with a new task. Only the OS
+ * threads are created per run.
+ */
+
+#ifndef CB_FIBER_H
+#define CB_FIBER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "error.h"
+
+/** @brief Default stack size of each fiber in bytes. */
+#define CB_FIBER_STACK_SIZE  (64 * 1024)
+
+/** @brief Opaque runtime. */
+typedef struct cb_fiber_rt cb_fiber_rt_t;
+
+/** @brief Opaque handle of a running task, used to yield. */
+typedef struct cb_fiber_task cb_fiber_task_t;
+
+/**
+ * @brief Task body.
+ *
+ * @param task     Handle to pass to cb_fiber_yield().
+ * @param task_id  Task index (0 .. num_tasks - 1).
+ * @param ctx      Context pointer given to cb_fiber_rt_run().
+ */
+typedef void (*cb_fiber_task_fn_t)(cb_fiber_task_t *task, int task_id,
+                                   void *ctx);
+
+/**
+ * @brief Scheduling counters for one run, summed over all threads.
+ */
+typedef struct {
+    uint64_t yields;       /**< Calls to cb_fiber_yield(). */
+    uint64_t completions;  /**< Tasks that ran to completion. */
+} cb_fiber_stats_t;
+
+/**
+ * @brief Create a runtime with its fibers.
+ *
+ * @param out          Output: the new runtime.
+ * @param num_threads  OS threads per run (1 - CB_MAX_WORKERS).
+ * @param num_tasks    Tasks per run (>= 1).
+ * @param stack_size   Stack size of each fiber in bytes.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC,
+ *         CB_ERR_PLATFORM (fibers unsupported) on failure.
+ */
+cb_error_t cb_fiber_rt_create(cb_fiber_rt_t **out, int num_threads,
+                              int num_tasks, size_t stack_size);
+
+/**
+ * @brief Run every task to completion and return when all are done.
+ *
+ * @param rt     Runtime.
+ * @param fn     Task body, called once per task.
+ * @param ctx    Context pointer passed to every call of @p fn.
+ * @param stats  Output: scheduling counters (may be NULL).
+ * @return CB_OK on success, CB_ERR_THREAD or CB_ERR_PLATFORM on failure.
+ */
+cb_error_t cb_fiber_rt_run(cb_fiber_rt_t *rt, cb_fiber_task_fn_t fn,
+                           void *ctx, cb_fiber_stats_t *stats);
+
+/**
+ * @brief Suspend the calling task and let the next queued task run.
+ * @param task  Handle passed to the task body.
+ */
+void cb_fiber_yield(cb_fiber_task_t *task);
+
+/**
+ * @brief Destroy a runtime and all of its fibers.
+ * @param rt  Runtime to destroy, or NULL (no-op). Must not be running.
+ */
+void cb_fiber_rt_destroy(cb_fiber_rt_t *rt);
+
+#endif /* CB_FIBER_H */
@@ -0,0 +1,335 @@
+/**
+ * @file forkjoin.c
+ * @brief Implementation of the work-stealing fork-join pool.
+ *
+ * The deque follows Chase and Lev, with the C11 memory orderings from
+ * Lê et al., "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (PPoPP 2013). Tasks live on the stack of the worker that
+ * spawned them; the spawner cannot return past a join until the task
+ * is done, so a thief's pointer never outlives the task.
+ */
+
+#include "forkjoin.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "barrier.h"
+#include "platform.h"
+#include "types.h"
+#include "worker.h"
+
+/** @brief Failed steal attempts before an idle worker yields its CPU. */
+#define FJ_SPINS_BEFORE_YIELD  64
+
+/**
+ * @brief One spawned half-range.
+ */
+typedef struct {
+    int         start;   /**< First element. */
+    int         length;  /**< Number of elements. */
+    long int    sum;     /**< Result; valid once done is set. */
+    atomic_bool done;    /**< Set by a thief when it has finished. */
+} fj_task_t;
+
+/**
+ * @brief Per-worker deque and counters, one per cache-line-aligned slot.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) atomic_long top;  /**< Steal end (thieves). */
+    _Alignas(CB_CACHE_LINE) atomic_long bottom; /**< Owner end. */
+    _Atomic(fj_task_t *) slots[CB_FORKJOIN_DEQUE_SIZE]; /**< Circular buffer. */
+    cb_forkjoin_t *pool;    /**< Owning pool. */
+    int            id;      /**< Worker index. */
+    uint32_t       rng;     /**< Xorshift state for victim selection. */
+    uint64_t       spawns;  /**< Tasks pushed this run. */
+    uint64_t       steals;  /**< Tasks stolen this run. */
+    uint64_t       leaves;  /**< Leaves summed this run. */
+    cb_thread_t    thread;  /**< Handle of a helper worker's thread. */
+} fj_worker_t;
+
+struct cb_forkjoin {
+    int          num_workers;  /**< Workers per run. */
+    fj_worker_t *workers;      /**< One per worker, cache-line aligned. */
+    const int   *dataset;      /**< Input of the current run. */
+    int          grain;        /**< Grain size of the current run. */
+    atomic_bool  done;         /**< Root task finished; helpers exit. */
+};
+
+/** @brief Owner: push a task at the bottom. Returns false when full. */
+static bool deque_push(fj_worker_t *w, fj_task_t *task)
+{
+    long b = atomic_load_explicit(&w->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&w->top, memory_order_acquire);
+
+    if (b - t >= CB_FORKJOIN_DEQUE_SIZE) {
+        return false;
+    }
+
+    atomic_store_explicit(&w->slots[b & (CB_FORKJOIN_DEQUE_SIZE - 1)], task,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+/** @brief Owner: pop the newest task, or NULL if the deque is empty. */
+static fj_task_t *deque_pop(fj_worker_t *w)
+{
+    long b = atomic_load_explicit(&w->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&w->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&w->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    fj_task_t *task = atomic_load_explicit(
+        &w->slots[b & (CB_FORKJOIN_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (t == b) {
+        /* Last task: race any thief for it. */
+        if (!atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                     memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+/** @brief Thief: take the oldest task, or NULL if empty or lost a race. */
+static fj_task_t *deque_steal(fj_worker_t *w)
+{
+    long t = atomic_load_explicit(&w->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+
+    if (t >= b) {
+        return NULL;
+    }
+
+    fj_task_t *task = atomic_load_explicit(
+        &w->slots[t & (CB_FORKJOIN_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;
+    }
+    return task;
+}
+
+static long int fj_sum(fj_worker_t *w, int start, int length);
+
+/**
+ * @brief Steal one task from a random victim and run it.
+ * @return True if a task was run.
+ */
+static bool steal_and_run(fj_worker_t *w)
+{
+    cb_forkjoin_t *pool = w->pool;
+
+    if (pool->num_workers < 2) {
+        return false;
+    }
+
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 17;
+    w->rng ^= w->rng << 5;
+
+    /* Any worker but ourselves. */
+    int victim = (int)(w->rng % (uint32_t)(pool->num_workers - 1));
+    if (victim >= w->id) {
+        victim++;
+    }
+
+    fj_task_t *task = deque_steal(&pool->workers[victim]);
+    if (!task) {
+        return false;
+    }
+
+    w->steals++;
+    task->sum = fj_sum(w, task->start, task->length);
+    atomic_store_explicit(&task->done, true, memory_order_release);
+    return true;
+}
+
+/** @brief Back off after a failed steal: spin briefly, then yield. */
+static void idle_backoff(int *misses)
+{
+    if (++*misses < FJ_SPINS_BEFORE_YIELD) {
+        cb_cpu_relax();
+    } else {
+        *misses = 0;
+        cb_thread_yield();
+    }
+}
+
+/** @brief Sum [start, start + length), splitting above the grain size. */
+static long int fj_sum(fj_worker_t *w, int start, int length)
+{
+    if (length <= w->pool->grain) {
+        w->leaves++;
+        return cb_array_sum(w->pool->dataset, start, length).sum;
+    }
+
+    int half = length / 2;
+    fj_task_t right;
+    right.start = start + half;
+    right.length = length - half;
+    right.sum = 0;
+    atomic_init(&right.done, false);
+
+    bool pushed = deque_push(w, &right);
+    if (pushed) {
+        w->spawns++;
+    }
+
+    long int left = fj_sum(w, start, half);
+
+    /*
+     * Everything pushed above this frame has been popped again, so the
+     * newest entry is the right half unless a thief took it (and with
+     * it everything older, leaving the deque empty).
+     */
+    if (!pushed || deque_pop(w) == &right) {
+        return left + fj_sum(w, right.start, right.length);
+    }
+
+    int misses = 0;
+    while (!atomic_load_explicit(&right.done, memory_order_acquire)) {
+        if (steal_and_run(w)) {
+            misses = 0;
+        } else {
+            idle_backoff(&misses);
+        }
+    }
+    return left + right.sum;
+}
+
+/** @brief Helper worker: steal until the root task is done. */
+static void *helper_thread_fn(void *arg)
+{
+    fj_worker_t *w = (fj_worker_t *)arg;
+    int misses = 0;
+
+    while (!atomic_load_explicit(&w->pool->done, memory_order_acquire)) {
+        if (steal_and_run(w)) {
+            misses = 0;
+        } else {
+            idle_backoff(&misses);
+        }
+    }
+
+    return NULL;
+}
+
+cb_error_t cb_forkjoin_create(cb_forkjoin_t **out, int num_workers)
+{
+    if (!out || num_workers < 1 || num_workers > CB_MAX_WORKERS) {
+        return CB_ERR_ARGS;
+    }
+
+    *out = NULL;
+
+    cb_forkjoin_t *pool = calloc(1, sizeof(*pool));
+    if (!pool) {
+        return CB_ERR_ALLOC;
+    }
+
+    pool->num_workers = num_workers;
+    pool->workers = cb_aligned_alloc(CB_CACHE_LINE,
+                                     (size_t)num_workers * sizeof(fj_worker_t));
+    if (!pool->workers) {
+        free(pool);
+        return CB_ERR_ALLOC;
+    }
+    memset(pool->workers, 0, (size_t)num_workers * sizeof(fj_worker_t));
+
+    for (int i = 0; i < num_workers; i++) {
+        fj_worker_t *w = &pool->workers[i];
+        atomic_init(&w->top, 0);
+        atomic_init(&w->bottom, 0);
+        for (int s = 0; s < CB_FORKJOIN_DEQUE_SIZE; s++) {
+            atomic_init(&w->slots[s], NULL);
+        }
+        w->pool = pool;
+        w->id = i;
+    }
+    atomic_init(&pool->done, false);
+
+    *out = pool;
+    return CB_OK;
+}
+
+cb_error_t cb_forkjoin_sum(cb_forkjoin_t *pool, const int *dataset,
+                           int length, int grain, long int *sum_out,
+                           cb_forkjoin_stats_t *stats)
+{
+    cb_error_t err = CB_OK;
+    int created = 1;
+
+    if (!pool || !dataset || length < 1 || grain < 1 || !sum_out) {
+        return CB_ERR_ARGS;
+    }
+
+    pool->dataset = dataset;
+    pool->grain = grain;
+    atomic_store_explicit(&pool->done, false, memory_order_relaxed);
+
+    for (int i = 0; i < pool->num_workers; i++) {
+        fj_worker_t *w = &pool->workers[i];
+        atomic_store_explicit(&w->top, 0, memory_order_relaxed);
+        atomic_store_explicit(&w->bottom, 0, memory_order_relaxed);
+        w->rng = 2463534242u + (uint32_t)i;
+        w->spawns = 0;
+        w->steals = 0;
+        w->leaves = 0;
+    }
+
+    for (int i = 1; i < pool->num_workers; i++) {
+        err = cb_thread_create(&pool->workers[i].thread, helper_thread_fn,
+                               &pool->workers[i]);
+        if (err) {
+            break;
+        }
+        created++;
+    }
+
+    if (!err) {
+        *sum_out = fj_sum(&pool->workers[0], 0, length);
+    }
+    atomic_store_explicit(&pool->done, true, memory_order_release);
+
+    for (int i = 1; i < created; i++) {
+        cb_error_t join_err = cb_thread_join(&pool->workers[i].thread);
+        if (join_err && !err) {
+            err = join_err;
+        }
+    }
+
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+        for (int i = 0; i < pool->num_workers; i++) {
+            stats->spawns += pool->workers[i].spawns;
+            stats->steals += pool->workers[i].steals;
+            stats->leaves += pool->workers[i].leaves;
+        }
+    }
+
+    return err;
+}
+
+void cb_forkjoin_destroy(cb_forkjoin_t *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    cb_aligned_free(pool->workers);
+    free(pool);
+}
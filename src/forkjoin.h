@@ -0,0 +1,76 @@
+/**
+ * @file forkjoin.h
+ * @brief Work-stealing fork-join pool for recursive reductions.
+ *
+ * A range is split in half until it is no longer than the grain size;
+ * the leaves are summed with cb_array_sum(). At each split the worker
+ * pushes the right half onto its own deque and recurses into the left
+ * half (help-first spawning with child stealing). Idle workers steal
+ * the oldest task from a random victim, which is the largest piece of
+ * work still waiting. At a join the worker pops the right half back if
+ * nobody stole it; otherwise it steals and runs other tasks until the
+ * thief is done.
+ *
+ * Each worker owns a fixed-size Chase-Lev deque: the owner pushes and
+ * pops at the bottom without atomic read-modify-writes, and thieves
+ * take from the top with a compare-and-swap. A full deque makes the
+ * spawn run inline instead.
+ */
+
+#ifndef CB_FORKJOIN_H
+#define CB_FORKJOIN_H
+
+#include <stdint.h>
+
+#include "error.h"
+
+/** @brief Capacity of each worker's deque. */
+#define CB_FORKJOIN_DEQUE_SIZE  1024
+
+/** @brief Opaque pool. */
+typedef struct cb_forkjoin cb_forkjoin_t;
+
+/**
+ * @brief Scheduling counters for one run, summed over all workers.
+ */
+typedef struct {
+    uint64_t spawns;  /**< Tasks pushed onto a deque. */
+    uint64_t steals;  /**< Tasks taken from another worker's deque. */
+    uint64_t leaves;  /**< Ranges summed directly with cb_array_sum(). */
+} cb_forkjoin_stats_t;
+
+/**
+ * @brief Create a pool and its deques.
+ *
+ * @param out          Output: the new pool.
+ * @param num_workers  Workers per run (1 - CB_MAX_WORKERS), including
+ *                     the calling thread.
+ * @return CB_OK on success, CB_ERR_ARGS or CB_ERR_ALLOC on failure.
+ */
+cb_error_t cb_forkjoin_create(cb_forkjoin_t **out, int num_workers);
+
+/**
+ * @brief Sum dataset[0 .. length) by recursive fork-join.
+ *
+ * The calling thread runs the root task as worker 0; the other workers
+ * are created for the run and joined before it returns.
+ *
+ * @param pool     Pool.
+ * @param dataset  Input array.
+ * @param length   Number of elements (>= 1).
+ * @param grain    Largest range summed without splitting (>= 1).
+ * @param sum_out  Output: the total.
+ * @param stats    Output: scheduling counters (may be NULL).
+ * @return CB_OK on success, CB_ERR_ARGS or CB_ERR_THREAD on failure.
+ */
+cb_error_t cb_forkjoin_sum(cb_forkjoin_t *pool, const int *dataset,
+                           int length, int grain, long int *sum_out,
+                           cb_forkjoin_stats_t *stats);
+
+/**
+ * @brief Destroy a pool.
+ * @param pool  Pool to destroy, or NULL (no-op). Must not be running.
+ */
+void cb_forkjoin_destroy(cb_forkjoin_t *pool);
+
+#endif /* CB_FORKJOIN_H */
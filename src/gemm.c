@@ -0,0 +1,381 @@
+/**
+ * @file gemm.c
+ * @brief Implementation of the cache-blocked matrix multiply kernels.
+ *
+ * Packing copies each operand sliver into the exact order the
+ * micro-kernel reads it, zero-padding partial slivers so the kernel
+ * never needs edge cases. The micro-kernel produces an MR x NR tile
+ * of partial sums for one KC-deep panel; the driver adds the tile into
+ * C, clipping it at the matrix edge.
+ *
+ * On x86 targets with SSE2 (every x86-64 compiler) the micro-kernels
+ * keep the whole tile in eight vector registers. Elsewhere a portable
+ * kernel with the same loop order is used and left to the compiler's
+ * auto-vectorizer.
+ */
+
+#include "gemm.h"
+
+#include <stddef.h>
+
+#include "platform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEMM_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/** @brief Alignment of the packing buffers (one cache line). */
+#define GEMM_ALIGN 64
+
+/** @brief Round @p value up to a multiple of @p step. */
+static int round_up(int value, int step)
+{
+    return ((value + step - 1) / step) * step;
+}
+
+/** @brief Smaller of two ints. */
+static int min_int(int a, int b)
+{
+    return (a < b) ? a : b;
+}
+
+/**
+ * @brief Validate arguments shared by both precisions.
+ */
+static cb_error_t check_args(int n, const void *a, const void *b,
+                             const void *c, int row_begin, int row_end,
+                             const cb_gemm_tiles_t *tiles)
+{
+    if (n < 1 || !a || !b || !c || !tiles ||
+        row_begin < 0 || row_end > n || row_begin > row_end ||
+        tiles->mc < 1 || tiles->kc < 1 || tiles->nc < 1) {
+        return CB_ERR_ARGS;
+    }
+    return CB_OK;
+}
+
+/* ---- Single precision -------------------------------------------------- */
+
+/**
+ * @brief Pack rows [0, mb) x cols [0, kb) of an A block into MR-row slivers.
+ */
+static void spack_a(const float *a, int lda, int mb, int kb, float *ap)
+{
+    for (int ir = 0; ir < mb; ir += CB_GEMM_MR) {
+        for (int p = 0; p < kb; p++) {
+            for (int i = 0; i < CB_GEMM_MR; i++) {
+                *ap++ = (ir + i < mb) ? a[(size_t)(ir + i) * lda + p] : 0.0f;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Pack rows [0, kb) x cols [0, nb) of a B panel into NR-column slivers.
+ */
+static void spack_b(const float *b, int ldb, int kb, int nb, float *bp)
+{
+    for (int jr = 0; jr < nb; jr += CB_SGEMM_NR) {
+        for (int p = 0; p < kb; p++) {
+            for (int j = 0; j < CB_SGEMM_NR; j++) {
+                *bp++ = (jr + j < nb) ? b[(size_t)p * ldb + jr + j] : 0.0f;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compute one MR x NR tile of partial sums from packed slivers.
+ *
+ * @param kc    Panel depth.
+ * @param ap    Packed A sliver (kc x MR).
+ * @param bp    Packed B sliver (kc x NR), 16-byte aligned.
+ * @param tile  Output MR x NR row-major tile (overwritten).
+ */
+static void smicro_kernel(int kc, const float *ap, const float *bp,
+                          float *tile)
+{
+#ifdef GEMM_USE_SSE2
+    __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+    __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+    __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+
+    for (int p = 0; p < kc; p++) {
+        __m128 b0 = _mm_load_ps(bp);
+        __m128 b1 = _mm_load_ps(bp + 4);
+        __m128 a;
+
+        a = _mm_set1_ps(ap[0]);
+        c00 = _mm_add_ps(c00, _mm_mul_ps(a, b0));
+        c01 = _mm_add_ps(c01, _mm_mul_ps(a, b1));
+        a = _mm_set1_ps(ap[1]);
+        c10 = _mm_add_ps(c10, _mm_mul_ps(a, b0));
+        c11 = _mm_add_ps(c11, _mm_mul_ps(a, b1));
+        a = _mm_set1_ps(ap[2]);
+        c20 = _mm_add_ps(c20, _mm_mul_ps(a, b0));
+        c21 = _mm_add_ps(c21, _mm_mul_ps(a, b1));
+        a = _mm_set1_ps(ap[3]);
+        c30 = _mm_add_ps(c30, _mm_mul_ps(a, b0));
+        c31 = _mm_add_ps(c31, _mm_mul_ps(a, b1));
+
+        ap += CB_GEMM_MR;
+        bp += CB_SGEMM_NR;
+    }
+
+    _mm_storeu_ps(tile + 0,  c00);
+    _mm_storeu_ps(tile + 4,  c01);
+    _mm_storeu_ps(tile + 8,  c10);
+    _mm_storeu_ps(tile + 12, c11);
+    _mm_storeu_ps(tile + 16, c20);
+    _mm_storeu_ps(tile + 20, c21);
+    _mm_storeu_ps(tile + 24, c30);
+    _mm_storeu_ps(tile + 28, c31);
+#else
+    float acc[CB_GEMM_MR][CB_SGEMM_NR] = {{0.0f}};
+
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < CB_GEMM_MR; i++) {
+            float ai = ap[i];
+            for (int j = 0; j < CB_SGEMM_NR; j++) {
+                acc[i][j] += ai * bp[j];
+            }
+        }
+        ap += CB_GEMM_MR;
+        bp += CB_SGEMM_NR;
+    }
+
+    for (int i = 0; i < CB_GEMM_MR; i++) {
+        for (int j = 0; j < CB_SGEMM_NR; j++) {
+            tile[i * CB_SGEMM_NR + j] = acc[i][j];
+        }
+    }
+#endif
+}
+
+cb_error_t cb_sgemm_rows(int n, const float *a, const float *b, float *c,
+                         int row_begin, int row_end,
+                         const cb_gemm_tiles_t *tiles)
+{
+    cb_error_t err = check_args(n, a, b, c, row_begin, row_end, tiles);
+    if (err) {
+        return err;
+    }
+
+    int mc = round_up(min_int(tiles->mc, n), CB_GEMM_MR);
+    int kc = min_int(tiles->kc, n);
+    int nc = round_up(min_int(tiles->nc, n), CB_SGEMM_NR);
+
+    float *ap = cb_aligned_alloc(GEMM_ALIGN, (size_t)mc * kc * sizeof(float));
+    float *bp = cb_aligned_alloc(GEMM_ALIGN, (size_t)kc * nc * sizeof(float));
+    if (!ap || !bp) {
+        cb_aligned_free(ap);
+        cb_aligned_free(bp);
+        return CB_ERR_ALLOC;
+    }
+
+    float tile[CB_GEMM_MR * CB_SGEMM_NR];
+
+    for (int jc = 0; jc < n; jc += nc) {
+        int nb = min_int(nc, n - jc);
+
+        for (int pc = 0; pc < n; pc += kc) {
+            int kb = min_int(kc, n - pc);
+
+            spack_b(b + (size_t)pc * n + jc, n, kb, nb, bp);
+
+            for (int ic = row_begin; ic < row_end; ic += mc) {
+                int mb = min_int(mc, row_end - ic);
+
+                spack_a(a + (size_t)ic * n + pc, n, mb, kb, ap);
+
+                for (int jr = 0; jr < nb; jr += CB_SGEMM_NR) {
+                    int nr = min_int(CB_SGEMM_NR, nb - jr);
+
+                    for (int ir = 0; ir < mb; ir += CB_GEMM_MR) {
+                        int mr = min_int(CB_GEMM_MR, mb - ir);
+
+                        smicro_kernel(kb, ap + (size_t)ir * kb,
+                                      bp + (size_t)jr * kb, tile);
+
+                        float *cij = c + (size_t)(ic + ir) * n + jc + jr;
+                        for (int i = 0; i < mr; i++) {
+                            for (int j = 0; j < nr; j++) {
+                                float v = tile[i * CB_SGEMM_NR + j];
+                                cij[(size_t)i * n + j] =
+                                    (pc == 0) ? v : cij[(size_t)i * n + j] + v;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    cb_aligned_free(ap);
+    cb_aligned_free(bp);
+    return CB_OK;
+}
+
+/* ---- Double precision -------------------------------------------------- */
+
+/** @brief Double-precision counterpart of spack_a(). */
+static void dpack_a(const double *a, int lda, int mb, int kb, double *ap)
+{
+    for (int ir = 0; ir < mb; ir += CB_GEMM_MR) {
+        for (int p = 0; p < kb; p++) {
+            for (int i = 0; i < CB_GEMM_MR; i++) {
+                *ap++ = (ir + i < mb) ? a[(size_t)(ir + i) * lda + p] : 0.0;
+            }
+        }
+    }
+}
+
+/** @brief Double-precision counterpart of spack_b(). */
+static void dpack_b(const double *b, int ldb, int kb, int nb, double *bp)
+{
+    for (int jr = 0; jr < nb; jr += CB_DGEMM_NR) {
+        for (int p = 0; p < kb; p++) {
+            for (int j = 0; j < CB_DGEMM_NR; j++) {
+                *bp++ = (jr + j < nb) ? b[(size_t)p * ldb + jr + j] : 0.0;
+            }
+        }
+    }
+}
+
+/** @brief Double-precision counterpart of smicro_kernel(). */
+static void dmicro_kernel(int kc, const double *ap, const double *bp,
+                          double *tile)
+{
+#ifdef GEMM_USE_SSE2
+    __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+    __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+    __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+    __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+
+    for (int p = 0; p < kc; p++) {
+        __m128d b0 = _mm_load_pd(bp);
+        __m128d b1 = _mm_load_pd(bp + 2);
+        __m128d a;
+
+        a = _mm_set1_pd(ap[0]);
+        c00 = _mm_add_pd(c00, _mm_mul_pd(a, b0));
+        c01 = _mm_add_pd(c01, _mm_mul_pd(a, b1));
+        a = _mm_set1_pd(ap[1]);
+        c10 = _mm_add_pd(c10, _mm_mul_pd(a, b0));
+        c11 = _mm_add_pd(c11, _mm_mul_pd(a, b1));
+        a = _mm_set1_pd(ap[2]);
+        c20 = _mm_add_pd(c20, _mm_mul_pd(a, b0));
+        c21 = _mm_add_pd(c21, _mm_mul_pd(a, b1));
+        a = _mm_set1_pd(ap[3]);
+        c30 = _mm_add_pd(c30, _mm_mul_pd(a, b0));
+        c31 = _mm_add_pd(c31, _mm_mul_pd(a, b1));
+
+        ap += CB_GEMM_MR;
+        bp += CB_DGEMM_NR;
+    }
+
+    _mm_storeu_pd(tile + 0,  c00);
+    _mm_storeu_pd(tile + 2,  c01);
+    _mm_storeu_pd(tile + 4,  c10);
+    _mm_storeu_pd(tile + 6,  c11);
+    _mm_storeu_pd(tile + 8,  c20);
+    _mm_storeu_pd(tile + 10, c21);
+    _mm_storeu_pd(tile + 12, c30);
+    _mm_storeu_pd(tile + 14, c31);
+#else
+    double acc[CB_GEMM_MR][CB_DGEMM_NR] = {{0.0}};
+
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < CB_GEMM_MR; i++) {
+            double ai = ap[i];
+            for (int j = 0; j < CB_DGEMM_NR; j++) {
+                acc[i][j] += ai * bp[j];
+            }
+        }
+        ap += CB_GEMM_MR;
+        bp += CB_DGEMM_NR;
+    }
+
+    for (int i = 0; i < CB_GEMM_MR; i++) {
+        for (int j = 0; j < CB_DGEMM_NR; j++) {
+            tile[i * CB_DGEMM_NR + j] = acc[i][j];
+        }
+    }
+#endif
+}
+
+cb_error_t cb_dgemm_rows(int n, const double *a, const double *b, double *c,
+                         int row_begin, int row_end,
+                         const cb_gemm_tiles_t *tiles)
+{
+    cb_error_t err = check_args(n, a, b, c, row_begin, row_end, tiles);
+    if (err) {
+        return err;
+    }
+
+    int mc = round_up(min_int(tiles->mc, n), CB_GEMM_MR);
+    int kc = min_int(tiles->kc, n);
+    int nc = round_up(min_int(tiles->nc, n), CB_DGEMM_NR);
+
+    double *ap = cb_aligned_alloc(GEMM_ALIGN, (size_t)mc * kc * sizeof(double));
+    double *bp = cb_aligned_alloc(GEMM_ALIGN, (size_t)kc * nc * sizeof(double));
+    if (!ap || !bp) {
+        cb_aligned_free(ap);
+        cb_aligned_free(bp);
+        return CB_ERR_ALLOC;
+    }
+
+    double tile[CB_GEMM_MR * CB_DGEMM_NR];
+
+    for (int jc = 0; jc < n; jc += nc) {
+        int nb = min_int(nc, n - jc);
+
+        for (int pc = 0; pc < n; pc += kc) {
+            int kb = min_int(kc, n - pc);
+
+            dpack_b(b + (size_t)pc * n + jc, n, kb, nb, bp);
+
+            for (int ic = row_begin; ic < row_end; ic += mc) {
+                int mb = min_int(mc, row_end - ic);
+
+                dpack_a(a + (size_t)ic * n + pc, n, mb, kb, ap);
+
+                for (int jr = 0; jr < nb; jr += CB_DGEMM_NR) {
+                    int nr = min_int(CB_DGEMM_NR, nb - jr);
+
+                    for (int ir = 0; ir < mb; ir += CB_GEMM_MR) {
+                        int mr = min_int(CB_GEMM_MR, mb - ir);
+
+                        dmicro_kernel(kb, ap + (size_t)ir * kb,
+                                      bp + (size_t)jr * kb, tile);
+
+                        double *cij = c + (size_t)(ic + ir) * n + jc + jr;
+                        for (int i = 0; i < mr; i++) {
+                            for (int j = 0; j < nr; j++) {
+                                double v = tile[i * CB_DGEMM_NR + j];
+                                cij[(size_t)i * n + j] =
+                                    (pc == 0) ? v : cij[(size_t)i * n + j] + v;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    cb_aligned_free(ap);
+    cb_aligned_free(bp);
+    return CB_OK;
+}
+
+const char *cb_gemm_kernel_name(void)
+{
+#ifdef GEMM_USE_SSE2
+    return "sse2";
+#else
+    return "portable";
+#endif
+}
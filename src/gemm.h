@@ -0,0 +1,81 @@
+/**
+ * @file gemm.h
+ * @brief Cache-blocked matrix multiply kernels for the gemm workload.
+ *
+ * Computes C = A * B for square row-major matrices using the classic
+ * three-level blocking: B is packed in KC x NC panels, A in MC x KC
+ * blocks, and a register-blocked MR x NR micro-kernel updates C from
+ * the packed operands. Only a range of C rows is computed per call, so
+ * callers can split the work by row panels across workers.
+ *
+ * Every element of C accumulates its products in the same order no
+ * matter how the rows are split, so results are bitwise identical
+ * across worker counts.
+ */
+
+#ifndef CB_GEMM_H
+#define CB_GEMM_H
+
+#include "error.h"
+
+/** @brief Micro-kernel rows (shared by both precisions). */
+#define CB_GEMM_MR  4
+
+/** @brief Micro-kernel columns for single precision. */
+#define CB_SGEMM_NR 8
+
+/** @brief Micro-kernel columns for double precision. */
+#define CB_DGEMM_NR 4
+
+/** @brief Default rows of A per packed block. */
+#define CB_GEMM_DEFAULT_MC  128
+
+/** @brief Default depth of a packed panel. */
+#define CB_GEMM_DEFAULT_KC  256
+
+/** @brief Default columns of B per packed panel. */
+#define CB_GEMM_DEFAULT_NC  2048
+
+/**
+ * @brief Cache blocking parameters.
+ *
+ * mc is rounded up to a multiple of CB_GEMM_MR and nc to a multiple of
+ * the micro-kernel width when the kernels run.
+ */
+typedef struct {
+    int mc;  /**< Rows of A per packed block (L2-resident). */
+    int kc;  /**< Shared dimension per packed panel (L1-resident slivers). */
+    int nc;  /**< Columns of B per packed panel (L3-resident). */
+} cb_gemm_tiles_t;
+
+/**
+ * @brief Single-precision C[row_begin..row_end) = A[row_begin..row_end) * B.
+ *
+ * @param n          Matrix order.
+ * @param a          n x n row-major A.
+ * @param b          n x n row-major B.
+ * @param c          n x n row-major C; only the requested rows are written.
+ * @param row_begin  First row of C to compute.
+ * @param row_end    One past the last row of C to compute.
+ * @param tiles      Cache blocking parameters.
+ * @return CB_OK on success, CB_ERR_ARGS on bad parameters, or
+ *         CB_ERR_ALLOC if the packing buffers cannot be allocated.
+ */
+cb_error_t cb_sgemm_rows(int n, const float *a, const float *b, float *c,
+                         int row_begin, int row_end,
+                         const cb_gemm_tiles_t *tiles);
+
+/**
+ * @brief Double-precision counterpart of cb_sgemm_rows().
+ */
+cb_error_t cb_dgemm_rows(int n, const double *a, const double *b, double *c,
+                         int row_begin, int row_end,
+                         const cb_gemm_tiles_t *tiles);
+
+/**
+ * @brief Name of the micro-kernel implementation compiled in.
+ * @return "sse2" or "portable".
+ */
+const char *cb_gemm_kernel_name(void);
+
+#endif /* CB_GEMM_H */
@@ -15,11 +15,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "bench_alloc.h"
+#include "bench_smt.h"
+#include "bench_tenants.h"
+#include "cluster.h"
+#include "gemm.h"
+#include "kernel.h"
 #include "platform.h"
+#include "profile.h"
 
 /** @brief Maximum length of a single input line. */
 #define INPUT_BUF_SIZE 256
 
+/** @brief read_long() default meaning "an answer is required". */
+#define INPUT_NO_DEFAULT LONG_MIN
+
 /**
  * @brief Read a long integer from stdin with prompt, validation, and retry.
  *
@@ -31,11 +41,12 @@
  * @param prompt   Prompt string displayed before reading input.
  * @param min_val  Minimum acceptable value (inclusive).
  * @param max_val  Maximum acceptable value (inclusive).
+ * @param def_val  Value taken for an empty line, or INPUT_NO_DEFAULT.
  * @param out      Output: the parsed and validated value.
  * @return CB_OK on success, CB_ERR_INPUT on EOF.
  */
 static cb_error_t read_long(const char *prompt, long min_val,
-                            long max_val, long *out)
+                            long max_val, long def_val, long *out)
 {
     char buf[INPUT_BUF_SIZE];
 
@@ -53,6 +64,11 @@ static cb_error_t read_long(const char *prompt, long min_val,
             buf[len - 1] = '\0';
         }
 
+        if (buf[0] == '\0' && def_val != INPUT_NO_DEFAULT) {
+            *out = def_val;
+            return CB_OK;
+        }
+
         errno = 0;
         char *endptr;
         long val = strtol(buf, &endptr, 10);
@@ -188,6 +204,206 @@ static cb_error_t read_yes_no(const char *prompt, bool *out)
     }
 }
 
+/**
+ * @brief Parse the integer value of a command-line option.
+ *
+ * Reports a diagnostic to stderr naming the option on failure.
+ *
+ * @param option   Option name (for diagnostics), e.g. "--barrier-episodes".
+ * @param text     Argument text to parse.
+ * @param min_val  Minimum acceptable value (inclusive).
+ * @param max_val  Maximum acceptable value (inclusive).
+ * @param out      Output: the parsed value.
+ * @return CB_OK on success, CB_ERR_ARGS on malformed or out-of-range input.
+ */
+static cb_error_t parse_long_arg(const char *option, const char *text,
+                                 long min_val, long max_val, long *out)
+{
+    errno = 0;
+    char *endptr;
+    long val = strtol(text, &endptr, 10);
+
+    if (endptr == text || *endptr != '\0' || errno == ERANGE ||
+        val < min_val || val > max_val) {
+        fprintf(stderr, "concur-bench: invalid value for %s: %s "
+                "(expected %ld - %ld)\n", option, text, min_val, max_val);
+        return CB_ERR_ARGS;
+    }
+
+    *out = val;
+    return CB_OK;
+}
+
+/**
+ * @brief Parse a bounded floating-point command-line value.
+ *
+ * @param option   Option name (for diagnostics), e.g. "--straggler-k".
+ * @param text     Argument text to parse.
+ * @param min_val  Minimum acceptable value (inclusive).
+ * @param max_val  Maximum acceptable value (inclusive).
+ * @param out      Output: the parsed value.
+ * @return CB_OK on success, CB_ERR_ARGS on malformed or out-of-range input.
+ */
+static cb_error_t parse_double_arg(const char *option, const char *text,
+                                   double min_val, double max_val,
+                                   double *out)
+{
+    errno = 0;
+    char *endptr;
+    double val = strtod(text, &endptr);
+
+    if (endptr == text || *endptr != '\0' || errno == ERANGE ||
+        !(val >= min_val && val <= max_val)) {
+        fprintf(stderr, "concur-bench: invalid value for %s: %s "
+                "(expected %g - %g)\n", option, text, min_val, max_val);
+        return CB_ERR_ARGS;
+    }
+
+    *out = val;
+    return CB_OK;
+}
+
+/**
+ * @brief Parse a "MC,KC,NC" tile specification for --gemm-tiles.
+ *
+ * @param text    Argument text to parse.
+ * @param config  Output: gemm_mc, gemm_kc, gemm_nc on success.
+ * @return CB_OK on success, CB_ERR_ARGS on malformed or out-of-range input.
+ */
+static cb_error_t parse_gemm_tiles(const char *text, cb_config_t *config)
+{
+    long vals[3];
+    const char *p = text;
+
+    for (int i = 0; i < 3; i++) {
+        char *endptr;
+        errno = 0;
+        vals[i] = strtol(p, &endptr, 10);
+        if (endptr == p || errno == ERANGE || vals[i] < 1 ||
+            vals[i] > CB_GEMM_MAX_SIZE ||
+            *endptr != (i < 2 ? ',' : '\0')) {
+            fprintf(stderr, "concur-bench: invalid value for --gemm-tiles: %s "
+                    "(expected MC,KC,NC, each 1 - %d)\n", text,
+                    CB_GEMM_MAX_SIZE);
+            return CB_ERR_ARGS;
+        }
+        p = endptr + 1;
+    }
+
+    config->gemm_mc = (int)vals[0];
+    config->gemm_kc = (int)vals[1];
+    config->gemm_nc = (int)vals[2];
+    return CB_OK;
+}
+
+/**
+ * @brief Parse a "SRC,DST" offset pair for --copy-align.
+ *
+ * @param text    Argument text to parse.
+ * @param config  Output: copy_src_align and copy_dst_align on success.
+ * @return CB_OK on success, CB_ERR_ARGS on malformed or out-of-range input.
+ */
+static cb_error_t parse_copy_align(const char *text, cb_config_t *config)
+{
+    long vals[2];
+    const char *p = text;
+
+    for (int i = 0; i < 2; i++) {
+        char *endptr;
+        errno = 0;
+        vals[i] = strtol(p, &endptr, 10);
+        if (endptr == p || errno == ERANGE || vals[i] < 0 ||
+            vals[i] > CB_COPY_MAX_ALIGN ||
+            *endptr != (i < 1 ? ',' : '\0')) {
+            fprintf(stderr, "concur-bench: invalid value for --copy-align: %s "
+                    "(expected SRC,DST, each 0 - %d)\n", text,
+                    CB_COPY_MAX_ALIGN);
+            return CB_ERR_ARGS;
+        }
+        p = endptr + 1;
+    }
+
+    config->copy_src_align = (int)vals[0];
+    config->copy_dst_align = (int)vals[1];
+    return CB_OK;
+}
+
+/**
+ * @brief Parse a comma-separated list of field widths for --layout-fields.
+ *
+ * @param text    Argument text to parse, e.g. "8,4,4,1".
+ * @param config  Output: layout_fields and layout_width on success.
+ * @return CB_OK on success, CB_ERR_ARGS on malformed input, a width
+ *         other than 1, 2, 4 or 8, or more than CB_LAYOUT_MAX_FIELDS fields.
+ */
+static cb_error_t parse_layout_fields(const char *text, cb_config_t *config)
+{
+    int widths[CB_LAYOUT_MAX_FIELDS];
+    int count = 0;
+    const char *p = text;
+
+    for (;;) {
+        char *endptr;
+        errno = 0;
+        long val = strtol(p, &endptr, 10);
+        if (endptr == p || errno == ERANGE || count == CB_LAYOUT_MAX_FIELDS ||
+            (val != 1 && val != 2 && val != 4 && val != 8) ||
+            (*endptr != ',' && *endptr != '\0')) {
+            fprintf(stderr, "concur-bench: invalid value for --layout-fields: "
+                    "%s (expected up to %d widths of 1, 2, 4 or 8 bytes)\n",
+                    text, CB_LAYOUT_MAX_FIELDS);
+            return CB_ERR_ARGS;
+        }
+        widths[count++] = (int)val;
+        if (*endptr == '\0') {
+            break;
+        }
+        p = endptr + 1;
+    }
+
+    config->layout_fields = count;
+    memcpy(config->layout_width, widths, (size_t)count * sizeof(int));
+    return CB_OK;
+}
+
+/**
+ * @brief Parse a comma-separated list of field indices for --layout-touch.
+ *
+ * Indices are checked against the field count once all options are
+ * parsed, since --layout-fields may come later.
+ *
+ * @param text    Argument text to parse, e.g. "0,3".
+ * @param config  Output: layout_touch on success.
+ * @return CB_OK on success, CB_ERR_ARGS on malformed input.
+ */
+static cb_error_t parse_layout_touch(const char *text, cb_config_t *config)
+{
+    unsigned int mask = 0;
+    const char *p = text;
+
+    for (;;) {
+        char *endptr;
+        errno = 0;
+        long val = strtol(p, &endptr, 10);
+        if (endptr == p || errno == ERANGE || val < 0 ||
+            val >= CB_LAYOUT_MAX_FIELDS ||
+            (*endptr != ',' && *endptr != '\0')) {
+            fprintf(stderr, "concur-bench: invalid value for --layout-touch: "
+                    "%s (expected field indices 0 - %d)\n", text,
+                    CB_LAYOUT_MAX_FIELDS - 1);
+            return CB_ERR_ARGS;
+        }
+        mask |= 1u << val;
+        if (*endptr == '\0') {
+            break;
+        }
+        p = endptr + 1;
+    }
+
+    config->layout_touch = mask;
+    return CB_OK;
+}
+
 /**
  * @brief Print usage information to stdout.
  */
@@ -198,13 +414,101 @@ static void print_usage(const char *prog_name)
         "\n"
         "Options:\n"
         "  --verbose            Enable detailed per-worker output\n"
+        "  --tsc                Time worker slices with the invariant TSC\n"
+        "  --tune-kernel        Pick the fastest sum kernel for this host\n"
+        "                       (kept in " CB_PROFILE_FILE ")\n"
+        "  --kernel <name>      Use sum kernel <name>, e.g. u8a4p0\n"
+        "  --recalibrate        Ignore the saved host profile and measure again\n"
         "  --iterations <N>     Number of benchmark iterations (default: %d)\n"
+        "  --barrier            Run the barrier algorithm suite\n"
+        "  --barrier-episodes <N>\n"
+        "                       Max episodes per barrier measurement (default: %d)\n"
+        "  --sort               Run the sort workload (merge and radix sorts)\n"
+        "  --gemm               Run the blocked matrix multiply workload\n"
+        "  --gemm-size <N>      Matrix order for --gemm (default: %d)\n"
+        "  --gemm-tiles <MC,KC,NC>\n"
+        "                       Cache tile sizes for --gemm (default: %d,%d,%d)\n"
+        "  --alloc              Run the allocator contention workload\n"
+        "  --alloc-ops <N>      Allocator ops per thread per iteration (default: %d)\n"
+        "  --alloc-pattern <P>  Run only pattern P: short-small, long-small,\n"
+        "                       long-mixed, prod-cons\n"
+        "  --fiber              Run the fiber (M:N coroutine) mode\n"
+        "  --fiber-tasks <N>    Tasks the dataset is split into (default: %d)\n"
+        "  --fiber-yield <N>    Elements summed between yields (default: %d)\n"
+        "  --forkjoin           Run the fork-join (work-stealing) mode\n"
+        "  --forkjoin-grain <N> Use only grain size N instead of a sweep\n"
+        "  --omp                Compare OpenMP schedules with thread mode\n"
+        "  --reduce             Compare serial and tree combining of results\n"
+        "  --autotune           Search workers, chunking and pinning\n"
+        "  --prefetch           Sweep prefetch distance and streaming loads\n"
+        "  --prefetch-distance <N>\n"
+        "                       Use only distance N (elements) instead of a sweep\n"
+        "  --access             Strided, blocked-random and gather patterns\n"
+        "  --access-stride <N>  Use only stride N (elements) instead of a sweep\n"
+        "  --smt                Measure SMT sibling interference\n"
+        "  --smt-antagonist <name>\n"
+        "                       Only this sibling antagonist: compute, memory,\n"
+        "                       idle\n"
+        "  --compress           Scan 8-bit, 7-bit packed and FOR encodings\n"
+        "  --layout             Compare AoS, SoA and AoSoA record layouts\n"
+        "  --layout-fields <W,W,...>\n"
+        "                       Field widths in bytes (default: %s)\n"
+        "  --layout-touch <I,I,...>\n"
+        "                       Fields summed (default: first and middle)\n"
+        "  --coordinator <N>    Coordinate a cluster run over N TCP nodes\n"
+        "  --cluster-port <P>   Coordinator port (default: %d, or any free\n"
+        "                       port with --cluster-local)\n"
+        "  --cluster-local      Spawn the nodes on 127.0.0.1 (default: 2)\n"
+        "  --cluster-worker <host:port>\n"
+        "                       Run as a cluster node of that coordinator\n"
+        "  --allreduce          Time ring, recursive-doubling and reduce-\n"
+        "                       scatter + allgather allreduce among processes\n"
+        "  --allreduce-max <B>  Largest allreduce vector in bytes\n"
+        "                       (default: %d)\n"
+        "  --straggler          Compare wait-all and speculative re-execution\n"
+        "                       of slow process slices\n"
+        "  --straggler-k <x>    Backup deadline in median slice times\n"
+        "                       (default: %.1f)\n"
+        "  --straggler-delay <ms>\n"
+        "                       Sleep injected into one child in about half\n"
+        "                       of the rounds, 0 for none (default: %d)\n",
+        prog_name ? prog_name : "concur-bench",
+        CB_DEFAULT_ITERATIONS,
+        CB_DEFAULT_BARRIER_EPISODES,
+        CB_DEFAULT_GEMM_SIZE,
+        CB_GEMM_DEFAULT_MC, CB_GEMM_DEFAULT_KC, CB_GEMM_DEFAULT_NC,
+        CB_DEFAULT_ALLOC_OPS,
+        CB_DEFAULT_FIBER_TASKS,
+        CB_DEFAULT_FIBER_YIELD,
+        CB_DEFAULT_LAYOUT_FIELDS,
+        CB_DEFAULT_CLUSTER_PORT,
+        CB_DEFAULT_ALLREDUCE_MAX,
+        CB_DEFAULT_STRAGGLER_K,
+        CB_DEFAULT_STRAGGLER_DELAY_MS);
+
+    /* Split so neither literal exceeds the 4095 characters C99 guarantees. */
+    fprintf(stdout,
+        "  --mutate             Compare incremental dirty-block re-reduction\n"
+        "                       with a full rescan on a mutating dataset\n"
+        "  --mutate-rate <pct>  Elements updated per iteration, in percent\n"
+        "                       (default: sweep 0.001 - 10)\n"
+        "  --tenants <K>        Run K concurrent tenant sessions and report\n"
+        "                       each one's slowdown against a solo run\n"
+        "  --tenant-cpus <name> Only this CPU placement: none, disjoint or\n"
+        "                       overlap (default: all; tenants: %d)\n"
+        "  --write              Time in-place transform and triad with\n"
+        "                       regular and non-temporal stores\n"
+        "  --copy               Compare memcpy / memset strategies across\n"
+        "                       sizes and thread counts\n"
+        "  --copy-max <MiB>     Largest total bytes copied at once by all\n"
+        "                       threads (default: %d)\n"
+        "  --copy-align <S,D>   Source and destination offsets from a page,\n"
+        "                       0 - %d bytes (default: 0,0)\n"
         "  --help               Show this help message and exit\n"
         "\n"
         "When run without options, the program prompts interactively\n"
         "for all configuration parameters.\n",
-        prog_name ? prog_name : "concur-bench",
-        CB_DEFAULT_ITERATIONS);
+        CB_DEFAULT_TENANTS, CB_DEFAULT_COPY_MAX_MIB, CB_COPY_MAX_ALIGN);
 }
 
 cb_error_t cb_parse_args(int argc, char *argv[],
@@ -220,6 +524,20 @@ cb_error_t cb_parse_args(int argc, char *argv[],
     memset(config, 0, sizeof(*config));
     config->iterations = CB_DEFAULT_ITERATIONS;
     config->verbose = false;
+    config->barrier_episodes = CB_DEFAULT_BARRIER_EPISODES;
+    config->gemm_size = CB_DEFAULT_GEMM_SIZE;
+    config->gemm_mc = CB_GEMM_DEFAULT_MC;
+    config->gemm_kc = CB_GEMM_DEFAULT_KC;
+    config->gemm_nc = CB_GEMM_DEFAULT_NC;
+    config->alloc_ops = CB_DEFAULT_ALLOC_OPS;
+    config->fiber_tasks = CB_DEFAULT_FIBER_TASKS;
+    config->fiber_yield = CB_DEFAULT_FIBER_YIELD;
+    parse_layout_fields(CB_DEFAULT_LAYOUT_FIELDS, config);
+    config->allreduce_max = CB_DEFAULT_ALLREDUCE_MAX;
+    config->straggler_k = CB_DEFAULT_STRAGGLER_K;
+    config->straggler_delay_ms = CB_DEFAULT_STRAGGLER_DELAY_MS;
+    config->tenants = CB_DEFAULT_TENANTS;
+    config->copy_max_mib = CB_DEFAULT_COPY_MAX_MIB;
     *is_worker = false;
     memset(worker_args, 0, sizeof(*worker_args));
 
@@ -234,6 +552,38 @@ cb_error_t cb_parse_args(int argc, char *argv[],
             continue;
         }
 
+        if (strcmp(argv[i], "--tsc") == 0) {
+            config->use_tsc = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--tune-kernel") == 0) {
+            config->tune_kernel = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--recalibrate") == 0) {
+            config->recalibrate = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--kernel") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --kernel requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (!cb_kernel_find(argv[i + 1])) {
+                fprintf(stderr, "concur-bench: unknown kernel: %s (expected "
+                        "u<unroll>a<accumulators>p<prefetch>, e.g. u8a4p0)\n",
+                        argv[i + 1]);
+                return CB_ERR_ARGS;
+            }
+            snprintf(config->kernel_name, sizeof(config->kernel_name),
+                     "%s", argv[i + 1]);
+            i++;
+            continue;
+        }
+
         if (strcmp(argv[i], "--iterations") == 0) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "concur-bench: --iterations requires a value\n");
@@ -253,6 +603,469 @@ cb_error_t cb_parse_args(int argc, char *argv[],
             continue;
         }
 
+        if (strcmp(argv[i], "--barrier") == 0) {
+            config->run_barrier = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--barrier-episodes") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --barrier-episodes requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], CB_BARRIER_MIN_EPISODES,
+                               INT_MAX, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->barrier_episodes = (int)val;
+            config->run_barrier = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--sort") == 0) {
+            config->run_sort = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--gemm") == 0) {
+            config->run_gemm = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--gemm-size") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --gemm-size requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], CB_GEMM_MIN_SIZE,
+                               CB_GEMM_MAX_SIZE, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->gemm_size = (int)val;
+            config->run_gemm = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--gemm-tiles") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --gemm-tiles requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (parse_gemm_tiles(argv[i + 1], config)) {
+                return CB_ERR_ARGS;
+            }
+            config->run_gemm = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--alloc") == 0) {
+            config->run_alloc = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--alloc-ops") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --alloc-ops requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1000, INT_MAX, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->alloc_ops = (int)val;
+            config->run_alloc = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--alloc-pattern") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --alloc-pattern requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (!cb_bench_alloc_pattern_valid(argv[i + 1])) {
+                fprintf(stderr, "concur-bench: unknown alloc pattern: %s\n",
+                        argv[i + 1]);
+                return CB_ERR_ARGS;
+            }
+            snprintf(config->alloc_pattern, sizeof(config->alloc_pattern),
+                     "%s", argv[i + 1]);
+            config->run_alloc = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--fiber") == 0) {
+            config->run_fiber = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--fiber-tasks") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --fiber-tasks requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, CB_FIBER_MAX_TASKS, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->fiber_tasks = (int)val;
+            config->run_fiber = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--fiber-yield") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --fiber-yield requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, INT_MAX, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->fiber_yield = (int)val;
+            config->run_fiber = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--forkjoin") == 0) {
+            config->run_forkjoin = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--forkjoin-grain") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --forkjoin-grain requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, INT_MAX, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->forkjoin_grain = (int)val;
+            config->run_forkjoin = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--omp") == 0) {
+            config->run_omp = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--reduce") == 0) {
+            config->run_reduce = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--autotune") == 0) {
+            config->run_autotune = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--prefetch") == 0) {
+            config->run_prefetch = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--prefetch-distance") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --prefetch-distance requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, INT_MAX, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->prefetch_distance = (int)val;
+            config->run_prefetch = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--access") == 0) {
+            config->run_access = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--access-stride") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --access-stride requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, INT_MAX, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->access_stride = (int)val;
+            config->run_access = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--smt") == 0) {
+            config->run_smt = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--smt-antagonist") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --smt-antagonist requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (!cb_bench_smt_antagonist_valid(argv[i + 1])) {
+                fprintf(stderr, "concur-bench: unknown smt antagonist: %s\n",
+                        argv[i + 1]);
+                return CB_ERR_ARGS;
+            }
+            snprintf(config->smt_antagonist, sizeof(config->smt_antagonist),
+                     "%s", argv[i + 1]);
+            config->run_smt = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--compress") == 0) {
+            config->run_compress = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--layout") == 0) {
+            config->run_layout = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--layout-fields") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --layout-fields requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (parse_layout_fields(argv[i + 1], config)) {
+                return CB_ERR_ARGS;
+            }
+            config->run_layout = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--layout-touch") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --layout-touch requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (parse_layout_touch(argv[i + 1], config)) {
+                return CB_ERR_ARGS;
+            }
+            config->run_layout = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--coordinator") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --coordinator requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, CB_CLUSTER_MAX_NODES,
+                               &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->cluster_nodes = (int)val;
+            config->run_cluster = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--cluster-port") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --cluster-port requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, 65535, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->cluster_port = (int)val;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--cluster-local") == 0) {
+            config->cluster_local = true;
+            config->run_cluster = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--cluster-worker") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --cluster-worker requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (cb_cluster_parse_endpoint(argv[i + 1], config->cluster_host,
+                                          sizeof(config->cluster_host),
+                                          &config->cluster_port)) {
+                fprintf(stderr, "concur-bench: invalid value for "
+                        "--cluster-worker: %s (expected host:port)\n",
+                        argv[i + 1]);
+                return CB_ERR_ARGS;
+            }
+            config->cluster_worker = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--allreduce") == 0) {
+            config->run_allreduce = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--allreduce-max") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --allreduce-max requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 8, CB_ALLREDUCE_MAX_BYTES,
+                               &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->allreduce_max = (int)val;
+            config->run_allreduce = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--straggler") == 0) {
+            config->run_straggler = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--straggler-k") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --straggler-k requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (parse_double_arg(argv[i], argv[i + 1], 1.0, 100.0,
+                                 &config->straggler_k)) {
+                return CB_ERR_ARGS;
+            }
+            config->run_straggler = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--straggler-delay") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --straggler-delay requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 0, 10000, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->straggler_delay_ms = (int)val;
+            config->run_straggler = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--mutate") == 0) {
+            config->run_mutate = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--mutate-rate") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --mutate-rate requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (parse_double_arg(argv[i], argv[i + 1], 1e-6,
+                                 CB_MUTATE_RATE_MAX, &config->mutate_rate)) {
+                return CB_ERR_ARGS;
+            }
+            config->run_mutate = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--tenants") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --tenants requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, CB_MAX_TENANTS, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->tenants = (int)val;
+            config->run_tenants = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--write") == 0) {
+            config->run_write = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--copy") == 0) {
+            config->run_copy = true;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--copy-max") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --copy-max requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            long val;
+            if (parse_long_arg(argv[i], argv[i + 1], 1, CB_COPY_MAX_MIB, &val)) {
+                return CB_ERR_ARGS;
+            }
+            config->copy_max_mib = (int)val;
+            config->run_copy = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--copy-align") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --copy-align requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (parse_copy_align(argv[i + 1], config)) {
+                return CB_ERR_ARGS;
+            }
+            config->run_copy = true;
+            i++;
+            continue;
+        }
+
+        if (strcmp(argv[i], "--tenant-cpus") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "concur-bench: --tenant-cpus requires a value\n");
+                return CB_ERR_ARGS;
+            }
+            if (!cb_bench_tenants_placement_valid(argv[i + 1])) {
+                fprintf(stderr, "concur-bench: unknown tenant placement: %s\n",
+                        argv[i + 1]);
+                return CB_ERR_ARGS;
+            }
+            snprintf(config->tenant_cpus, sizeof(config->tenant_cpus),
+                     "%s", argv[i + 1]);
+            config->run_tenants = true;
+            i++;
+            continue;
+        }
+
         if (strcmp(argv[i], "--worker") == 0) {
             /* --worker <id> <shm_name> <array_size> <num_workers> <start> <length> */
             if (i + 6 >= argc) {
@@ -276,6 +1089,16 @@ cb_error_t cb_parse_args(int argc, char *argv[],
         return CB_ERR_ARGS;
     }
 
+    if (config->layout_touch >> config->layout_fields) {
+        fprintf(stderr, "concur-bench: --layout-touch names a field beyond "
+                "the %d in --layout-fields\n", config->layout_fields);
+        return CB_ERR_ARGS;
+    }
+
+    if (config->run_cluster && config->cluster_nodes == 0) {
+        config->cluster_nodes = 2;
+    }
+
     return CB_OK;
 }
 
@@ -288,6 +1111,15 @@ cb_error_t cb_input_interactive(cb_config_t *config)
     cb_error_t err;
     long val;
     int cpu_cores = cb_cpu_count();
+    int cpu_budget = cb_cpu_budget();
+
+    /* The budget has no upper bound; keep the Enter default in range. */
+    int worker_default = cpu_budget;
+    if (worker_default > CB_MAX_WORKERS) {
+        worker_default = CB_MAX_WORKERS;
+    } else if (worker_default < CB_MIN_WORKERS) {
+        worker_default = CB_MIN_WORKERS;
+    }
 
     /* Verbose mode (only prompt if not already set via CLI). */
     if (!config->verbose) {
@@ -302,23 +1134,28 @@ cb_error_t cb_input_interactive(cb_config_t *config)
     char prompt[INPUT_BUF_SIZE];
     snprintf(prompt, sizeof(prompt),
              "Array length (%d - %d): ", CB_MIN_ARRAY_LEN, INT_MAX);
-    err = read_long(prompt, CB_MIN_ARRAY_LEN, INT_MAX, &val);
+    err = read_long(prompt, CB_MIN_ARRAY_LEN, INT_MAX, INPUT_NO_DEFAULT,
+                    &val);
     if (err) return err;
     config->array_length = (int)val;
 
     /* Number of processes. */
     snprintf(prompt, sizeof(prompt),
-             "Number of processes (%d - %d) [detected %d cores]: ",
-             CB_MIN_WORKERS, CB_MAX_WORKERS, cpu_cores);
-    err = read_long(prompt, CB_MIN_WORKERS, CB_MAX_WORKERS, &val);
+             "Number of processes (%d - %d) [%d cores, CPU budget %d; "
+             "Enter = %d]: ", CB_MIN_WORKERS, CB_MAX_WORKERS, cpu_cores,
+             cpu_budget, worker_default);
+    err = read_long(prompt, CB_MIN_WORKERS, CB_MAX_WORKERS, worker_default,
+                    &val);
     if (err) return err;
     config->num_processes = (int)val;
 
     /* Number of threads. */
     snprintf(prompt, sizeof(prompt),
-             "Number of threads (%d - %d) [detected %d cores]: ",
-             CB_MIN_WORKERS, CB_MAX_WORKERS, cpu_cores);
-    err = read_long(prompt, CB_MIN_WORKERS, CB_MAX_WORKERS, &val);
+             "Number of threads (%d - %d) [%d cores, CPU budget %d; "
+             "Enter = %d]: ", CB_MIN_WORKERS, CB_MAX_WORKERS, cpu_cores,
+             cpu_budget, worker_default);
+    err = read_long(prompt, CB_MIN_WORKERS, CB_MAX_WORKERS, worker_default,
+                    &val);
     if (err) return err;
     config->num_threads = (int)val;
 
@@ -334,7 +1171,7 @@ cb_error_t cb_input_interactive(cb_config_t *config)
     snprintf(prompt, sizeof(prompt),
              "Benchmark iterations (1 - 100) [default %d]: ",
              config->iterations);
-    err = read_long(prompt, 1, 100, &val);
+    err = read_long(prompt, 1, 100, INPUT_NO_DEFAULT, &val);
     if (err) return err;
     config->iterations = (int)val;
 
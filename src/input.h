@@ -43,6 +43,141 @@ typedef struct {
  *       Set the number of benchmark iterations (default: CB_DEFAULT_ITERATIONS).
  *   --verbose
  *       Enable detailed per-worker output.
+ *   --tsc
+ *       Time worker slices with the invariant TSC instead of the
+ *       monotonic clock (x86 only; falls back with a warning).
+ *   --tune-kernel
+ *       Time every sum kernel variant and use the fastest; the choice
+ *       is kept in the host profile (CB_PROFILE_FILE).
+ *   --kernel <name>
+ *       Use the named sum kernel variant (overrides --tune-kernel).
+ *   --recalibrate
+ *       Ignore the saved host profile, calibrate again, and overwrite it.
+ *   --barrier
+ *       Run the barrier algorithm suite after the core modes.
+ *   --barrier-episodes <N>
+ *       Cap episodes per barrier measurement (implies --barrier).
+ *   --sort
+ *       Run the sort workload (merge and radix sorts) after the core modes.
+ *   --gemm
+ *       Run the blocked matrix multiply workload after the core modes.
+ *   --gemm-size <N>
+ *       Matrix order for the gemm workload (implies --gemm).
+ *   --gemm-tiles <MC,KC,NC>
+ *       Cache tile sizes for the gemm workload (implies --gemm).
+ *   --alloc
+ *       Run the allocator contention workload after the core modes.
+ *   --alloc-ops <N>
+ *       Allocator operations per thread per iteration (implies --alloc).
+ *   --alloc-pattern <P>
+ *       Run only allocation pattern P (implies --alloc).
+ *   --fiber
+ *       Run the fiber (M:N coroutine) mode after the core modes.
+ *   --fiber-tasks <N>
+ *       Number of fiber tasks the dataset is split into (implies --fiber).
+ *   --fiber-yield <N>
+ *       Elements a fiber task sums between yields (implies --fiber).
+ *   --forkjoin
+ *       Run the fork-join (work-stealing) mode after the core modes.
+ *   --forkjoin-grain <N>
+ *       Use only grain size N instead of a sweep (implies --forkjoin).
+ *   --omp
+ *       Run the OpenMP comparison after the core modes (baseline rows
+ *       only in a build without OpenMP).
+ *   --reduce
+ *       Run the serial vs tree result-combine suite after the core modes.
+ *   --autotune
+ *       Search worker count, chunking and pinning for thread and
+ *       process mode after the core modes.
+ *   --prefetch
+ *       Run the prefetch-distance / streaming-load sweep after the
+ *       core modes.
+ *   --prefetch-distance <N>
+ *       Use only prefetch distance N (elements) instead of a sweep
+ *       (implies --prefetch).
+ *   --access
+ *       Run the strided / blocked-random / gather access-pattern suite
+ *       after the core modes.
+ *   --access-stride <N>
+ *       Use only stride N (elements) instead of a sweep (implies
+ *       --access).
+ *   --smt
+ *       Run the SMT sibling interference suite after the core modes.
+ *   --smt-antagonist <name>
+ *       Run only this sibling antagonist (compute, memory, idle)
+ *       (implies --smt).
+ *   --compress
+ *       Run the compressed-scan suite (fused decode-and-sum over the
+ *       8-bit, 7-bit packed and frame-of-reference encodings) after
+ *       the core modes.
+ *   --layout
+ *       Run the AoS / SoA / AoSoA record-layout suite after the core
+ *       modes.
+ *   --layout-fields <W,W,...>
+ *       Field widths in bytes, each 1, 2, 4 or 8, at most
+ *       CB_LAYOUT_MAX_FIELDS of them (implies --layout).
+ *   --layout-touch <I,I,...>
+ *       Indices of the fields the reduction sums (implies --layout).
+ *   --coordinator <N>
+ *       Coordinate a cluster run over N worker nodes connected by TCP
+ *       (1 - CB_CLUSTER_MAX_NODES) after the core modes.
+ *   --cluster-port <P>
+ *       Port the coordinator listens on (default
+ *       CB_DEFAULT_CLUSTER_PORT, or an ephemeral port with
+ *       --cluster-local).
+ *   --cluster-local
+ *       Spawn the nodes on 127.0.0.1 instead of waiting for remote
+ *       ones (implies --coordinator 2 unless given).
+ *   --cluster-worker <host:port>
+ *       Run as a cluster node of the coordinator at host:port and exit
+ *       when it is done; no dataset prompts.
+ *   --allreduce
+ *       Run the allreduce suite (ring, recursive doubling and
+ *       reduce-scatter + allgather among num_processes workers) after
+ *       the core modes.
+ *   --allreduce-max <B>
+ *       Largest allreduce vector in bytes, 8 - CB_ALLREDUCE_MAX_BYTES
+ *       (default CB_DEFAULT_ALLREDUCE_MAX) (implies --allreduce).
+ *   --straggler
+ *       Run the straggler suite (wait-all vs speculative re-execution
+ *       of slow process slices) after the core modes.
+ *   --straggler-k <x>
+ *       Backup deadline as a multiple of the median slice time,
+ *       1 - 100 (default CB_DEFAULT_STRAGGLER_K) (implies --straggler).
+ *   --straggler-delay <ms>
+ *       Sleep injected into one child in about half of the rounds,
+ *       0 - 10000, 0 for none (default CB_DEFAULT_STRAGGLER_DELAY_MS)
+ *       (implies --straggler).
+ *   --mutate
+ *       Run the mutating workload (incremental dirty-block re-reduction
+ *       vs a full rescan over a sweep of mutation rates) after the core
+ *       modes.
+ *   --mutate-rate <pct>
+ *       Measure a single mutation rate, in percent of the elements
+ *       updated per iteration, 0.000001 - CB_MUTATE_RATE_MAX (implies
+ *       --mutate).
+ *   --tenants <K>
+ *       Run the multi-tenant suite with K concurrent tenant sessions,
+ *       1 - CB_MAX_TENANTS, after the core modes.
+ *   --tenant-cpus <name>
+ *       Only the given CPU placement of the tenants' threads: "none",
+ *       "disjoint" or "overlap" (default all; implies --tenants with
+ *       CB_DEFAULT_TENANTS tenants unless --tenants is given).
+ *   --write
+ *       Run the write-heavy suite (in-place transform and triad with
+ *       regular and non-temporal stores in single, thread and process
+ *       mode) after the core modes.
+ *   --copy
+ *       Run the copy suite (libc, rep, AVX2, AVX-512 and non-temporal
+ *       memcpy / memset from 64 B up, with 1, 2, 4, ... num_threads
+ *       threads) after the core modes.
+ *   --copy-max <MiB>
+ *       Largest total bytes copied at once by all threads, 1 -
+ *       CB_COPY_MAX_MIB (default CB_DEFAULT_COPY_MAX_MIB) (implies
+ *       --copy).
+ *   --copy-align <S,D>
+ *       Source and destination offsets from a page boundary, each 0 -
+ *       CB_COPY_MAX_ALIGN (default 0,0) (implies --copy).
  *   --help
  *       Print usage information and return CB_ERR_ARGS to signal exit.
  *
@@ -68,8 +203,9 @@ cb_error_t cb_parse_args(int argc, char *argv[],
  * line input and strtol for numeric parsing, providing robust error
  * handling and retry logic.
  *
- * The detected CPU core count is displayed as a suggestion for the
- * process and thread count prompts.
+ * The process and thread count prompts show the detected core count
+ * and the CPU budget (cb_cpu_budget(), which honours cgroup quotas and
+ * cpusets); an empty answer takes the budget.
  *
  * Fields already set by cb_parse_args() (e.g., iterations, verbose)
  * are used as defaults and may be overridden by the user.
@@ -0,0 +1,435 @@
+/**
+ * @file kernel.c
+ * @brief Implementation of the summation kernels and the autotuner.
+ *
+ * KERNEL_DEFINE expands to one kernel. With a constant unroll depth the
+ * compiler fully unrolls the inner loop and keeps each accumulator in
+ * its own register; accumulator k takes elements k, k + A, k + 2A, ...
+ * of every unrolled step. Prefetch variants are generated only for the
+ * deeper unrolls, so at most one prefetch is issued per 32 bytes.
+ *
+ * The build ID is the build time of this file, so a host profile
+ * written by a build with other compiler flags does not restore a
+ * kernel choice made for different code.
+ */
+
+#include "kernel.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "platform.h"
+#include "timer.h"
+#include "types.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KERNEL_PREFETCH(p) __builtin_prefetch((p), 0, 3)
+#define KERNEL_PREFETCH_NTA(p) __builtin_prefetch((p), 0, 0)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define KERNEL_PREFETCH(p) _mm_prefetch((const char *)(p), _MM_HINT_T0)
+#define KERNEL_PREFETCH_NTA(p) _mm_prefetch((const char *)(p), _MM_HINT_NTA)
+#else
+#define KERNEL_PREFETCH(p) ((void)(p))
+#define KERNEL_PREFETCH_NTA(p) ((void)(p))
+#endif
+
+/*
+ * MOVNTDQA (SSE4.1) is compiled for this function only and chosen at
+ * run time, so the build itself needs no -msse4.1.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define KERNEL_HAVE_STREAM 1
+#define KERNEL_STREAM_TARGET __attribute__((target("sse4.1")))
+#include <smmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define KERNEL_HAVE_STREAM 1
+#define KERNEL_STREAM_TARGET
+#include <intrin.h>
+#include <smmintrin.h>
+#endif
+
+/** @brief Elements per iteration of the runtime-distance kernels (64 B). */
+#define KERNEL_SWEEP_UNROLL 16
+
+/** @brief Accumulators of the runtime-distance kernels. */
+#define KERNEL_SWEEP_ACCS 4
+
+/**
+ * @brief Define kernel sum_u<U>a<A>p<P>.
+ *
+ * @param U  Unroll depth (elements per iteration).
+ * @param A  Accumulators (divides U).
+ * @param P  Prefetch distance in elements (0 = none).
+ */
+#define KERNEL_DEFINE(U, A, P)                                              \
+    static long int sum_u##U##a##A##p##P(const int *data, int length)       \
+    {                                                                       \
+        long int acc[A] = { 0 };                                            \
+        long int sum = 0;                                                   \
+        int i = 0;                                                          \
+                                                                            \
+        for (; length - i >= (U); i += (U)) {                               \
+            if ((P) > 0 && length - i > (P)) {                              \
+                KERNEL_PREFETCH(data + i + (P));                            \
+            }                                                               \
+            for (int k = 0; k < (U); k++) {                                 \
+                acc[k % (A)] += data[i + k];                                \
+            }                                                               \
+        }                                                                   \
+        for (; i < length; i++) {                                           \
+            sum += data[i];                                                 \
+        }                                                                   \
+        for (int k = 0; k < (A); k++) {                                     \
+            sum += acc[k];                                                  \
+        }                                                                   \
+        return sum;                                                         \
+    }
+
+/** @brief Registry entry for kernel sum_u<U>a<A>p<P>. */
+#define KERNEL_ENTRY(U, A, P) \
+    { "u" #U "a" #A "p" #P, sum_u##U##a##A##p##P, U, A, P }
+
+KERNEL_DEFINE(1, 1, 0)
+KERNEL_DEFINE(2, 1, 0)
+KERNEL_DEFINE(2, 2, 0)
+KERNEL_DEFINE(4, 1, 0)
+KERNEL_DEFINE(4, 2, 0)
+KERNEL_DEFINE(4, 4, 0)
+KERNEL_DEFINE(8, 1, 0)
+KERNEL_DEFINE(8, 2, 0)
+KERNEL_DEFINE(8, 4, 0)
+KERNEL_DEFINE(8, 8, 0)
+KERNEL_DEFINE(16, 1, 0)
+KERNEL_DEFINE(16, 2, 0)
+KERNEL_DEFINE(16, 4, 0)
+KERNEL_DEFINE(16, 8, 0)
+KERNEL_DEFINE(8, 1, 256)
+KERNEL_DEFINE(8, 2, 256)
+KERNEL_DEFINE(8, 4, 256)
+KERNEL_DEFINE(8, 8, 256)
+KERNEL_DEFINE(16, 1, 256)
+KERNEL_DEFINE(16, 2, 256)
+KERNEL_DEFINE(16, 4, 256)
+KERNEL_DEFINE(16, 8, 256)
+KERNEL_DEFINE(8, 1, 1024)
+KERNEL_DEFINE(8, 2, 1024)
+KERNEL_DEFINE(8, 4, 1024)
+KERNEL_DEFINE(8, 8, 1024)
+KERNEL_DEFINE(16, 1, 1024)
+KERNEL_DEFINE(16, 2, 1024)
+KERNEL_DEFINE(16, 4, 1024)
+KERNEL_DEFINE(16, 8, 1024)
+
+/** @brief All variants; index 0 is the default. */
+static const cb_sum_kernel_t kernels[] = {
+    KERNEL_ENTRY(1, 1, 0),
+    KERNEL_ENTRY(2, 1, 0),
+    KERNEL_ENTRY(2, 2, 0),
+    KERNEL_ENTRY(4, 1, 0),
+    KERNEL_ENTRY(4, 2, 0),
+    KERNEL_ENTRY(4, 4, 0),
+    KERNEL_ENTRY(8, 1, 0),
+    KERNEL_ENTRY(8, 2, 0),
+    KERNEL_ENTRY(8, 4, 0),
+    KERNEL_ENTRY(8, 8, 0),
+    KERNEL_ENTRY(16, 1, 0),
+    KERNEL_ENTRY(16, 2, 0),
+    KERNEL_ENTRY(16, 4, 0),
+    KERNEL_ENTRY(16, 8, 0),
+    KERNEL_ENTRY(8, 1, 256),
+    KERNEL_ENTRY(8, 2, 256),
+    KERNEL_ENTRY(8, 4, 256),
+    KERNEL_ENTRY(8, 8, 256),
+    KERNEL_ENTRY(16, 1, 256),
+    KERNEL_ENTRY(16, 2, 256),
+    KERNEL_ENTRY(16, 4, 256),
+    KERNEL_ENTRY(16, 8, 256),
+    KERNEL_ENTRY(8, 1, 1024),
+    KERNEL_ENTRY(8, 2, 1024),
+    KERNEL_ENTRY(8, 4, 1024),
+    KERNEL_ENTRY(8, 8, 1024),
+    KERNEL_ENTRY(16, 1, 1024),
+    KERNEL_ENTRY(16, 2, 1024),
+    KERNEL_ENTRY(16, 4, 1024),
+    KERNEL_ENTRY(16, 8, 1024),
+};
+
+/** @brief Number of entries in kernels[]. */
+#define KERNEL_COUNT ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+/** @brief Selection state, written only before workers start. */
+static cb_kernel_info_t kernel_state = { &kernels[0], CB_KERNEL_DEFAULT, 0.0, 0.0 };
+
+int cb_kernel_count(void)
+{
+    return KERNEL_COUNT;
+}
+
+const cb_sum_kernel_t *cb_kernel_get(int index)
+{
+    if (index < 0 || index >= KERNEL_COUNT) {
+        return NULL;
+    }
+    return &kernels[index];
+}
+
+const cb_sum_kernel_t *cb_kernel_find(const char *name)
+{
+    if (!name) {
+        return NULL;
+    }
+    for (int i = 0; i < KERNEL_COUNT; i++) {
+        if (strcmp(kernels[i].name, name) == 0) {
+            return &kernels[i];
+        }
+    }
+    return NULL;
+}
+
+cb_error_t cb_kernel_select(const char *name)
+{
+    const cb_sum_kernel_t *k = cb_kernel_find(name);
+    if (!k) {
+        return CB_ERR_ARGS;
+    }
+
+    kernel_state.kernel = k;
+    kernel_state.origin = CB_KERNEL_FORCED;
+    kernel_state.gbps = 0.0;
+    kernel_state.naive_gbps = 0.0;
+    return CB_OK;
+}
+
+long int cb_kernel_sum(const int *data, int length)
+{
+    return kernel_state.kernel->fn(data, length);
+}
+
+void cb_kernel_get_info(cb_kernel_info_t *info)
+{
+    if (info) {
+        *info = kernel_state;
+    }
+}
+
+const char *cb_kernel_build_id(void)
+{
+    static char id[64];
+
+    if (!id[0]) {
+        snprintf(id, sizeof(id), "%s %s, %d variants", __DATE__, __TIME__,
+                 KERNEL_COUNT);
+    }
+    return id;
+}
+
+cb_error_t cb_kernel_restore(const char *name, double gbps, double naive_gbps)
+{
+    const cb_sum_kernel_t *k = cb_kernel_find(name);
+    if (!k) {
+        return CB_ERR_ARGS;
+    }
+
+    kernel_state.kernel = k;
+    kernel_state.origin = CB_KERNEL_CACHED;
+    kernel_state.gbps = gbps;
+    kernel_state.naive_gbps = naive_gbps;
+    return CB_OK;
+}
+
+/**
+ * @brief Define a runtime-distance kernel.
+ *
+ * Like u16a4 with the prefetch distance as an argument: one PREFETCH
+ * per 64-byte step, @p distance elements ahead (0 = none).
+ */
+#define KERNEL_SWEEP_DEFINE(NAME, PREFETCH)                                 \
+    static long int NAME(const int *data, int length, int distance)         \
+    {                                                                       \
+        long int acc[KERNEL_SWEEP_ACCS] = { 0 };                            \
+        long int sum = 0;                                                   \
+        int i = 0;                                                          \
+                                                                            \
+        for (; length - i >= KERNEL_SWEEP_UNROLL; i += KERNEL_SWEEP_UNROLL) { \
+            if (distance > 0 && length - i > distance) {                    \
+                PREFETCH(data + i + distance);                              \
+            }                                                               \
+            for (int k = 0; k < KERNEL_SWEEP_UNROLL; k++) {                 \
+                acc[k % KERNEL_SWEEP_ACCS] += data[i + k];                  \
+            }                                                               \
+        }                                                                   \
+        for (; i < length; i++) {                                           \
+            sum += data[i];                                                 \
+        }                                                                   \
+        for (int k = 0; k < KERNEL_SWEEP_ACCS; k++) {                       \
+            sum += acc[k];                                                  \
+        }                                                                   \
+        return sum;                                                         \
+    }
+
+KERNEL_SWEEP_DEFINE(sum_sweep_t0, KERNEL_PREFETCH)
+KERNEL_SWEEP_DEFINE(sum_sweep_nta, KERNEL_PREFETCH_NTA)
+
+#ifdef KERNEL_HAVE_STREAM
+/**
+ * @brief Define an SSE4.1 sum, 8 ints per iteration, loading with LOAD.
+ *
+ * Unaligned head and tail elements are summed with plain loads. Ints
+ * are widened to 64-bit lanes so the vector sums cannot overflow
+ * where a scalar long would not. The MOVDQA and MOVNTDQA versions
+ * differ only in the load, so the pair isolates its effect.
+ */
+#define KERNEL_SSE_DEFINE(NAME, LOAD)                                       \
+    KERNEL_STREAM_TARGET                                                    \
+    static long int NAME(const int *data, int length)                       \
+    {                                                                       \
+        long int sum = 0;                                                   \
+        int i = 0;                                                          \
+                                                                            \
+        while (i < length && ((uintptr_t)(data + i) & 15u) != 0) {          \
+            sum += data[i++];                                               \
+        }                                                                   \
+                                                                            \
+        __m128i acc0 = _mm_setzero_si128();                                 \
+        __m128i acc1 = _mm_setzero_si128();                                 \
+        for (; length - i >= 8; i += 8) {                                   \
+            __m128i a = LOAD((__m128i *)(uintptr_t)(data + i));             \
+            __m128i b = LOAD((__m128i *)(uintptr_t)(data + i + 4));         \
+            acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(a));              \
+            acc1 = _mm_add_epi64(acc1,                                      \
+                                 _mm_cvtepi32_epi64(_mm_srli_si128(a, 8))); \
+            acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(b));              \
+            acc1 = _mm_add_epi64(acc1,                                      \
+                                 _mm_cvtepi32_epi64(_mm_srli_si128(b, 8))); \
+        }                                                                   \
+                                                                            \
+        int64_t lanes[2];                                                   \
+        _mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc0, acc1));      \
+        sum += (long int)(lanes[0] + lanes[1]);                             \
+                                                                            \
+        for (; i < length; i++) {                                           \
+            sum += data[i];                                                 \
+        }                                                                   \
+        return sum;                                                         \
+    }
+
+KERNEL_SSE_DEFINE(sum_vector, _mm_load_si128)
+KERNEL_SSE_DEFINE(sum_stream, _mm_stream_load_si128)
+
+/** @brief CPUID.1:ECX[19] = SSE4.1. */
+static bool stream_cpu_ok(void)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+#endif /* KERNEL_HAVE_STREAM */
+
+bool cb_kernel_stream_supported(void)
+{
+#ifdef KERNEL_HAVE_STREAM
+    return stream_cpu_ok();
+#else
+    return false;
+#endif
+}
+
+long int cb_kernel_sum_load(const int *data, int length,
+                            cb_load_kind_t kind, int distance)
+{
+    switch (kind) {
+    case CB_LOAD_PREFETCH:
+        return sum_sweep_t0(data, length, distance);
+    case CB_LOAD_PREFETCH_NTA:
+        return sum_sweep_nta(data, length, distance);
+    case CB_LOAD_VECTOR:
+#ifdef KERNEL_HAVE_STREAM
+        if (stream_cpu_ok()) {
+            return sum_vector(data, length);
+        }
+#endif
+        return sum_sweep_t0(data, length, 0);
+    case CB_LOAD_STREAM:
+#ifdef KERNEL_HAVE_STREAM
+        if (stream_cpu_ok()) {
+            return sum_stream(data, length);
+        }
+#endif
+        return sum_sweep_t0(data, length, 0);
+    default:
+        return sum_sweep_t0(data, length, 0);
+    }
+}
+
+const char *cb_load_kind_name(cb_load_kind_t kind)
+{
+    switch (kind) {
+    case CB_LOAD_PREFETCH:     return "prefetch";
+    case CB_LOAD_PREFETCH_NTA: return "prefetch-nta";
+    case CB_LOAD_VECTOR:       return "vector";
+    case CB_LOAD_STREAM:       return "stream";
+    default:                   return "plain";
+    }
+}
+
+/** @brief Fastest of CB_KERNEL_TUNE_REPS timed runs, in GB/s. */
+static double time_kernel(const cb_sum_kernel_t *k, const int *data,
+                          int length, long int *sum_out)
+{
+    uint64_t best = UINT64_MAX;
+
+    /* Untimed warm-up pulls the data into whatever cache level fits. */
+    *sum_out = k->fn(data, length);
+
+    for (int r = 0; r < CB_KERNEL_TUNE_REPS; r++) {
+        uint64_t t0 = cb_timer_ns();
+        long int sum = k->fn(data, length);
+        uint64_t dt = cb_timer_ns() - t0;
+        if (sum != *sum_out) {
+            return 0.0;
+        }
+        if (dt < best) {
+            best = dt;
+        }
+    }
+
+    if (best == 0) {
+        best = 1;
+    }
+    return (double)length * sizeof(int) / (double)best;
+}
+
+cb_error_t cb_kernel_tune(const int *data, int length)
+{
+    if (!data || length < 1) {
+        return CB_ERR_ARGS;
+    }
+
+    int n = length < CB_KERNEL_TUNE_ELEMS ? length : CB_KERNEL_TUNE_ELEMS;
+    long int expected;
+    double naive = time_kernel(&kernels[0], data, n, &expected);
+    int best = 0;
+    double best_gbps = naive;
+
+    for (int i = 1; i < KERNEL_COUNT; i++) {
+        long int sum;
+        double gbps = time_kernel(&kernels[i], data, n, &sum);
+        if (sum == expected && gbps > best_gbps) {
+            best = i;
+            best_gbps = gbps;
+        }
+    }
+
+    kernel_state.kernel = &kernels[best];
+    kernel_state.origin = CB_KERNEL_TUNED;
+    kernel_state.gbps = best_gbps;
+    kernel_state.naive_gbps = naive;
+    return CB_OK;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file kernel.h
+ * @brief Summation kernel variants and the startup kernel autotuner.
+ *
+ * cb_array_sum() delegates to the active kernel. Every kernel returns
+ * the same sum; they differ only in unroll depth, the number of
+ * independent accumulators (which bounds how many adds are in flight
+ * at once), and an optional software prefetch distance. The variants
+ * are generated at compile time from one macro template.
+ *
+ * The default kernel is the plain one-accumulator loop. The tuner
+ * times every variant on the current host and activates the fastest;
+ * its choice is kept in the host profile so later runs on the same
+ * host and build can skip the tuning pass.
+ */
+
+#ifndef CB_KERNEL_H
+#define CB_KERNEL_H
+
+#include <stdbool.h>
+
+#include "error.h"
+
+/** @brief Elements of the dataset timed per variant while tuning. */
+#define CB_KERNEL_TUNE_ELEMS  (1 << 20)
+
+/** @brief Timed repetitions per variant; the fastest counts. */
+#define CB_KERNEL_TUNE_REPS   5
+
+/** @brief Sum @p length ints starting at @p data. */
+typedef long int (*cb_sum_kernel_fn_t)(const int *data, int length);
+
+/**
+ * @brief One generated kernel variant.
+ */
+typedef struct {
+    const char        *name;          /**< "u<unroll>a<accs>p<prefetch>". */
+    cb_sum_kernel_fn_t fn;            /**< Kernel function. */
+    int                unroll;        /**< Elements per loop iteration. */
+    int                accumulators;  /**< Independent partial sums. */
+    int                prefetch;      /**< Prefetch distance in elements (0 = none). */
+} cb_sum_kernel_t;
+
+/**
+ * @brief How the active kernel was chosen.
+ */
+typedef enum {
+    CB_KERNEL_DEFAULT = 0,  /**< Built-in default (no tuning). */
+    CB_KERNEL_FORCED,       /**< Named explicitly (--kernel). */
+    CB_KERNEL_TUNED,        /**< Timed on this run. */
+    CB_KERNEL_CACHED        /**< Restored from the host profile. */
+} cb_kernel_origin_t;
+
+/**
+ * @brief Outcome of kernel selection, for reporting.
+ */
+typedef struct {
+    const cb_sum_kernel_t *kernel;      /**< Active kernel. */
+    cb_kernel_origin_t     origin;      /**< How it was chosen. */
+    double                 gbps;        /**< Tuned rate of the active kernel (GB/s). */
+    double                 naive_gbps;  /**< Tuned rate of the default kernel (GB/s). */
+} cb_kernel_info_t;
+
+/** @brief Number of generated variants. */
+int cb_kernel_count(void);
+
+/**
+ * @brief Get a variant by index.
+ * @return The variant, or NULL if @p index is out of range.
+ */
+const cb_sum_kernel_t *cb_kernel_get(int index);
+
+/**
+ * @brief Look up a variant by name.
+ * @return The variant, or NULL if no variant has that name.
+ */
+const cb_sum_kernel_t *cb_kernel_find(const char *name);
+
+/**
+ * @brief Activate a variant by name.
+ * @return CB_OK, or CB_ERR_ARGS for an unknown name.
+ */
+cb_error_t cb_kernel_select(const char *name);
+
+/**
+ * @brief Pick the fastest variant for this host and activate it.
+ *
+ * Every variant is timed on up to CB_KERNEL_TUNE_ELEMS elements of
+ * @p data. The choice can be saved in the host profile (profile.h)
+ * and brought back with cb_kernel_restore() on later runs.
+ *
+ * Call before any worker threads or processes exist.
+ *
+ * @param data    Input used for timing (the benchmark dataset).
+ * @param length  Elements available in @p data (>= 1).
+ * @return CB_OK on success, CB_ERR_ARGS on bad arguments.
+ */
+cb_error_t cb_kernel_tune(const int *data, int length);
+
+/**
+ * @brief Activate a previously tuned variant without timing it again.
+ *
+ * @param name        Variant name.
+ * @param gbps        Its tuned rate (GB/s), for reporting.
+ * @param naive_gbps  The default kernel's tuned rate (GB/s).
+ * @return CB_OK, or CB_ERR_ARGS for an unknown name.
+ */
+cb_error_t cb_kernel_restore(const char *name, double gbps, double naive_gbps);
+
+/**
+ * @brief Identify this build of the kernels.
+ *
+ * A tuning result is only valid for the build that produced it; the
+ * host profile stores this string next to the choice.
+ *
+ * @return A static string.
+ */
+const char *cb_kernel_build_id(void);
+
+/**
+ * @brief Sum with the active kernel.
+ */
+long int cb_kernel_sum(const int *data, int length);
+
+/**
+ * @brief Load strategy of the runtime-distance kernels.
+ */
+typedef enum {
+    CB_LOAD_PLAIN = 0,     /**< Ordinary loads, hardware prefetch only. */
+    CB_LOAD_PREFETCH,      /**< Software prefetch into all cache levels. */
+    CB_LOAD_PREFETCH_NTA,  /**< Non-temporal prefetch (minimal cache pollution). */
+    CB_LOAD_VECTOR,        /**< MOVDQA loads, same SSE4.1 loop as CB_LOAD_STREAM. */
+    CB_LOAD_STREAM         /**< MOVNTDQA streaming loads (SSE4.1). */
+} cb_load_kind_t;
+
+/**
+ * @brief Sum with a load strategy chosen at run time.
+ *
+ * A fixed 16-element, 4-accumulator loop, so rows of a prefetch
+ * sweep differ only in how data is loaded. The prefetch kinds issue
+ * one prefetch per 64 bytes, @p distance elements ahead; distance 0
+ * is the same as CB_LOAD_PLAIN. CB_LOAD_VECTOR and CB_LOAD_STREAM
+ * share one SSE4.1 loop (compare them with each other, not with the
+ * scalar kinds), ignore @p distance, and fall back to plain loads when
+ * cb_kernel_stream_supported() is false. Does not affect the active
+ * kernel.
+ *
+ * @param data      Input.
+ * @param length    Elements to sum.
+ * @param kind      Load strategy.
+ * @param distance  Prefetch distance in elements.
+ */
+long int cb_kernel_sum_load(const int *data, int length,
+                            cb_load_kind_t kind, int distance);
+
+/**
+ * @brief True if CB_LOAD_VECTOR and CB_LOAD_STREAM use SSE4.1 on this
+ *        build and CPU.
+ */
+bool cb_kernel_stream_supported(void);
+
+/**
+ * @brief Short name of a load strategy ("plain", "prefetch", ...).
+ */
+const char *cb_load_kind_name(cb_load_kind_t kind);
+
+/**
+ * @brief Get how the active kernel was chosen.
+ * @param info  Output.
+ */
+void cb_kernel_get_info(cb_kernel_info_t *info);
+
+#endif /* CB_KERNEL_H */
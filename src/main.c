@@ -4,9 +4,11 @@
  *
  * Orchestrates the full benchmark pipeline:
  * 1. Parse command-line arguments (including --worker dispatch on Windows).
- * 2. Collect remaining configuration interactively from the user.
+ * 2. Collect remaining configuration interactively from the user, then
+ *    restore host calibration from the saved profile or measure it.
  * 3. Generate the random dataset.
- * 4. Run three benchmark modes: single-threaded, multi-process, multi-thread.
+ * 4. Run three benchmark modes: single-threaded, multi-process, multi-thread,
+ *    followed by any supplementary suites enabled on the command line.
  * 5. Verify correctness (all modes must produce the same sum).
  * 6. Display results on the terminal.
  * 7. Save a text report and CSV file to the results directory.
@@ -20,16 +22,86 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "bench_access.h"
+#include "bench_allreduce.h"
+#include "bench_alloc.h"
+#include "bench_autotune.h"
+#include "bench_barrier.h"
+#include "bench_cluster.h"
+#include "bench_compress.h"
+#include "bench_copy.h"
+#include "bench_fiber.h"
+#include "bench_forkjoin.h"
+#include "bench_gemm.h"
+#include "bench_layout.h"
+#include "bench_mutate.h"
+#include "bench_omp.h"
+#include "bench_prefetch.h"
+#include "bench_reduce.h"
 #include "bench_process.h"
 #include "bench_single.h"
+#include "bench_smt.h"
+#include "bench_sort.h"
+#include "bench_straggler.h"
+#include "bench_tenants.h"
 #include "bench_thread.h"
+#include "bench_write.h"
+#include "cluster.h"
 #include "dataset.h"
 #include "error.h"
 #include "input.h"
+#include "kernel.h"
 #include "output.h"
 #include "platform.h"
+#include "profile.h"
+#include "table.h"
+#include "timer.h"
 #include "types.h"
 
+/**
+ * @brief cgroup throttling counters sampled when a mode or suite starts.
+ */
+typedef struct {
+    bool          known;  /**< cgroup v2 cpu.stat was readable. */
+    cb_cpu_stat_t stat;   /**< Counters at the start. */
+} throttle_mark_t;
+
+/** @brief Sample the throttling counters before a mode or suite. */
+static void throttle_mark(throttle_mark_t *mark)
+{
+    mark->known = cb_cpu_stat_read(&mark->stat) == CB_OK;
+}
+
+/** @brief Store the throttling since @p mark in @p report. */
+static void throttle_report(const throttle_mark_t *mark,
+                            cb_run_report_t *report)
+{
+    cb_cpu_stat_t now;
+
+    report->throttle_known = mark->known && cb_cpu_stat_read(&now) == CB_OK;
+    if (report->throttle_known) {
+        report->periods = now.nr_periods - mark->stat.nr_periods;
+        report->throttled = now.nr_throttled - mark->stat.nr_throttled;
+        report->throttled_sec =
+            (double)(now.throttled_usec - mark->stat.throttled_usec) / 1e6;
+    }
+}
+
+/** @brief Flag a suite table whose run was throttled by the CPU quota. */
+static void throttle_note(const throttle_mark_t *mark, cb_table_t *table)
+{
+    cb_run_report_t r;
+
+    memset(&r, 0, sizeof(r));
+    throttle_report(mark, &r);
+    if (r.throttled > 0) {
+        cb_table_set_warning(table, "THROTTLED: the CPU quota ran out in "
+                             "%llu of %llu periods (%.3f s stalled) while "
+                             "this suite ran; its timings are distorted.",
+                             r.throttled, r.periods, r.throttled_sec);
+    }
+}
+
 int main(int argc, char *argv[])
 {
     cb_error_t err = CB_OK;
@@ -39,6 +111,10 @@ int main(int argc, char *argv[])
     bool is_worker = false;
     int *dataset = NULL;
     char run_dir[CB_MAX_PATH];
+    cb_profile_t profile;
+    cb_profile_status_t profile_status = CB_PROFILE_MISSING;
+    throttle_mark_t mark;
+    bool profile_dirty = false;
 
     memset(&config, 0, sizeof(config));
     memset(&session, 0, sizeof(session));
@@ -55,6 +131,9 @@ int main(int argc, char *argv[])
     /* ---- Step 2: Windows worker dispatch ---- */
 #ifdef _WIN32
     if (is_worker) {
+        if (config.kernel_name[0]) {
+            cb_kernel_select(config.kernel_name);
+        }
         return cb_bench_process_worker_main(&worker_args);
     }
 #else
@@ -65,6 +144,15 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    /* A cluster node needs no dataset or prompts: it serves jobs. */
+    if (config.cluster_worker) {
+        if (config.kernel_name[0]) {
+            cb_kernel_select(config.kernel_name);
+        }
+        return cb_cluster_node_main(config.cluster_host, config.cluster_port,
+                                    config.verbose);
+    }
+
     /* ---- Step 3: Interactive input for remaining config ---- */
     fprintf(stdout, "concur-bench - Concurrency Benchmark Tool\n");
     fprintf(stdout, "==========================================\n\n");
@@ -75,6 +163,29 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    /* Calibration is per host; reuse the saved profile when it matches. */
+    if (config.recalibrate) {
+        err = cb_profile_init(&profile);
+    } else {
+        err = cb_profile_load(CB_PROFILE_FILE, &profile, &profile_status);
+    }
+    if (err) {
+        cb_perror("host profile", err);
+        return 1;
+    }
+
+    if (!profile.has_timer ||
+        cb_timer_restore(config.use_tsc, &profile.timer) != CB_OK) {
+        if (cb_timer_init(config.use_tsc) != CB_OK) {
+            fprintf(stderr, "concur-bench: invariant TSC not available; "
+                            "timing with the monotonic clock\n");
+            config.use_tsc = false;
+        }
+        cb_timer_get_info(&profile.timer);
+        profile.has_timer = true;
+        profile_dirty = true;
+    }
+
     /* ---- Step 4: Generate dataset ---- */
     fprintf(stdout, "\n");
     err = cb_dataset_create(&config, &dataset, config.verbose);
@@ -83,6 +194,51 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (config.kernel_name[0]) {
+        cb_kernel_select(config.kernel_name);
+    } else if (config.tune_kernel &&
+               (!profile.has_kernel ||
+                cb_kernel_restore(profile.kernel_name, profile.kernel_gbps,
+                                  profile.kernel_naive_gbps) != CB_OK)) {
+        fprintf(stdout, "Tuning sum kernel (%d variants)...\n",
+                cb_kernel_count());
+        err = cb_kernel_tune(dataset, config.array_length);
+        if (err) {
+            cb_perror("kernel tuning", err);
+            goto cleanup;
+        }
+
+        cb_kernel_info_t kinfo;
+        cb_kernel_get_info(&kinfo);
+        snprintf(profile.kernel_name, sizeof(profile.kernel_name), "%s",
+                 kinfo.kernel->name);
+        snprintf(profile.kernel_build, sizeof(profile.kernel_build), "%s",
+                 cb_kernel_build_id());
+        profile.kernel_gbps = kinfo.gbps;
+        profile.kernel_naive_gbps = kinfo.naive_gbps;
+        profile.has_kernel = true;
+        profile_dirty = true;
+    }
+
+    if (!profile_dirty) {
+        snprintf(session.profile_info, sizeof(session.profile_info),
+                 "loaded from %s", CB_PROFILE_FILE);
+    } else {
+        const char *why = config.recalibrate ? "recalibrated"
+                        : profile_status == CB_PROFILE_LOADED ? "extended"
+                        : profile_status == CB_PROFILE_STALE ? "host changed"
+                        : "new";
+        /* A profile that cannot be written only costs the next run time. */
+        bool saved = cb_profile_save(CB_PROFILE_FILE, &profile) == CB_OK;
+        if (!saved) {
+            fprintf(stderr, "concur-bench: could not save host profile "
+                            "to %s\n", CB_PROFILE_FILE);
+        }
+        snprintf(session.profile_info, sizeof(session.profile_info),
+                 "%s, %s %s", why, saved ? "saved to" : "could not save",
+                 CB_PROFILE_FILE);
+    }
+
     /* ---- Step 5: Populate session metadata ---- */
     session.config = config;
     cb_system_info_str(session.system_info, sizeof(session.system_info));
@@ -91,31 +247,405 @@ int main(int argc, char *argv[])
     /* ---- Step 6: Run benchmarks ---- */
     fprintf(stdout, "\nRunning single-threaded benchmark (%d iteration%s)...\n",
             config.iterations, config.iterations == 1 ? "" : "s");
+    throttle_mark(&mark);
     err = cb_bench_single_run(dataset, &config, &session.single);
     if (err) {
         cb_perror("single-threaded benchmark", err);
         goto cleanup;
     }
+    throttle_report(&mark, &session.single);
 
     fprintf(stdout, "Running multi-process benchmark (%d process%s, "
             "%d iteration%s)...\n",
             config.num_processes, config.num_processes == 1 ? "" : "es",
             config.iterations, config.iterations == 1 ? "" : "s");
+    throttle_mark(&mark);
     err = cb_bench_process_run(dataset, &config, &session.process);
     if (err) {
         cb_perror("multi-process benchmark", err);
         goto cleanup;
     }
+    throttle_report(&mark, &session.process);
 
     fprintf(stdout, "Running multi-threaded benchmark (%d thread%s, "
             "%d iteration%s)...\n",
             config.num_threads, config.num_threads == 1 ? "" : "s",
             config.iterations, config.iterations == 1 ? "" : "s");
+    throttle_mark(&mark);
     err = cb_bench_thread_run(dataset, &config, &session.thread);
     if (err) {
         cb_perror("multi-threaded benchmark", err);
         goto cleanup;
     }
+    throttle_report(&mark, &session.thread);
+
+    if (config.run_barrier) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running barrier suite (%d iteration%s per point)...\n",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_barrier_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("barrier suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_sort) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running sort workload (%d iteration%s per mode)...\n",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_sort_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("sort workload", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_gemm) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running gemm workload (n=%d, %d iteration%s per mode)...\n",
+                config.gemm_size, config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_gemm_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("gemm workload", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_alloc) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running alloc workload (%d thread%s, %d iteration%s "
+                "per row)...\n",
+                config.num_threads, config.num_threads == 1 ? "" : "s",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_alloc_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("alloc workload", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_fiber) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running fiber mode (%d task%s on %d thread%s, "
+                "%d iteration%s)...\n",
+                config.fiber_tasks, config.fiber_tasks == 1 ? "" : "s",
+                config.num_threads, config.num_threads == 1 ? "" : "s",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_fiber_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("fiber mode", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_forkjoin) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running fork-join mode (%d worker%s, %d iteration%s "
+                "per grain)...\n",
+                config.num_threads, config.num_threads == 1 ? "" : "s",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_forkjoin_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("fork-join mode", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_omp) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running OpenMP comparison (%d thread%s, %d iteration%s "
+                "per mode)...\n",
+                config.num_threads, config.num_threads == 1 ? "" : "s",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_omp_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("OpenMP comparison", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_reduce) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running reduce suite (%d iteration%s per row)...\n",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_reduce_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("reduce suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_autotune) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running configuration autotune...\n");
+        throttle_mark(&mark);
+        err = cb_bench_autotune_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("autotune", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_prefetch) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running prefetch sweep (%d iteration%s per row)...\n",
+                config.iterations, config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_prefetch_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("prefetch sweep", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_access) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running access-pattern suite (%d iteration%s per "
+                "row)...\n", config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_access_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("access-pattern suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_smt) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running SMT sibling suite (%d iteration%s per "
+                "row)...\n", config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_smt_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("SMT suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_compress) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running compressed scan (%d iteration%s per "
+                "row)...\n", config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_compress_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("compressed scan", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_layout) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running record-layout suite (%d iteration%s per "
+                "row)...\n", config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_layout_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("record-layout suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_cluster) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running cluster mode with %d node%s (%d iteration%s "
+                "per row)...\n", config.cluster_nodes,
+                config.cluster_nodes == 1 ? "" : "s", config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_cluster_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("cluster mode", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_allreduce) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running allreduce suite (%d iteration%s per "
+                "row)...\n", config.iterations,
+                config.iterations == 1 ? "" : "s");
+        throttle_mark(&mark);
+        err = cb_bench_allreduce_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("allreduce suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_straggler) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running straggler suite...\n");
+        throttle_mark(&mark);
+        err = cb_bench_straggler_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("straggler suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_mutate) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running mutating workload...\n");
+        throttle_mark(&mark);
+        err = cb_bench_mutate_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("mutating workload", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_tenants) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running multi-tenant suite...\n");
+        throttle_mark(&mark);
+        err = cb_bench_tenants_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("multi-tenant suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_write) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running write-heavy suite...\n");
+        throttle_mark(&mark);
+        err = cb_bench_write_run(dataset, &config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("write-heavy suite", err);
+            goto cleanup;
+        }
+    }
+
+    if (config.run_copy) {
+        cb_table_t *table = NULL;
+
+        fprintf(stdout, "Running copy suite...\n");
+        throttle_mark(&mark);
+        err = cb_bench_copy_run(&config, &table);
+        if (!err) {
+            throttle_note(&mark, table);
+            err = cb_table_attach(&session, table);
+        }
+        if (err) {
+            cb_perror("copy suite", err);
+            goto cleanup;
+        }
+    }
 
     /* ---- Step 7: Display results ---- */
     cb_output_terminal(&session);
@@ -144,6 +674,7 @@ int main(int argc, char *argv[])
     }
 
 cleanup:
+    cb_table_release_all(&session);
     cb_dataset_destroy(dataset);
     return (err != CB_OK) ? 1 : 0;
 }
@@ -17,7 +17,11 @@
 #include <string.h>
 #include <time.h>
 
+#include "bench_omp.h"
+#include "kernel.h"
 #include "platform.h"
+#include "table.h"
+#include "timer.h"
 
 /** @brief Separator line for the results table. */
 #define TABLE_SEP \
@@ -27,6 +31,112 @@
 #define TABLE_HDR \
     "| Mode      | Workers | Min (s)    | Mean (s)   | Max (s)    | Stddev (s) | Speedup |"
 
+/**
+ * @brief Print the active timer and its measured resolution and overhead.
+ */
+static void print_timer(FILE *f)
+{
+    cb_timer_info_t t;
+    cb_timer_get_info(&t);
+
+    if (t.source == CB_TIMER_TSC) {
+        fprintf(f, "  Timer:           tsc @ %.3f GHz, resolution %.0f ns, "
+                "overhead %.1f ns/call%s\n", t.tsc_ghz, t.resolution_ns,
+                t.overhead_ns, t.from_profile ? " (profile)" : "");
+        fprintf(f, "  Monotonic clock: resolution %.0f ns, overhead %.1f ns/call\n",
+                t.mono_resolution_ns, t.mono_overhead_ns);
+    } else {
+        fprintf(f, "  Timer:           monotonic, resolution %.0f ns, "
+                "overhead %.1f ns/call%s\n", t.mono_resolution_ns,
+                t.mono_overhead_ns, t.from_profile ? " (profile)" : "");
+    }
+}
+
+/**
+ * @brief Print the active sum kernel and how it was chosen.
+ */
+static void print_kernel(FILE *f)
+{
+    cb_kernel_info_t k;
+    cb_kernel_get_info(&k);
+
+    switch (k.origin) {
+    case CB_KERNEL_TUNED:
+    case CB_KERNEL_CACHED:
+        fprintf(f, "  Sum kernel:      %s (%s: %.2f GB/s vs %.2f GB/s "
+                "for u1a1p0)\n", k.kernel->name,
+                k.origin == CB_KERNEL_TUNED ? "tuned" : "profile",
+                k.gbps, k.naive_gbps);
+        break;
+    case CB_KERNEL_FORCED:
+        fprintf(f, "  Sum kernel:      %s (--kernel)\n", k.kernel->name);
+        break;
+    default:
+        fprintf(f, "  Sum kernel:      %s (default)\n", k.kernel->name);
+        break;
+    }
+}
+
+/**
+ * @brief Print the CPU budget and the limits it was derived from.
+ */
+static void print_cpu_budget(FILE *f, const cb_config_t *c)
+{
+    cb_cpu_limits_t l;
+    char quota[32] = "none", cpuset[16] = "n/a";
+
+    cb_cpu_limits(&l);
+    if (l.quota > 0.0) {
+        snprintf(quota, sizeof(quota), "%.2f CPUs", l.quota);
+    }
+    if (l.cpuset > 0) {
+        snprintf(cpuset, sizeof(cpuset), "%d", l.cpuset);
+    }
+    fprintf(f, "  CPU budget:      %d of %d cores (cpu.max %s, cpuset %s, "
+            "affinity %d)\n", l.budget, l.online, quota, cpuset, l.affinity);
+
+    int most = c->num_threads > c->num_processes ? c->num_threads
+                                                 : c->num_processes;
+    if (most > l.budget) {
+        fprintf(f, "  Warning:         %d workers exceed the CPU budget; "
+                "expect throttling or time-slicing\n", most);
+    }
+}
+
+/**
+ * @brief Flag core modes that were throttled by the CPU quota.
+ *
+ * Prints nothing when cgroup v2 throttling counters are unavailable.
+ *
+ * @param f        File stream.
+ * @param session  Complete benchmark session.
+ */
+static void print_throttle(FILE *f, const cb_session_t *session)
+{
+    const cb_run_report_t *reports[] = {
+        &session->single, &session->process, &session->thread
+    };
+    bool known = false, any = false;
+
+    for (int i = 0; i < 3; i++) {
+        const cb_run_report_t *r = reports[i];
+        if (!r->throttle_known) {
+            continue;
+        }
+        known = true;
+        if (r->throttled > 0) {
+            fprintf(f, "%sTHROTTLED: %s mode hit the CPU quota in %llu of "
+                    "%llu periods (%.3f s stalled); its timings are "
+                    "distorted.\n", any ? "" : "\n", r->label, r->throttled,
+                    r->periods, r->throttled_sec);
+            any = true;
+        }
+    }
+    if (known && !any) {
+        fprintf(f, "\nThrottling: none (cgroup cpu.stat)\n");
+    }
+}
+
 /**
  * @brief Print a single row of the results table.
  *
@@ -72,6 +182,20 @@ static void print_table(FILE *f, const cb_session_t *session)
     fprintf(f, "%s\n", TABLE_SEP);
 }
 
+/**
+ * @brief Print every supplementary suite table, each preceded by a blank line.
+ *
+ * @param f        File stream.
+ * @param session  Complete benchmark session.
+ */
+static void print_suite_tables(FILE *f, const cb_session_t *session)
+{
+    for (int i = 0; i < session->num_tables; i++) {
+        fprintf(f, "\n");
+        cb_table_print(f, session->tables[i]);
+    }
+}
+
 /**
  * @brief Print the configuration summary to a file stream.
  *
@@ -89,6 +213,135 @@ static void print_config(FILE *f, const cb_session_t *session)
     fprintf(f, "  Seed:            %u\n", c->seed);
     fprintf(f, "  Iterations:      %d\n", c->iterations);
     fprintf(f, "  Verbose:         %s\n", c->verbose ? "yes" : "no");
+    print_timer(f);
+    print_kernel(f);
+    fprintf(f, "  Host profile:    %s\n", session->profile_info);
+    print_cpu_budget(f, c);
+    if (c->run_barrier) {
+        fprintf(f, "  Barrier suite:   yes (max %d episodes)\n",
+                c->barrier_episodes);
+    }
+    if (c->run_sort) {
+        fprintf(f, "  Sort workload:   yes\n");
+    }
+    if (c->run_gemm) {
+        fprintf(f, "  GEMM workload:   n=%d, tiles %d,%d,%d\n",
+                c->gemm_size, c->gemm_mc, c->gemm_kc, c->gemm_nc);
+    }
+    if (c->run_alloc) {
+        fprintf(f, "  Alloc workload:  %d ops/thread, pattern %s\n",
+                c->alloc_ops, c->alloc_pattern[0] ? c->alloc_pattern : "all");
+    }
+    if (c->run_fiber) {
+        fprintf(f, "  Fiber mode:      %d tasks, yield every %d elements\n",
+                c->fiber_tasks, c->fiber_yield);
+    }
+    if (c->run_forkjoin) {
+        if (c->forkjoin_grain > 0) {
+            fprintf(f, "  Fork-join mode:  grain %d\n", c->forkjoin_grain);
+        } else {
+            fprintf(f, "  Fork-join mode:  grain sweep from %d\n",
+                    CB_FORKJOIN_MIN_GRAIN);
+        }
+    }
+    if (c->run_omp) {
+        fprintf(f, "  OpenMP modes:    %s\n",
+                cb_bench_omp_available() ? "yes" : "not built");
+    }
+    if (c->run_reduce) {
+        fprintf(f, "  Reduce suite:    yes\n");
+    }
+    if (c->run_autotune) {
+        fprintf(f, "  Autotune:        yes\n");
+    }
+    if (c->run_prefetch) {
+        if (c->prefetch_distance > 0) {
+            fprintf(f, "  Prefetch sweep:  distance %d elements\n",
+                    c->prefetch_distance);
+        } else {
+            fprintf(f, "  Prefetch sweep:  distances from %d elements\n",
+                    CB_PREFETCH_MIN_DISTANCE);
+        }
+    }
+    if (c->run_access) {
+        if (c->access_stride > 0) {
+            fprintf(f, "  Access patterns: stride %d elements\n",
+                    c->access_stride);
+        } else {
+            fprintf(f, "  Access patterns: yes\n");
+        }
+    }
+    if (c->run_smt) {
+        fprintf(f, "  SMT suite:       antagonists %s\n",
+                c->smt_antagonist[0] ? c->smt_antagonist : "all");
+    }
+    if (c->run_compress) {
+        fprintf(f, "  Compressed scan: yes\n");
+    }
+    if (c->run_layout) {
+        fprintf(f, "  Record layouts:  %d fields (", c->layout_fields);
+        for (int i = 0; i < c->layout_fields; i++) {
+            fprintf(f, "%s%d", i ? "," : "", c->layout_width[i]);
+        }
+        fprintf(f, " bytes), summing ");
+        if (c->layout_touch) {
+            bool first = true;
+            for (int i = 0; i < c->layout_fields; i++) {
+                if (c->layout_touch & (1u << i)) {
+                    fprintf(f, "%s%d", first ? "" : ",", i);
+                    first = false;
+                }
+            }
+            fprintf(f, "\n");
+        } else {
+            fprintf(f, "first and middle\n");
+        }
+    }
+    if (c->run_cluster) {
+        fprintf(f, "  Cluster:         %d node%s, ", c->cluster_nodes,
+                c->cluster_nodes == 1 ? "" : "s");
+        if (c->cluster_local) {
+            fprintf(f, "spawned on 127.0.0.1\n");
+        } else {
+            fprintf(f, "port %d\n", c->cluster_port ? c->cluster_port
+                                                    : CB_DEFAULT_CLUSTER_PORT);
+        }
+    }
+    if (c->run_allreduce) {
+        fprintf(f, "  Allreduce:       8 B - %d B per vector, %d processes\n",
+                c->allreduce_max, c->num_processes);
+    }
+    if (c->run_straggler) {
+        fprintf(f, "  Stragglers:      backup after %.2f x median",
+                c->straggler_k);
+        if (c->straggler_delay_ms) {
+            fprintf(f, ", %d ms injected\n", c->straggler_delay_ms);
+        } else {
+            fprintf(f, ", nothing injected\n");
+        }
+    }
+    if (c->run_mutate) {
+        if (c->mutate_rate > 0.0) {
+            fprintf(f, "  Mutation:        %g%% of elements per iteration\n",
+                    c->mutate_rate);
+        } else {
+            fprintf(f, "  Mutation:        sweep 0.001%% - 10%%\n");
+        }
+    }
+    if (c->run_tenants) {
+        fprintf(f, "  Tenants:         %d x %d threads, placement %s\n",
+                c->tenants, c->num_threads,
+                c->tenant_cpus[0] ? c->tenant_cpus : "all");
+    }
+    if (c->run_write) {
+        fprintf(f, "  Write suite:     transform and triad, regular and "
+                "non-temporal stores\n");
+    }
+    if (c->run_copy) {
+        fprintf(f, "  Copy suite:      64 B - %d MiB total, 1 - %d threads, "
+                "offsets +%d / +%d B\n", c->copy_max_mib, c->num_threads,
+                c->copy_src_align, c->copy_dst_align);
+    }
 }
 
 void cb_output_terminal(const cb_session_t *session)
@@ -105,6 +358,7 @@ void cb_output_terminal(const cb_session_t *session)
     fprintf(stdout, "\n");
 
     print_table(stdout, session);
+    print_throttle(stdout, session);
 
     /* Correctness check. */
     if (session->single.sum == session->process.sum &&
@@ -117,6 +371,8 @@ void cb_output_terminal(const cb_session_t *session)
         fprintf(stdout, "  process: %ld\n", session->process.sum);
         fprintf(stdout, "  thread:  %ld\n", session->thread.sum);
     }
+
+    print_suite_tables(stdout, session);
 }
 
 cb_error_t cb_output_create_run_dir(const char *base_dir,
@@ -166,6 +422,7 @@ cb_error_t cb_output_txt_report(const cb_session_t *session,
 
     fprintf(f, "Results:\n\n");
     print_table(f, session);
+    print_throttle(f, session);
 
     /* Speedup analysis. */
     double base_mean = session->single.stats.mean_sec;
@@ -191,6 +448,8 @@ cb_error_t cb_output_txt_report(const cb_session_t *session,
         fprintf(f, "    thread:  %ld\n", session->thread.sum);
     }
 
+    print_suite_tables(f, session);
+
     fclose(f);
     return CB_OK;
 }
@@ -216,7 +475,8 @@ cb_error_t cb_output_csv(const cb_session_t *session,
 
     /* Header row. */
     fprintf(f, "mode,workers,iterations,min_sec,mean_sec,max_sec,"
-               "stddev_sec,sum,speedup,array_length,seed\n");
+               "stddev_sec,sum,speedup,array_length,seed,"
+               "throttled_periods,throttled_sec\n");
 
     double base_mean = session->single.stats.mean_sec;
     const cb_run_report_t *reports[] = {
@@ -228,7 +488,7 @@ cb_error_t cb_output_csv(const cb_session_t *session,
         double speedup = (base_mean > 0.0)
             ? base_mean / r->stats.mean_sec : 0.0;
 
-        fprintf(f, "%s,%d,%d,%.9f,%.9f,%.9f,%.9f,%ld,%.4f,%d,%u\n",
+        fprintf(f, "%s,%d,%d,%.9f,%.9f,%.9f,%.9f,%ld,%.4f,%d,%u,",
                 r->label,
                 r->parallelism,
                 r->stats.iterations,
@@ -240,9 +500,24 @@ cb_error_t cb_output_csv(const cb_session_t *session,
                 speedup,
                 session->config.array_length,
                 session->config.seed);
+        /* Throttling columns stay empty without cgroup v2 counters. */
+        if (r->throttle_known) {
+            fprintf(f, "%llu,%.6f\n", r->throttled, r->throttled_sec);
+        } else {
+            fprintf(f, ",\n");
+        }
     }
 
     fclose(f);
+
+    /* One additional CSV per supplementary suite table. */
+    for (int i = 0; i < session->num_tables; i++) {
+        cb_error_t err = cb_table_write_csv(session->tables[i], dir_path);
+        if (err) {
+            return err;
+        }
+    }
+
     return CB_OK;
 }
 
@@ -23,9 +23,9 @@
  * (single, process, thread), showing worker count, min/mean/max/stddev
  * timing, and speedup relative to the single-threaded baseline.
  *
- * Also prints a configuration summary, system information, and a
+ * Also prints a configuration summary, system information, a
  * correctness verification note (whether all three modes produced
- * the same sum).
+ * the same sum), and every supplementary suite table in the session.
  *
  * @param session  Complete benchmark session results.
  */
@@ -53,7 +53,8 @@ cb_error_t cb_output_create_run_dir(const char *base_dir,
  *
  * Creates "report.txt" in the specified directory, containing:
  * system information, full configuration dump, the results table,
- * correctness verification, and speedup analysis.
+ * correctness verification, speedup analysis, and every supplementary
+ * suite table in the session.
  *
  * @param session   Complete benchmark session results.
  * @param dir_path  Directory to write the report file into.
@@ -69,6 +70,9 @@ cb_error_t cb_output_txt_report(const cb_session_t *session,
  * mode, workers, iterations, min_sec, mean_sec, max_sec, stddev_sec,
  * sum, speedup, array_length, seed
  *
+ * Each supplementary suite table is additionally written to
+ * "<table name>.csv" in the same directory.
+ *
  * @param session   Complete benchmark session results.
  * @param dir_path  Directory to write the CSV file into.
  * @return CB_OK on success, CB_ERR_IO if file creation fails.
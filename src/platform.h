@@ -4,7 +4,9 @@
  *
  * Provides unified types and function signatures for operations that
  * differ between Unix and Windows: high-resolution timing, threads,
- * mutexes, pipes, process spawning, shared memory, and system queries.
+ * mutexes, low-level wait/wake primitives, native barriers, pipes,
+ * process spawning, shared memory, TCP sockets, aligned allocation, and
+ * system queries.
  *
  * Implementations reside in platform_unix.c and platform_win.c; only
  * one is compiled per target via CMake. All platform-specific headers
@@ -18,6 +20,7 @@
 #ifndef CB_PLATFORM_H
 #define CB_PLATFORM_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -81,16 +84,54 @@ typedef struct {
  * @brief Opaque shared memory region.
  *
  * Used on Windows for the process benchmark (CreateFileMapping +
- * MapViewOfFile). On Unix, fork() provides implicit memory sharing
- * via copy-on-write, so this type is typically unused.
+ * MapViewOfFile). On Unix (shm_open + mmap), the dataset itself is
+ * shared via fork() copy-on-write; shared memory is used for state
+ * that children must write, such as process-shared barriers.
  *
  * @note base_addr is exposed for direct pointer access after mapping.
  */
 typedef struct {
     void    *base_addr;   /**< Pointer to the mapped memory region. */
-    uint8_t  _opaque[40]; /**< Platform-specific handles and metadata. */
+    uint8_t  _opaque[96]; /**< Platform-specific handles, size, and name. */
 } cb_shared_mem_t;
 
+/**
+ * @brief Opaque TCP socket.
+ *
+ * Unix: wraps an int file descriptor (4 bytes).
+ * Windows: wraps a SOCKET (8 bytes on 64-bit).
+ */
+typedef struct {
+    uint8_t _opaque[16];
+} cb_socket_t;
+
+/**
+ * @brief Opaque native (OS-provided) barrier.
+ *
+ * Unix: wraps pthread_barrier_t (32 bytes on 64-bit Linux).
+ * Windows: wraps SYNCHRONIZATION_BARRIER (32 bytes on 64-bit Windows).
+ */
+typedef struct {
+    uint8_t _opaque[64];
+} cb_native_barrier_t;
+
+/**
+ * @brief Opaque user-level execution context (fiber).
+ *
+ * Unix: a ucontext_t plus an mmap'd stack with a guard page.
+ * Windows: a Win32 fiber. Heap-allocated because ucontext_t varies
+ * widely in size between systems.
+ */
+typedef struct cb_fiber cb_fiber_t;
+
+/**
+ * @brief Function signature for fiber entry points.
+ *
+ * The function must never return; it finishes by switching to another
+ * fiber, and is destroyed while suspended.
+ */
+typedef void (*cb_fiber_fn_t)(void *arg);
+
 /** @brief Function signature for thread entry points. */
 typedef void *(*cb_thread_fn_t)(void *arg);
 
@@ -116,6 +157,26 @@ typedef void (*cb_child_fn_t)(void *arg);
  */
 double cb_time_now(void);
 
+/**
+ * @brief Return the same monotonic clock as cb_time_now() in integer
+ *        nanoseconds.
+ *
+ * Integer nanoseconds keep full precision at any uptime, where a double
+ * of seconds loses sub-microsecond digits after a few weeks.
+ *
+ * @return Nanoseconds since an arbitrary epoch, or 0 on error.
+ */
+uint64_t cb_time_now_ns(void);
+
+/**
+ * @brief Sleep the calling thread for at least @p ms milliseconds.
+ *
+ * Resumes the sleep after signal interruptions on Unix.
+ *
+ * @param ms  Milliseconds to sleep.
+ */
+void cb_sleep_ms(unsigned int ms);
+
 /* ---- Mutex ---- */
 
 /**
@@ -146,6 +207,79 @@ cb_error_t cb_mutex_unlock(cb_mutex_t *mtx);
  */
 void cb_mutex_destroy(cb_mutex_t *mtx);
 
+/* ---- Wait / Wake Primitives ---- */
+
+/**
+ * @brief Hint to the CPU that the caller is in a spin-wait loop.
+ *
+ * Emits PAUSE on x86 and YIELD on AArch64; a no-op elsewhere. Reduces
+ * power and pipeline flush cost while spinning, and yields execution
+ * resources to an SMT sibling.
+ */
+void cb_cpu_relax(void);
+
+/**
+ * @brief Give up the remainder of the caller's time slice.
+ *
+ * Uses sched_yield() on Unix and SwitchToThread() on Windows.
+ */
+void cb_thread_yield(void);
+
+/**
+ * @brief Sleep until the 32-bit word at @p addr is woken or changes.
+ *
+ * Returns immediately if *addr != expected. May return spuriously, so
+ * callers must re-check their condition in a loop.
+ *
+ * Linux: futex(FUTEX_WAIT), private unless @p process_shared.
+ * Windows: WaitOnAddress() for thread-local words; yields otherwise.
+ * Other Unix: falls back to cb_thread_yield().
+ *
+ * @param addr            Address of a naturally aligned 32-bit word.
+ * @param expected        Value the caller last observed at @p addr.
+ * @param process_shared  True if @p addr lives in cross-process shared memory.
+ */
+void cb_futex_wait(void *addr, uint32_t expected, bool process_shared);
+
+/**
+ * @brief Wake up to @p count waiters sleeping on @p addr.
+ *
+ * @param addr            Address previously passed to cb_futex_wait().
+ * @param count           Maximum waiters to wake (INT32_MAX for all).
+ * @param process_shared  Must match the value used by the waiters.
+ */
+void cb_futex_wake(void *addr, int count, bool process_shared);
+
+/* ---- Native Barrier ---- */
+
+/**
+ * @brief Initialize an OS-provided barrier for @p count participants.
+ *
+ * When @p process_shared is true, the barrier must reside in shared
+ * memory mapped by every participating process (Unix only).
+ *
+ * @param barrier         Barrier to initialize.
+ * @param count           Number of participants (>= 1).
+ * @param process_shared  Allow use across processes.
+ * @return CB_OK on success, CB_ERR_PLATFORM if unsupported or on failure.
+ */
+cb_error_t cb_native_barrier_init(cb_native_barrier_t *barrier,
+                                  unsigned int count,
+                                  bool process_shared);
+
+/**
+ * @brief Block until all participants have reached the barrier.
+ * @param barrier  Initialized barrier.
+ * @return CB_OK on success, CB_ERR_PLATFORM on failure.
+ */
+cb_error_t cb_native_barrier_wait(cb_native_barrier_t *barrier);
+
+/**
+ * @brief Destroy a barrier initialized with cb_native_barrier_init().
+ * @param barrier  Barrier to destroy. No participant may be waiting.
+ */
+void cb_native_barrier_destroy(cb_native_barrier_t *barrier);
+
 /* ---- Threads ---- */
 
 /**
@@ -170,6 +304,67 @@ cb_error_t cb_thread_create(cb_thread_t *thread, cb_thread_fn_t fn, void *arg);
  */
 cb_error_t cb_thread_join(cb_thread_t *thread);
 
+/**
+ * @brief Restrict the calling thread to one logical CPU.
+ *
+ * Uses sched_setaffinity() on Linux and SetThreadAffinityMask() on
+ * Windows (CPUs 0 - 63 of the current processor group). In a forked
+ * child this pins the whole (single-threaded) process.
+ *
+ * @param cpu  Logical CPU index (0 .. cb_cpu_count() - 1).
+ * @return CB_OK on success, CB_ERR_ARGS for a bad index, or
+ *         CB_ERR_PLATFORM if pinning is unsupported or refused.
+ */
+cb_error_t cb_thread_pin_self(int cpu);
+
+/* ---- Fibers ---- */
+
+/**
+ * @brief Turn the calling thread into a fiber so it can switch to others.
+ *
+ * Must be called once on each thread before cb_fiber_switch() and
+ * paired with cb_fiber_thread_exit() on the same thread.
+ *
+ * @param out  Output: a fiber representing the calling thread.
+ * @return CB_OK on success, CB_ERR_ALLOC or CB_ERR_PLATFORM on failure.
+ */
+cb_error_t cb_fiber_thread_enter(cb_fiber_t **out);
+
+/**
+ * @brief Undo cb_fiber_thread_enter() and free the thread's fiber.
+ * @param self  Fiber returned by cb_fiber_thread_enter() on this thread.
+ */
+void cb_fiber_thread_exit(cb_fiber_t *self);
+
+/**
+ * @brief Create a suspended fiber that will run fn(arg) on its own stack.
+ *
+ * @param out         Output: the new fiber.
+ * @param stack_size  Stack size in bytes (rounded up to whole pages).
+ * @param fn          Entry point; must never return.
+ * @param arg         Argument passed to @p fn.
+ * @return CB_OK on success, CB_ERR_ALLOC or CB_ERR_PLATFORM on failure.
+ */
+cb_error_t cb_fiber_create(cb_fiber_t **out, size_t stack_size,
+                           cb_fiber_fn_t fn, void *arg);
+
+/**
+ * @brief Save the running context into @p from and resume @p to.
+ *
+ * A fiber may be resumed on a different thread than the one that
+ * suspended it, but never on two threads at once.
+ *
+ * @param from  The currently running fiber.
+ * @param to    Fiber to resume.
+ */
+void cb_fiber_switch(cb_fiber_t *from, cb_fiber_t *to);
+
+/**
+ * @brief Destroy a suspended fiber created by cb_fiber_create().
+ * @param fiber  Fiber to destroy, or NULL (no-op).
+ */
+void cb_fiber_destroy(cb_fiber_t *fiber);
+
 /* ---- Pipes ---- */
 
 /**
@@ -219,6 +414,24 @@ cb_error_t cb_pipe_close_read(cb_pipe_t *p);
  */
 cb_error_t cb_pipe_close_write(cb_pipe_t *p);
 
+/**
+ * @brief Wait until one of several pipes can be read without blocking.
+ *
+ * A pipe counts as readable when it holds data or its write end has
+ * been closed by every holder (a read then reports end of file).
+ *
+ * @param pipes       Pipes to watch (read ends open); NULL entries are
+ *                    skipped.
+ * @param count       Number of entries in @p pipes.
+ * @param timeout_ms  Longest wait in milliseconds; negative waits forever.
+ * @param ready       Output: index of a readable pipe.
+ * @return CB_OK if a pipe is readable, CB_ERR_TIMEOUT if none became
+ *         readable in time, CB_ERR_ARGS if no pipe is given,
+ *         CB_ERR_ALLOC or CB_ERR_PIPE on failure.
+ */
+cb_error_t cb_pipe_wait_any(cb_pipe_t *const *pipes, int count,
+                            int timeout_ms, int *ready);
+
 /* ---- Process Spawning ---- */
 
 /**
@@ -268,14 +481,36 @@ cb_error_t cb_process_kill(cb_process_t *proc);
  */
 uint32_t cb_process_get_id(const cb_process_t *proc);
 
+/**
+ * @brief Get the numeric process ID of the calling process.
+ *
+ * Used to derive unique names for shared memory segments.
+ *
+ * @return getpid() on Unix, GetCurrentProcessId() on Windows.
+ */
+uint32_t cb_process_self_id(void);
+
+/**
+ * @brief Get the resident set size of the calling process.
+ *
+ * Reads /proc/self/statm on Linux and GetProcessMemoryInfo() on
+ * Windows. Other systems do not expose the current (as opposed to
+ * peak) RSS portably and report CB_ERR_PLATFORM.
+ *
+ * @param bytes  Output: resident set size in bytes.
+ * @return CB_OK on success, CB_ERR_PLATFORM if unavailable.
+ */
+cb_error_t cb_process_rss(size_t *bytes);
+
 /* ---- Shared Memory ---- */
 
 /**
  * @brief Create a named shared memory region.
  *
- * Allocates a shared memory segment accessible by name from other
- * processes. After creation, cb_shared_mem_ptr() returns a pointer
- * to the mapped memory.
+ * Allocates a zero-filled shared memory segment accessible by name from
+ * other processes. After creation, cb_shared_mem_ptr() returns a pointer
+ * to the mapped memory. On Unix the mapping is also inherited by
+ * children created with cb_process_spawn().
  *
  * @param shm   Output handle, filled on success.
  * @param name  Unique name for the shared memory segment.
@@ -317,18 +552,181 @@ void *cb_shared_mem_ptr(cb_shared_mem_t *shm);
  */
 void cb_shared_mem_destroy(cb_shared_mem_t *shm);
 
+/* ---- TCP Sockets ---- */
+
+/**
+ * @brief Open a TCP listening socket.
+ *
+ * @param sock      Output socket, filled on success.
+ * @param host      Address to bind (numeric or name), or NULL for all
+ *                  interfaces.
+ * @param port      Port to bind; 0 lets the system choose.
+ * @param port_out  Output: the bound port. May be NULL.
+ * @return CB_OK on success, CB_ERR_NET on failure.
+ */
+cb_error_t cb_socket_listen(cb_socket_t *sock, const char *host, int port,
+                            int *port_out);
+
+/**
+ * @brief Accept one connection on a listening socket.
+ *
+ * @param listener    Socket from cb_socket_listen().
+ * @param conn        Output connected socket, filled on success.
+ * @param timeout_ms  Longest wait in milliseconds; negative waits forever.
+ * @param peer        Output: the peer's numeric address. May be NULL.
+ * @param peer_size   Size of @p peer in bytes.
+ * @return CB_OK on success, CB_ERR_TIMEOUT if no peer connected in
+ *         time, CB_ERR_NET on failure.
+ */
+cb_error_t cb_socket_accept(cb_socket_t *listener, cb_socket_t *conn,
+                            int timeout_ms, char *peer, size_t peer_size);
+
+/**
+ * @brief Connect to a TCP server, retrying while it is not yet listening.
+ *
+ * @param sock        Output socket, filled on success.
+ * @param host        Server address (numeric or name).
+ * @param port        Server port.
+ * @param timeout_ms  Give up after this many milliseconds of refusals.
+ * @return CB_OK on success, CB_ERR_TIMEOUT if the server never accepted,
+ *         CB_ERR_NET on failure.
+ */
+cb_error_t cb_socket_connect(cb_socket_t *sock, const char *host, int port,
+                             int timeout_ms);
+
+/**
+ * @brief Send exactly @p len bytes.
+ *
+ * Connected sockets have Nagle's algorithm disabled, so a message
+ * leaves as soon as it is complete.
+ *
+ * @return CB_OK on success, CB_ERR_NET on failure or a closed peer.
+ */
+cb_error_t cb_socket_send(cb_socket_t *sock, const void *buf, size_t len);
+
+/**
+ * @brief Receive exactly @p len bytes, blocking until they arrive.
+ *
+ * @return CB_OK on success, CB_ERR_NET on failure or a closed peer.
+ */
+cb_error_t cb_socket_recv(cb_socket_t *sock, void *buf, size_t len);
+
+/**
+ * @brief Close a socket.
+ * @param sock  Socket to close. Safe to call on a zero-initialized handle.
+ */
+void cb_socket_close(cb_socket_t *sock);
+
+/* ---- Aligned Allocation ---- */
+
+/**
+ * @brief Allocate memory aligned to @p alignment bytes.
+ *
+ * Used for structures that are padded to cache lines to avoid false
+ * sharing. Memory must be released with cb_aligned_free().
+ *
+ * @param alignment  Alignment in bytes; a power of two >= sizeof(void *).
+ * @param size       Number of bytes to allocate.
+ * @return Pointer to the allocation, or NULL on failure.
+ */
+void *cb_aligned_alloc(size_t alignment, size_t size);
+
+/**
+ * @brief Release memory obtained from cb_aligned_alloc().
+ * @param ptr  Pointer to free, or NULL (no-op).
+ */
+void cb_aligned_free(void *ptr);
+
 /* ---- System Information ---- */
 
 /**
  * @brief Return the number of logical CPU cores available.
  *
  * Uses sysconf(_SC_NPROCESSORS_ONLN) on Unix and GetSystemInfo() on
- * Windows. Returns 1 if detection fails.
+ * Windows. Returns 1 if detection fails. This is the host's count; in
+ * a container, cb_cpu_budget() is what the scheduler actually grants.
  *
  * @return Number of logical CPU cores (minimum 1).
  */
 int cb_cpu_count(void);
 
+/**
+ * @brief CPU limits that apply to this process.
+ *
+ * Containers usually see every host core through sysconf() while the
+ * scheduler only grants them a fraction: a CFS quota (cgroup v2
+ * cpu.max), a cpuset (cpuset.cpus.effective) or an affinity mask.
+ * The budget is the smallest of these, rounded up to whole CPUs, and
+ * is the sensible default worker count. Limits that do not apply or
+ * cannot be read are 0.
+ */
+typedef struct {
+    int    online;    /**< Logical cores online (cb_cpu_count()). */
+    int    affinity;  /**< CPUs in the affinity mask. */
+    int    cpuset;    /**< CPUs in cpuset.cpus.effective. */
+    double quota;     /**< Tightest cpu.max quota / period, in CPUs. */
+    int    budget;    /**< Effective CPU budget (minimum 1). */
+} cb_cpu_limits_t;
+
+/**
+ * @brief CFS bandwidth counters from cgroup v2 cpu.stat.
+ *
+ * Read from the cgroup whose cpu.max is the tightest, where throttling
+ * is accounted. Cumulative; callers diff two samples.
+ */
+typedef struct {
+    uint64_t nr_periods;      /**< Enforcement periods elapsed. */
+    uint64_t nr_throttled;    /**< Periods in which the quota ran out. */
+    uint64_t throttled_usec;  /**< Total time spent throttled (us). */
+} cb_cpu_stat_t;
+
+/**
+ * @brief Determine the CPU limits of this process.
+ *
+ * On Linux, reads the cgroup v2 hierarchy of /proc/self/cgroup
+ * (cpu.max on every ancestor, cpuset.cpus.effective) and the affinity
+ * mask. Elsewhere only the online count is known and it is the budget.
+ *
+ * @param out  Output limits.
+ * @return CB_OK on success, CB_ERR_ARGS if out is NULL.
+ */
+cb_error_t cb_cpu_limits(cb_cpu_limits_t *out);
+
+/**
+ * @brief Return the effective CPU budget (see cb_cpu_limits_t).
+ *
+ * @return CPUs this process can actually use (minimum 1).
+ */
+int cb_cpu_budget(void);
+
+/**
+ * @brief Sample the cgroup v2 CFS throttling counters.
+ *
+ * @param out  Output counters.
+ * @return CB_OK on success, CB_ERR_PLATFORM when there is no cgroup v2
+ *         cpu controller (cgroup v1, not Linux), CB_ERR_ARGS on NULL.
+ */
+cb_error_t cb_cpu_stat_read(cb_cpu_stat_t *out);
+
+/**
+ * @brief Map logical CPUs to physical cores.
+ *
+ * core_of[i] receives a dense physical-core index (0, 1, ...) for
+ * logical CPU i, shared by its SMT siblings, or -1 when CPU i does not
+ * exist, is offline, or is outside this process's affinity mask (so
+ * that every listed CPU can be pinned with cb_thread_pin_self()).
+ *
+ * Linux reads /sys/devices/system/cpu/cpuN/topology; Windows uses
+ * GetLogicalProcessorInformation().
+ *
+ * @param core_of   Output array of max_cpus entries.
+ * @param max_cpus  Capacity of core_of.
+ * @param num_cpus  Output: highest listed CPU + 1.
+ * @return CB_OK on success, CB_ERR_PLATFORM when the topology cannot be
+ *         read, CB_ERR_ARGS on bad arguments.
+ */
+cb_error_t cb_cpu_topology(int *core_of, int max_cpus, int *num_cpus);
+
 /**
  * @brief Fill a buffer with a human-readable OS and CPU description.
  *
@@ -340,6 +738,23 @@ int cb_cpu_count(void);
  */
 cb_error_t cb_system_info_str(char *buf, size_t buf_size);
 
+/**
+ * @brief Fill a buffer with a fingerprint of the host hardware and OS.
+ *
+ * Covers the CPU model, microcode revision, OS kernel release and
+ * logical core count, so that anything calibrated on this host can be
+ * discarded when one of them changes. Fields that cannot be read are
+ * reported as "unknown".
+ *
+ * Example output: "cpu=Intel(R) Xeon(R) ...; microcode=0x2b000590;
+ * kernel=Linux 6.1.0 x86_64; cores=8"
+ *
+ * @param buf       Output buffer.
+ * @param buf_size  Size of the output buffer in bytes.
+ * @return CB_OK on success, CB_ERR_ARGS on a bad buffer.
+ */
+cb_error_t cb_host_fingerprint(char *buf, size_t buf_size);
+
 /**
  * @brief Get the filesystem path of the currently running executable.
  *
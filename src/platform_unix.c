@@ -3,10 +3,13 @@
  * @brief Unix/POSIX implementation of the platform abstraction layer.
  *
  * Provides implementations for all functions declared in platform.h
- * using POSIX APIs: pthreads for threading, fork/waitpid for process
- * management, pipe/read/write for inter-process communication,
+ * using POSIX APIs: pthreads for threading and barriers, fork/waitpid
+ * for process management, pipe/read/write for inter-process
+ * communication, shm_open/mmap for shared memory, BSD sockets for TCP,
+ * futex(2) for
+ * wait/wake on Linux, ucontext for fibers, sched_setaffinity for pinning,
  * clock_gettime(CLOCK_MONOTONIC) for high-resolution timing, and
- * sysconf for system queries.
+ * sysconf, uname, /proc and the cgroup v2 hierarchy for system queries.
  *
  * This file is only compiled on Unix/Linux/macOS targets.
  */
@@ -16,20 +19,47 @@
 #error "platform_unix.c must not be compiled on Windows"
 #endif
 
+/* futex(2) is reached through syscall(), which is not part of POSIX. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "platform.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/utsname.h>
 #include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if !defined(__APPLE__)
+#include <ucontext.h>
+#endif
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
 /* ---- Compile-Time Size Assertions ---- */
 
 _Static_assert(sizeof(pthread_mutex_t) <= sizeof(((cb_mutex_t *)0)->_opaque),
@@ -44,12 +74,22 @@ _Static_assert(2 * sizeof(int) <= sizeof(((cb_pipe_t *)0)->_opaque),
 _Static_assert(sizeof(pid_t) <= sizeof(((cb_process_t *)0)->_opaque),
                "cb_process_t opaque buffer too small for pid_t");
 
+_Static_assert(sizeof(int) <= sizeof(((cb_socket_t *)0)->_opaque),
+               "cb_socket_t opaque buffer too small for int");
+
+#if !defined(__APPLE__)
+_Static_assert(sizeof(pthread_barrier_t) <=
+               sizeof(((cb_native_barrier_t *)0)->_opaque),
+               "cb_native_barrier_t opaque buffer too small for pthread_barrier_t");
+#endif
+
 /* ---- Internal Accessor Macros ---- */
 
 #define MTX_PTR(m)    ((pthread_mutex_t *)((m)->_opaque))
 #define THREAD_PTR(t) ((pthread_t *)((t)->_opaque))
 #define PIPE_FDS(p)   ((int *)((p)->_opaque))
 #define PID_PTR(p)    ((pid_t *)((p)->_opaque))
+#define BARRIER_PTR(b) ((pthread_barrier_t *)((b)->_opaque))
 
 /* ---- Timing ---- */
 
@@ -64,6 +104,26 @@ double cb_time_now(void)
     return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
 }
 
+uint64_t cb_time_now_ns(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1) {
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void cb_sleep_ms(unsigned int ms)
+{
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {
+        /* Sleep for the remainder. */
+    }
+}
+
 /* ---- Mutex ---- */
 
 cb_error_t cb_mutex_init(cb_mutex_t *mtx)
@@ -100,6 +160,117 @@ void cb_mutex_destroy(cb_mutex_t *mtx)
     pthread_mutex_destroy(MTX_PTR(mtx));
 }
 
+/* ---- Wait / Wake Primitives ---- */
+
+void cb_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+void cb_thread_yield(void)
+{
+    sched_yield();
+}
+
+void cb_futex_wait(void *addr, uint32_t expected, bool process_shared)
+{
+#if defined(__linux__)
+    int op = process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+    /* EAGAIN (value changed) and EINTR are both "re-check and retry". */
+    syscall(SYS_futex, (uint32_t *)addr, op, expected, NULL, NULL, 0);
+#else
+    (void)addr;
+    (void)expected;
+    (void)process_shared;
+    sched_yield();
+#endif
+}
+
+void cb_futex_wake(void *addr, int count, bool process_shared)
+{
+#if defined(__linux__)
+    int op = process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+    syscall(SYS_futex, (uint32_t *)addr, op, count, NULL, NULL, 0);
+#else
+    (void)addr;
+    (void)count;
+    (void)process_shared;
+#endif
+}
+
+/* ---- Native Barrier ---- */
+
+#if !defined(__APPLE__)
+
+cb_error_t cb_native_barrier_init(cb_native_barrier_t *barrier,
+                                  unsigned int count,
+                                  bool process_shared)
+{
+    pthread_barrierattr_t attr;
+    int rc;
+
+    memset(barrier, 0, sizeof(*barrier));
+
+    if (pthread_barrierattr_init(&attr) != 0) {
+        return CB_ERR_PLATFORM;
+    }
+
+    rc = pthread_barrierattr_setpshared(&attr, process_shared
+                                        ? PTHREAD_PROCESS_SHARED
+                                        : PTHREAD_PROCESS_PRIVATE);
+    if (rc == 0) {
+        rc = pthread_barrier_init(BARRIER_PTR(barrier), &attr, count);
+    }
+
+    pthread_barrierattr_destroy(&attr);
+    return (rc == 0) ? CB_OK : CB_ERR_PLATFORM;
+}
+
+cb_error_t cb_native_barrier_wait(cb_native_barrier_t *barrier)
+{
+    int rc = pthread_barrier_wait(BARRIER_PTR(barrier));
+
+    if (rc != 0 && rc != PTHREAD_BARRIER_SERIAL_THREAD) {
+        return CB_ERR_PLATFORM;
+    }
+
+    return CB_OK;
+}
+
+void cb_native_barrier_destroy(cb_native_barrier_t *barrier)
+{
+    pthread_barrier_destroy(BARRIER_PTR(barrier));
+}
+
+#else /* __APPLE__: pthread barriers are not provided by macOS. */
+
+cb_error_t cb_native_barrier_init(cb_native_barrier_t *barrier,
+                                  unsigned int count,
+                                  bool process_shared)
+{
+    (void)count;
+    (void)process_shared;
+    memset(barrier, 0, sizeof(*barrier));
+    return CB_ERR_PLATFORM;
+}
+
+cb_error_t cb_native_barrier_wait(cb_native_barrier_t *barrier)
+{
+    (void)barrier;
+    return CB_ERR_PLATFORM;
+}
+
+void cb_native_barrier_destroy(cb_native_barrier_t *barrier)
+{
+    (void)barrier;
+}
+
+#endif
+
 /* ---- Threads ---- */
 
 cb_error_t cb_thread_create(cb_thread_t *thread, cb_thread_fn_t fn, void *arg)
@@ -122,6 +293,179 @@ cb_error_t cb_thread_join(cb_thread_t *thread)
     return CB_OK;
 }
 
+cb_error_t cb_thread_pin_self(int cpu)
+{
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return CB_ERR_ARGS;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        return CB_ERR_PLATFORM;
+    }
+    return CB_OK;
+#else
+    /* macOS only offers affinity hints; other systems vary. */
+    (void)cpu;
+    return CB_ERR_PLATFORM;
+#endif
+}
+
+/* ---- Fibers ---- */
+
+#if !defined(__APPLE__)
+
+/**
+ * @brief Unix fiber: a ucontext plus its stack mapping.
+ */
+struct cb_fiber {
+    ucontext_t     ctx;         /**< Saved register context. */
+    void          *mapping;     /**< Stack mapping including the guard page. */
+    size_t         map_size;    /**< Size of @c mapping in bytes. */
+    cb_fiber_fn_t  fn;          /**< Entry point. */
+    void          *arg;         /**< Entry argument. */
+};
+
+/**
+ * @brief makecontext() entry; rebuilds the fiber pointer from two ints.
+ *
+ * makecontext() only passes int arguments portably, so the pointer is
+ * split into 32-bit halves.
+ */
+static void fiber_trampoline(unsigned int hi, unsigned int lo)
+{
+    struct cb_fiber *f =
+        (struct cb_fiber *)(uintptr_t)(((uint64_t)hi << 32) | (uint64_t)lo);
+
+    f->fn(f->arg);
+
+    /* Entry points must switch away instead of returning. */
+    abort();
+}
+
+cb_error_t cb_fiber_thread_enter(cb_fiber_t **out)
+{
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+
+    *out = calloc(1, sizeof(struct cb_fiber));
+    return *out ? CB_OK : CB_ERR_ALLOC;
+}
+
+void cb_fiber_thread_exit(cb_fiber_t *self)
+{
+    free(self);
+}
+
+cb_error_t cb_fiber_create(cb_fiber_t **out, size_t stack_size,
+                           cb_fiber_fn_t fn, void *arg)
+{
+    if (!out || !fn || stack_size == 0) {
+        return CB_ERR_ARGS;
+    }
+
+    *out = NULL;
+
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) {
+        return CB_ERR_PLATFORM;
+    }
+
+    struct cb_fiber *f = calloc(1, sizeof(*f));
+    if (!f) {
+        return CB_ERR_ALLOC;
+    }
+
+    size_t usable = (stack_size + (size_t)page - 1) / (size_t)page * (size_t)page;
+    f->map_size = usable + (size_t)page;
+    f->mapping = mmap(NULL, f->map_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (f->mapping == MAP_FAILED) {
+        free(f);
+        return CB_ERR_ALLOC;
+    }
+
+    /* Lowest page is a guard: overflowing the stack faults immediately. */
+    if (mprotect(f->mapping, (size_t)page, PROT_NONE) != 0 ||
+        getcontext(&f->ctx) != 0) {
+        munmap(f->mapping, f->map_size);
+        free(f);
+        return CB_ERR_PLATFORM;
+    }
+
+    f->fn = fn;
+    f->arg = arg;
+    f->ctx.uc_stack.ss_sp = (char *)f->mapping + page;
+    f->ctx.uc_stack.ss_size = usable;
+    f->ctx.uc_link = NULL;
+
+    uint64_t bits = (uint64_t)(uintptr_t)f;
+    makecontext(&f->ctx, (void (*)(void))fiber_trampoline, 2,
+                (unsigned int)(bits >> 32), (unsigned int)(bits & 0xFFFFFFFFu));
+
+    *out = f;
+    return CB_OK;
+}
+
+void cb_fiber_switch(cb_fiber_t *from, cb_fiber_t *to)
+{
+    swapcontext(&from->ctx, &to->ctx);
+}
+
+void cb_fiber_destroy(cb_fiber_t *fiber)
+{
+    if (!fiber) {
+        return;
+    }
+
+    munmap(fiber->mapping, fiber->map_size);
+    free(fiber);
+}
+
+#else /* __APPLE__: ucontext is deprecated and hidden under strict POSIX. */
+
+cb_error_t cb_fiber_thread_enter(cb_fiber_t **out)
+{
+    if (out) {
+        *out = NULL;
+    }
+    return CB_ERR_PLATFORM;
+}
+
+void cb_fiber_thread_exit(cb_fiber_t *self)
+{
+    (void)self;
+}
+
+cb_error_t cb_fiber_create(cb_fiber_t **out, size_t stack_size,
+                           cb_fiber_fn_t fn, void *arg)
+{
+    (void)stack_size;
+    (void)fn;
+    (void)arg;
+    if (out) {
+        *out = NULL;
+    }
+    return CB_ERR_PLATFORM;
+}
+
+void cb_fiber_switch(cb_fiber_t *from, cb_fiber_t *to)
+{
+    (void)from;
+    (void)to;
+}
+
+void cb_fiber_destroy(cb_fiber_t *fiber)
+{
+    (void)fiber;
+}
+
+#endif
+
 /* ---- Pipes ---- */
 
 cb_error_t cb_pipe_create(cb_pipe_t *p)
@@ -206,6 +550,71 @@ cb_error_t cb_pipe_close_write(cb_pipe_t *p)
     return CB_OK;
 }
 
+cb_error_t cb_pipe_wait_any(cb_pipe_t *const *pipes, int count,
+                            int timeout_ms, int *ready)
+{
+    if (!pipes || count < 1 || !ready) {
+        return CB_ERR_ARGS;
+    }
+
+    struct pollfd *pfds = calloc((size_t)count, sizeof(struct pollfd));
+    int *index = calloc((size_t)count, sizeof(int));
+    int watched = 0;
+    cb_error_t err = CB_OK;
+
+    if (!pfds || !index) {
+        err = CB_ERR_ALLOC;
+        goto cleanup;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (pipes[i]) {
+            pfds[watched].fd = PIPE_FDS(pipes[i])[0];
+            pfds[watched].events = POLLIN;
+            index[watched] = i;
+            watched++;
+        }
+    }
+    if (watched == 0) {
+        err = CB_ERR_ARGS;
+        goto cleanup;
+    }
+
+    double deadline = cb_time_now() + timeout_ms / 1000.0;
+    for (;;) {
+        int wait_ms = timeout_ms;
+        if (timeout_ms >= 0) {
+            double left = (deadline - cb_time_now()) * 1000.0;
+            wait_ms = left > 0.0 ? (int)left + 1 : 0;
+        }
+
+        int rc = poll(pfds, (nfds_t)watched, wait_ms);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            err = CB_ERR_PIPE;
+            goto cleanup;
+        }
+        if (rc == 0) {
+            err = CB_ERR_TIMEOUT;
+            goto cleanup;
+        }
+
+        for (int i = 0; i < watched; i++) {
+            if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                *ready = index[i];
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    free(pfds);
+    free(index);
+    return err;
+}
+
 /* ---- Process Spawning ---- */
 
 cb_error_t cb_process_spawn(cb_process_t *proc,
@@ -270,32 +679,124 @@ uint32_t cb_process_get_id(const cb_process_t *proc)
     return (uint32_t)(*((const pid_t *)proc->_opaque));
 }
 
-/* ---- Shared Memory (stub on Unix) ---- */
+uint32_t cb_process_self_id(void)
+{
+    return (uint32_t)getpid();
+}
 
-/*
- * On Unix, the process benchmark uses fork() which provides implicit
- * memory sharing via copy-on-write. These functions are provided for
- * API completeness but are not used in the Unix process benchmark.
+cb_error_t cb_process_rss(size_t *bytes)
+{
+    if (!bytes) {
+        return CB_ERR_ARGS;
+    }
+
+#if defined(__linux__)
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) {
+        return CB_ERR_PLATFORM;
+    }
+
+    unsigned long total_pages = 0, resident_pages = 0;
+    int matched = fscanf(f, "%lu %lu", &total_pages, &resident_pages);
+    fclose(f);
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (matched != 2 || page_size <= 0) {
+        return CB_ERR_PLATFORM;
+    }
+
+    *bytes = (size_t)resident_pages * (size_t)page_size;
+    return CB_OK;
+#else
+    return CB_ERR_PLATFORM;
+#endif
+}
+
+/* ---- Shared Memory ---- */
+
+/**
+ * @brief Internal layout of the shared memory opaque buffer on Unix.
+ *
+ * Only the creator unlinks the name on destroy; handles obtained via
+ * cb_shared_mem_open() merely unmap.
  */
+typedef struct {
+    size_t size;      /**< Size of the mapped region. */
+    int    owner;     /**< Nonzero if this handle created the segment. */
+    char   name[64];  /**< POSIX shm name, including the leading '/'. */
+} unix_shm_data_t;
+
+_Static_assert(sizeof(unix_shm_data_t) <= sizeof(((cb_shared_mem_t *)0)->_opaque),
+               "cb_shared_mem_t opaque buffer too small for unix_shm_data_t");
+
+#define SHM_DATA(s) ((unix_shm_data_t *)((s)->_opaque))
+
+/**
+ * @brief Map a POSIX shared memory object, creating it if requested.
+ *
+ * @param shm     Output handle.
+ * @param name    Segment name; a leading '/' is added if missing.
+ * @param size    Size in bytes.
+ * @param create  True to create (exclusively) and size the segment.
+ * @return CB_OK on success, CB_ERR_SHM or CB_ERR_ARGS on failure.
+ */
+static cb_error_t shm_map(cb_shared_mem_t *shm, const char *name,
+                          size_t size, bool create)
+{
+    memset(shm, 0, sizeof(*shm));
+
+    if (!name || size == 0) {
+        return CB_ERR_ARGS;
+    }
+
+    unix_shm_data_t *data = SHM_DATA(shm);
+    int written = snprintf(data->name, sizeof(data->name), "%s%s",
+                           name[0] == '/' ? "" : "/", name);
+    if (written < 0 || (size_t)written >= sizeof(data->name)) {
+        return CB_ERR_ARGS;
+    }
+
+    int flags = create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR;
+    int fd = shm_open(data->name, flags, 0600);
+    if (fd == -1) {
+        return CB_ERR_SHM;
+    }
+
+    if (create && ftruncate(fd, (off_t)size) == -1) {
+        close(fd);
+        shm_unlink(data->name);
+        return CB_ERR_SHM;
+    }
+
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); /* The mapping keeps the object alive. */
+
+    if (ptr == MAP_FAILED) {
+        if (create) {
+            shm_unlink(data->name);
+        }
+        return CB_ERR_SHM;
+    }
+
+    shm->base_addr = ptr;
+    data->size = size;
+    data->owner = create ? 1 : 0;
+
+    return CB_OK;
+}
 
 cb_error_t cb_shared_mem_create(cb_shared_mem_t *shm,
                                 const char *name,
                                 size_t size)
 {
-    (void)shm;
-    (void)name;
-    (void)size;
-    return CB_ERR_PLATFORM; /* Not implemented on Unix. */
+    return shm_map(shm, name, size, true);
 }
 
 cb_error_t cb_shared_mem_open(cb_shared_mem_t *shm,
                               const char *name,
                               size_t size)
 {
-    (void)shm;
-    (void)name;
-    (void)size;
-    return CB_ERR_PLATFORM; /* Not implemented on Unix. */
+    return shm_map(shm, name, size, false);
 }
 
 void *cb_shared_mem_ptr(cb_shared_mem_t *shm)
@@ -305,7 +806,271 @@ void *cb_shared_mem_ptr(cb_shared_mem_t *shm)
 
 void cb_shared_mem_destroy(cb_shared_mem_t *shm)
 {
-    (void)shm;
+    unix_shm_data_t *data = SHM_DATA(shm);
+
+    if (shm->base_addr) {
+        munmap(shm->base_addr, data->size);
+        shm->base_addr = NULL;
+    }
+
+    if (data->owner) {
+        shm_unlink(data->name);
+        data->owner = 0;
+    }
+}
+
+/* ---- TCP Sockets ---- */
+
+/*
+ * The descriptor is stored plus one, so a zero-initialized handle
+ * means "no socket" rather than stdin.
+ */
+
+/** @brief Descriptor of @p sock, or -1 if none. */
+static int sock_fd(const cb_socket_t *sock)
+{
+    int v;
+    memcpy(&v, sock->_opaque, sizeof(v));
+    return v - 1;
+}
+
+/** @brief Store @p fd in @p sock. */
+static void sock_set(cb_socket_t *sock, int fd)
+{
+    int v = fd + 1;
+    memset(sock, 0, sizeof(*sock));
+    memcpy(sock->_opaque, &v, sizeof(v));
+}
+
+/** @brief Resolve @p host:@p port for a stream socket. */
+static cb_error_t sock_resolve(const char *host, int port, bool passive,
+                               struct addrinfo **res)
+{
+    struct addrinfo hints;
+    char service[16];
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    snprintf(service, sizeof(service), "%d", port);
+
+    return getaddrinfo(host, service, &hints, res) == 0 ? CB_OK : CB_ERR_NET;
+}
+
+/** @brief Disable Nagle's algorithm; messages are small and latency-bound. */
+static void sock_nodelay(int fd)
+{
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+cb_error_t cb_socket_listen(cb_socket_t *sock, const char *host, int port,
+                            int *port_out)
+{
+    struct addrinfo *res = NULL;
+    int fd = -1;
+
+    memset(sock, 0, sizeof(*sock));
+    if (sock_resolve(host, port, true, &res)) {
+        return CB_ERR_NET;
+    }
+
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd == -1) {
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 &&
+            listen(fd, SOMAXCONN) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+
+    if (fd == -1) {
+        return CB_ERR_NET;
+    }
+
+    if (port_out) {
+        struct sockaddr_storage addr;
+        socklen_t len = sizeof(addr);
+        *port_out = port;
+        if (getsockname(fd, (struct sockaddr *)&addr, &len) == 0) {
+            if (addr.ss_family == AF_INET) {
+                *port_out = ntohs(((struct sockaddr_in *)&addr)->sin_port);
+            } else if (addr.ss_family == AF_INET6) {
+                *port_out = ntohs(((struct sockaddr_in6 *)&addr)->sin6_port);
+            }
+        }
+    }
+
+    sock_set(sock, fd);
+    return CB_OK;
+}
+
+cb_error_t cb_socket_accept(cb_socket_t *listener, cb_socket_t *conn,
+                            int timeout_ms, char *peer, size_t peer_size)
+{
+    struct pollfd pfd;
+    int rc;
+
+    memset(conn, 0, sizeof(*conn));
+    pfd.fd = sock_fd(listener);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    do {
+        rc = poll(&pfd, 1, timeout_ms < 0 ? -1 : timeout_ms);
+    } while (rc == -1 && errno == EINTR);
+    if (rc == 0) {
+        return CB_ERR_TIMEOUT;
+    }
+    if (rc == -1) {
+        return CB_ERR_NET;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t len;
+    int fd;
+    do {
+        len = sizeof(addr);
+        fd = accept(pfd.fd, (struct sockaddr *)&addr, &len);
+    } while (fd == -1 && errno == EINTR);
+    if (fd == -1) {
+        return CB_ERR_NET;
+    }
+
+    if (peer && peer_size > 0 &&
+        getnameinfo((struct sockaddr *)&addr, len, peer, (socklen_t)peer_size,
+                    NULL, 0, NI_NUMERICHOST) != 0) {
+        snprintf(peer, peer_size, "?");
+    }
+    sock_nodelay(fd);
+    sock_set(conn, fd);
+    return CB_OK;
+}
+
+cb_error_t cb_socket_connect(cb_socket_t *sock, const char *host, int port,
+                             int timeout_ms)
+{
+    double deadline = cb_time_now() + timeout_ms / 1000.0;
+
+    memset(sock, 0, sizeof(*sock));
+
+    for (;;) {
+        struct addrinfo *res = NULL;
+        bool refused = false;
+        int fd = -1;
+
+        if (sock_resolve(host, port, false, &res)) {
+            return CB_ERR_NET;
+        }
+        for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd == -1) {
+                continue;
+            }
+            if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                break;
+            }
+            refused = refused || errno == ECONNREFUSED;
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+
+        if (fd != -1) {
+            sock_nodelay(fd);
+            sock_set(sock, fd);
+            return CB_OK;
+        }
+        if (!refused) {
+            return CB_ERR_NET;
+        }
+        if (cb_time_now() >= deadline) {
+            return CB_ERR_TIMEOUT;
+        }
+
+        /* The server may not be listening yet. */
+        struct timespec pause = { 0, 50 * 1000 * 1000 };
+        nanosleep(&pause, NULL);
+    }
+}
+
+cb_error_t cb_socket_send(cb_socket_t *sock, const void *buf, size_t len)
+{
+    const char *p = buf;
+    int fd = sock_fd(sock);
+#ifdef MSG_NOSIGNAL
+    int flags = MSG_NOSIGNAL; /* A closed peer is an error, not SIGPIPE. */
+#else
+    int flags = 0;
+#endif
+
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, flags);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return CB_ERR_NET;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return CB_OK;
+}
+
+cb_error_t cb_socket_recv(cb_socket_t *sock, void *buf, size_t len)
+{
+    char *p = buf;
+    int fd = sock_fd(sock);
+
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return CB_ERR_NET;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return CB_OK;
+}
+
+void cb_socket_close(cb_socket_t *sock)
+{
+    int fd = sock_fd(sock);
+
+    if (fd >= 0) {
+        close(fd);
+    }
+    memset(sock, 0, sizeof(*sock));
+}
+
+/* ---- Aligned Allocation ---- */
+
+void *cb_aligned_alloc(size_t alignment, size_t size)
+{
+    void *ptr = NULL;
+
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return NULL;
+    }
+
+    return ptr;
+}
+
+void cb_aligned_free(void *ptr)
+{
+    free(ptr);
 }
 
 /* ---- System Information ---- */
@@ -316,6 +1081,304 @@ int cb_cpu_count(void)
     return (count > 0) ? (int)count : 1;
 }
 
+#if defined(__linux__)
+/** @brief Mount point of the cgroup v2 (unified) hierarchy. */
+#define CGROUP_ROOT "/sys/fs/cgroup"
+
+/** @brief Buffer size for cgroup directory paths. */
+#define CGROUP_PATH_LEN 512
+
+/**
+ * @brief Read the first line of dir/file.
+ * @return true if the file exists and is not empty.
+ */
+static bool cgroup_read(const char *dir, const char *file, char *out,
+                        size_t size)
+{
+    char path[CGROUP_PATH_LEN + 64];
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    bool ok = fgets(out, (int)size, f) != NULL;
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Locate the cgroup v2 directory of this process.
+ * @return false on cgroup v1 and hybrid hosts, where the cpu controller
+ *         is not in the unified hierarchy.
+ */
+static bool cgroup_self_dir(char *dir, size_t size)
+{
+    char line[CGROUP_PATH_LEN];
+    bool found = false;
+
+    FILE *f = fopen("/proc/self/cgroup", "r");
+    if (!f) {
+        return false;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "0::", 3) == 0) {
+            line[strcspn(line, "\r\n")] = '\0';
+            int len = snprintf(dir, size, "%s%s", CGROUP_ROOT,
+                               strcmp(line + 3, "/") == 0 ? "" : line + 3);
+            found = len > 0 && (size_t)len < size;
+            break;
+        }
+    }
+    fclose(f);
+    if (!found) {
+        return false;
+    }
+
+    /* Without a cgroup namespace, a container sees its host path, which
+     * is not mounted inside; its own cgroup is then the mount root. */
+    char probe[64];
+    if (cgroup_read(dir, "cgroup.controllers", probe, sizeof(probe))) {
+        return true;
+    }
+    snprintf(dir, size, "%s", CGROUP_ROOT);
+    return cgroup_read(dir, "cgroup.controllers", probe, sizeof(probe));
+}
+
+/**
+ * @brief Find the tightest cpu.max quota from dir up to the root.
+ *
+ * Quotas nest (Kubernetes sets one on the pod and one per container),
+ * so every ancestor is checked.
+ *
+ * @param limit_dir  Receives the directory of the tightest quota, or
+ *                   dir itself when there is none.
+ * @return The quota in CPUs, or 0 when unlimited.
+ */
+static double cgroup_quota(const char *dir, char *limit_dir, size_t size)
+{
+    char cur[CGROUP_PATH_LEN];
+    double best = 0.0;
+
+    snprintf(cur, sizeof(cur), "%s", dir);
+    snprintf(limit_dir, size, "%s", dir);
+
+    for (;;) {
+        char line[128], max[32];
+        long long period = 0;
+        if (cgroup_read(cur, "cpu.max", line, sizeof(line)) &&
+            sscanf(line, "%31s %lld", max, &period) == 2 &&
+            strcmp(max, "max") != 0 && period > 0) {
+            double q = strtod(max, NULL) / (double)period;
+            if (q > 0.0 && (best == 0.0 || q < best)) {
+                best = q;
+                snprintf(limit_dir, size, "%s", cur);
+            }
+        }
+
+        char *slash = strrchr(cur, '/');
+        if (strcmp(cur, CGROUP_ROOT) == 0 || !slash ||
+            (size_t)(slash - cur) < strlen(CGROUP_ROOT)) {
+            break;
+        }
+        *slash = '\0';
+    }
+    return best;
+}
+
+/** @brief Count the CPUs in a list such as "0-3,8,10-11". */
+static int cpu_list_count(const char *list)
+{
+    const char *p = list;
+    int count = 0;
+
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long hi = lo;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+            if (end == p) {
+                break;
+            }
+        }
+        if (hi >= lo) {
+            count += (int)(hi - lo + 1);
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+#endif
+
+cb_error_t cb_cpu_limits(cb_cpu_limits_t *out)
+{
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->online = cb_cpu_count();
+    out->budget = out->online;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        out->affinity = CPU_COUNT(&set);
+    }
+
+    char dir[CGROUP_PATH_LEN], limit_dir[CGROUP_PATH_LEN], line[4096];
+    if (cgroup_self_dir(dir, sizeof(dir))) {
+        out->quota = cgroup_quota(dir, limit_dir, sizeof(limit_dir));
+        if (cgroup_read(dir, "cpuset.cpus.effective", line, sizeof(line))) {
+            out->cpuset = cpu_list_count(line);
+        }
+    }
+
+    if (out->affinity > 0 && out->affinity < out->budget) {
+        out->budget = out->affinity;
+    }
+    if (out->cpuset > 0 && out->cpuset < out->budget) {
+        out->budget = out->cpuset;
+    }
+    if (out->quota > 0.0) {
+        int q = (int)out->quota;
+        if (q < out->quota) {
+            q++; /* A 2.5-CPU quota still runs three threads at once. */
+        }
+        if (q < out->budget) {
+            out->budget = q;
+        }
+    }
+#endif
+
+    if (out->budget < 1) {
+        out->budget = 1;
+    }
+    return CB_OK;
+}
+
+int cb_cpu_budget(void)
+{
+    cb_cpu_limits_t limits;
+    cb_cpu_limits(&limits);
+    return limits.budget;
+}
+
+cb_error_t cb_cpu_topology(int *core_of, int max_cpus, int *num_cpus)
+{
+    if (!core_of || max_cpus < 1 || !num_cpus) {
+        return CB_ERR_ARGS;
+    }
+
+    *num_cpus = 0;
+
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return CB_ERR_PLATFORM;
+    }
+
+    /* A core is identified by the first CPU of its sibling list. */
+    int *first = malloc((size_t)max_cpus * sizeof(int));
+    if (!first) {
+        return CB_ERR_ALLOC;
+    }
+    int cores = 0;
+
+    for (int cpu = 0; cpu < max_cpus; cpu++) {
+        char path[128], line[256];
+        core_of[cpu] = -1;
+        if (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+
+        /* core_cpus_list replaced thread_siblings_list in Linux 5.8. */
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%d/topology/core_cpus_list", cpu);
+        FILE *f = fopen(path, "r");
+        if (!f) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d"
+                     "/topology/thread_siblings_list", cpu);
+            f = fopen(path, "r");
+        }
+        if (!f) {
+            continue;
+        }
+        bool ok = fgets(line, sizeof(line), f) != NULL;
+        fclose(f);
+        if (!ok) {
+            continue;
+        }
+
+        int id = atoi(line);
+        int c = 0;
+        while (c < cores && first[c] != id) {
+            c++;
+        }
+        if (c == cores) {
+            first[cores++] = id;
+        }
+        core_of[cpu] = c;
+        *num_cpus = cpu + 1;
+    }
+
+    free(first);
+    return cores > 0 ? CB_OK : CB_ERR_PLATFORM;
+#else
+    return CB_ERR_PLATFORM;
+#endif
+}
+
+cb_error_t cb_cpu_stat_read(cb_cpu_stat_t *out)
+{
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(out, 0, sizeof(*out));
+
+#if defined(__linux__)
+    char dir[CGROUP_PATH_LEN], limit_dir[CGROUP_PATH_LEN];
+    if (!cgroup_self_dir(dir, sizeof(dir))) {
+        return CB_ERR_PLATFORM;
+    }
+    cgroup_quota(dir, limit_dir, sizeof(limit_dir));
+
+    char path[CGROUP_PATH_LEN + 64];
+    snprintf(path, sizeof(path), "%s/cpu.stat", limit_dir);
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return CB_ERR_PLATFORM;
+    }
+
+    /* nr_periods only appears when the cpu controller is enabled. */
+    bool found = false;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long long v;
+        if (sscanf(line, "nr_periods %llu", &v) == 1) {
+            out->nr_periods = v;
+            found = true;
+        } else if (sscanf(line, "nr_throttled %llu", &v) == 1) {
+            out->nr_throttled = v;
+        } else if (sscanf(line, "throttled_usec %llu", &v) == 1) {
+            out->throttled_usec = v;
+        }
+    }
+    fclose(f);
+    return found ? CB_OK : CB_ERR_PLATFORM;
+#else
+    return CB_ERR_PLATFORM;
+#endif
+}
+
 cb_error_t cb_system_info_str(char *buf, size_t buf_size)
 {
     if (!buf || buf_size == 0) {
@@ -358,6 +1421,72 @@ cb_error_t cb_system_info_str(char *buf, size_t buf_size)
     return CB_OK;
 }
 
+#if defined(__linux__)
+/**
+ * @brief Copy the value of the first "key : value" line in /proc/cpuinfo.
+ * @return true if the key was found.
+ */
+static bool cpuinfo_field(FILE *f, const char *key, char *out, size_t size)
+{
+    char line[256];
+    size_t klen = strlen(key);
+
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, key, klen) != 0) {
+            continue;
+        }
+        char *value = strchr(line, ':');
+        if (!value) {
+            continue;
+        }
+        value++;
+        while (*value == ' ' || *value == '\t') {
+            value++;
+        }
+        value[strcspn(value, "\r\n")] = '\0';
+        snprintf(out, size, "%s", value);
+        return true;
+    }
+    return false;
+}
+#endif
+
+cb_error_t cb_host_fingerprint(char *buf, size_t buf_size)
+{
+    char model[128] = "unknown";
+    char microcode[32] = "unknown";
+    char kernel[256] = "unknown";
+    struct utsname u;
+
+    if (!buf || buf_size == 0) {
+        return CB_ERR_ARGS;
+    }
+
+#if defined(__linux__)
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if (f) {
+        /* x86 reports "model name"; most other architectures "Processor"
+         * or "cpu model". */
+        if (!cpuinfo_field(f, "model name", model, sizeof(model)) &&
+            !cpuinfo_field(f, "Processor", model, sizeof(model))) {
+            cpuinfo_field(f, "cpu model", model, sizeof(model));
+        }
+        cpuinfo_field(f, "microcode", microcode, sizeof(microcode));
+        fclose(f);
+    }
+#endif
+
+    if (uname(&u) == 0) {
+        snprintf(kernel, sizeof(kernel), "%s %s %s", u.sysname, u.release,
+                 u.machine);
+    }
+
+    snprintf(buf, buf_size, "cpu=%s; microcode=%s; kernel=%s; cores=%d",
+             model, microcode, kernel, cb_cpu_count());
+    return CB_OK;
+}
+
 cb_error_t cb_get_exe_path(char *buf, size_t buf_size)
 {
     if (!buf || buf_size == 0) {
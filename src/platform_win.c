@@ -4,9 +4,11 @@
  *
  * Provides implementations for all functions declared in platform.h
  * using Win32 APIs: CreateThread for threading, CRITICAL_SECTION for
- * mutexes, CreateProcess for process spawning, CreatePipe for IPC,
+ * mutexes, Win32 fibers for user-level context switching, WaitOnAddress and SYNCHRONIZATION_BARRIER for wait/wake and
+ * barriers, CreateProcess for process spawning, CreatePipe for IPC,
  * QueryPerformanceCounter for high-resolution timing, CreateFileMapping
- * for shared memory, and GetSystemInfo for system queries.
+ * for shared memory, Winsock for TCP, and GetSystemInfo for system
+ * queries.
  *
  * This file is only compiled on Windows targets.
  */
@@ -18,12 +20,19 @@
 
 #include "platform.h"
 
+#include <limits.h>
+#include <malloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #include <windows.h>
+#include <psapi.h>
+#include <winreg.h>
+#include <winver.h>
 
 /* ---- Compile-Time Size Assertions ---- */
 
@@ -39,12 +48,20 @@ _Static_assert(2 * sizeof(HANDLE) <= sizeof(((cb_pipe_t *)0)->_opaque),
 _Static_assert(sizeof(PROCESS_INFORMATION) <= sizeof(((cb_process_t *)0)->_opaque),
                "cb_process_t opaque buffer too small for PROCESS_INFORMATION");
 
+_Static_assert(sizeof(SOCKET) <= sizeof(((cb_socket_t *)0)->_opaque),
+               "cb_socket_t opaque buffer too small for SOCKET");
+
+_Static_assert(sizeof(SYNCHRONIZATION_BARRIER) <=
+               sizeof(((cb_native_barrier_t *)0)->_opaque),
+               "cb_native_barrier_t opaque buffer too small for SYNCHRONIZATION_BARRIER");
+
 /* ---- Internal Accessor Macros ---- */
 
 #define CS_PTR(m)     ((CRITICAL_SECTION *)((m)->_opaque))
 #define THANDLE(t)    (*((HANDLE *)((t)->_opaque)))
 #define PIPE_HANDLES(p) ((HANDLE *)((p)->_opaque))
 #define PI_PTR(p)     ((PROCESS_INFORMATION *)((p)->_opaque))
+#define SB_PTR(b)     ((SYNCHRONIZATION_BARRIER *)((b)->_opaque))
 
 /**
  * @brief Internal wrapper for Windows thread entry.
@@ -89,6 +106,25 @@ double cb_time_now(void)
     return (double)counter.QuadPart / (double)freq.QuadPart;
 }
 
+uint64_t cb_time_now_ns(void)
+{
+    LARGE_INTEGER freq, counter;
+
+    if (!QueryPerformanceFrequency(&freq) || freq.QuadPart == 0 ||
+        !QueryPerformanceCounter(&counter)) {
+        return 0;
+    }
+
+    /* Split to avoid overflowing counter * 1e9. */
+    uint64_t f = (uint64_t)freq.QuadPart, c = (uint64_t)counter.QuadPart;
+    return (c / f) * 1000000000u + (c % f) * 1000000000u / f;
+}
+
+void cb_sleep_ms(unsigned int ms)
+{
+    Sleep(ms);
+}
+
 /* ---- Mutex ---- */
 
 cb_error_t cb_mutex_init(cb_mutex_t *mtx)
@@ -115,6 +151,73 @@ void cb_mutex_destroy(cb_mutex_t *mtx)
     DeleteCriticalSection(CS_PTR(mtx));
 }
 
+/* ---- Wait / Wake Primitives ---- */
+
+void cb_cpu_relax(void)
+{
+    YieldProcessor();
+}
+
+void cb_thread_yield(void)
+{
+    SwitchToThread();
+}
+
+void cb_futex_wait(void *addr, uint32_t expected, bool process_shared)
+{
+    /* WaitOnAddress only works within a single process. */
+    if (process_shared) {
+        SwitchToThread();
+        return;
+    }
+
+    WaitOnAddress(addr, &expected, sizeof(expected), INFINITE);
+}
+
+void cb_futex_wake(void *addr, int count, bool process_shared)
+{
+    if (process_shared) {
+        return;
+    }
+
+    if (count == 1) {
+        WakeByAddressSingle(addr);
+    } else {
+        WakeByAddressAll(addr);
+    }
+}
+
+/* ---- Native Barrier ---- */
+
+cb_error_t cb_native_barrier_init(cb_native_barrier_t *barrier,
+                                  unsigned int count,
+                                  bool process_shared)
+{
+    memset(barrier, 0, sizeof(*barrier));
+
+    /* SYNCHRONIZATION_BARRIER cannot be shared between processes. */
+    if (process_shared) {
+        return CB_ERR_PLATFORM;
+    }
+
+    if (!InitializeSynchronizationBarrier(SB_PTR(barrier), (LONG)count, -1)) {
+        return CB_ERR_PLATFORM;
+    }
+
+    return CB_OK;
+}
+
+cb_error_t cb_native_barrier_wait(cb_native_barrier_t *barrier)
+{
+    EnterSynchronizationBarrier(SB_PTR(barrier), 0);
+    return CB_OK;
+}
+
+void cb_native_barrier_destroy(cb_native_barrier_t *barrier)
+{
+    DeleteSynchronizationBarrier(SB_PTR(barrier));
+}
+
 /* ---- Threads ---- */
 
 cb_error_t cb_thread_create(cb_thread_t *thread, cb_thread_fn_t fn, void *arg)
@@ -152,6 +255,119 @@ cb_error_t cb_thread_join(cb_thread_t *thread)
     return CB_OK;
 }
 
+cb_error_t cb_thread_pin_self(int cpu)
+{
+    if (cpu < 0 || cpu >= 64) {
+        return CB_ERR_ARGS;
+    }
+
+    if (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) == 0) {
+        return CB_ERR_PLATFORM;
+    }
+    return CB_OK;
+}
+
+/* ---- Fibers ---- */
+
+/**
+ * @brief Windows fiber: a Win32 fiber handle plus its entry point.
+ */
+struct cb_fiber {
+    LPVOID         handle;     /**< Fiber handle from CreateFiber/ConvertThreadToFiber. */
+    bool           converted;  /**< True if this is a converted thread. */
+    cb_fiber_fn_t  fn;         /**< Entry point (created fibers only). */
+    void          *arg;        /**< Entry argument. */
+};
+
+/** @brief CreateFiber() entry trampoline. */
+static VOID WINAPI win_fiber_entry(LPVOID param)
+{
+    struct cb_fiber *f = (struct cb_fiber *)param;
+
+    f->fn(f->arg);
+
+    /* Entry points must switch away instead of returning. */
+    abort();
+}
+
+cb_error_t cb_fiber_thread_enter(cb_fiber_t **out)
+{
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+
+    struct cb_fiber *f = calloc(1, sizeof(*f));
+    if (!f) {
+        *out = NULL;
+        return CB_ERR_ALLOC;
+    }
+
+    f->handle = ConvertThreadToFiber(NULL);
+    if (!f->handle) {
+        free(f);
+        *out = NULL;
+        return CB_ERR_PLATFORM;
+    }
+    f->converted = true;
+
+    *out = f;
+    return CB_OK;
+}
+
+void cb_fiber_thread_exit(cb_fiber_t *self)
+{
+    if (!self) {
+        return;
+    }
+
+    ConvertFiberToThread();
+    free(self);
+}
+
+cb_error_t cb_fiber_create(cb_fiber_t **out, size_t stack_size,
+                           cb_fiber_fn_t fn, void *arg)
+{
+    if (!out || !fn || stack_size == 0) {
+        return CB_ERR_ARGS;
+    }
+
+    struct cb_fiber *f = calloc(1, sizeof(*f));
+    if (!f) {
+        *out = NULL;
+        return CB_ERR_ALLOC;
+    }
+
+    f->fn = fn;
+    f->arg = arg;
+    f->handle = CreateFiber(stack_size, win_fiber_entry, f);
+    if (!f->handle) {
+        free(f);
+        *out = NULL;
+        return CB_ERR_ALLOC;
+    }
+
+    *out = f;
+    return CB_OK;
+}
+
+void cb_fiber_switch(cb_fiber_t *from, cb_fiber_t *to)
+{
+    (void)from;
+    SwitchToFiber(to->handle);
+}
+
+void cb_fiber_destroy(cb_fiber_t *fiber)
+{
+    if (!fiber) {
+        return;
+    }
+
+    if (!fiber->converted) {
+        DeleteFiber(fiber->handle);
+    }
+    free(fiber);
+}
+
 /* ---- Pipes ---- */
 
 cb_error_t cb_pipe_create(cb_pipe_t *p)
@@ -242,6 +458,53 @@ cb_error_t cb_pipe_close_write(cb_pipe_t *p)
     return CB_OK;
 }
 
+cb_error_t cb_pipe_wait_any(cb_pipe_t *const *pipes, int count,
+                            int timeout_ms, int *ready)
+{
+    if (!pipes || count < 1 || !ready) {
+        return CB_ERR_ARGS;
+    }
+
+    /*
+     * Anonymous pipes cannot be waited on with WaitForMultipleObjects,
+     * so poll them with PeekNamedPipe and sleep 1 ms between rounds.
+     */
+    ULONGLONG deadline = GetTickCount64() +
+                         (ULONGLONG)(timeout_ms < 0 ? 0 : timeout_ms);
+    for (;;) {
+        bool any = false;
+
+        for (int i = 0; i < count; i++) {
+            if (!pipes[i]) {
+                continue;
+            }
+            any = true;
+
+            DWORD avail = 0;
+            if (!PeekNamedPipe(PIPE_HANDLES(pipes[i])[0], NULL, 0, NULL,
+                               &avail, NULL)) {
+                if (GetLastError() == ERROR_BROKEN_PIPE) {
+                    *ready = i; /* End of file. */
+                    return CB_OK;
+                }
+                return CB_ERR_PIPE;
+            }
+            if (avail > 0) {
+                *ready = i;
+                return CB_OK;
+            }
+        }
+
+        if (!any) {
+            return CB_ERR_ARGS;
+        }
+        if (timeout_ms >= 0 && GetTickCount64() >= deadline) {
+            return CB_ERR_TIMEOUT;
+        }
+        Sleep(1);
+    }
+}
+
 /* ---- Process Spawning ---- */
 
 cb_error_t cb_process_spawn(cb_process_t *proc,
@@ -338,6 +601,27 @@ uint32_t cb_process_get_id(const cb_process_t *proc)
     return pi->dwProcessId;
 }
 
+uint32_t cb_process_self_id(void)
+{
+    return (uint32_t)GetCurrentProcessId();
+}
+
+cb_error_t cb_process_rss(size_t *bytes)
+{
+    PROCESS_MEMORY_COUNTERS pmc;
+
+    if (!bytes) {
+        return CB_ERR_ARGS;
+    }
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return CB_ERR_PLATFORM;
+    }
+
+    *bytes = (size_t)pmc.WorkingSetSize;
+    return CB_OK;
+}
+
 /* ---- Shared Memory ---- */
 
 /**
@@ -428,6 +712,254 @@ void cb_shared_mem_destroy(cb_shared_mem_t *shm)
     }
 }
 
+/* ---- TCP Sockets ---- */
+
+/*
+ * The SOCKET is stored plus one, so a zero-initialized handle means
+ * "no socket" (INVALID_SOCKET + 1 == 0).
+ */
+
+/** @brief SOCKET of @p sock, or INVALID_SOCKET if none. */
+static SOCKET sock_get(const cb_socket_t *sock)
+{
+    SOCKET v;
+    memcpy(&v, sock->_opaque, sizeof(v));
+    return v - 1;
+}
+
+/** @brief Store @p s in @p sock. */
+static void sock_set(cb_socket_t *sock, SOCKET s)
+{
+    SOCKET v = s + 1;
+    memset(sock, 0, sizeof(*sock));
+    memcpy(sock->_opaque, &v, sizeof(v));
+}
+
+static INIT_ONCE wsa_once = INIT_ONCE_STATIC_INIT;
+static bool wsa_ready = false;
+
+/** @brief InitOnce callback: start Winsock 2.2 for the process. */
+static BOOL CALLBACK wsa_init(PINIT_ONCE once, PVOID param, PVOID *ctx)
+{
+    WSADATA wsa;
+    (void)once;
+    (void)param;
+    (void)ctx;
+    wsa_ready = WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+    return TRUE;
+}
+
+/** @brief Resolve @p host:@p port for a stream socket. */
+static cb_error_t sock_resolve(const char *host, int port, bool passive,
+                               struct addrinfo **res)
+{
+    struct addrinfo hints;
+    char service[16];
+
+    InitOnceExecuteOnce(&wsa_once, wsa_init, NULL, NULL);
+    if (!wsa_ready) {
+        return CB_ERR_NET;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    snprintf(service, sizeof(service), "%d", port);
+
+    return getaddrinfo(host, service, &hints, res) == 0 ? CB_OK : CB_ERR_NET;
+}
+
+/** @brief Disable Nagle's algorithm; messages are small and latency-bound. */
+static void sock_nodelay(SOCKET s)
+{
+    BOOL one = TRUE;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof(one));
+}
+
+cb_error_t cb_socket_listen(cb_socket_t *sock, const char *host, int port,
+                            int *port_out)
+{
+    struct addrinfo *res = NULL;
+    SOCKET s = INVALID_SOCKET;
+
+    memset(sock, 0, sizeof(*sock));
+    if (sock_resolve(host, port, true, &res)) {
+        return CB_ERR_NET;
+    }
+
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s == INVALID_SOCKET) {
+            continue;
+        }
+        if (bind(s, ai->ai_addr, (int)ai->ai_addrlen) == 0 &&
+            listen(s, SOMAXCONN) == 0) {
+            break;
+        }
+        closesocket(s);
+        s = INVALID_SOCKET;
+    }
+    freeaddrinfo(res);
+
+    if (s == INVALID_SOCKET) {
+        return CB_ERR_NET;
+    }
+
+    if (port_out) {
+        struct sockaddr_storage addr;
+        int len = sizeof(addr);
+        *port_out = port;
+        if (getsockname(s, (struct sockaddr *)&addr, &len) == 0) {
+            if (addr.ss_family == AF_INET) {
+                *port_out = ntohs(((struct sockaddr_in *)&addr)->sin_port);
+            } else if (addr.ss_family == AF_INET6) {
+                *port_out = ntohs(((struct sockaddr_in6 *)&addr)->sin6_port);
+            }
+        }
+    }
+
+    sock_set(sock, s);
+    return CB_OK;
+}
+
+cb_error_t cb_socket_accept(cb_socket_t *listener, cb_socket_t *conn,
+                            int timeout_ms, char *peer, size_t peer_size)
+{
+    WSAPOLLFD pfd;
+
+    memset(conn, 0, sizeof(*conn));
+    pfd.fd = sock_get(listener);
+    pfd.events = POLLRDNORM;
+    pfd.revents = 0;
+
+    int rc = WSAPoll(&pfd, 1, timeout_ms < 0 ? -1 : timeout_ms);
+    if (rc == 0) {
+        return CB_ERR_TIMEOUT;
+    }
+    if (rc == SOCKET_ERROR) {
+        return CB_ERR_NET;
+    }
+
+    struct sockaddr_storage addr;
+    int len = sizeof(addr);
+    SOCKET s = accept(pfd.fd, (struct sockaddr *)&addr, &len);
+    if (s == INVALID_SOCKET) {
+        return CB_ERR_NET;
+    }
+
+    if (peer && peer_size > 0 &&
+        getnameinfo((struct sockaddr *)&addr, len, peer, (DWORD)peer_size,
+                    NULL, 0, NI_NUMERICHOST) != 0) {
+        snprintf(peer, peer_size, "?");
+    }
+    sock_nodelay(s);
+    sock_set(conn, s);
+    return CB_OK;
+}
+
+cb_error_t cb_socket_connect(cb_socket_t *sock, const char *host, int port,
+                             int timeout_ms)
+{
+    double deadline = cb_time_now() + timeout_ms / 1000.0;
+
+    memset(sock, 0, sizeof(*sock));
+
+    for (;;) {
+        struct addrinfo *res = NULL;
+        bool refused = false;
+        SOCKET s = INVALID_SOCKET;
+
+        if (sock_resolve(host, port, false, &res)) {
+            return CB_ERR_NET;
+        }
+        for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+            s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (s == INVALID_SOCKET) {
+                continue;
+            }
+            if (connect(s, ai->ai_addr, (int)ai->ai_addrlen) == 0) {
+                break;
+            }
+            refused = refused || WSAGetLastError() == WSAECONNREFUSED;
+            closesocket(s);
+            s = INVALID_SOCKET;
+        }
+        freeaddrinfo(res);
+
+        if (s != INVALID_SOCKET) {
+            sock_nodelay(s);
+            sock_set(sock, s);
+            return CB_OK;
+        }
+        if (!refused) {
+            return CB_ERR_NET;
+        }
+        if (cb_time_now() >= deadline) {
+            return CB_ERR_TIMEOUT;
+        }
+
+        /* The server may not be listening yet. */
+        Sleep(50);
+    }
+}
+
+cb_error_t cb_socket_send(cb_socket_t *sock, const void *buf, size_t len)
+{
+    const char *p = buf;
+    SOCKET s = sock_get(sock);
+
+    while (len > 0) {
+        int chunk = len > INT_MAX ? INT_MAX : (int)len;
+        int n = send(s, p, chunk, 0);
+        if (n <= 0) {
+            return CB_ERR_NET;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return CB_OK;
+}
+
+cb_error_t cb_socket_recv(cb_socket_t *sock, void *buf, size_t len)
+{
+    char *p = buf;
+    SOCKET s = sock_get(sock);
+
+    while (len > 0) {
+        int chunk = len > INT_MAX ? INT_MAX : (int)len;
+        int n = recv(s, p, chunk, 0);
+        if (n <= 0) {
+            return CB_ERR_NET;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return CB_OK;
+}
+
+void cb_socket_close(cb_socket_t *sock)
+{
+    SOCKET s = sock_get(sock);
+
+    if (s != INVALID_SOCKET) {
+        closesocket(s);
+    }
+    memset(sock, 0, sizeof(*sock));
+}
+
+/* ---- Aligned Allocation ---- */
+
+void *cb_aligned_alloc(size_t alignment, size_t size)
+{
+    return _aligned_malloc(size, alignment);
+}
+
+void cb_aligned_free(void *ptr)
+{
+    _aligned_free(ptr);
+}
+
 /* ---- System Information ---- */
 
 int cb_cpu_count(void)
@@ -437,6 +969,107 @@ int cb_cpu_count(void)
     return (si.dwNumberOfProcessors > 0) ? (int)si.dwNumberOfProcessors : 1;
 }
 
+cb_error_t cb_cpu_limits(cb_cpu_limits_t *out)
+{
+    DWORD_PTR process_mask, system_mask;
+
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->online = cb_cpu_count();
+    out->budget = out->online;
+
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                               &system_mask)) {
+        for (DWORD_PTR m = process_mask; m; m &= m - 1) {
+            out->affinity++;
+        }
+        if (out->affinity > 0 && out->affinity < out->budget) {
+            out->budget = out->affinity;
+        }
+    }
+    return CB_OK;
+}
+
+int cb_cpu_budget(void)
+{
+    cb_cpu_limits_t limits;
+    cb_cpu_limits(&limits);
+    return limits.budget;
+}
+
+cb_error_t cb_cpu_topology(int *core_of, int max_cpus, int *num_cpus)
+{
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION *info = NULL;
+    DWORD_PTR process_mask, system_mask;
+    DWORD bytes = 0;
+    int cores = 0;
+
+    if (!core_of || max_cpus < 1 || !num_cpus) {
+        return CB_ERR_ARGS;
+    }
+
+    *num_cpus = 0;
+    for (int cpu = 0; cpu < max_cpus; cpu++) {
+        core_of[cpu] = -1;
+    }
+
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                                &system_mask)) {
+        return CB_ERR_PLATFORM;
+    }
+
+    GetLogicalProcessorInformation(NULL, &bytes);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || bytes == 0) {
+        return CB_ERR_PLATFORM;
+    }
+    info = malloc(bytes);
+    if (!info) {
+        return CB_ERR_ALLOC;
+    }
+    if (!GetLogicalProcessorInformation(info, &bytes)) {
+        free(info);
+        return CB_ERR_PLATFORM;
+    }
+
+    /* Masks cover the calling thread's processor group only. */
+    int mask_bits = (int)(sizeof(DWORD_PTR) * 8);
+    DWORD entries = bytes / sizeof(*info);
+    for (DWORD e = 0; e < entries; e++) {
+        if (info[e].Relationship != RelationProcessorCore) {
+            continue;
+        }
+        bool listed = false;
+        for (int cpu = 0; cpu < max_cpus && cpu < mask_bits; cpu++) {
+            DWORD_PTR bit = (DWORD_PTR)1 << cpu;
+            if ((info[e].ProcessorMask & bit) && (process_mask & bit)) {
+                core_of[cpu] = cores;
+                listed = true;
+                if (cpu + 1 > *num_cpus) {
+                    *num_cpus = cpu + 1;
+                }
+            }
+        }
+        if (listed) {
+            cores++;
+        }
+    }
+
+    free(info);
+    return cores > 0 ? CB_OK : CB_ERR_PLATFORM;
+}
+
+cb_error_t cb_cpu_stat_read(cb_cpu_stat_t *out)
+{
+    if (!out) {
+        return CB_ERR_ARGS;
+    }
+    memset(out, 0, sizeof(*out));
+    return CB_ERR_PLATFORM;
+}
+
 cb_error_t cb_system_info_str(char *buf, size_t buf_size)
 {
     if (!buf || buf_size == 0) {
@@ -450,6 +1083,64 @@ cb_error_t cb_system_info_str(char *buf, size_t buf_size)
     return CB_OK;
 }
 
+cb_error_t cb_host_fingerprint(char *buf, size_t buf_size)
+{
+    static const char cpu_key[] =
+        "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0";
+    char model[128] = "unknown";
+    char microcode[32] = "unknown";
+    unsigned char rev[8];
+    DWORD size;
+
+    if (!buf || buf_size == 0) {
+        return CB_ERR_ARGS;
+    }
+
+    size = sizeof(model);
+    if (RegGetValueA(HKEY_LOCAL_MACHINE, cpu_key, "ProcessorNameString",
+                     RRF_RT_REG_SZ, NULL, model, &size) != ERROR_SUCCESS) {
+        snprintf(model, sizeof(model), "unknown");
+    }
+
+    /* "Update Revision" is an 8-byte binary value; the revision is the
+     * high DWORD. */
+    size = sizeof(rev);
+    if (RegGetValueA(HKEY_LOCAL_MACHINE, cpu_key, "Update Revision",
+                     RRF_RT_REG_BINARY, NULL, rev, &size) == ERROR_SUCCESS &&
+        size == sizeof(rev)) {
+        unsigned long r = (unsigned long)rev[4] | (unsigned long)rev[5] << 8 |
+                          (unsigned long)rev[6] << 16 |
+                          (unsigned long)rev[7] << 24;
+        snprintf(microcode, sizeof(microcode), "0x%lx", r);
+    }
+
+    /* GetVersionEx() is capped by the manifest; the kernel32 build is
+     * what changes with an OS update. */
+    char kernel[64] = "unknown";
+    char path[MAX_PATH];
+    if (GetSystemDirectoryA(path, sizeof(path)) > 0) {
+        strncat(path, "\\kernel32.dll", sizeof(path) - strlen(path) - 1);
+        DWORD handle = 0;
+        DWORD vsize = GetFileVersionInfoSizeA(path, &handle);
+        void *vinfo = vsize ? malloc(vsize) : NULL;
+        VS_FIXEDFILEINFO *ffi = NULL;
+        UINT flen = 0;
+        if (vinfo && GetFileVersionInfoA(path, 0, vsize, vinfo) &&
+            VerQueryValueA(vinfo, "\\", (void **)&ffi, &flen) && ffi) {
+            snprintf(kernel, sizeof(kernel), "Windows %lu.%lu.%lu.%lu",
+                     (unsigned long)HIWORD(ffi->dwFileVersionMS),
+                     (unsigned long)LOWORD(ffi->dwFileVersionMS),
+                     (unsigned long)HIWORD(ffi->dwFileVersionLS),
+                     (unsigned long)LOWORD(ffi->dwFileVersionLS));
+        }
+        free(vinfo);
+    }
+
+    snprintf(buf, buf_size, "cpu=%s; microcode=%s; kernel=%s; cores=%d",
+             model, microcode, kernel, cb_cpu_count());
+    return CB_OK;
+}
+
 cb_error_t cb_get_exe_path(char *buf, size_t buf_size)
 {
     if (!buf || buf_size == 0) {
@@ -0,0 +1,160 @@
+/**
+ * @file pool.c
+ * @brief Implementation of the persistent phase pool.
+ *
+ * Threads pass a start gate once all of them exist, then loop: wait at
+ * the barrier, read the phase, run the step, wait again. Destroying
+ * the pool publishes POOL_EXIT and passes only the first barrier
+ * episode, which the threads leave by returning.
+ */
+
+#include "pool.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "barrier.h"
+#include "platform.h"
+
+/** @brief Phase that makes the threads return. */
+#define POOL_EXIT (-1)
+
+/**
+ * @brief Per-thread argument.
+ */
+typedef struct {
+    cb_pool_t *pool;  /**< Owning pool. */
+    int        id;    /**< Participant index (1 .. size - 1). */
+} pool_arg_t;
+
+/**
+ * @brief Pool state.
+ */
+struct cb_pool {
+    cb_barrier_t    *barrier;  /**< Phase barrier over all participants. */
+    cb_thread_t     *threads;  /**< Threads 1 .. size - 1. */
+    pool_arg_t      *args;     /**< Their arguments. */
+    int              size;     /**< Participants, including the caller. */
+    int              created;  /**< Threads started. */
+    bool             running;  /**< All threads passed the gate. */
+    cb_pool_step_fn  step;     /**< Work per participant and phase. */
+    void            *ctx;      /**< Argument of step. */
+    _Atomic int      phase;    /**< Current phase, or POOL_EXIT. */
+    cb_start_gate_t  gate;     /**< Start gate. */
+};
+
+/** @brief Thread body: run phases until POOL_EXIT. */
+static void *pool_thread_fn(void *arg)
+{
+    pool_arg_t *a = (pool_arg_t *)arg;
+    cb_pool_t *pool = a->pool;
+
+    if (!cb_start_gate_wait(&pool->gate)) {
+        return NULL;
+    }
+
+    for (;;) {
+        cb_barrier_wait(pool->barrier, a->id);
+        int phase = atomic_load(&pool->phase);
+        if (phase == POOL_EXIT) {
+            return NULL;
+        }
+        pool->step(pool->ctx, a->id, phase);
+        cb_barrier_wait(pool->barrier, a->id);
+    }
+}
+
+cb_error_t cb_pool_create(cb_pool_t **out, int size, cb_pool_step_fn step,
+                          void *ctx)
+{
+    if (!out || !step || size < 1 || size > CB_MAX_WORKERS) {
+        return CB_ERR_ARGS;
+    }
+
+    *out = NULL;
+
+    cb_error_t err = CB_OK;
+    cb_pool_t *pool = calloc(1, sizeof(cb_pool_t));
+    if (!pool) {
+        return CB_ERR_ALLOC;
+    }
+
+    pool->size = size;
+    pool->step = step;
+    pool->ctx = ctx;
+    pool->barrier = cb_aligned_alloc(CB_CACHE_LINE, sizeof(cb_barrier_t));
+    pool->threads = calloc((size_t)size, sizeof(cb_thread_t));
+    pool->args = calloc((size_t)size, sizeof(pool_arg_t));
+    if (!pool->barrier || !pool->threads || !pool->args) {
+        cb_aligned_free(pool->barrier);
+        pool->barrier = NULL;
+        err = CB_ERR_ALLOC;
+        goto fail;
+    }
+
+    err = cb_barrier_init(pool->barrier, CB_BARRIER_CENTRAL,
+                          CB_WAIT_SPIN_FUTEX, size, false);
+    if (err) {
+        cb_aligned_free(pool->barrier);
+        pool->barrier = NULL;
+        goto fail;
+    }
+
+    cb_start_gate_init(&pool->gate);
+    for (int i = 1; i < size; i++) {
+        pool->args[i].pool = pool;
+        pool->args[i].id = i;
+        err = cb_thread_create(&pool->threads[i], pool_thread_fn,
+                               &pool->args[i]);
+        if (err) {
+            break;
+        }
+        pool->created++;
+    }
+    if (err) {
+        cb_start_gate_abort(&pool->gate);
+        goto fail;
+    }
+    cb_start_gate_open(&pool->gate);
+    pool->running = true;
+
+    *out = pool;
+    return CB_OK;
+
+fail:
+    cb_pool_destroy(pool);
+    return err;
+}
+
+double cb_pool_run(cb_pool_t *pool, int phase)
+{
+    atomic_store(&pool->phase, phase);
+    double t_start = cb_time_now();
+    cb_barrier_wait(pool->barrier, 0);
+    pool->step(pool->ctx, 0, phase);
+    cb_barrier_wait(pool->barrier, 0);
+    return cb_time_now() - t_start;
+}
+
+void cb_pool_destroy(cb_pool_t *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    if (pool->running) {
+        atomic_store(&pool->phase, POOL_EXIT);
+        cb_barrier_wait(pool->barrier, 0);
+    }
+    for (int i = 1; i <= pool->created; i++) {
+        cb_thread_join(&pool->threads[i]);
+    }
+    if (pool->barrier) {
+        cb_barrier_destroy(pool->barrier);
+        cb_aligned_free(pool->barrier);
+    }
+    free(pool->threads);
+    free(pool->args);
+    free(pool);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file pool.h
+ * @brief Persistent thread pool driven phase by phase by its creator.
+ *
+ * The creating thread is participant 0 and the pool starts the others,
+ * which stay alive until the pool is destroyed. Each cb_pool_run()
+ * publishes a phase number and passes a barrier; every participant,
+ * the caller included, then runs the step function for that phase,
+ * and a second barrier episode ends the phase. Suites that time many
+ * short phases use it so thread creation stays out of the samples.
+ */
+
+#ifndef CB_POOL_H
+#define CB_POOL_H
+
+#include "error.h"
+
+/**
+ * @brief Work of one participant in one phase.
+ *
+ * @param ctx    Caller context given to cb_pool_create().
+ * @param id     Participant index (0 is the caller of cb_pool_run()).
+ * @param phase  Phase number given to cb_pool_run().
+ */
+typedef void (*cb_pool_step_fn)(void *ctx, int id, int phase);
+
+/** @brief Opaque pool handle. */
+typedef struct cb_pool cb_pool_t;
+
+/**
+ * @brief Create a pool of @p size participants and start its threads.
+ *
+ * @param out   Output pointer to the new pool.
+ * @param size  Participants, including the caller (1 - CB_MAX_WORKERS).
+ * @param step  Step function run by every participant in every phase.
+ * @param ctx   Context passed to @p step.
+ * @return CB_OK on success, or CB_ERR_ARGS, CB_ERR_ALLOC, CB_ERR_THREAD
+ *         on failure (any threads already started are joined).
+ */
+cb_error_t cb_pool_create(cb_pool_t **out, int size, cb_pool_step_fn step,
+                          void *ctx);
+
+/**
+ * @brief Run one phase on every participant, the caller as participant 0.
+ *
+ * @param pool   Pool from cb_pool_create().
+ * @param phase  Phase number passed to the step function (>= 0).
+ * @return Seconds from publishing the phase to the last participant
+ *         finishing it, including one barrier round trip.
+ */
+double cb_pool_run(cb_pool_t *pool, int phase);
+
+/**
+ * @brief Stop and join the threads and free the pool.
+ * @param pool  Pool to destroy, or NULL (no-op).
+ */
+void cb_pool_destroy(cb_pool_t *pool);
+
+#endif /* CB_POOL_H */
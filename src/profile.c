@@ -0,0 +1,179 @@
+/**
+ * @file profile.c
+ * @brief Implementation of the host calibration profile.
+ *
+ * File format, one entry per line, unknown lines ignored:
+ *
+ *     # comment
+ *     version <CB_PROFILE_VERSION>
+ *     fingerprint <cb_host_fingerprint() output>
+ *     timer <source> <tsc GHz> <resolution ns> <overhead ns>
+ *           <monotonic resolution ns> <monotonic overhead ns>
+ *     kernel <name> <GB/s> <default GB/s> <cb_kernel_build_id()>
+ *
+ * (the timer entry is a single line). Entries are only used once both
+ * the version and the fingerprint lines have matched.
+ */
+
+#include "profile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "kernel.h"
+#include "platform.h"
+
+/** @brief Maximum length of a profile line. */
+#define PROFILE_LINE_LEN 512
+
+cb_error_t cb_profile_init(cb_profile_t *profile)
+{
+    if (!profile) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(profile, 0, sizeof(*profile));
+    return cb_host_fingerprint(profile->fingerprint,
+                               sizeof(profile->fingerprint));
+}
+
+/** @brief Parse a timer entry (after "timer "). */
+static bool parse_timer(const char *s, cb_timer_info_t *t)
+{
+    char source[16];
+
+    memset(t, 0, sizeof(*t));
+    if (sscanf(s, "%15s %lf %lf %lf %lf %lf", source, &t->tsc_ghz,
+               &t->resolution_ns, &t->overhead_ns, &t->mono_resolution_ns,
+               &t->mono_overhead_ns) != 6) {
+        return false;
+    }
+    t->source = strcmp(source, cb_timer_source_name(CB_TIMER_TSC)) == 0
+                    ? CB_TIMER_TSC : CB_TIMER_MONOTONIC;
+    return true;
+}
+
+/** @brief Parse a kernel entry (after "kernel "). */
+static bool parse_kernel(const char *s, cb_profile_t *p)
+{
+    int used = 0;
+
+    if (sscanf(s, "%15s %lf %lf %n", p->kernel_name, &p->kernel_gbps,
+               &p->kernel_naive_gbps, &used) != 3 || used == 0) {
+        return false;
+    }
+    snprintf(p->kernel_build, sizeof(p->kernel_build), "%s", s + used);
+    return true;
+}
+
+cb_error_t cb_profile_load(const char *path, cb_profile_t *profile,
+                           cb_profile_status_t *status)
+{
+    char line[PROFILE_LINE_LEN];
+    int version = 0;
+    bool host_ok = false;
+    cb_profile_t stored;
+
+    if (!path || !profile || !status) {
+        return CB_ERR_ARGS;
+    }
+
+    cb_error_t err = cb_profile_init(profile);
+    if (err) {
+        return err;
+    }
+    *status = CB_PROFILE_MISSING;
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return CB_OK;
+    }
+
+    memset(&stored, 0, sizeof(stored));
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (sscanf(line, "version %d", &version) == 1) {
+            continue;
+        } else if (strncmp(line, "fingerprint ", 12) == 0) {
+            host_ok = strcmp(line + 12, profile->fingerprint) == 0;
+        } else if (strncmp(line, "timer ", 6) == 0) {
+            stored.has_timer = parse_timer(line + 6, &stored.timer);
+        } else if (strncmp(line, "kernel ", 7) == 0) {
+            stored.has_kernel = parse_kernel(line + 7, &stored);
+        }
+    }
+    fclose(f);
+
+    if (version != CB_PROFILE_VERSION || !host_ok) {
+        *status = CB_PROFILE_STALE;
+        return CB_OK;
+    }
+
+    profile->has_timer = stored.has_timer;
+    profile->timer = stored.timer;
+
+    /* A rebuild may have changed the kernels; keep the rest. */
+    if (stored.has_kernel &&
+        strcmp(stored.kernel_build, cb_kernel_build_id()) == 0) {
+        profile->has_kernel = true;
+        memcpy(profile->kernel_name, stored.kernel_name,
+               sizeof(profile->kernel_name));
+        memcpy(profile->kernel_build, stored.kernel_build,
+               sizeof(profile->kernel_build));
+        profile->kernel_gbps = stored.kernel_gbps;
+        profile->kernel_naive_gbps = stored.kernel_naive_gbps;
+    }
+
+    *status = CB_PROFILE_LOADED;
+    return CB_OK;
+}
+
+cb_error_t cb_profile_save(const char *path, const cb_profile_t *profile)
+{
+    char dir[CB_MAX_PATH];
+
+    if (!path || !profile) {
+        return CB_ERR_ARGS;
+    }
+
+    /* Create the parent directory, if the path has one. */
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *slash = strrchr(dir, '/');
+    char *bslash = strrchr(dir, '\\');
+    if (bslash && (!slash || bslash > slash)) {
+        slash = bslash;
+    }
+    if (slash && slash != dir) {
+        *slash = '\0';
+        if (cb_mkdir_p(dir) != CB_OK) {
+            return CB_ERR_IO;
+        }
+    }
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        return CB_ERR_IO;
+    }
+
+    fprintf(f, "# concur-bench host profile; delete or run with "
+            "--recalibrate to measure again\n");
+    fprintf(f, "version %d\n", CB_PROFILE_VERSION);
+    fprintf(f, "fingerprint %s\n", profile->fingerprint);
+    if (profile->has_timer) {
+        const cb_timer_info_t *t = &profile->timer;
+        fprintf(f, "timer %s %.12g %.3f %.3f %.3f %.3f\n",
+                cb_timer_source_name(t->source), t->tsc_ghz,
+                t->resolution_ns, t->overhead_ns, t->mono_resolution_ns,
+                t->mono_overhead_ns);
+    }
+    if (profile->has_kernel) {
+        fprintf(f, "kernel %s %.3f %.3f %s\n", profile->kernel_name,
+                profile->kernel_gbps, profile->kernel_naive_gbps,
+                profile->kernel_build);
+    }
+
+    if (fclose(f) != 0) {
+        return CB_ERR_IO;
+    }
+    return CB_OK;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file profile.h
+ * @brief Persistent per-host calibration profile.
+ *
+ * Startup calibration (the TSC rate, timer resolution and overhead,
+ * and the tuned sum kernel) depends only on the host, so it is saved
+ * in a small versioned text file and restored by later runs instead
+ * of being measured again. The file is keyed by the host fingerprint
+ * from cb_host_fingerprint() (CPU model, microcode, OS kernel, core
+ * count) and by CB_PROFILE_VERSION; if either differs, the stored
+ * entries are ignored and the file is rewritten after calibration.
+ *
+ * Each entry is optional. A run fills in what it calibrated and
+ * saves the profile only if something new was measured.
+ */
+
+#ifndef CB_PROFILE_H
+#define CB_PROFILE_H
+
+#include <stdbool.h>
+
+#include "error.h"
+#include "timer.h"
+#include "types.h"
+
+/** @brief Default location of the host profile. */
+#define CB_PROFILE_FILE  "results/host_profile.txt"
+
+/** @brief File format version; bump when entries change meaning. */
+#define CB_PROFILE_VERSION  1
+
+/** @brief Maximum length of the host fingerprint. */
+#define CB_PROFILE_FINGERPRINT_LEN  384
+
+/** @brief Maximum length of the kernel build ID. */
+#define CB_PROFILE_BUILD_LEN  64
+
+/**
+ * @brief What cb_profile_load() found.
+ */
+typedef enum {
+    CB_PROFILE_MISSING = 0,  /**< No profile file yet. */
+    CB_PROFILE_STALE,        /**< File for another host or version. */
+    CB_PROFILE_LOADED        /**< File matched; entries restored. */
+} cb_profile_status_t;
+
+/**
+ * @brief Calibration results for one host.
+ */
+typedef struct {
+    char            fingerprint[CB_PROFILE_FINGERPRINT_LEN]; /**< This host. */
+    bool            has_timer;    /**< timer is valid. */
+    cb_timer_info_t timer;        /**< Timer measurements. */
+    bool            has_kernel;   /**< kernel_* fields are valid. */
+    char            kernel_name[CB_KERNEL_NAME_LEN];   /**< Tuned kernel. */
+    char            kernel_build[CB_PROFILE_BUILD_LEN]; /**< cb_kernel_build_id() when tuned. */
+    double          kernel_gbps;        /**< Tuned kernel rate (GB/s). */
+    double          kernel_naive_gbps;  /**< Default kernel rate (GB/s). */
+} cb_profile_t;
+
+/**
+ * @brief Start an empty profile for the current host.
+ *
+ * @param profile  Output.
+ * @return CB_OK, or CB_ERR_ARGS if @p profile is NULL.
+ */
+cb_error_t cb_profile_init(cb_profile_t *profile);
+
+/**
+ * @brief Load the profile for the current host.
+ *
+ * Always leaves a usable profile for the current host in @p profile;
+ * entries are filled in only if the file exists and its version and
+ * fingerprint match. A kernel entry from another build is dropped on
+ * its own.
+ *
+ * @param path     Profile file.
+ * @param profile  Output.
+ * @param status   Output: what was found.
+ * @return CB_OK, or CB_ERR_ARGS on NULL arguments.
+ */
+cb_error_t cb_profile_load(const char *path, cb_profile_t *profile,
+                           cb_profile_status_t *status);
+
+/**
+ * @brief Write @p profile to @p path, creating its directory.
+ *
+ * @return CB_OK, or CB_ERR_IO if the file cannot be written.
+ */
+cb_error_t cb_profile_save(const char *path, const cb_profile_t *profile);
+
+#endif /* CB_PROFILE_H */
@@ -0,0 +1,71 @@
+/**
+ * @file reduce.c
+ * @brief Implementation of the tree reduction.
+ *
+ * A value is written before its flag is published and read after the
+ * flag is seen, and the flag operations are sequentially consistent,
+ * so plain loads and stores suffice for the values themselves.
+ */
+
+#include "reduce.h"
+
+#include <string.h>
+
+cb_error_t cb_reduce_init(cb_reduce_t *reduce, int count,
+                          cb_wait_policy_t policy, bool process_shared)
+{
+    if (!reduce || count < 1 || count > CB_MAX_WORKERS ||
+        policy < 0 || policy >= CB_WAIT_POLICY_COUNT) {
+        return CB_ERR_ARGS;
+    }
+
+    memset(reduce, 0, sizeof(*reduce));
+
+    reduce->count = count;
+    reduce->policy = policy;
+    reduce->process_shared = process_shared;
+
+    int rounds = 0;
+    while ((1 << rounds) < count) {
+        rounds++;
+    }
+    reduce->rounds = rounds;
+
+    return CB_OK;
+}
+
+long int cb_reduce_tree(cb_reduce_t *reduce, int id, uint32_t episode,
+                        long int value)
+{
+    for (int r = 0; r < reduce->rounds; r++) {
+        int stride = 1 << r;
+
+        if (id & stride) {
+            /* Hand the subtree sum to the parent and drop out. */
+            cb_reduce_slot_t *mine = &reduce->slots[id];
+            mine->value = value;
+            cb_flag_publish(&mine->ready, episode, 1, reduce->process_shared);
+            return value;
+        }
+
+        int partner = id + stride;
+        if (partner < reduce->count) {
+            cb_reduce_slot_t *child = &reduce->slots[partner];
+            cb_flag_wait(&child->ready, episode, reduce->policy,
+                         reduce->process_shared);
+            value += child->value;
+        }
+    }
+
+    /* Only participant 0 gets here. */
+    reduce->total = value;
+    cb_flag_publish(&reduce->done, episode, INT32_MAX, reduce->process_shared);
+    return value;
+}
+
+long int cb_reduce_wait(cb_reduce_t *reduce, uint32_t episode)
+{
+    cb_flag_wait(&reduce->done, episode, reduce->policy,
+                 reduce->process_shared);
+    return reduce->total;
+}
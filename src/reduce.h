@@ -0,0 +1,88 @@
+/**
+ * @file reduce.h
+ * @brief Tree reduction of per-worker partial sums.
+ *
+ * Combines N partial results in ceil(log2 N) rounds instead of one
+ * serial pass. In round r, participant i with bit r set hands its value
+ * to participant i - 2^r through its slot and drops out; participant
+ * i with bits 0 .. r clear waits for participant i + 2^r and adds its
+ * value. Participant 0 ends up with the total and publishes it.
+ *
+ * Like cb_barrier_t, the structure holds no pointers, so it works on
+ * the heap for threads or in a cb_shared_mem_t region for processes.
+ * Slots are padded to their own cache lines. Flags carry episode
+ * numbers and never need resetting: pass 1, 2, 3, ... for successive
+ * reductions.
+ */
+
+#ifndef CB_REDUCE_H
+#define CB_REDUCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "barrier.h"
+#include "error.h"
+#include "types.h"
+
+/**
+ * @brief One participant's hand-off slot.
+ */
+typedef struct {
+    _Alignas(CB_CACHE_LINE) cb_flag_t ready;  /**< Episode of the latest value. */
+    long int value;                           /**< Partial sum handed up. */
+} cb_reduce_slot_t;
+
+/**
+ * @brief Reduction state for up to CB_MAX_WORKERS participants.
+ */
+typedef struct {
+    int              count;           /**< Number of participants. */
+    int              rounds;          /**< ceil(log2(count)). */
+    cb_wait_policy_t policy;          /**< How combiners wait for partners. */
+    bool             process_shared;  /**< True if placed in shared memory. */
+    _Alignas(CB_CACHE_LINE) cb_flag_t done; /**< Episode of the latest total. */
+    long int         total;           /**< Total of the latest episode. */
+    cb_reduce_slot_t slots[CB_MAX_WORKERS]; /**< One slot per participant. */
+} cb_reduce_t;
+
+/**
+ * @brief Initialize a reduction in caller-provided (heap or shared) memory.
+ *
+ * @param reduce          Storage of at least sizeof(cb_reduce_t) bytes,
+ *                        aligned to CB_CACHE_LINE.
+ * @param count           Number of participants (1 - CB_MAX_WORKERS).
+ * @param policy          Wait policy for partner values.
+ * @param process_shared  True if participants are separate processes.
+ * @return CB_OK on success, or CB_ERR_ARGS.
+ */
+cb_error_t cb_reduce_init(cb_reduce_t *reduce, int count,
+                          cb_wait_policy_t policy, bool process_shared);
+
+/**
+ * @brief Contribute a partial sum to one tree reduction.
+ *
+ * Returns as soon as the caller has handed its value up, so only
+ * participant 0 waits for the whole tree. Participant 0 stores the
+ * total in reduce->total and publishes @p episode on reduce->done.
+ *
+ * @param reduce   Reduction state.
+ * @param id       Caller's participant index (0 .. count - 1).
+ * @param episode  Episode number of this reduction (1, 2, 3, ...).
+ * @param value    Caller's partial sum.
+ * @return The total for participant 0; the caller's subtree sum
+ *         for everyone else.
+ */
+long int cb_reduce_tree(cb_reduce_t *reduce, int id, uint32_t episode,
+                        long int value);
+
+/**
+ * @brief Wait for the total of an episode (any thread or process).
+ *
+ * @param reduce   Reduction state.
+ * @param episode  Episode number to wait for.
+ * @return The total.
+ */
+long int cb_reduce_wait(cb_reduce_t *reduce, uint32_t episode);
+
+#endif /* CB_REDUCE_H */
@@ -0,0 +1,298 @@
+/**
+ * @file sort.c
+ * @brief Implementation of sorting kernels.
+ *
+ * Radix digits are taken from the key with its sign bit flipped, so
+ * negative integers order correctly under unsigned digit comparison.
+ */
+
+#include "sort.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Extract radix digit @p pass from a signed key.
+ */
+static unsigned int radix_digit(int key, int pass)
+{
+    uint32_t u = (uint32_t)key ^ 0x80000000u;
+    return (u >> (8 * pass)) & 0xFFu;
+}
+
+/**
+ * @brief Merge src[lo..mid) and src[mid..hi) into dst[lo..hi).
+ */
+static void merge_pair(const int *src, int *dst, int lo, int mid, int hi)
+{
+    int i = lo, j = mid, k = lo;
+
+    while (i < mid && j < hi) {
+        dst[k++] = (src[j] < src[i]) ? src[j++] : src[i++];
+    }
+    while (i < mid) {
+        dst[k++] = src[i++];
+    }
+    while (j < hi) {
+        dst[k++] = src[j++];
+    }
+}
+
+void cb_sort_merge(int *data, int *scratch, int n)
+{
+    int *src = data;
+    int *dst = scratch;
+
+    /* 64-bit arithmetic keeps lo + 2 * width from overflowing near INT_MAX. */
+    for (long long width = 1; width < n; width *= 2) {
+        for (long long lo = 0; lo < n; lo += 2 * width) {
+            long long mid = (lo + width < n) ? lo + width : n;
+            long long hi  = (lo + 2 * width < n) ? lo + 2 * width : n;
+            merge_pair(src, dst, (int)lo, (int)mid, (int)hi);
+        }
+        int *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != data) {
+        memcpy(data, src, (size_t)n * sizeof(int));
+    }
+}
+
+void cb_sort_radix_histogram(const int *src, int n, int pass, int *hist)
+{
+    memset(hist, 0, CB_RADIX_BUCKETS * sizeof(int));
+
+    for (int i = 0; i < n; i++) {
+        hist[radix_digit(src[i], pass)]++;
+    }
+}
+
+void cb_sort_radix_scatter(const int *src, int n, int pass, int *offsets,
+                           int *dst)
+{
+    for (int i = 0; i < n; i++) {
+        dst[offsets[radix_digit(src[i], pass)]++] = src[i];
+    }
+}
+
+void cb_sort_radix(int *data, int *scratch, int n)
+{
+    int hist[CB_RADIX_BUCKETS];
+    int *src = data;
+    int *dst = scratch;
+
+    for (int pass = 0; pass < CB_RADIX_PASSES; pass++) {
+        cb_sort_radix_histogram(src, n, pass, hist);
+
+        int offset = 0;
+        bool trivial = false;
+        for (int d = 0; d < CB_RADIX_BUCKETS; d++) {
+            int count = hist[d];
+            if (count == n) {
+                trivial = true;
+            }
+            hist[d] = offset;
+            offset += count;
+        }
+
+        if (trivial) {
+            continue; /* Every key shares this digit. */
+        }
+
+        cb_sort_radix_scatter(src, n, pass, hist, dst);
+
+        int *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != data) {
+        memcpy(data, src, (size_t)n * sizeof(int));
+    }
+}
+
+/** @brief First index in [lo, hi) with data[i] >= value. */
+static int lower_bound(const int *data, int lo, int hi, long long value)
+{
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if ((long long)data[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/** @brief First index in [lo, hi) with data[i] > value. */
+static int upper_bound(const int *data, int lo, int hi, long long value)
+{
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if ((long long)data[mid] <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void cb_sort_split_runs(const int *data, const int *bounds, int num_runs,
+                        long rank, int *split)
+{
+    long total = 0;
+    long long lo = INT_MAX, hi = INT_MIN;
+
+    for (int j = 0; j < num_runs; j++) {
+        int len = bounds[j + 1] - bounds[j];
+        total += len;
+        if (len > 0 && data[bounds[j]] < lo) {
+            lo = data[bounds[j]];
+        }
+        if (len > 0 && data[bounds[j + 1] - 1] > hi) {
+            hi = data[bounds[j + 1] - 1];
+        }
+    }
+
+    if (rank <= 0 || rank >= total) {
+        for (int j = 0; j < num_runs; j++) {
+            split[j] = (rank <= 0) ? bounds[j] : bounds[j + 1];
+        }
+        return;
+    }
+
+    /* Smallest value v with count(<= v) >= rank. */
+    while (lo < hi) {
+        long long mid = lo + (hi - lo) / 2;
+        long count = 0;
+        for (int j = 0; j < num_runs; j++) {
+            count += upper_bound(data, bounds[j], bounds[j + 1], mid) - bounds[j];
+        }
+        if (count >= rank) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    /* Take everything below v, then fill the rest with copies of v. */
+    long remaining = rank;
+    for (int j = 0; j < num_runs; j++) {
+        split[j] = lower_bound(data, bounds[j], bounds[j + 1], lo);
+        remaining -= split[j] - bounds[j];
+    }
+    for (int j = 0; j < num_runs && remaining > 0; j++) {
+        int equal_end = upper_bound(data, split[j], bounds[j + 1], lo);
+        long take = equal_end - split[j];
+        if (take > remaining) {
+            take = remaining;
+        }
+        split[j] += (int)take;
+        remaining -= take;
+    }
+}
+
+/**
+ * @brief Heap entry: current head value and the run it came from.
+ */
+typedef struct {
+    int value;  /**< Head element of the run. */
+    int run;    /**< Run index. */
+} heap_node_t;
+
+/** @brief Restore the min-heap property downward from index @p i. */
+static void sift_down(heap_node_t *heap, int size, int i)
+{
+    for (;;) {
+        int smallest = i;
+        int l = 2 * i + 1, r = 2 * i + 2;
+        if (l < size && heap[l].value < heap[smallest].value) {
+            smallest = l;
+        }
+        if (r < size && heap[r].value < heap[smallest].value) {
+            smallest = r;
+        }
+        if (smallest == i) {
+            return;
+        }
+        heap_node_t tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+cb_error_t cb_sort_kway_merge(const int *src, const int *starts,
+                              const int *ends, int k, int *dst)
+{
+    heap_node_t *heap = NULL;
+    int *pos = NULL;
+
+    heap = malloc((size_t)(k > 0 ? k : 1) * sizeof(*heap));
+    pos  = malloc((size_t)(k > 0 ? k : 1) * sizeof(*pos));
+    if (!heap || !pos) {
+        free(heap);
+        free(pos);
+        return CB_ERR_ALLOC;
+    }
+
+    int size = 0;
+    for (int j = 0; j < k; j++) {
+        pos[j] = starts[j];
+        if (pos[j] < ends[j]) {
+            heap[size].value = src[pos[j]];
+            heap[size].run = j;
+            size++;
+        }
+    }
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        sift_down(heap, size, i);
+    }
+
+    int out = 0;
+    while (size > 0) {
+        int run = heap[0].run;
+        dst[out++] = heap[0].value;
+
+        if (++pos[run] < ends[run]) {
+            heap[0].value = src[pos[run]];
+        } else {
+            heap[0] = heap[--size];
+        }
+        sift_down(heap, size, 0);
+    }
+
+    free(heap);
+    free(pos);
+    return CB_OK;
+}
+
+bool cb_sort_is_sorted(const int *data, int n)
+{
+    for (int i = 1; i < n; i++) {
+        if (data[i] < data[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t cb_sort_fingerprint(const int *data, int n)
+{
+    uint64_t acc = 0;
+
+    for (int i = 0; i < n; i++) {
+        /* splitmix64 finalizer: a bijective, well-mixed hash of the value. */
+        uint64_t z = (uint64_t)(uint32_t)data[i] + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        acc += z ^ (z >> 31);
+    }
+
+    return acc;
+}
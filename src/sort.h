@@ -0,0 +1,125 @@
+/**
+ * @file sort.h
+ * @brief Sorting kernels for the sort workload.
+ *
+ * Provides the sequential building blocks that the sort benchmark
+ * composes into single-threaded, thread-parallel, and process-parallel
+ * sorts: a bottom-up merge sort, an LSD radix sort on 8-bit digits,
+ * the per-digit histogram/scatter steps used by the parallel radix
+ * sort, rank-exact splitting of sorted runs (multisequence selection),
+ * and a heap-based k-way merge. Also provides the checks used to verify
+ * that an output is sorted and a permutation of its input.
+ */
+
+#ifndef CB_SORT_H
+#define CB_SORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "error.h"
+
+/** @brief Number of buckets per radix digit (8-bit digits). */
+#define CB_RADIX_BUCKETS  256
+
+/** @brief Number of radix passes for 32-bit keys. */
+#define CB_RADIX_PASSES   4
+
+/**
+ * @brief Sort an array with a bottom-up merge sort.
+ *
+ * @param data     Array to sort in place.
+ * @param scratch  Scratch buffer of at least @p n elements.
+ * @param n        Number of elements.
+ */
+void cb_sort_merge(int *data, int *scratch, int n);
+
+/**
+ * @brief Sort an array with an LSD radix sort (four 8-bit passes).
+ *
+ * Passes whose digit is identical for every key are skipped. The
+ * sorted result is left in @p data.
+ *
+ * @param data     Array to sort.
+ * @param scratch  Scratch buffer of at least @p n elements.
+ * @param n        Number of elements.
+ */
+void cb_sort_radix(int *data, int *scratch, int n);
+
+/**
+ * @brief Count the radix digit of every key in a slice.
+ *
+ * @param src   Source keys.
+ * @param n     Number of keys.
+ * @param pass  Digit index (0 = least significant).
+ * @param hist  Output histogram of CB_RADIX_BUCKETS counts (overwritten).
+ */
+void cb_sort_radix_histogram(const int *src, int n, int pass, int *hist);
+
+/**
+ * @brief Stably scatter a slice to its digit buckets.
+ *
+ * @param src      Source keys.
+ * @param n        Number of keys.
+ * @param pass     Digit index (0 = least significant).
+ * @param offsets  Per-bucket destination indices into @p dst; advanced
+ *                 as keys are written.
+ * @param dst      Destination array.
+ */
+void cb_sort_radix_scatter(const int *src, int n, int pass, int *offsets,
+                           int *dst);
+
+/**
+ * @brief Split sorted runs at an exact global rank.
+ *
+ * The runs are data[bounds[j] .. bounds[j + 1]) for j in [0, num_runs).
+ * On return, split[j] (absolute index within run j) satisfies
+ * sum_j (split[j] - bounds[j]) == rank, and every element before a
+ * split is <= every element after any split. Handles duplicate keys.
+ *
+ * @param data      Array holding the runs.
+ * @param bounds    num_runs + 1 run boundaries.
+ * @param num_runs  Number of runs.
+ * @param rank      Target global rank (0 .. total elements).
+ * @param split     Output array of num_runs split indices.
+ */
+void cb_sort_split_runs(const int *data, const int *bounds, int num_runs,
+                        long rank, int *split);
+
+/**
+ * @brief Merge k sorted ranges into a contiguous output.
+ *
+ * Range j is src[starts[j] .. ends[j]). Uses a binary heap of run heads.
+ *
+ * @param src     Array holding the ranges.
+ * @param starts  k start indices.
+ * @param ends    k end indices.
+ * @param k       Number of ranges.
+ * @param dst     Output buffer (sum of range lengths elements).
+ * @return CB_OK on success, CB_ERR_ALLOC if the heap cannot be allocated.
+ */
+cb_error_t cb_sort_kway_merge(const int *src, const int *starts,
+                              const int *ends, int k, int *dst);
+
+/**
+ * @brief Check that an array is in non-decreasing order.
+ * @param data  Array to check.
+ * @param n     Number of elements.
+ * @return true if sorted.
+ */
+bool cb_sort_is_sorted(const int *data, int n);
+
+/**
+ * @brief Order-independent fingerprint of the multiset of values.
+ *
+ * Sums a 64-bit mix of every element, so two arrays that are
+ * permutations of each other always produce the same fingerprint and
+ * differing multisets collide only with negligible probability.
+ *
+ * @param data  Array to fingerprint.
+ * @param n     Number of elements.
+ * @return 64-bit fingerprint.
+ */
+uint64_t cb_sort_fingerprint(const int *data, int n);
+
+#endif /* CB_SORT_H */
@@ -0,0 +1,157 @@
+/**
+ * @file store.c
+ * @brief Implementation of the regular and non-temporal store kernels.
+ *
+ * STORE_*_DEFINE expands to one kernel per store instruction. Each
+ * handles elements with scalar code until the output is 16-byte
+ * aligned, then writes one full 64-byte line per iteration, so the
+ * non-temporal version fills whole write-combining buffers, and
+ * finishes the tail with scalar code. Inputs are loaded unaligned;
+ * only the output alignment matters to the stores. Non-temporal
+ * versions end with SFENCE so their stores are globally visible before
+ * the caller reads the data or signals another thread.
+ */
+
+#include "store.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STORE_HAVE_SSE2 1
+#endif
+
+#ifdef STORE_HAVE_SSE2
+/** @brief SFENCE after non-temporal stores, nothing after regular ones. */
+#define STORE_FENCE_REGULAR()
+#define STORE_FENCE_STREAM() _mm_sfence()
+
+/**
+ * @brief Define transform kernel NAME storing with STORE.
+ */
+#define STORE_TRANSFORM_DEFINE(NAME, STORE, FENCE)                          \
+    static void NAME(int *data, int length)                                 \
+    {                                                                       \
+        const __m128i one = _mm_set1_epi32(1);                              \
+        int i = 0;                                                          \
+                                                                            \
+        while (i < length && ((uintptr_t)(data + i) & 15u) != 0) {          \
+            data[i]++;                                                      \
+            i++;                                                            \
+        }                                                                   \
+        for (; length - i >= 16; i += 16) {                                 \
+            __m128i *p = (__m128i *)(uintptr_t)(data + i);                  \
+            __m128i v0 = _mm_add_epi32(_mm_load_si128(p), one);             \
+            __m128i v1 = _mm_add_epi32(_mm_load_si128(p + 1), one);         \
+            __m128i v2 = _mm_add_epi32(_mm_load_si128(p + 2), one);         \
+            __m128i v3 = _mm_add_epi32(_mm_load_si128(p + 3), one);         \
+            STORE(p, v0);                                                   \
+            STORE(p + 1, v1);                                               \
+            STORE(p + 2, v2);                                               \
+            STORE(p + 3, v3);                                               \
+        }                                                                   \
+        for (; i < length; i++) {                                           \
+            data[i]++;                                                      \
+        }                                                                   \
+        FENCE();                                                            \
+    }
+
+/**
+ * @brief Define triad kernel NAME storing with STORE.
+ */
+#define STORE_TRIAD_DEFINE(NAME, STORE, FENCE)                              \
+    static void NAME(float *a, const float *b, const float *c, float s,     \
+                     int length)                                            \
+    {                                                                       \
+        const __m128 vs = _mm_set1_ps(s);                                   \
+        int i = 0;                                                          \
+                                                                            \
+        while (i < length && ((uintptr_t)(a + i) & 15u) != 0) {             \
+            a[i] = b[i] + s * c[i];                                         \
+            i++;                                                            \
+        }                                                                   \
+        for (; length - i >= 16; i += 16) {                                 \
+            for (int k = 0; k < 16; k += 4) {                               \
+                __m128 vb = _mm_loadu_ps(b + i + k);                        \
+                __m128 vc = _mm_loadu_ps(c + i + k);                        \
+                STORE(a + i + k, _mm_add_ps(vb, _mm_mul_ps(vs, vc)));       \
+            }                                                               \
+        }                                                                   \
+        for (; i < length; i++) {                                           \
+            a[i] = b[i] + s * c[i];                                         \
+        }                                                                   \
+        FENCE();                                                            \
+    }
+
+STORE_TRANSFORM_DEFINE(transform_regular, _mm_store_si128, STORE_FENCE_REGULAR)
+STORE_TRANSFORM_DEFINE(transform_stream, _mm_stream_si128, STORE_FENCE_STREAM)
+STORE_TRIAD_DEFINE(triad_regular, _mm_store_ps, STORE_FENCE_REGULAR)
+STORE_TRIAD_DEFINE(triad_stream, _mm_stream_ps, STORE_FENCE_STREAM)
+#else
+/** @brief Scalar transform (no SSE2). */
+static void transform_scalar(int *data, int length)
+{
+    for (int i = 0; i < length; i++) {
+        data[i]++;
+    }
+}
+
+/** @brief Scalar triad (no SSE2). */
+static void triad_scalar(float *a, const float *b, const float *c, float s,
+                         int length)
+{
+    for (int i = 0; i < length; i++) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+#endif /* STORE_HAVE_SSE2 */
+
+void cb_store_transform(int *data, int length, cb_store_kind_t kind)
+{
+#ifdef STORE_HAVE_SSE2
+    if (kind == CB_STORE_STREAM) {
+        transform_stream(data, length);
+    } else {
+        transform_regular(data, length);
+    }
+#else
+    (void)kind;
+    transform_scalar(data, length);
+#endif
+}
+
+void cb_store_triad(float *a, const float *b, const float *c, float s,
+                    int length, cb_store_kind_t kind)
+{
+#ifdef STORE_HAVE_SSE2
+    if (kind == CB_STORE_STREAM) {
+        triad_stream(a, b, c, s, length);
+    } else {
+        triad_regular(a, b, c, s, length);
+    }
+#else
+    (void)kind;
+    triad_scalar(a, b, c, s, length);
+#endif
+}
+
+bool cb_store_stream_supported(void)
+{
+#ifdef STORE_HAVE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *cb_store_kind_name(cb_store_kind_t kind)
+{
+    switch (kind) {
+    case CB_STORE_REGULAR: return "regular";
+    case CB_STORE_STREAM:  return "non-temporal";
+    default:               break;
+    }
+
+    return "unknown";
+}
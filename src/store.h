@@ -0,0 +1,64 @@
+/**
+ * @file store.h
+ * @brief Write-heavy streaming kernels with regular and non-temporal stores.
+ *
+ * A regular store to a line that is not in the cache first reads the
+ * line for ownership (RFO), then writes it back when it is evicted, so
+ * every written byte costs two bytes of memory traffic. A non-temporal
+ * store goes through a write-combining buffer straight to memory and
+ * skips the read. Each kernel here comes in both flavours with the
+ * same SSE2 loop, so a pair differs only in the store instruction.
+ */
+
+#ifndef CB_STORE_H
+#define CB_STORE_H
+
+#include <stdbool.h>
+
+/** @brief Elements per 64-byte line; callers split work on this boundary. */
+#define CB_STORE_LINE_ELEMS 16
+
+/**
+ * @brief Store instruction used by a kernel.
+ */
+typedef enum {
+    CB_STORE_REGULAR = 0, /**< MOVDQA / MOVAPS (write-allocate). */
+    CB_STORE_STREAM,      /**< MOVNTDQ / MOVNTPS (non-temporal). */
+    CB_STORE_KIND_COUNT   /**< Number of store kinds. */
+} cb_store_kind_t;
+
+/**
+ * @brief In-place transform: data[i] = data[i] + 1.
+ *
+ * @param data    Array, updated in place.
+ * @param length  Elements.
+ * @param kind    Store instruction.
+ */
+void cb_store_transform(int *data, int length, cb_store_kind_t kind);
+
+/**
+ * @brief Out-of-place triad: a[i] = b[i] + s * c[i].
+ *
+ * @param a       Output array.
+ * @param b       First input.
+ * @param c       Second input.
+ * @param s       Scalar.
+ * @param length  Elements.
+ * @param kind    Store instruction.
+ */
+void cb_store_triad(float *a, const float *b, const float *c, float s,
+                    int length, cb_store_kind_t kind);
+
+/**
+ * @brief True if this build has SSE2 kernels, i.e. CB_STORE_STREAM
+ *        really issues non-temporal stores. Otherwise both kinds run
+ *        the same scalar loop.
+ */
+bool cb_store_stream_supported(void);
+
+/**
+ * @brief Short name of a store kind ("regular", "non-temporal").
+ */
+const char *cb_store_kind_name(cb_store_kind_t kind);
+
+#endif /* CB_STORE_H */
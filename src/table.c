@@ -0,0 +1,308 @@
+/**
+ * @file table.c
+ * @brief Implementation of generic result tables.
+ *
+ * Rows are stored in a geometrically grown heap array of fixed-width
+ * cells. Column widths are computed at print time from the widest cell
+ * or header in each column.
+ */
+
+#include "table.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+
+/** @brief Initial number of row slots allocated on first use. */
+#define TABLE_INITIAL_ROWS 16
+
+cb_error_t cb_table_create(cb_table_t **out, const char *name,
+                           const char *title, const char *const *headers,
+                           int num_cols)
+{
+    if (!out || !name || !title || !headers ||
+        num_cols < 1 || num_cols > CB_TABLE_MAX_COLS) {
+        return CB_ERR_ARGS;
+    }
+
+    *out = NULL;
+
+    cb_table_t *t = calloc(1, sizeof(*t));
+    if (!t) {
+        return CB_ERR_ALLOC;
+    }
+
+    snprintf(t->name, sizeof(t->name), "%s", name);
+    snprintf(t->title, sizeof(t->title), "%s", title);
+    t->num_cols = num_cols;
+
+    for (int i = 0; i < num_cols; i++) {
+        snprintf(t->headers[i], sizeof(t->headers[i]), "%s", headers[i]);
+    }
+
+    *out = t;
+    return CB_OK;
+}
+
+cb_error_t cb_table_add_row(cb_table_t *table)
+{
+    if (!table) {
+        return CB_ERR_ARGS;
+    }
+
+    if (table->num_rows == table->capacity) {
+        int new_cap = table->capacity ? table->capacity * 2 : TABLE_INITIAL_ROWS;
+        cb_table_row_t *rows = realloc(table->rows,
+                                       (size_t)new_cap * sizeof(*rows));
+        if (!rows) {
+            return CB_ERR_ALLOC;
+        }
+        table->rows = rows;
+        table->capacity = new_cap;
+    }
+
+    memset(&table->rows[table->num_rows], 0, sizeof(cb_table_row_t));
+    table->num_rows++;
+    return CB_OK;
+}
+
+void cb_table_set(cb_table_t *table, int col, const char *fmt, ...)
+{
+    if (!table || table->num_rows == 0 || col < 0 || col >= table->num_cols) {
+        return;
+    }
+
+    char *cell = table->rows[table->num_rows - 1].cells[col];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(cell, CB_TABLE_CELL_LEN, fmt, ap);
+    va_end(ap);
+}
+
+void cb_table_add_note(cb_table_t *table, const char *fmt, ...)
+{
+    if (!table || table->num_notes >= CB_TABLE_MAX_NOTES) {
+        return;
+    }
+
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(table->notes[table->num_notes], CB_TABLE_NOTE_LEN, fmt, ap);
+    va_end(ap);
+    table->num_notes++;
+}
+
+void cb_table_set_warning(cb_table_t *table, const char *fmt, ...)
+{
+    if (!table) {
+        return;
+    }
+
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(table->warning, CB_TABLE_NOTE_LEN, fmt, ap);
+    va_end(ap);
+}
+
+/**
+ * @brief Decide whether a cell should be right-aligned.
+ *
+ * Numbers, percentages, and speedups ("1.25x") start with a digit,
+ * sign, or decimal point.
+ */
+static int is_numeric_cell(const char *cell)
+{
+    char c = cell[0];
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+}
+
+/**
+ * @brief Print a "+-----+-----+" separator line for the given widths.
+ */
+static void print_separator(FILE *f, const int *widths, int num_cols)
+{
+    fputc('+', f);
+    for (int c = 0; c < num_cols; c++) {
+        for (int i = 0; i < widths[c] + 2; i++) {
+            fputc('-', f);
+        }
+        fputc('+', f);
+    }
+    fputc('\n', f);
+}
+
+void cb_table_print(FILE *f, const cb_table_t *table)
+{
+    if (!f || !table) {
+        return;
+    }
+
+    int widths[CB_TABLE_MAX_COLS];
+
+    for (int c = 0; c < table->num_cols; c++) {
+        widths[c] = (int)strlen(table->headers[c]);
+        for (int r = 0; r < table->num_rows; r++) {
+            int len = (int)strlen(table->rows[r].cells[c]);
+            if (len > widths[c]) {
+                widths[c] = len;
+            }
+        }
+    }
+
+    fprintf(f, "%s\n\n", table->title);
+
+    print_separator(f, widths, table->num_cols);
+    fputc('|', f);
+    for (int c = 0; c < table->num_cols; c++) {
+        fprintf(f, " %-*s |", widths[c], table->headers[c]);
+    }
+    fputc('\n', f);
+    print_separator(f, widths, table->num_cols);
+
+    for (int r = 0; r < table->num_rows; r++) {
+        fputc('|', f);
+        for (int c = 0; c < table->num_cols; c++) {
+            const char *cell = table->rows[r].cells[c];
+            if (is_numeric_cell(cell)) {
+                fprintf(f, " %*s |", widths[c], cell);
+            } else {
+                fprintf(f, " %-*s |", widths[c], cell);
+            }
+        }
+        fputc('\n', f);
+    }
+
+    print_separator(f, widths, table->num_cols);
+
+    if (table->warning[0] != '\0') {
+        fprintf(f, "%s\n", table->warning);
+    }
+    for (int i = 0; i < table->num_notes; i++) {
+        fprintf(f, "%s\n", table->notes[i]);
+    }
+}
+
+cb_error_t cb_table_write_csv(const cb_table_t *table, const char *dir_path)
+{
+    if (!table || !dir_path) {
+        return CB_ERR_ARGS;
+    }
+
+    char filepath[CB_MAX_PATH];
+    int written = snprintf(filepath, sizeof(filepath), "%s/%s.csv",
+                           dir_path, table->name);
+    if (written < 0 || (size_t)written >= sizeof(filepath)) {
+        return CB_ERR_OVERFLOW;
+    }
+
+    FILE *f = fopen(filepath, "w");
+    if (!f) {
+        return CB_ERR_IO;
+    }
+
+    for (int c = 0; c < table->num_cols; c++) {
+        fprintf(f, "%s%s", c ? "," : "", table->headers[c]);
+    }
+    fputc('\n', f);
+
+    for (int r = 0; r < table->num_rows; r++) {
+        for (int c = 0; c < table->num_cols; c++) {
+            fprintf(f, "%s%s", c ? "," : "", table->rows[r].cells[c]);
+        }
+        fputc('\n', f);
+    }
+
+    fclose(f);
+    return CB_OK;
+}
+
+void cb_table_destroy(cb_table_t *table)
+{
+    if (!table) {
+        return;
+    }
+
+    free(table->rows);
+    free(table);
+}
+
+cb_error_t cb_table_create_timing(cb_table_t **out, const char *name,
+                                  const char *title, const char *rate_header)
+{
+    const char *headers[CB_TIMING_COLS] = {
+        "Mode", "Workers", "Min (s)", "Mean (s)", "Max (s)", "Stddev (s)",
+        "Speedup", rate_header, "Check"
+    };
+
+    if (!rate_header) {
+        return CB_ERR_ARGS;
+    }
+
+    return cb_table_create(out, name, title, headers, CB_TIMING_COLS);
+}
+
+cb_error_t cb_table_add_timing_row(cb_table_t *table, const char *mode,
+                                   int workers, const cb_bench_stats_t *stats,
+                                   double baseline_sec, double work_per_run,
+                                   const char *check)
+{
+    if (!table || !mode || !stats || !check) {
+        return CB_ERR_ARGS;
+    }
+
+    cb_error_t err = cb_table_add_row(table);
+    if (err) {
+        return err;
+    }
+
+    double mean = stats->mean_sec;
+    double speedup = (baseline_sec > 0.0 && mean > 0.0) ? baseline_sec / mean : 1.0;
+    double rate = (mean > 0.0) ? work_per_run / mean : 0.0;
+
+    cb_table_set(table, 0, "%s", mode);
+    cb_table_set(table, 1, "%d", workers);
+    cb_table_set(table, 2, "%.6f", stats->min_sec);
+    cb_table_set(table, 3, "%.6f", mean);
+    cb_table_set(table, 4, "%.6f", stats->max_sec);
+    cb_table_set(table, 5, "%.6f", stats->stddev_sec);
+    cb_table_set(table, 6, "%.2fx", speedup);
+    cb_table_set(table, 7, "%.2f", rate);
+    cb_table_set(table, 8, "%s", check);
+
+    return CB_OK;
+}
+
+cb_error_t cb_table_attach(cb_session_t *session, cb_table_t *table)
+{
+    if (!session || !table) {
+        cb_table_destroy(table);
+        return CB_ERR_ARGS;
+    }
+
+    if (session->num_tables >= CB_MAX_TABLES) {
+        cb_table_destroy(table);
+        return CB_ERR_OVERFLOW;
+    }
+
+    session->tables[session->num_tables++] = table;
+    return CB_OK;
+}
+
+void cb_table_release_all(cb_session_t *session)
+{
+    if (!session) {
+        return;
+    }
+
+    for (int i = 0; i < session->num_tables; i++) {
+        cb_table_destroy(session->tables[i]);
+        session->tables[i] = NULL;
+    }
+
+    session->num_tables = 0;
+}
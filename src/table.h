@@ -0,0 +1,195 @@
+/**
+ * @file table.h
+ * @brief Generic result tables for supplementary benchmark suites.
+ *
+ * The three core modes (single, process, thread) share one fixed table
+ * layout in output.c. Supplementary suites (barrier sweeps, workloads,
+ * tuners, ...) each measure different quantities, so they describe their
+ * results as a titled table of preformatted cells instead. The output
+ * module renders every attached table on the terminal and in the text
+ * report, and writes each one to its own CSV file.
+ */
+
+#ifndef CB_TABLE_H
+#define CB_TABLE_H
+
+#include <stdio.h>
+
+#include "error.h"
+#include "types.h"
+
+/** @brief Maximum number of columns in a table. */
+#define CB_TABLE_MAX_COLS   12
+
+/** @brief Maximum length of one formatted cell, including the terminator. */
+#define CB_TABLE_CELL_LEN   32
+
+/** @brief Maximum number of free-form note lines printed below a table. */
+#define CB_TABLE_MAX_NOTES  8
+
+/** @brief Maximum length of one note line, including the terminator. */
+#define CB_TABLE_NOTE_LEN   160
+
+/**
+ * @brief One row of preformatted cells.
+ */
+typedef struct {
+    char cells[CB_TABLE_MAX_COLS][CB_TABLE_CELL_LEN]; /**< Cell text, left to right. */
+} cb_table_row_t;
+
+/**
+ * @brief A titled table of preformatted result cells.
+ *
+ * Created with cb_table_create(), filled row by row with
+ * cb_table_add_row() and cb_table_set(), and released with
+ * cb_table_destroy(). Cells that look numeric are right-aligned when
+ * rendered; all others are left-aligned.
+ */
+struct cb_table {
+    char            name[32];    /**< File stem for the CSV export (e.g. "barrier"). */
+    char            title[96];   /**< Heading printed above the table. */
+    int             num_cols;    /**< Number of columns in use. */
+    char            headers[CB_TABLE_MAX_COLS][CB_TABLE_CELL_LEN]; /**< Column headers. */
+    cb_table_row_t *rows;        /**< Heap-allocated row storage. */
+    int             num_rows;    /**< Number of rows filled. */
+    int             capacity;    /**< Allocated row slots. */
+    char            notes[CB_TABLE_MAX_NOTES][CB_TABLE_NOTE_LEN]; /**< Footnotes. */
+    int             num_notes;   /**< Number of notes in use. */
+    char            warning[CB_TABLE_NOTE_LEN]; /**< Run-wide warning, or empty. */
+};
+
+/**
+ * @brief Allocate an empty table.
+ *
+ * @param out       Output pointer to the new table.
+ * @param name      CSV file stem (without extension).
+ * @param title     Heading printed above the table.
+ * @param headers   Array of @p num_cols column header strings.
+ * @param num_cols  Number of columns (1 - CB_TABLE_MAX_COLS).
+ * @return CB_OK on success, CB_ERR_ARGS or CB_ERR_ALLOC on failure.
+ */
+cb_error_t cb_table_create(cb_table_t **out, const char *name,
+                           const char *title, const char *const *headers,
+                           int num_cols);
+
+/**
+ * @brief Append an empty row; subsequent cb_table_set() calls fill it.
+ *
+ * @param table  Table to extend.
+ * @return CB_OK on success, CB_ERR_ALLOC if the row storage cannot grow.
+ */
+cb_error_t cb_table_add_row(cb_table_t *table);
+
+/**
+ * @brief Format one cell of the most recently added row.
+ *
+ * Text longer than CB_TABLE_CELL_LEN - 1 characters is truncated.
+ * Out-of-range columns and calls before the first row are ignored.
+ *
+ * @param table  Table being filled.
+ * @param col    Zero-based column index.
+ * @param fmt    printf-style format string.
+ */
+void cb_table_set(cb_table_t *table, int col, const char *fmt, ...);
+
+/**
+ * @brief Append a footnote line printed below the table.
+ *
+ * Notes beyond CB_TABLE_MAX_NOTES are silently dropped.
+ *
+ * @param table  Table to annotate.
+ * @param fmt    printf-style format string.
+ */
+void cb_table_add_note(cb_table_t *table, const char *fmt, ...);
+
+/**
+ * @brief Set a warning line printed below the table, ahead of the notes.
+ *
+ * Unlike notes, the warning has its own slot, so it is never dropped
+ * however many notes the suite added. A later call replaces it.
+ *
+ * @param table  Table to annotate.
+ * @param fmt    printf-style format string.
+ */
+void cb_table_set_warning(cb_table_t *table, const char *fmt, ...);
+
+/**
+ * @brief Render a table as a bordered ASCII grid followed by its notes.
+ *
+ * @param f      Output stream.
+ * @param table  Table to print.
+ */
+void cb_table_print(FILE *f, const cb_table_t *table);
+
+/**
+ * @brief Write a table to "<dir_path>/<name>.csv".
+ *
+ * @param table     Table to export.
+ * @param dir_path  Output directory.
+ * @return CB_OK on success, CB_ERR_IO or CB_ERR_OVERFLOW on failure.
+ */
+cb_error_t cb_table_write_csv(const cb_table_t *table, const char *dir_path);
+
+/**
+ * @brief Free a table created by cb_table_create().
+ * @param table  Table to free, or NULL (no-op).
+ */
+void cb_table_destroy(cb_table_t *table);
+
+/** @brief Number of columns in a table made by cb_table_create_timing(). */
+#define CB_TIMING_COLS      9
+
+/**
+ * @brief Create a per-mode timing table in the layout of the core table.
+ *
+ * Columns: Mode, Workers, Min (s), Mean (s), Max (s), Stddev (s),
+ * Speedup, <rate_header>, Check. Used by workload suites that run the
+ * same job in several modes.
+ *
+ * @param out          Output pointer to the new table.
+ * @param name         CSV file stem.
+ * @param title        Heading printed above the table.
+ * @param rate_header  Header of the throughput column (e.g. "Melem/s").
+ * @return CB_OK on success, CB_ERR_ARGS or CB_ERR_ALLOC on failure.
+ */
+cb_error_t cb_table_create_timing(cb_table_t **out, const char *name,
+                                  const char *title, const char *rate_header);
+
+/**
+ * @brief Append one mode to a table made by cb_table_create_timing().
+ *
+ * @param table         Timing table.
+ * @param mode          Mode label.
+ * @param workers       Degree of parallelism.
+ * @param stats         Timing statistics for the mode.
+ * @param baseline_sec  Mean time of the baseline mode (speedup = baseline /
+ *                      mean); 0 prints a speedup of 1.00x.
+ * @param work_per_run  Work units per run; the rate column shows
+ *                      work_per_run / mean.
+ * @param check         Verification result text (e.g. "PASS").
+ * @return CB_OK on success, CB_ERR_ALLOC on failure.
+ */
+cb_error_t cb_table_add_timing_row(cb_table_t *table, const char *mode,
+                                   int workers, const cb_bench_stats_t *stats,
+                                   double baseline_sec, double work_per_run,
+                                   const char *check);
+
+/**
+ * @brief Transfer ownership of a table to the session.
+ *
+ * On failure (session already holds CB_MAX_TABLES tables), the table is
+ * destroyed so the caller never has to clean up after this call.
+ *
+ * @param session  Session that will own the table.
+ * @param table    Table to attach.
+ * @return CB_OK on success, CB_ERR_OVERFLOW if the session is full.
+ */
+cb_error_t cb_table_attach(cb_session_t *session, cb_table_t *table);
+
+/**
+ * @brief Destroy every table attached to the session.
+ * @param session  Session whose tables are released.
+ */
+void cb_table_release_all(cb_session_t *session);
+
+#endif /* CB_TABLE_H */
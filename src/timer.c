@@ -0,0 +1,274 @@
+/**
+ * @file timer.c
+ * @brief Implementation of the selectable interval timer.
+ *
+ * Ticks are converted with a 32.28 fixed-point nanoseconds-per-tick
+ * factor. The tick delta is split at bit 28 so that both products fit
+ * in 64 bits for any TSC faster than 62.5 MHz, which keeps the read
+ * path to two multiplies and no division.
+ */
+
+#include "timer.h"
+
+#include <string.h>
+
+#include "platform.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define TIMER_HAVE_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#define TIMER_HAVE_TSC 1
+#include <intrin.h>
+#endif
+
+/** @brief Fractional bits of the ticks-to-nanoseconds factor. */
+#define TIMER_SHIFT 28
+
+/** @brief Calls averaged for the overhead measurement. */
+#define TIMER_OVERHEAD_CALLS  100000
+
+/** @brief Clock steps sampled for the resolution measurement. */
+#define TIMER_RESOLUTION_SAMPLES  1000
+
+/** @brief Reads to wait for one clock step before giving up. */
+#define TIMER_MAX_SPINS  1000000
+
+/**
+ * @brief Global timer state, written only by cb_timer_init().
+ */
+static struct {
+    cb_timer_source_t source;   /**< Active source. */
+    uint64_t          tsc_base; /**< TSC at the end of calibration. */
+    uint64_t          ns_base;  /**< Monotonic ns at the same moment. */
+    uint64_t          mult;     /**< ns per tick << TIMER_SHIFT. */
+    cb_timer_info_t   info;     /**< Measured properties. */
+} timer_state;
+
+#ifdef TIMER_HAVE_TSC
+/** @brief Read the TSC; RDTSCP waits for earlier instructions to retire. */
+static uint64_t read_tsc(void)
+{
+    unsigned int aux;
+    return (uint64_t)__rdtscp(&aux);
+}
+
+/**
+ * @brief Query CPUID for RDTSCP and the invariant TSC flag.
+ * @return true if both are present.
+ */
+static bool tsc_usable(bool *invariant)
+{
+    unsigned int max_ext, edx_1, edx_7;
+
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, (int)0x80000000);
+    max_ext = (unsigned int)regs[0];
+    if (max_ext < 0x80000007u) {
+        *invariant = false;
+        return false;
+    }
+    __cpuid(regs, (int)0x80000001);
+    edx_1 = (unsigned int)regs[3];
+    __cpuid(regs, (int)0x80000007);
+    edx_7 = (unsigned int)regs[3];
+#else
+    unsigned int eax, ebx, ecx;
+    max_ext = __get_cpuid_max(0x80000000u, NULL);
+    if (max_ext < 0x80000007u ||
+        !__get_cpuid(0x80000001u, &eax, &ebx, &ecx, &edx_1) ||
+        !__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx_7)) {
+        *invariant = false;
+        return false;
+    }
+#endif
+
+    /* CPUID.80000007H:EDX[8] = invariant TSC; 80000001H:EDX[27] = RDTSCP. */
+    *invariant = (edx_7 & (1u << 8)) != 0;
+    return *invariant && (edx_1 & (1u << 27)) != 0;
+}
+
+/** @brief Convert a TSC reading to monotonic nanoseconds. */
+static uint64_t tsc_to_ns(uint64_t tsc)
+{
+    uint64_t delta = tsc - timer_state.tsc_base;
+    uint64_t lo = delta & ((1u << TIMER_SHIFT) - 1);
+
+    return timer_state.ns_base + (delta >> TIMER_SHIFT) * timer_state.mult +
+           ((lo * timer_state.mult) >> TIMER_SHIFT);
+}
+
+/** @brief Install a TSC rate, anchored at one (tsc, ns) pair. */
+static void set_tsc_rate(double hz, uint64_t tsc, uint64_t ns)
+{
+    timer_state.mult = (uint64_t)(1e9 / hz * (double)(1u << TIMER_SHIFT) + 0.5);
+    timer_state.tsc_base = tsc;
+    timer_state.ns_base = ns;
+    timer_state.info.tsc_ghz = hz / 1e9;
+}
+
+/**
+ * @brief Calibrate the TSC against the monotonic clock.
+ * @return CB_OK, or CB_ERR_PLATFORM if the clock failed.
+ */
+static cb_error_t calibrate_tsc(void)
+{
+    uint64_t ns0 = cb_time_now_ns();
+    uint64_t tsc0 = read_tsc();
+    uint64_t target = ns0 + (uint64_t)CB_TIMER_CALIBRATE_MS * 1000000u;
+    uint64_t ns1, tsc1;
+
+    if (ns0 == 0) {
+        return CB_ERR_PLATFORM;
+    }
+
+    /* Busy-wait so the CPU stays out of deep sleep during the window. */
+    do {
+        ns1 = cb_time_now_ns();
+        tsc1 = read_tsc();
+    } while (ns1 < target);
+
+    if (tsc1 <= tsc0) {
+        return CB_ERR_PLATFORM;
+    }
+
+    double hz = (double)(tsc1 - tsc0) * 1e9 / (double)(ns1 - ns0);
+    if (hz < 62.5e6) {
+        return CB_ERR_PLATFORM;
+    }
+
+    set_tsc_rate(hz, tsc1, ns1);
+    return CB_OK;
+}
+#endif /* TIMER_HAVE_TSC */
+
+uint64_t cb_timer_ns(void)
+{
+#ifdef TIMER_HAVE_TSC
+    if (timer_state.source == CB_TIMER_TSC) {
+        return tsc_to_ns(read_tsc());
+    }
+#endif
+    return cb_time_now_ns();
+}
+
+/**
+ * @brief Measure the smallest step and the mean call cost of a clock.
+ */
+static void measure_clock(uint64_t (*clock_fn)(void), double *resolution_ns,
+                          double *overhead_ns)
+{
+    uint64_t best = UINT64_MAX;
+
+    for (int i = 0; i < TIMER_RESOLUTION_SAMPLES; i++) {
+        uint64_t t0 = clock_fn(), t1 = t0;
+        for (int spin = 0; t1 == t0 && spin < TIMER_MAX_SPINS; spin++) {
+            t1 = clock_fn();
+        }
+        if (t1 > t0 && t1 - t0 < best) {
+            best = t1 - t0;
+        }
+    }
+    *resolution_ns = (best == UINT64_MAX) ? 0.0 : (double)best;
+
+    uint64_t start = clock_fn();
+    for (int i = 0; i < TIMER_OVERHEAD_CALLS; i++) {
+        (void)clock_fn();
+    }
+    *overhead_ns = (double)(clock_fn() - start) / TIMER_OVERHEAD_CALLS;
+}
+
+cb_error_t cb_timer_init(bool want_tsc)
+{
+    cb_error_t err = CB_OK;
+
+    memset(&timer_state, 0, sizeof(timer_state));
+
+#ifdef TIMER_HAVE_TSC
+    bool invariant = false;
+    bool usable = tsc_usable(&invariant);
+    timer_state.info.tsc_invariant = invariant;
+
+    if (want_tsc) {
+        err = usable ? calibrate_tsc() : CB_ERR_PLATFORM;
+        if (!err) {
+            timer_state.source = CB_TIMER_TSC;
+        } else {
+            timer_state.info.tsc_ghz = 0.0;
+        }
+    }
+#else
+    if (want_tsc) {
+        err = CB_ERR_PLATFORM;
+    }
+#endif
+
+    timer_state.info.source = timer_state.source;
+    measure_clock(cb_time_now_ns, &timer_state.info.mono_resolution_ns,
+                  &timer_state.info.mono_overhead_ns);
+    if (timer_state.source == CB_TIMER_MONOTONIC) {
+        timer_state.info.resolution_ns = timer_state.info.mono_resolution_ns;
+        timer_state.info.overhead_ns = timer_state.info.mono_overhead_ns;
+    } else {
+        measure_clock(cb_timer_ns, &timer_state.info.resolution_ns,
+                      &timer_state.info.overhead_ns);
+    }
+
+    return err;
+}
+
+cb_error_t cb_timer_restore(bool want_tsc, const cb_timer_info_t *saved)
+{
+    if (!saved) {
+        return CB_ERR_ARGS;
+    }
+
+#ifdef TIMER_HAVE_TSC
+    bool invariant = false;
+    bool usable = tsc_usable(&invariant);
+
+    if (want_tsc && (!usable || saved->source != CB_TIMER_TSC ||
+                     saved->tsc_ghz * 1e9 < 62.5e6)) {
+        return CB_ERR_PLATFORM;
+    }
+
+    memset(&timer_state, 0, sizeof(timer_state));
+    timer_state.info = *saved;
+    timer_state.info.tsc_invariant = invariant;
+    if (want_tsc) {
+        uint64_t ns = cb_time_now_ns();
+        set_tsc_rate(saved->tsc_ghz * 1e9, read_tsc(), ns);
+        timer_state.source = CB_TIMER_TSC;
+    }
+#else
+    if (want_tsc) {
+        return CB_ERR_PLATFORM;
+    }
+
+    memset(&timer_state, 0, sizeof(timer_state));
+    timer_state.info = *saved;
+#endif
+
+    timer_state.info.source = timer_state.source;
+    timer_state.info.from_profile = true;
+    if (timer_state.source == CB_TIMER_MONOTONIC) {
+        timer_state.info.resolution_ns = saved->mono_resolution_ns;
+        timer_state.info.overhead_ns = saved->mono_overhead_ns;
+    }
+    return CB_OK;
+}
+
+void cb_timer_get_info(cb_timer_info_t *info)
+{
+    if (info) {
+        *info = timer_state.info;
+    }
+}
+
+const char *cb_timer_source_name(cb_timer_source_t source)
+{
+    return source == CB_TIMER_TSC ? "tsc" : "monotonic";
+}
@@ -0,0 +1,105 @@
+/**
+ * @file timer.h
+ * @brief Selectable high-resolution interval timer.
+ *
+ * By default the timer reads the platform monotonic clock. With
+ * cb_timer_init(true) on an x86 CPU with an invariant TSC (constant
+ * rate across P-states and C-states), it reads the time stamp counter
+ * with RDTSCP instead and converts ticks to nanoseconds with a
+ * fixed-point factor calibrated against the monotonic clock at
+ * startup.
+ *
+ * Timestamps are integer nanoseconds on the monotonic clock's epoch,
+ * so they keep full precision at any uptime and remain comparable
+ * across threads and forked children. cb_timer_init() also measures
+ * the resolution and per-call overhead of the active source and of
+ * the monotonic clock, so they can be reported next to the results
+ * and subtracted from very small workloads.
+ */
+
+#ifndef CB_TIMER_H
+#define CB_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "error.h"
+
+/** @brief Length of the TSC calibration window in milliseconds. */
+#define CB_TIMER_CALIBRATE_MS  50
+
+/**
+ * @brief Clock behind cb_timer_ns().
+ */
+typedef enum {
+    CB_TIMER_MONOTONIC = 0,  /**< Platform monotonic clock (the default). */
+    CB_TIMER_TSC             /**< Invariant TSC read with RDTSCP. */
+} cb_timer_source_t;
+
+/**
+ * @brief Timer properties measured by cb_timer_init().
+ */
+typedef struct {
+    cb_timer_source_t source;              /**< Active source. */
+    bool              tsc_invariant;       /**< CPU reports an invariant TSC. */
+    double            tsc_ghz;             /**< Calibrated TSC rate (0 if unused). */
+    double            resolution_ns;       /**< Smallest observed step of the source. */
+    double            overhead_ns;         /**< Mean cost of one cb_timer_ns() call. */
+    double            mono_resolution_ns;  /**< Same, for the monotonic clock. */
+    double            mono_overhead_ns;    /**< Same, for the monotonic clock. */
+    bool              from_profile;        /**< Restored, not measured. */
+} cb_timer_info_t;
+
+/**
+ * @brief Select, calibrate and measure the timer.
+ *
+ * Call once at startup, before any worker threads or processes exist.
+ * If the TSC is requested but unusable, the monotonic clock stays
+ * active and CB_ERR_PLATFORM is returned; the timer is usable either
+ * way.
+ *
+ * @param want_tsc  Use the invariant TSC if the CPU supports it.
+ * @return CB_OK, or CB_ERR_PLATFORM if the TSC was requested but not
+ *         available.
+ */
+cb_error_t cb_timer_init(bool want_tsc);
+
+/**
+ * @brief Select the timer using measurements saved by an earlier run.
+ *
+ * Skips the TSC calibration window and the resolution and overhead
+ * measurements, taking them from @p saved (as returned by
+ * cb_timer_get_info() on an earlier run on the same host). Fails
+ * without side effects if @p want_tsc is set but @p saved was not
+ * measured on the TSC or this CPU has no usable TSC; call
+ * cb_timer_init() then.
+ *
+ * @param want_tsc  Use the invariant TSC.
+ * @param saved     Measurements from an earlier run.
+ * @return CB_OK, CB_ERR_ARGS if @p saved is NULL, or CB_ERR_PLATFORM
+ *         if @p saved cannot satisfy @p want_tsc.
+ */
+cb_error_t cb_timer_restore(bool want_tsc, const cb_timer_info_t *saved);
+
+/**
+ * @brief Read the active timer.
+ * @return Nanoseconds since the monotonic clock's epoch.
+ */
+uint64_t cb_timer_ns(void);
+
+/**
+ * @brief Get the properties measured by cb_timer_init().
+ *
+ * Before cb_timer_init() the source is the monotonic clock and all
+ * measurements are zero.
+ *
+ * @param info  Output.
+ */
+void cb_timer_get_info(cb_timer_info_t *info);
+
+/**
+ * @brief Short name of a timer source ("monotonic" or "tsc").
+ */
+const char *cb_timer_source_name(cb_timer_source_t source);
+
+#endif /* CB_TIMER_H */
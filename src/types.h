@@ -28,6 +28,100 @@
 /** @brief Default number of benchmark iterations per mode. */
 #define CB_DEFAULT_ITERATIONS  5
 
+/** @brief Maximum number of supplementary result tables per session. */
+#define CB_MAX_TABLES      32
+
+/** @brief Default cap on barrier episodes per barrier-suite measurement. */
+#define CB_DEFAULT_BARRIER_EPISODES  200000
+
+/** @brief Minimum barrier episodes per measurement (one stop-check batch). */
+#define CB_BARRIER_MIN_EPISODES      32
+
+/** @brief Default matrix order for the gemm workload. */
+#define CB_DEFAULT_GEMM_SIZE  512
+
+/** @brief Smallest and largest accepted gemm matrix order. */
+#define CB_GEMM_MIN_SIZE      16
+#define CB_GEMM_MAX_SIZE      4096
+
+/** @brief Default allocator operations per thread per alloc iteration. */
+#define CB_DEFAULT_ALLOC_OPS  200000
+
+/** @brief Maximum length of an alloc pattern name, including the NUL. */
+#define CB_ALLOC_PATTERN_LEN  16
+
+/** @brief Default number of fiber tasks the dataset is split into. */
+#define CB_DEFAULT_FIBER_TASKS  1024
+
+/** @brief Maximum number of fiber tasks (each owns a fiber stack). */
+#define CB_FIBER_MAX_TASKS      16384
+
+/** @brief Default elements a fiber task sums between yields. */
+#define CB_DEFAULT_FIBER_YIELD  256
+
+/** @brief Maximum length of a sum kernel name, including the NUL. */
+#define CB_KERNEL_NAME_LEN      16
+
+/** @brief Smallest grain in the default fork-join grain sweep. */
+#define CB_FORKJOIN_MIN_GRAIN   256
+
+/** @brief Shortest distance (elements) in the default prefetch sweep. */
+#define CB_PREFETCH_MIN_DISTANCE  64
+
+/** @brief Elements per block of the blocked-random access pattern (128 KiB). */
+#define CB_ACCESS_BLOCK           32768
+
+/** @brief Maximum length of an SMT antagonist name, including the NUL. */
+#define CB_SMT_ANTAGONIST_LEN     16
+
+/** @brief Maximum number of fields in a layout-suite record. */
+#define CB_LAYOUT_MAX_FIELDS      16
+
+/** @brief Default layout-suite field widths in bytes (a 32-byte record). */
+#define CB_DEFAULT_LAYOUT_FIELDS  "8,8,4,4,4,2,1,1"
+
+/** @brief TCP port of a cluster coordinator that is not run with --cluster-local. */
+#define CB_DEFAULT_CLUSTER_PORT   47615
+
+/** @brief Maximum number of cluster worker nodes. */
+#define CB_CLUSTER_MAX_NODES      64
+
+/** @brief Maximum length of a cluster coordinator host name, including the NUL. */
+#define CB_CLUSTER_HOST_LEN       256
+
+/** @brief Default largest allreduce vector, in bytes (256 MiB). */
+#define CB_DEFAULT_ALLREDUCE_MAX  (256 << 20)
+
+/** @brief Upper bound on --allreduce-max, in bytes (1 GiB). */
+#define CB_ALLREDUCE_MAX_BYTES    (1 << 30)
+
+/** @brief Default straggler deadline, as a multiple of the median slice time. */
+#define CB_DEFAULT_STRAGGLER_K    2.0
+
+/** @brief Default sleep injected into one straggler-suite child, in ms. */
+#define CB_DEFAULT_STRAGGLER_DELAY_MS 50
+
+/** @brief Upper bound on --mutate-rate, in percent of the elements. */
+#define CB_MUTATE_RATE_MAX        100.0
+
+/** @brief Default number of tenants for --tenant-cpus without --tenants. */
+#define CB_DEFAULT_TENANTS        2
+
+/** @brief Upper bound on --tenants. */
+#define CB_MAX_TENANTS            16
+
+/** @brief Maximum length of a tenant CPU placement name, including the NUL. */
+#define CB_TENANT_CPUS_LEN        16
+
+/** @brief Default --copy-max: bytes copied at once by all threads, in MiB. */
+#define CB_DEFAULT_COPY_MAX_MIB   256
+
+/** @brief Upper bound on --copy-max, in MiB (16 GiB). */
+#define CB_COPY_MAX_MIB           16384
+
+/** @brief Upper bound on the --copy-align offsets, in bytes. */
+#define CB_COPY_MAX_ALIGN         63
+
 /* ---- Core Data Structures ---- */
 
 /**
@@ -61,14 +155,18 @@ typedef struct {
  * @brief Complete report for one benchmark mode (single / process / thread).
  *
  * Combines the final summation result, the degree of parallelism used,
- * and the timing statistics into a single structure that the output
- * module can format and display.
+ * the timing statistics and any CPU-quota throttling into a single
+ * structure that the output module can format and display.
  */
 typedef struct {
-    const char       *label;       /**< Mode identifier: "single", "process", or "thread". */
-    long int          sum;         /**< Final summation result (used for correctness check). */
-    int               parallelism; /**< Number of workers (1 for single-threaded). */
-    cb_bench_stats_t  stats;       /**< Timing statistics across all iterations. */
+    const char        *label;          /**< Mode identifier: "single", "process", or "thread". */
+    long int           sum;            /**< Final summation result (used for correctness check). */
+    int                parallelism;    /**< Number of workers (1 for single-threaded). */
+    cb_bench_stats_t   stats;          /**< Timing statistics across all iterations. */
+    bool               throttle_known; /**< cgroup throttling was sampled around this mode. */
+    unsigned long long periods;        /**< CFS quota periods elapsed while it ran. */
+    unsigned long long throttled;      /**< Periods in which the quota ran out. */
+    double             throttled_sec;  /**< Time spent throttled (seconds). */
 } cb_run_report_t;
 
 /**
@@ -85,21 +183,85 @@ typedef struct {
     unsigned int seed;          /**< RNG seed (0 = generate from current time). */
     int          iterations;    /**< Number of benchmark iterations per mode. */
     bool         verbose;       /**< Enable detailed per-worker output. */
+    bool         run_barrier;   /**< Run the barrier algorithm suite (--barrier). */
+    int          barrier_episodes; /**< Max episodes per barrier measurement. */
+    bool         run_sort;      /**< Run the sort workload (--sort). */
+    bool         run_gemm;      /**< Run the gemm workload (--gemm). */
+    int          gemm_size;     /**< Matrix order for the gemm workload. */
+    int          gemm_mc;       /**< GEMM rows of A per packed block. */
+    int          gemm_kc;       /**< GEMM depth per packed panel. */
+    int          gemm_nc;       /**< GEMM columns of B per packed panel. */
+    bool         run_alloc;     /**< Run the allocator workload (--alloc). */
+    int          alloc_ops;     /**< Allocator operations per thread per iteration. */
+    char         alloc_pattern[CB_ALLOC_PATTERN_LEN]; /**< Only this pattern ("" = all). */
+    bool         run_fiber;     /**< Run the fiber mode (--fiber). */
+    int          fiber_tasks;   /**< Tasks the dataset is split into for --fiber. */
+    int          fiber_yield;   /**< Elements a fiber task sums between yields. */
+    bool         run_forkjoin;  /**< Run the fork-join mode (--forkjoin). */
+    int          forkjoin_grain; /**< Only this grain size (0 = sweep). */
+    bool         run_omp;       /**< Run the OpenMP comparison (--omp). */
+    bool         run_reduce;    /**< Run the combine suite (--reduce). */
+    bool         run_autotune;  /**< Run the configuration search (--autotune). */
+    bool         run_prefetch;  /**< Run the prefetch sweep (--prefetch). */
+    int          prefetch_distance; /**< Only this distance in elements (0 = sweep). */
+    bool         run_access;    /**< Run the access-pattern suite (--access). */
+    int          access_stride; /**< Only this stride in elements (0 = sweep). */
+    bool         run_smt;       /**< Run the SMT sibling suite (--smt). */
+    char         smt_antagonist[CB_SMT_ANTAGONIST_LEN]; /**< Only this antagonist ("" = all). */
+    bool         run_compress;  /**< Run the compressed-scan suite (--compress). */
+    bool         run_layout;    /**< Run the record-layout suite (--layout). */
+    int          layout_fields; /**< Fields per record. */
+    int          layout_width[CB_LAYOUT_MAX_FIELDS]; /**< Field widths in bytes (1, 2, 4, 8). */
+    unsigned int layout_touch;  /**< Bit mask of summed fields (0 = first and middle). */
+    bool         run_cluster;   /**< Coordinate a cluster run (--coordinator). */
+    int          cluster_nodes; /**< Worker nodes the coordinator waits for. */
+    int          cluster_port;  /**< Coordinator TCP port (0 = default). */
+    bool         cluster_local; /**< Spawn the nodes on this host (--cluster-local). */
+    bool         cluster_worker; /**< Run as a cluster node (--cluster-worker). */
+    char         cluster_host[CB_CLUSTER_HOST_LEN]; /**< Coordinator address for a node. */
+    bool         run_allreduce; /**< Run the allreduce suite (--allreduce). */
+    int          allreduce_max; /**< Largest allreduce vector in bytes. */
+    bool         run_straggler; /**< Run the straggler suite (--straggler). */
+    double       straggler_k;   /**< Backup deadline, x median slice time. */
+    int          straggler_delay_ms; /**< Injected child sleep (0 = none). */
+    bool         run_mutate;    /**< Run the mutating workload (--mutate). */
+    double       mutate_rate;   /**< Updated elements in % (0 = sweep). */
+    bool         run_tenants;   /**< Run the multi-tenant suite (--tenants). */
+    int          tenants;       /**< Concurrent tenant sessions. */
+    char         tenant_cpus[CB_TENANT_CPUS_LEN]; /**< Only this placement ("" = all). */
+    bool         run_write;     /**< Run the write-heavy suite (--write). */
+    bool         run_copy;      /**< Run the copy suite (--copy). */
+    int          copy_max_mib;  /**< Largest total bytes in flight, MiB. */
+    int          copy_src_align; /**< Source offset from a page, bytes. */
+    int          copy_dst_align; /**< Destination offset from a page, bytes. */
+    bool         use_tsc;       /**< Time worker slices with the TSC (--tsc). */
+    bool         tune_kernel;   /**< Autotune the sum kernel (--tune-kernel). */
+    bool         recalibrate;   /**< Ignore the saved host profile (--recalibrate). */
+    char         kernel_name[CB_KERNEL_NAME_LEN]; /**< Forced sum kernel ("" = none). */
 } cb_config_t;
 
+/**
+ * @brief Generic table of supplementary suite results (see table.h).
+ */
+typedef struct cb_table cb_table_t;
+
 /**
  * @brief Complete benchmark session results.
  *
  * Top-level container holding the configuration, all three benchmark
- * reports, system information, and a timestamp. Passed to the output
- * module to generate the terminal display, text report, and CSV file.
+ * reports, any supplementary suite tables, system information, and a
+ * timestamp. Passed to the output module to generate the terminal
+ * display, text report, and CSV files.
  */
 typedef struct {
     cb_config_t     config;            /**< Configuration used for this run. */
     cb_run_report_t single;            /**< Single-threaded benchmark results. */
     cb_run_report_t process;           /**< Multi-process benchmark results. */
     cb_run_report_t thread;            /**< Multi-threaded benchmark results. */
+    cb_table_t     *tables[CB_MAX_TABLES]; /**< Supplementary suite tables (owned). */
+    int             num_tables;        /**< Number of entries in tables. */
     char            system_info[256];  /**< OS and CPU description string. */
+    char            profile_info[128]; /**< How the host profile was used. */
     char            timestamp[32];     /**< Run timestamp in "YYYYMMDD_HHMMSS" format. */
 } cb_session_t;
 
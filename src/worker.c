@@ -17,21 +17,22 @@
 
 #include "worker.h"
 
+#include <stdint.h>
 #include <stdio.h>
 
+#include "kernel.h"
+#include "timer.h"
+
 cb_result_t cb_array_sum(const int *dataset, int start, int length)
 {
     cb_result_t result;
     result.sum = 0;
 
-    double t_start = cb_time_now();
+    uint64_t t_start = cb_timer_ns();
 
-    for (int i = start; i < start + length; i++) {
-        result.sum += dataset[i];
-    }
+    result.sum = cb_kernel_sum(dataset + start, length);
 
-    double t_end = cb_time_now();
-    result.elapsed_sec = t_end - t_start;
+    result.elapsed_sec = (double)(cb_timer_ns() - t_start) * 1e-9;
 
     return result;
 }